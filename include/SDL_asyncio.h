@@ -0,0 +1,173 @@
+/*
+  Simple DirectMedia Layer
+  Copyright (C) 1997-2020 Sam Lantinga <slouken@libsdl.org>
+
+  This software is provided 'as-is', without any express or implied
+  warranty.  In no event will the authors be held liable for any damages
+  arising from the use of this software.
+
+  Permission is granted to anyone to use this software for any purpose,
+  including commercial applications, and to alter it and redistribute it
+  freely, subject to the following restrictions:
+
+  1. The origin of this software must not be misrepresented; you must not
+     claim that you wrote the original software. If you use this software
+     in a product, an acknowledgment in the product documentation would be
+     appreciated but is not required.
+  2. Altered source versions must be plainly marked as such, and must not be
+     misrepresented as being the original software.
+  3. This notice may not be removed or altered from any source distribution.
+*/
+
+#ifndef SDL_asyncio_h_
+#define SDL_asyncio_h_
+
+/**
+ *  \file SDL_asyncio.h
+ *
+ *  Header for asynchronous file I/O.
+ *
+ *  Read requests are submitted to a queue and run by its I/O threads.
+ *  When a request finishes, its outcome is put on the queue's completion
+ *  list, where it can be polled for or waited on.
+ */
+
+#include "SDL_stdinc.h"
+#include "SDL_error.h"
+#include "SDL_rwops.h"
+
+#include "begin_code.h"
+/* Set up for C function definitions, even when using C++ */
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* The asynchronous I/O queue structure, defined in SDL_asyncio.c */
+struct SDL_AsyncIOQueue;
+typedef struct SDL_AsyncIOQueue SDL_AsyncIOQueue;
+
+/**
+ *  The kind of an asynchronous I/O request.
+ */
+typedef enum
+{
+    SDL_ASYNCIO_READ,           /**< A read from a stream, SDL_ReadAsyncIO() */
+    SDL_ASYNCIO_LOAD_FILE       /**< A whole file, SDL_LoadFileAsyncIO() */
+} SDL_AsyncIOType;
+
+/**
+ *  The result of an asynchronous I/O request.
+ */
+typedef enum
+{
+    SDL_ASYNCIO_COMPLETE,       /**< The request finished */
+    SDL_ASYNCIO_FAILURE         /**< The request failed, see SDL_GetError() */
+} SDL_AsyncIOResult;
+
+/**
+ *  What happened to a finished asynchronous I/O request.
+ */
+typedef struct SDL_AsyncIOOutcome
+{
+    SDL_AsyncIOType type;       /**< The kind of request */
+    SDL_AsyncIOResult result;   /**< Whether the request succeeded */
+    SDL_RWops *src;             /**< The stream read from, or NULL for a loaded file */
+    void *buffer;               /**< The data read. For loaded files, free this with SDL_free() */
+    Sint64 offset;              /**< The offset in the stream the data was read from */
+    size_t bytes_requested;     /**< The number of bytes asked for */
+    size_t bytes_transferred;   /**< The number of bytes read, less than asked for at the end of a stream */
+    void *userdata;             /**< The pointer passed when the request was submitted */
+} SDL_AsyncIOOutcome;
+
+/**
+ *  Create a queue for asynchronous I/O requests, with its own I/O threads.
+ *
+ *  \param num_threads The number of I/O threads, or 0 to pick one suited
+ *                     to the system.
+ *
+ *  \return The new queue, or NULL on error.
+ *
+ *  If SDL is built without thread support, requests are run as they are
+ *  submitted.
+ */
+extern DECLSPEC SDL_AsyncIOQueue *SDLCALL SDL_CreateAsyncIOQueue(int num_threads);
+
+/**
+ *  Read from a stream without waiting for the data.
+ *
+ *  Reads from a stream don't change its position if it is a file, or in
+ *  memory, otherwise they are run one at a time. Don't use the stream in
+ *  any other way until the request has finished.
+ *
+ *  \param queue The queue to put the request on
+ *  \param src The stream to read from
+ *  \param offset The offset in the stream to start reading at
+ *  \param ptr Where to put the data, which must stay valid until the request finishes
+ *  \param size The number of bytes to read
+ *  \param userdata A pointer passed back in the outcome
+ *
+ *  \return 0 on success, or -1 on error.
+ */
+extern DECLSPEC int SDLCALL SDL_ReadAsyncIO(SDL_AsyncIOQueue *queue, SDL_RWops *src,
+                                            Sint64 offset, void *ptr, size_t size,
+                                            void *userdata);
+
+/**
+ *  Load an entire file, like SDL_LoadFile(), without waiting for it.
+ *
+ *  The data is in the outcome's buffer and should be freed with SDL_free().
+ *
+ *  \param queue The queue to put the request on
+ *  \param file The file to load
+ *  \param userdata A pointer passed back in the outcome
+ *
+ *  \return 0 on success, or -1 on error.
+ */
+extern DECLSPEC int SDLCALL SDL_LoadFileAsyncIO(SDL_AsyncIOQueue *queue, const char *file,
+                                                void *userdata);
+
+/**
+ *  Get the outcome of a finished request, if there is one.
+ *
+ *  If the request failed, SDL_GetError() has the reason.
+ *
+ *  \return SDL_TRUE if \c outcome was filled in, or SDL_FALSE if no request
+ *          has finished yet.
+ */
+extern DECLSPEC SDL_bool SDLCALL SDL_GetAsyncIOResult(SDL_AsyncIOQueue *queue,
+                                                      SDL_AsyncIOOutcome *outcome);
+
+/**
+ *  Wait for a request to finish and get its outcome.
+ *
+ *  If the request failed, SDL_GetError() has the reason.
+ *
+ *  \param queue The queue to wait on
+ *  \param outcome Filled in with the outcome of the finished request
+ *  \param timeout The maximum number of milliseconds to wait, or -1 to wait
+ *                 as long as there are unfinished requests.
+ *
+ *  \return SDL_TRUE if \c outcome was filled in, or SDL_FALSE if the wait
+ *          timed out or there were no requests to wait for.
+ */
+extern DECLSPEC SDL_bool SDLCALL SDL_WaitAsyncIOResult(SDL_AsyncIOQueue *queue,
+                                                       SDL_AsyncIOOutcome *outcome,
+                                                       Sint32 timeout);
+
+/**
+ *  Wait for the submitted requests to finish, then destroy the queue.
+ *
+ *  Outcomes that weren't retrieved are discarded, and the data of loaded
+ *  files among them is freed.
+ */
+extern DECLSPEC void SDLCALL SDL_DestroyAsyncIOQueue(SDL_AsyncIOQueue *queue);
+
+/* Ends C function definitions when using C++ */
+#ifdef __cplusplus
+}
+#endif
+#include "close_code.h"
+
+#endif /* SDL_asyncio_h_ */
+
+/* vi: set ts=4 sw=4 expandtab: */
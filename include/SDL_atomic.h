@@ -283,6 +283,42 @@ extern DECLSPEC void* SDLCALL SDL_AtomicSetPtr(void **a, void* v);
  */
 extern DECLSPEC void* SDLCALL SDL_AtomicGetPtr(void **a);
 
+/**
+ * \brief A type representing a 64-bit atomic integer value.  It is a struct
+ *        so people don't accidentally use numeric operations on it.
+ *
+ * \note On some 32-bit platforms these operations are emulated with a lock.
+ */
+typedef struct { Sint64 value; } SDL_atomic64_t;
+
+/**
+ * \brief Set a 64-bit atomic variable to a new value if it is currently an old value.
+ *
+ * \return SDL_TRUE if the atomic variable was set, SDL_FALSE otherwise.
+ *
+ * \note If you don't know what this function is for, you shouldn't use it!
+*/
+extern DECLSPEC SDL_bool SDLCALL SDL_AtomicCAS64(SDL_atomic64_t *a, Sint64 oldval, Sint64 newval);
+
+/**
+ * \brief Set a 64-bit atomic variable to a value.
+ *
+ * \return The previous value of the atomic variable.
+ */
+extern DECLSPEC Sint64 SDLCALL SDL_AtomicSet64(SDL_atomic64_t *a, Sint64 v);
+
+/**
+ * \brief Get the value of a 64-bit atomic variable
+ */
+extern DECLSPEC Sint64 SDLCALL SDL_AtomicGet64(SDL_atomic64_t *a);
+
+/**
+ * \brief Add to a 64-bit atomic variable.
+ *
+ * \return The previous value of the atomic variable.
+ */
+extern DECLSPEC Sint64 SDLCALL SDL_AtomicAdd64(SDL_atomic64_t *a, Sint64 v);
+
 /* Ends C function definitions when using C++ */
 #ifdef __cplusplus
 }
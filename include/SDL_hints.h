@@ -1152,6 +1152,35 @@ extern "C" {
  */
 #define SDL_HINT_RENDER_BATCHING  "SDL_RENDER_BATCHING"
 
+/**
+ *  \brief  A variable controlling whether the render API optimizes batches before drawing them.
+ *
+ *  This variable can be set to the following values:
+ *
+ *    "0"     - Draw the commands in a batch as they were queued (default)
+ *    "1"     - Merge adjacent draws that share a texture, blend mode and color,
+ *              and move draws next to others with the same texture when they
+ *              don't overlap anything drawn in between.
+ *
+ *  The result looks the same, but with fewer state changes and larger draws.
+ *  This only has an effect when batching is enabled, and only on renderers
+ *  that support it. It is checked when a renderer is created.
+ */
+#define SDL_HINT_RENDER_OPTIMIZE_COMMANDS  "SDL_RENDER_OPTIMIZE_COMMANDS"
+
+/**
+ *  \brief  A variable controlling how many threads the software renderer uses to draw geometry
+ *
+ *  This variable can be set to the following values:
+ *    "1"     - Draw on the rendering thread only (default)
+ *    "N"     - Split long SDL_RenderGeometry() calls across N threads
+ *    "0"     - Use one thread per CPU
+ *
+ *  The rendering thread draws part of the geometry itself and waits for the
+ *  rest. It is checked when a renderer is created.
+ */
+#define SDL_HINT_RENDER_SOFTWARE_THREADS  "SDL_RENDER_SOFTWARE_THREADS"
+
 
 /**
  *  \brief  A variable controlling whether SDL logs all events pushed onto its internal queue.
@@ -1289,6 +1318,9 @@ extern DECLSPEC SDL_bool SDLCALL SDL_SetHint(const char *name,
 /**
  *  \brief Get a hint
  *
+ *  Environment variables are read the first time each hint is looked up.
+ *  Call SDL_RefreshHintEnvironment() if you change them after that.
+ *
  *  \return The string value of a hint variable.
  */
 extern DECLSPEC const char * SDLCALL SDL_GetHint(const char *name);
@@ -1300,6 +1332,18 @@ extern DECLSPEC const char * SDLCALL SDL_GetHint(const char *name);
  */
 extern DECLSPEC SDL_bool SDLCALL SDL_GetHintBoolean(const char *name, SDL_bool default_value);
 
+/**
+ *  \brief Re-read the environment variables for hints that have been used
+ *
+ *  Hints take a snapshot of their environment variable the first time they
+ *  are looked up. Call this after changing the environment so that SDL sees
+ *  the new values. Callbacks are called for any hints whose value changes.
+ *
+ *  Strings returned by SDL_GetHint() for those hints may no longer be valid
+ *  after this call.
+ */
+extern DECLSPEC void SDLCALL SDL_RefreshHintEnvironment(void);
+
 /**
  * \brief type definition of the hint callback function.
  */
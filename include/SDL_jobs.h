@@ -0,0 +1,177 @@
+/*
+  Simple DirectMedia Layer
+  Copyright (C) 1997-2020 Sam Lantinga <slouken@libsdl.org>
+
+  This software is provided 'as-is', without any express or implied
+  warranty.  In no event will the authors be held liable for any damages
+  arising from the use of this software.
+
+  Permission is granted to anyone to use this software for any purpose,
+  including commercial applications, and to alter it and redistribute it
+  freely, subject to the following restrictions:
+
+  1. The origin of this software must not be misrepresented; you must not
+     claim that you wrote the original software. If you use this software
+     in a product, an acknowledgment in the product documentation would be
+     appreciated but is not required.
+  2. Altered source versions must be plainly marked as such, and must not be
+     misrepresented as being the original software.
+  3. This notice may not be removed or altered from any source distribution.
+*/
+
+#ifndef SDL_jobs_h_
+#define SDL_jobs_h_
+
+/**
+ *  \file SDL_jobs.h
+ *
+ *  Header for the SDL job system, a pool of worker threads that run
+ *  short functions in parallel.
+ *
+ *  Each worker keeps its own queue of jobs. Jobs submitted from a worker
+ *  go on that worker's queue, and idle workers steal jobs from the others,
+ *  so jobs that spawn more jobs scale well. Jobs submitted from other
+ *  threads go on a shared queue.
+ *
+ *  Jobs can be collected in a job group, which can be waited on, and jobs
+ *  can be held back until all the jobs in another group have finished.
+ */
+
+#include "SDL_stdinc.h"
+#include "SDL_error.h"
+
+#include "begin_code.h"
+/* Set up for C function definitions, even when using C++ */
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* The SDL job pool structure, defined in SDL_jobs.c */
+struct SDL_JobPool;
+typedef struct SDL_JobPool SDL_JobPool;
+
+/* The SDL job group structure, defined in SDL_jobs.c */
+struct SDL_JobGroup;
+typedef struct SDL_JobGroup SDL_JobGroup;
+
+/**
+ *  The function run by a job, passed the data given when it was submitted.
+ */
+typedef void (SDLCALL * SDL_JobFunction) (void *data);
+
+/**
+ *  The function run by SDL_ParallelFor(), passed a range of indices to
+ *  process, from \c start up to but not including \c end.
+ */
+typedef void (SDLCALL * SDL_ParallelForFunction) (int start, int end, void *data);
+
+/**
+ *  Create a pool of worker threads.
+ *
+ *  \param num_threads The number of worker threads, or 0 to use one less
+ *                     than SDL_GetCPUCount(), leaving a CPU for the calling
+ *                     thread, which helps run jobs while it waits for them.
+ *
+ *  \return The new job pool, or NULL on error.
+ */
+extern DECLSPEC SDL_JobPool *SDLCALL SDL_CreateJobPool(int num_threads);
+
+/**
+ *  Get the number of worker threads in a job pool.
+ */
+extern DECLSPEC int SDLCALL SDL_GetJobPoolThreadCount(SDL_JobPool *pool);
+
+/**
+ *  Wait for all the submitted jobs to finish, then destroy the job pool.
+ *
+ *  Jobs still waiting for a group that never finishes are not run.
+ */
+extern DECLSPEC void SDLCALL SDL_DestroyJobPool(SDL_JobPool *pool);
+
+/**
+ *  Create a job group, to wait for jobs or to run jobs after them.
+ *
+ *  A job group should only be used with one job pool at a time.
+ *
+ *  \return The new job group, or NULL on error.
+ */
+extern DECLSPEC SDL_JobGroup *SDLCALL SDL_CreateJobGroup(void);
+
+/**
+ *  Destroy a job group. There should be no unfinished jobs in the group.
+ *
+ *  Jobs still waiting to run after the group are dropped without running,
+ *  and count as finished in their own groups.
+ */
+extern DECLSPEC void SDLCALL SDL_DestroyJobGroup(SDL_JobGroup *group);
+
+/**
+ *  Submit a job to run on a job pool.
+ *
+ *  \param pool The job pool to run the job on
+ *  \param func The function to run
+ *  \param data A pointer passed to the function
+ *  \param group The job group to add the job to, or NULL
+ *
+ *  \return 0 on success, or -1 on error.
+ */
+extern DECLSPEC int SDLCALL SDL_SubmitJob(SDL_JobPool *pool,
+                                          SDL_JobFunction func, void *data,
+                                          SDL_JobGroup *group);
+
+/**
+ *  Submit a job that runs once every job in \c after has finished.
+ *
+ *  If \c after has no unfinished jobs, the job is queued right away.
+ *  Submit all the jobs in \c after before submitting jobs that depend on it.
+ *
+ *  \param pool The job pool to run the job on
+ *  \param after The job group to wait for
+ *  \param func The function to run
+ *  \param data A pointer passed to the function
+ *  \param group The job group to add the job to, or NULL
+ *
+ *  \return 0 on success, or -1 on error.
+ */
+extern DECLSPEC int SDLCALL SDL_SubmitJobAfter(SDL_JobPool *pool,
+                                               SDL_JobGroup *after,
+                                               SDL_JobFunction func, void *data,
+                                               SDL_JobGroup *group);
+
+/**
+ *  Wait for every job in a job group to finish.
+ *
+ *  The calling thread runs queued jobs from the pool while it waits, so
+ *  this may be called from inside a job.
+ */
+extern DECLSPEC void SDLCALL SDL_WaitJobGroup(SDL_JobPool *pool, SDL_JobGroup *group);
+
+/**
+ *  Run a function over a range of indices in parallel, and wait for it.
+ *
+ *  The range from \c start up to but not including \c end is split into
+ *  batches of \c grain indices, each of which is run as a job.
+ *
+ *  \param pool The job pool to run the batches on
+ *  \param start The first index
+ *  \param end One past the last index
+ *  \param grain The number of indices per batch, or 0 to pick one
+ *  \param func The function to run on each batch
+ *  \param data A pointer passed to the function
+ *
+ *  \return 0 on success, or -1 on error.
+ */
+extern DECLSPEC int SDLCALL SDL_ParallelFor(SDL_JobPool *pool,
+                                            int start, int end, int grain,
+                                            SDL_ParallelForFunction func,
+                                            void *data);
+
+/* Ends C function definitions when using C++ */
+#ifdef __cplusplus
+}
+#endif
+#include "close_code.h"
+
+#endif /* SDL_jobs_h_ */
+
+/* vi: set ts=4 sw=4 expandtab: */
@@ -240,6 +240,78 @@ extern DECLSPEC int SDLCALL SDL_CondWaitTimeout(SDL_cond * cond,
 /* @} *//* Condition variable functions */
 
 
+/**
+ *  \name Reader-writer lock functions
+ */
+/* @{ */
+
+/* The SDL reader-writer lock structure, defined in SDL_rwlock.c */
+struct SDL_rwlock;
+typedef struct SDL_rwlock SDL_rwlock;
+
+/**
+ *  Create a reader-writer lock, initialized unlocked.
+ *
+ *  Any number of threads can hold the lock for reading at the same time,
+ *  but a thread holding it for writing has it to itself.
+ */
+extern DECLSPEC SDL_rwlock *SDLCALL SDL_CreateRWLock(void);
+
+/**
+ *  Lock the reader-writer lock for reading, waiting for any writer.
+ *
+ *  A thread may lock it for reading more than once, as long as it unlocks
+ *  it as many times, but it must not lock it for writing while it holds it
+ *  for reading.
+ *
+ *  Readers get in whenever no writer holds the lock, even if a writer is
+ *  waiting, so that locking for reading recursively can't deadlock. If
+ *  readers keep the lock held between them, a writer may wait
+ *  indefinitely.
+ *
+ *  \return 0, or -1 on error.
+ */
+extern DECLSPEC int SDLCALL SDL_LockRWLockForReading(SDL_rwlock * rwlock);
+
+/**
+ *  Lock the reader-writer lock for writing, waiting for all other readers
+ *  and writers.
+ *
+ *  The lock is not recursive for writing.
+ *
+ *  \return 0, or -1 on error.
+ */
+extern DECLSPEC int SDLCALL SDL_LockRWLockForWriting(SDL_rwlock * rwlock);
+
+/**
+ *  Try to lock the reader-writer lock for reading.
+ *
+ *  \return 0, ::SDL_MUTEX_TIMEDOUT, or -1 on error
+ */
+extern DECLSPEC int SDLCALL SDL_TryLockRWLockForReading(SDL_rwlock * rwlock);
+
+/**
+ *  Try to lock the reader-writer lock for writing.
+ *
+ *  \return 0, ::SDL_MUTEX_TIMEDOUT, or -1 on error
+ */
+extern DECLSPEC int SDLCALL SDL_TryLockRWLockForWriting(SDL_rwlock * rwlock);
+
+/**
+ *  Unlock the reader-writer lock, from either kind of lock.
+ *
+ *  \return 0, or -1 on error.
+ */
+extern DECLSPEC int SDLCALL SDL_UnlockRWLock(SDL_rwlock * rwlock);
+
+/**
+ *  Destroy a reader-writer lock.
+ */
+extern DECLSPEC void SDLCALL SDL_DestroyRWLock(SDL_rwlock * rwlock);
+
+/* @} *//* Reader-writer lock functions */
+
+
 /* Ends C function definitions when using C++ */
 #ifdef __cplusplus
 }
@@ -85,6 +85,51 @@ typedef struct SDL_RendererInfo
     int max_texture_height;     /**< The maximum texture height */
 } SDL_RendererInfo;
 
+/**
+ *  \brief The reasons a renderer runs the commands it has queued.
+ *
+ *  \sa SDL_RenderStats
+ */
+typedef enum
+{
+    SDL_RENDERFLUSH_NOT_BATCHING,   /**< A draw or state change with batching disabled */
+    SDL_RENDERFLUSH_TEXTURE,        /**< A texture used by queued draws was updated, locked, bound or destroyed */
+    SDL_RENDERFLUSH_TARGET,         /**< The render target was changed */
+    SDL_RENDERFLUSH_READ_PIXELS,    /**< SDL_RenderReadPixels() */
+    SDL_RENDERFLUSH_PRESENT,        /**< SDL_RenderPresent() */
+    SDL_RENDERFLUSH_EXPLICIT,       /**< SDL_RenderFlush(), or getting a native rendering object */
+    SDL_NUM_RENDERFLUSH_CAUSES
+} SDL_RenderFlushCause;
+
+/**
+ *  \brief Statistics on the drawing done by a renderer in one frame.
+ *
+ *  The command counts are for the commands the renderer ran, after any
+ *  merging done by SDL_HINT_RENDER_OPTIMIZE_COMMANDS.
+ *
+ *  \sa SDL_RenderGetStats()
+ */
+typedef struct SDL_RenderStats
+{
+    Uint32 commands_queued;     /**< The number of render commands queued */
+    Uint32 commands_executed;   /**< The number run by the renderer */
+    Uint32 state_changes;       /**< Viewport, clip rect and draw color commands */
+    Uint32 clears;              /**< Clear commands */
+    Uint32 point_draws;         /**< Point drawing commands */
+    Uint32 line_draws;          /**< Line drawing commands */
+    Uint32 rect_fills;          /**< Rectangle filling commands */
+    Uint32 copies;              /**< Texture copy commands */
+    Uint32 copies_ex;           /**< Rotated or flipped texture copy commands */
+    Uint32 copy_batches;        /**< SDL_RenderCopyBatch() commands */
+    Uint32 geometry_draws;      /**< SDL_RenderGeometry() commands */
+    size_t vertex_bytes;        /**< The size of the vertex data passed to the renderer */
+    Uint32 flushes;             /**< The number of times queued commands were run */
+    Uint32 flush_causes[SDL_NUM_RENDERFLUSH_CAUSES];  /**< The flushes for each SDL_RenderFlushCause */
+    Uint32 texture_uploads;     /**< The number of texture updates and unlocks */
+    size_t texture_upload_bytes;  /**< The number of bytes of pixels uploaded to textures */
+    Uint32 run_time_us;         /**< The time spent running commands, in microseconds */
+} SDL_RenderStats;
+
 /**
  *  \brief The scaling mode for a texture.
  */
@@ -125,6 +170,16 @@ typedef enum
     SDL_FLIP_VERTICAL = 0x00000002     /**< flip vertically */
 } SDL_RendererFlip;
 
+/**
+ *  \brief A vertex of a triangle drawn with SDL_RenderGeometry()
+ */
+typedef struct SDL_Vertex
+{
+    SDL_FPoint position;        /**< Vertex position, in SDL_Renderer coordinates  */
+    SDL_Color  color;           /**< Vertex color */
+    SDL_FPoint tex_coord;       /**< Normalized texture coordinates, if needed */
+} SDL_Vertex;
+
 /**
  *  \brief A structure representing rendering state
  */
@@ -137,6 +192,44 @@ typedef struct SDL_Renderer SDL_Renderer;
 struct SDL_Texture;
 typedef struct SDL_Texture SDL_Texture;
 
+/**
+ *  \brief Many small images packed into one texture
+ */
+struct SDL_TextureAtlas;
+typedef struct SDL_TextureAtlas SDL_TextureAtlas;
+
+/**
+ *  \brief A handle to an image in a texture atlas, 0 is never a valid image
+ */
+typedef Uint32 SDL_AtlasID;
+
+/**
+ *  \brief Flags used when creating a texture atlas
+ */
+typedef enum
+{
+    SDL_ATLAS_EVICT = 0x00000001    /**< Remove the least recently drawn images
+                                         to make room when the atlas is full */
+} SDL_AtlasFlags;
+
+/**
+ *  \brief A ring of buffers for reading pixels from a renderer asynchronously
+ */
+struct SDL_RenderReadback;
+typedef struct SDL_RenderReadback SDL_RenderReadback;
+
+/**
+ *  \brief Pixels read with SDL_RenderReadPixelsAsync()
+ */
+typedef struct SDL_RenderReadbackFrame
+{
+    Uint32 sequence;    /**< The number returned by SDL_RenderReadPixelsAsync() */
+    SDL_Rect rect;      /**< The area of the rendering target that was read */
+    Uint32 format;      /**< The format of the pixels */
+    void *pixels;       /**< The pixels, top row first */
+    int pitch;          /**< The length of a row of pixels in bytes */
+} SDL_RenderReadbackFrame;
+
 
 /* Function prototypes */
 
@@ -269,6 +362,52 @@ extern DECLSPEC SDL_Texture * SDLCALL SDL_CreateTexture(SDL_Renderer * renderer,
  */
 extern DECLSPEC SDL_Texture * SDLCALL SDL_CreateTextureFromSurface(SDL_Renderer * renderer, SDL_Surface * surface);
 
+/**
+ *  \brief Create a texture that keeps using an existing surface.
+ *
+ *  \param renderer The renderer.
+ *  \param surface The surface containing pixel data used to fill the texture.
+ *
+ *  \return The created texture is returned, or NULL on error.
+ *
+ *  The texture holds a reference to the surface until it is destroyed, so
+ *  the surface can be freed with SDL_FreeSurface() while the texture is
+ *  still in use.
+ *
+ *  If the renderer can draw straight from the surface's pixels, the texture
+ *  shares them instead of copying them, and keeps the surface's format.
+ *  The software renderer does this for surfaces in one of its texture
+ *  formats, without a color key or RLE acceleration. Otherwise the texture
+ *  is created as with SDL_CreateTextureFromSurface().
+ *
+ *  Either way, after changing the surface's pixels, call
+ *  SDL_UpdateSurfaceTexture() with the area that changed. If the texture
+ *  has been drawn with since the last SDL_RenderPresent(), call
+ *  SDL_RenderFlush() before changing the pixels, since the renderer may not
+ *  have read them yet.
+ *
+ *  \sa SDL_UpdateSurfaceTexture()
+ *  \sa SDL_DestroyTexture()
+ */
+extern DECLSPEC SDL_Texture * SDLCALL SDL_CreateSurfaceTexture(SDL_Renderer * renderer, SDL_Surface * surface);
+
+/**
+ *  \brief Update a texture created with SDL_CreateSurfaceTexture() from
+ *         its surface.
+ *
+ *  \param texture The texture to update.
+ *  \param rect A pointer to the area of the surface that changed, or NULL
+ *              for the whole surface.
+ *
+ *  \return 0 on success, or -1 if the texture is not valid or wasn't
+ *          created with SDL_CreateSurfaceTexture().
+ *
+ *  Nothing is copied when the texture shares the surface's pixels.
+ *
+ *  \sa SDL_CreateSurfaceTexture()
+ */
+extern DECLSPEC int SDLCALL SDL_UpdateSurfaceTexture(SDL_Texture * texture, const SDL_Rect * rect);
+
 /**
  *  \brief Query the attributes of a texture
  *
@@ -1037,6 +1176,179 @@ extern DECLSPEC int SDLCALL SDL_RenderCopyExF(SDL_Renderer * renderer,
                                             const SDL_FPoint *center,
                                             const SDL_RendererFlip flip);
 
+/**
+ *  \brief Copy many portions of a texture to the current rendering target in one call.
+ *
+ *  This draws the same as calling SDL_RenderCopyExF() once for each instance,
+ *  rotating around the center of its destination rectangle, but the copies
+ *  are queued as a single command, which the renderer can draw together.
+ *
+ *  \param renderer The renderer which should copy parts of a texture.
+ *  \param texture The source texture.
+ *  \param srcrects  An array of count source rectangles, or NULL to use the
+ *                   entire texture for every instance.
+ *  \param dstrects  An array of count destination rectangles.
+ *  \param colors    An array of count colors to modulate each instance with,
+ *                   or NULL to use the texture's color and alpha modulation.
+ *  \param angles    An array of count angles in degrees, or NULL for no rotation.
+ *  \param flips     An array of count SDL_RendererFlip values, or NULL for no
+ *                   flipping.
+ *  \param count     The number of instances.
+ *
+ *  \return 0 on success, or -1 on error
+ */
+extern DECLSPEC int SDLCALL SDL_RenderCopyBatch(SDL_Renderer * renderer,
+                                                SDL_Texture * texture,
+                                                const SDL_Rect * srcrects,
+                                                const SDL_FRect * dstrects,
+                                                const SDL_Color * colors,
+                                                const double * angles,
+                                                const SDL_RendererFlip * flips,
+                                                int count);
+
+/**
+ *  \brief Render a list of triangles, optionally using a texture and indices
+ *         into the vertex array.
+ *
+ *  Each vertex has its own color, which modulates the texture (or is the
+ *  color drawn if there is no texture) along with the texture's color and
+ *  alpha modulation. The colors and texture coordinates are interpolated
+ *  across the triangles. The texture's blend mode is used, or the
+ *  renderer's draw blend mode if there is no texture.
+ *
+ *  The software renderer skips any triangle with a vertex more than 4194304
+ *  pixels from the origin of the render target.
+ *
+ *  \param renderer     The renderer.
+ *  \param texture      The texture to use, or NULL for untextured triangles.
+ *  \param vertices     The vertices.
+ *  \param num_vertices The number of vertices.
+ *  \param indices      An array of indices into the vertices, three for each
+ *                      triangle, or NULL to draw the vertices in order.
+ *  \param num_indices  The number of indices.
+ *
+ *  \return 0 on success, or -1 if the operation is not supported
+ */
+extern DECLSPEC int SDLCALL SDL_RenderGeometry(SDL_Renderer * renderer,
+                                               SDL_Texture * texture,
+                                               const SDL_Vertex * vertices, int num_vertices,
+                                               const int * indices, int num_indices);
+
+/**
+ *  \brief Create a texture atlas, a texture that many small images are packed into.
+ *
+ *  Drawing images from one atlas doesn't change the texture between draws,
+ *  so they can be batched together. The atlas keeps a copy of its pixels,
+ *  which lets it move images around when it gets fragmented.
+ *
+ *  \param renderer The renderer.
+ *  \param format The format of the atlas texture and the pixels of its
+ *                images, which can't be a YUV format. 0 picks the
+ *                renderer's preferred format, which SDL_QueryTexture()
+ *                reports for the atlas texture.
+ *  \param w      The width of the atlas texture in pixels.
+ *  \param h      The height of the atlas texture in pixels.
+ *  \param flags  0, or ::SDL_ATLAS_EVICT
+ *
+ *  \return The created atlas, or NULL on error.
+ *
+ *  \note Destroy atlases before the renderer they were created with.
+ *
+ *  \sa SDL_AddAtlasImage()
+ *  \sa SDL_DestroyTextureAtlas()
+ */
+extern DECLSPEC SDL_TextureAtlas * SDLCALL SDL_CreateTextureAtlas(SDL_Renderer * renderer,
+                                                                  Uint32 format,
+                                                                  int w, int h,
+                                                                  Uint32 flags);
+
+/**
+ *  \brief Make room for an image in a texture atlas.
+ *
+ *  Space freed by removed images is reused, and the images are packed again
+ *  if that makes room. If the atlas was created with ::SDL_ATLAS_EVICT, the
+ *  least recently drawn images are removed until the new one fits.
+ *
+ *  \param atlas The atlas.
+ *  \param w     The width of the image in pixels.
+ *  \param h     The height of the image in pixels.
+ *
+ *  \return A handle to the new image, or 0 if it doesn't fit or on error.
+ *
+ *  \sa SDL_UpdateAtlasImage()
+ */
+extern DECLSPEC SDL_AtlasID SDLCALL SDL_AddAtlasImage(SDL_TextureAtlas * atlas, int w, int h);
+
+/**
+ *  \brief Set the pixels of an image in a texture atlas.
+ *
+ *  The texture is updated the next time an image of the atlas is drawn or
+ *  queried, so many images can be updated at once.
+ *
+ *  \param atlas  The atlas.
+ *  \param id     The image.
+ *  \param pixels The pixels, in the format of the atlas.
+ *  \param pitch  The number of bytes in a row of pixel data.
+ *
+ *  \return 0 on success, or -1 if the image isn't in the atlas.
+ */
+extern DECLSPEC int SDLCALL SDL_UpdateAtlasImage(SDL_TextureAtlas * atlas, SDL_AtlasID id,
+                                                 const void *pixels, int pitch);
+
+/**
+ *  \brief Remove an image from a texture atlas, its space can be reused.
+ */
+extern DECLSPEC void SDLCALL SDL_RemoveAtlasImage(SDL_TextureAtlas * atlas, SDL_AtlasID id);
+
+/**
+ *  \brief Get where an image is in a texture atlas.
+ *
+ *  The rectangle is valid until the next image is added or the atlas is
+ *  defragmented. This counts as drawing the image for ::SDL_ATLAS_EVICT.
+ *
+ *  \param atlas   The atlas.
+ *  \param id      The image.
+ *  \param texture Filled in with the atlas texture, may be NULL.
+ *  \param rect    Filled in with the image's place in the texture, may be NULL.
+ *
+ *  \return 0 on success, or -1 if the image isn't in the atlas, for example
+ *          because it was evicted.
+ */
+extern DECLSPEC int SDLCALL SDL_QueryAtlasImage(SDL_TextureAtlas * atlas, SDL_AtlasID id,
+                                                SDL_Texture ** texture, SDL_Rect * rect);
+
+/**
+ *  \brief Copy an image from a texture atlas to the current rendering target.
+ *
+ *  \param renderer The renderer the atlas was created with.
+ *  \param atlas    The atlas.
+ *  \param id       The image.
+ *  \param dstrect  The destination rectangle, or NULL for the entire
+ *                  rendering target.
+ *
+ *  \return 0 on success, or -1 on error, including if the image isn't in the atlas.
+ */
+extern DECLSPEC int SDLCALL SDL_RenderCopyAtlasImage(SDL_Renderer * renderer,
+                                                     SDL_TextureAtlas * atlas,
+                                                     SDL_AtlasID id,
+                                                     const SDL_FRect * dstrect);
+
+/**
+ *  \brief Pack the images in a texture atlas tightly again.
+ *
+ *  This moves images, so rectangles from SDL_QueryAtlasImage() need to be
+ *  queried again, but image handles stay valid.
+ *
+ *  \return 0 on success, or -1 if the images couldn't be packed, in which
+ *          case the atlas is unchanged.
+ */
+extern DECLSPEC int SDLCALL SDL_DefragmentTextureAtlas(SDL_TextureAtlas * atlas);
+
+/**
+ *  \brief Destroy a texture atlas and its texture.
+ */
+extern DECLSPEC void SDLCALL SDL_DestroyTextureAtlas(SDL_TextureAtlas * atlas);
+
 /**
  *  \brief Read pixels from the current rendering target.
  *
@@ -1057,6 +1369,93 @@ extern DECLSPEC int SDLCALL SDL_RenderReadPixels(SDL_Renderer * renderer,
                                                  Uint32 format,
                                                  void *pixels, int pitch);
 
+/**
+ *  \brief Create a ring of buffers for reading pixels from the current
+ *         rendering target without waiting for them.
+ *
+ *  \param renderer The renderer to read from.
+ *  \param format The format to return the pixels in, or 0 to use the format
+ *                of the rendering target.
+ *  \param num_buffers The number of reads that can be in flight or held by
+ *                     the application at once.
+ *
+ *  \return The readback ring, or NULL on error.
+ *
+ *  The software renderer copies the pixels when they're requested and
+ *  converts them to \c format on another thread. The OpenGL renderer reads
+ *  them into a pixel buffer object and copies them out when they're
+ *  returned, giving the GPU time to finish. Other renderers read the pixels
+ *  when they're requested, like SDL_RenderReadPixels().
+ *
+ *  \sa SDL_RenderReadPixelsAsync()
+ *  \sa SDL_GetRenderReadback()
+ *  \sa SDL_DestroyRenderReadback()
+ */
+extern DECLSPEC SDL_RenderReadback * SDLCALL SDL_CreateRenderReadback(SDL_Renderer * renderer,
+                                                                      Uint32 format,
+                                                                      int num_buffers);
+
+/**
+ *  \brief Start reading pixels from the current rendering target.
+ *
+ *  \param readback The readback ring to read into.
+ *  \param rect A pointer to the rectangle to read, or NULL for the entire
+ *              render target.
+ *
+ *  \return A sequence number identifying the read, which increases by one
+ *          with each read, or -1 on error, including when all the buffers
+ *          are in use.
+ *
+ *  Everything drawn so far is rendered before the pixels are read. The
+ *  pixels are returned by SDL_GetRenderReadback(), in the order they were
+ *  requested.
+ *
+ *  \sa SDL_GetRenderReadback()
+ */
+extern DECLSPEC int SDLCALL SDL_RenderReadPixelsAsync(SDL_RenderReadback * readback,
+                                                      const SDL_Rect * rect);
+
+/**
+ *  \brief Get the oldest pixels read by SDL_RenderReadPixelsAsync().
+ *
+ *  \param readback The readback ring.
+ *  \param frame A pointer filled in with the pixels.
+ *  \param timeout The maximum number of milliseconds to wait for the pixels,
+ *                 0 to return right away, or -1 to wait as long as it takes.
+ *
+ *  \return 1 if \c frame was filled in, 0 if the pixels weren't ready in
+ *          time or no reads are waiting to be returned, or -1 on error.
+ *
+ *  The pixels stay valid until they are given back with
+ *  SDL_ReleaseRenderReadback(). This should be called on the thread that
+ *  renders.
+ *
+ *  \sa SDL_ReleaseRenderReadback()
+ */
+extern DECLSPEC int SDLCALL SDL_GetRenderReadback(SDL_RenderReadback * readback,
+                                                  SDL_RenderReadbackFrame * frame,
+                                                  Sint32 timeout);
+
+/**
+ *  \brief Give pixels returned by SDL_GetRenderReadback() back to the ring,
+ *         so their buffer can be used for another read.
+ *
+ *  \param readback The readback ring.
+ *  \param frame The pixels returned by SDL_GetRenderReadback().
+ */
+extern DECLSPEC void SDLCALL SDL_ReleaseRenderReadback(SDL_RenderReadback * readback,
+                                                       const SDL_RenderReadbackFrame * frame);
+
+/**
+ *  \brief Destroy a readback ring.
+ *
+ *  Reads that haven't been returned are discarded. Readback rings that still
+ *  exist when their renderer is destroyed are destroyed with it.
+ *
+ *  \sa SDL_CreateRenderReadback()
+ */
+extern DECLSPEC void SDLCALL SDL_DestroyRenderReadback(SDL_RenderReadback * readback);
+
 /**
  *  \brief Update the screen with rendering performed.
  */
@@ -1103,6 +1502,19 @@ extern DECLSPEC void SDLCALL SDL_DestroyRenderer(SDL_Renderer * renderer);
  */
 extern DECLSPEC int SDLCALL SDL_RenderFlush(SDL_Renderer * renderer);
 
+/**
+ *  \brief Get statistics on the drawing done in the last frame.
+ *
+ *  The statistics are collected from one SDL_RenderPresent() to the next,
+ *  which is counted as part of the frame it presents.
+ *
+ *  \param renderer The renderer to query
+ *  \param stats    Filled in with the statistics of the last presented frame
+ *
+ *  \return 0 on success, or -1 on error
+ */
+extern DECLSPEC int SDLCALL SDL_RenderGetStats(SDL_Renderer * renderer, SDL_RenderStats * stats);
+
 
 /**
  *  \brief Bind the texture to the current OpenGL/ES/ES2 context for use with
@@ -45,6 +45,8 @@ extern "C" {
 #define SDL_RWOPS_JNIFILE   3U  /**< Android asset */
 #define SDL_RWOPS_MEMORY    4U  /**< Memory stream */
 #define SDL_RWOPS_MEMORY_RO 5U  /**< Read-Only memory stream */
+#define SDL_RWOPS_MAPPED    6U  /**< Read-Only memory-mapped file */
+#define SDL_RWOPS_BUFFERED  7U  /**< Buffered stream */
 
 /**
  * This is the read/write operation structure -- very basic.
@@ -165,6 +167,42 @@ extern DECLSPEC SDL_RWops *SDLCALL SDL_RWFromMem(void *mem, int size);
 extern DECLSPEC SDL_RWops *SDLCALL SDL_RWFromConstMem(const void *mem,
                                                       int size);
 
+/**
+ *  Open a file for reading by mapping it into memory.
+ *
+ *  Reads are served by copying straight out of the mapping, and the whole
+ *  file can be accessed without copying through SDL_RWGetMemory().
+ *  The mapping is hinted for sequential access.
+ *
+ *  If the file can't be mapped on this platform, it is opened with
+ *  SDL_RWFromFile() in "rb" mode instead.
+ *
+ *  \param file The file to open
+ *
+ *  \return the new stream, or NULL if the file couldn't be opened.
+ */
+extern DECLSPEC SDL_RWops *SDLCALL SDL_RWFromFileMapped(const char *file);
+
+/**
+ *  Wrap a stream with a buffer, so small reads and writes don't each go
+ *  through the stream.
+ *
+ *  Reads fill the buffer ahead of the read position, writes are collected
+ *  in the buffer until it's full or the stream is flushed by seeking,
+ *  reading, or closing it. Seeking within the data already read ahead
+ *  doesn't touch the stream.
+ *
+ *  \param src The stream to buffer, which shouldn't be used directly while
+ *             it's wrapped
+ *  \param buffer_size The size of the buffer, or 0 for a default size
+ *  \param autoclose Whether to close \c src when the new stream is closed
+ *
+ *  \return the new stream, or NULL on error.
+ */
+extern DECLSPEC SDL_RWops *SDLCALL SDL_RWFromRWBuffered(SDL_RWops *src,
+                                                        size_t buffer_size,
+                                                        SDL_bool autoclose);
+
 /* @} *//* RWFrom functions */
 
 
@@ -219,6 +257,19 @@ extern DECLSPEC size_t SDLCALL SDL_RWwrite(SDL_RWops *context,
  */
 extern DECLSPEC int SDLCALL SDL_RWclose(SDL_RWops *context);
 
+/**
+ *  Get the memory behind a memory or memory-mapped stream.
+ *
+ *  The memory stays valid until the stream is closed, and shouldn't be
+ *  written to unless the stream was created with SDL_RWFromMem().
+ *
+ *  If \c size is not NULL, it is filled with the size of the memory.
+ *
+ *  \return the start of the stream's data, or NULL if the stream isn't
+ *          backed by memory.
+ */
+extern DECLSPEC const void *SDLCALL SDL_RWGetMemory(SDL_RWops *context, size_t *size);
+
 /**
  *  Load all the data from an SDL data stream.
  *
@@ -70,6 +70,33 @@ extern DECLSPEC Uint64 SDLCALL SDL_GetPerformanceFrequency(void);
  */
 extern DECLSPEC void SDLCALL SDL_Delay(Uint32 ms);
 
+/**
+ * \brief Wait a specified number of nanoseconds before returning.
+ *
+ * This waits at least as long as requested, but the system may oversleep by
+ * up to its scheduling granularity. Use SDL_DelayPrecise() or
+ * SDL_DelayUntil() when the wakeup time matters more than CPU usage.
+ */
+extern DECLSPEC void SDLCALL SDL_DelayNS(Uint64 ns);
+
+/**
+ * \brief Wait a specified number of nanoseconds, as precisely as possible.
+ *
+ * This sleeps until shortly before the time is up and then spins for the
+ * rest, so it uses some CPU time but returns very close to the requested
+ * time.
+ */
+extern DECLSPEC void SDLCALL SDL_DelayPrecise(Uint64 ns);
+
+/**
+ * \brief Wait until SDL_GetPerformanceCounter() reaches \c deadline.
+ *
+ * This works like SDL_DelayPrecise(), but waits for an absolute time. A frame
+ * limiter can add its frame period to the deadline every frame without
+ * accumulating drift. This returns immediately if the deadline has passed.
+ */
+extern DECLSPEC void SDLCALL SDL_DelayUntil(Uint64 deadline);
+
 /**
  *  Function prototype for the timer callback function.
  *
@@ -94,6 +121,21 @@ extern DECLSPEC SDL_TimerID SDLCALL SDL_AddTimer(Uint32 interval,
                                                  SDL_TimerCallback callback,
                                                  void *param);
 
+/**
+ * \brief Add a new timer to the pool of timers already running, with
+ *        microsecond resolution.
+ *
+ * This works like SDL_AddTimer(), except that \c interval, and the interval
+ * passed to and returned from the callback, are in microseconds. The timer
+ * is driven by the high resolution counter, so it can fire more precisely
+ * than the millisecond tick count allows.
+ *
+ * \return A timer ID, or 0 when an error occurs.
+ */
+extern DECLSPEC SDL_TimerID SDLCALL SDL_AddTimerMicroseconds(Uint32 interval,
+                                                             SDL_TimerCallback callback,
+                                                             void *param);
+
 /**
  * \brief Remove a timer knowing its ID.
  *
@@ -22,11 +22,14 @@
 
 #include "SDL_hints.h"
 #include "SDL_error.h"
+#include "SDL_atomic.h"
 #include "SDL_hints_c.h"
 
 
-/* Assuming there aren't many hints set and they aren't being queried in
-   critical performance paths, we'll just use linked lists here.
+/* Hints are queried from hot paths like the renderer and joystick code, so
+   they're kept in a hash table keyed by name. Each hint keeps a copy of its
+   environment variable, read the first time the hint is looked up, and its
+   effective value parsed ahead of time for the typed getters.
  */
 typedef struct SDL_HintWatch {
     SDL_HintCallback callback;
@@ -36,19 +39,114 @@ typedef struct SDL_HintWatch {
 
 typedef struct SDL_Hint {
     char *name;
+    Uint32 hash;
     char *value;
+    char *env;              /* snapshot of the environment variable, or NULL */
+    const char *current;    /* value or env, whichever takes priority */
+    int boolean;            /* current as a boolean, or -1 if it's unset or empty */
+    int integer;            /* current as an integer, if it's set */
     SDL_HintPriority priority;
     SDL_HintWatch *callbacks;
     struct SDL_Hint *next;
 } SDL_Hint;
 
-static SDL_Hint *SDL_hints;
+/* Must be a power of two */
+#define SDL_HINT_BUCKETS    128
+
+static SDL_Hint *SDL_hints[SDL_HINT_BUCKETS];
+static SDL_SpinLock SDL_hints_lock;
+
+static Uint32
+SDL_HashHintName(const char *name)
+{
+    /* FNV-1a */
+    Uint32 hash = 2166136261u;
+    while (*name) {
+        hash ^= (Uint8) *name++;
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+static SDL_Hint *
+SDL_FindHint(const char *name, Uint32 hash)
+{
+    SDL_Hint *hint;
+
+    for (hint = SDL_hints[hash & (SDL_HINT_BUCKETS - 1)]; hint; hint = hint->next) {
+        if (hint->hash == hash && SDL_strcmp(name, hint->name) == 0) {
+            return hint;
+        }
+    }
+    return NULL;
+}
+
+/* Work out the effective value of a hint and parse it for the typed getters */
+static void
+SDL_UpdateHintCurrent(SDL_Hint *hint)
+{
+    if (hint->env && hint->priority != SDL_HINT_OVERRIDE) {
+        hint->current = hint->env;
+    } else {
+        hint->current = hint->value;
+    }
+
+    if (!hint->current || !*hint->current) {
+        hint->boolean = -1;
+        hint->integer = 0;
+    } else {
+        hint->boolean = SDL_GetStringBoolean(hint->current, SDL_TRUE);
+        hint->integer = SDL_atoi(hint->current);
+    }
+}
+
+/* Find a hint, adding it with a snapshot of its environment variable if it's new */
+static SDL_Hint *
+SDL_GetHintEntry(const char *name)
+{
+    const Uint32 hash = SDL_HashHintName(name);
+    const int bucket = hash & (SDL_HINT_BUCKETS - 1);
+    SDL_Hint *hint;
+    const char *env;
+
+    hint = SDL_FindHint(name, hash);
+    if (hint) {
+        return hint;
+    }
+
+    /* Lookups don't take the lock, so new hints are published fully built */
+    SDL_AtomicLock(&SDL_hints_lock);
+    hint = SDL_FindHint(name, hash);
+    if (!hint) {
+        hint = (SDL_Hint *)SDL_calloc(1, sizeof(*hint));
+        if (hint) {
+            env = SDL_getenv(name);
+            hint->name = SDL_strdup(name);
+            hint->hash = hash;
+            hint->env = env ? SDL_strdup(env) : NULL;
+            hint->priority = SDL_HINT_DEFAULT;
+            if (!hint->name || (env && !hint->env)) {
+                SDL_free(hint->name);
+                SDL_free(hint->env);
+                SDL_free(hint);
+                hint = NULL;
+            } else {
+                SDL_UpdateHintCurrent(hint);
+                hint->next = SDL_hints[bucket];
+                SDL_MemoryBarrierRelease();
+                SDL_hints[bucket] = hint;
+            }
+        }
+    }
+    SDL_AtomicUnlock(&SDL_hints_lock);
+
+    return hint;
+}
 
 SDL_bool
 SDL_SetHintWithPriority(const char *name, const char *value,
                         SDL_HintPriority priority)
 {
-    const char *env;
     SDL_Hint *hint;
     SDL_HintWatch *entry;
 
@@ -56,42 +154,29 @@ SDL_SetHintWithPriority(const char *name, const char *value,
         return SDL_FALSE;
     }
 
-    env = SDL_getenv(name);
-    if (env && priority < SDL_HINT_OVERRIDE) {
+    hint = SDL_GetHintEntry(name);
+    if (!hint) {
         return SDL_FALSE;
     }
 
-    for (hint = SDL_hints; hint; hint = hint->next) {
-        if (SDL_strcmp(name, hint->name) == 0) {
-            if (priority < hint->priority) {
-                return SDL_FALSE;
-            }
-            if (!hint->value || !value || SDL_strcmp(hint->value, value) != 0) {
-                for (entry = hint->callbacks; entry; ) {
-                    /* Save the next entry in case this one is deleted */
-                    SDL_HintWatch *next = entry->next;
-                    entry->callback(entry->userdata, name, hint->value, value);
-                    entry = next;
-                }
-                SDL_free(hint->value);
-                hint->value = value ? SDL_strdup(value) : NULL;
-            }
-            hint->priority = priority;
-            return SDL_TRUE;
-        }
+    if (hint->env && priority < SDL_HINT_OVERRIDE) {
+        return SDL_FALSE;
     }
-
-    /* Couldn't find the hint, add a new one */
-    hint = (SDL_Hint *)SDL_malloc(sizeof(*hint));
-    if (!hint) {
+    if (priority < hint->priority) {
         return SDL_FALSE;
     }
-    hint->name = SDL_strdup(name);
-    hint->value = value ? SDL_strdup(value) : NULL;
+    if (!hint->value || SDL_strcmp(hint->value, value) != 0) {
+        for (entry = hint->callbacks; entry; ) {
+            /* Save the next entry in case this one is deleted */
+            SDL_HintWatch *next = entry->next;
+            entry->callback(entry->userdata, name, hint->value, value);
+            entry = next;
+        }
+        SDL_free(hint->value);
+        hint->value = SDL_strdup(value);
+    }
     hint->priority = priority;
-    hint->callbacks = NULL;
-    hint->next = SDL_hints;
-    SDL_hints = hint;
+    SDL_UpdateHintCurrent(hint);
     return SDL_TRUE;
 }
 
@@ -104,19 +189,17 @@ SDL_SetHint(const char *name, const char *value)
 const char *
 SDL_GetHint(const char *name)
 {
-    const char *env;
     SDL_Hint *hint;
 
-    env = SDL_getenv(name);
-    for (hint = SDL_hints; hint; hint = hint->next) {
-        if (SDL_strcmp(name, hint->name) == 0) {
-            if (!env || hint->priority == SDL_HINT_OVERRIDE) {
-                return hint->value;
-            }
-            break;
-        }
+    if (!name) {
+        return NULL;
+    }
+
+    hint = SDL_GetHintEntry(name);
+    if (!hint) {
+        return SDL_getenv(name);
     }
-    return env;
+    return hint->current;
 }
 
 SDL_bool
@@ -134,8 +217,77 @@ SDL_GetStringBoolean(const char *value, SDL_bool default_value)
 SDL_bool
 SDL_GetHintBoolean(const char *name, SDL_bool default_value)
 {
-    const char *hint = SDL_GetHint(name);
-    return SDL_GetStringBoolean(hint, default_value);
+    SDL_Hint *hint;
+
+    if (!name) {
+        return default_value;
+    }
+
+    hint = SDL_GetHintEntry(name);
+    if (!hint) {
+        return SDL_GetStringBoolean(SDL_getenv(name), default_value);
+    }
+    if (hint->boolean < 0) {
+        return default_value;
+    }
+    return (SDL_bool) hint->boolean;
+}
+
+int
+SDL_GetHintInteger(const char *name, int default_value)
+{
+    SDL_Hint *hint;
+    const char *env;
+
+    if (!name) {
+        return default_value;
+    }
+
+    hint = SDL_GetHintEntry(name);
+    if (!hint) {
+        env = SDL_getenv(name);
+        return (env && *env) ? SDL_atoi(env) : default_value;
+    }
+    if (!hint->current || !*hint->current) {
+        return default_value;
+    }
+    return hint->integer;
+}
+
+void
+SDL_RefreshHintEnvironment(void)
+{
+    SDL_Hint *hint;
+    SDL_HintWatch *entry;
+    int i;
+
+    for (i = 0; i < SDL_HINT_BUCKETS; ++i) {
+        for (hint = SDL_hints[i]; hint; hint = hint->next) {
+            const char *env = SDL_getenv(hint->name);
+            const char *old_current;
+            char *old_env;
+
+            if (env ? (hint->env && SDL_strcmp(env, hint->env) == 0) : !hint->env) {
+                continue;  /* no change */
+            }
+
+            old_current = hint->current;
+            old_env = hint->env;
+            hint->env = env ? SDL_strdup(env) : NULL;
+            SDL_UpdateHintCurrent(hint);
+
+            if (old_current != hint->current &&
+                (!old_current || !hint->current || SDL_strcmp(old_current, hint->current) != 0)) {
+                for (entry = hint->callbacks; entry; ) {
+                    /* Save the next entry in case this one is deleted */
+                    SDL_HintWatch *next = entry->next;
+                    entry->callback(entry->userdata, hint->name, old_current, hint->current);
+                    entry = next;
+                }
+            }
+            SDL_free(old_env);
+        }
+    }
 }
 
 void
@@ -164,25 +316,12 @@ SDL_AddHintCallback(const char *name, SDL_HintCallback callback, void *userdata)
     entry->callback = callback;
     entry->userdata = userdata;
 
-    for (hint = SDL_hints; hint; hint = hint->next) {
-        if (SDL_strcmp(name, hint->name) == 0) {
-            break;
-        }
-    }
+    /* Need a hint entry for this watcher */
+    hint = SDL_GetHintEntry(name);
     if (!hint) {
-        /* Need to add a hint entry for this watcher */
-        hint = (SDL_Hint *)SDL_malloc(sizeof(*hint));
-        if (!hint) {
-            SDL_OutOfMemory();
-            SDL_free(entry);
-            return;
-        }
-        hint->name = SDL_strdup(name);
-        hint->value = NULL;
-        hint->priority = SDL_HINT_DEFAULT;
-        hint->callbacks = NULL;
-        hint->next = SDL_hints;
-        SDL_hints = hint;
+        SDL_OutOfMemory();
+        SDL_free(entry);
+        return;
     }
 
     /* Add it to the callbacks for this hint */
@@ -190,7 +329,7 @@ SDL_AddHintCallback(const char *name, SDL_HintCallback callback, void *userdata)
     hint->callbacks = entry;
 
     /* Now call it with the current value */
-    value = SDL_GetHint(name);
+    value = hint->current;
     callback(userdata, name, value, value);
 }
 
@@ -200,22 +339,24 @@ SDL_DelHintCallback(const char *name, SDL_HintCallback callback, void *userdata)
     SDL_Hint *hint;
     SDL_HintWatch *entry, *prev;
 
-    for (hint = SDL_hints; hint; hint = hint->next) {
-        if (SDL_strcmp(name, hint->name) == 0) {
-            prev = NULL;
-            for (entry = hint->callbacks; entry; entry = entry->next) {
-                if (callback == entry->callback && userdata == entry->userdata) {
-                    if (prev) {
-                        prev->next = entry->next;
-                    } else {
-                        hint->callbacks = entry->next;
-                    }
-                    SDL_free(entry);
-                    break;
+    if (!name) {
+        return;
+    }
+
+    hint = SDL_FindHint(name, SDL_HashHintName(name));
+    if (hint) {
+        prev = NULL;
+        for (entry = hint->callbacks; entry; entry = entry->next) {
+            if (callback == entry->callback && userdata == entry->userdata) {
+                if (prev) {
+                    prev->next = entry->next;
+                } else {
+                    hint->callbacks = entry->next;
                 }
-                prev = entry;
+                SDL_free(entry);
+                break;
             }
-            return;
+            prev = entry;
         }
     }
 }
@@ -224,19 +365,23 @@ void SDL_ClearHints(void)
 {
     SDL_Hint *hint;
     SDL_HintWatch *entry;
+    int i;
 
-    while (SDL_hints) {
-        hint = SDL_hints;
-        SDL_hints = hint->next;
+    for (i = 0; i < SDL_HINT_BUCKETS; ++i) {
+        while (SDL_hints[i]) {
+            hint = SDL_hints[i];
+            SDL_hints[i] = hint->next;
 
-        SDL_free(hint->name);
-        SDL_free(hint->value);
-        for (entry = hint->callbacks; entry; ) {
-            SDL_HintWatch *freeable = entry;
-            entry = entry->next;
-            SDL_free(freeable);
+            SDL_free(hint->name);
+            SDL_free(hint->value);
+            SDL_free(hint->env);
+            for (entry = hint->callbacks; entry; ) {
+                SDL_HintWatch *freeable = entry;
+                entry = entry->next;
+                SDL_free(freeable);
+            }
+            SDL_free(hint);
         }
-        SDL_free(hint);
     }
 }
 
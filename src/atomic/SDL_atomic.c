@@ -105,7 +105,18 @@ extern _inline int _SDL_xadd_watcom(volatile int *a, int v);
 #define EMULATE_CAS 1
 #endif
 
-#if EMULATE_CAS
+/* Not every 32-bit platform can do 64-bit atomic operations natively */
+#if defined(HAVE_MSC_ATOMICS)
+#define HAVE_MSC_ATOMICS64 1
+#elif defined(HAVE_GCC_ATOMICS) && (defined(__LP64__) || defined(_WIN64) || defined(__GCC_HAVE_SYNC_COMPARE_AND_SWAP_8))
+#define HAVE_GCC_ATOMICS64 1
+#elif defined(__SOLARIS__)
+#define HAVE_SOLARIS_ATOMICS64 1
+#else
+#define EMULATE_CAS64 1
+#endif
+
+#if EMULATE_CAS || EMULATE_CAS64
 static SDL_SpinLock locks[32];
 
 static SDL_INLINE void
@@ -289,6 +300,80 @@ SDL_AtomicGetPtr(void **a)
 #endif
 }
 
+SDL_bool
+SDL_AtomicCAS64(SDL_atomic64_t *a, Sint64 oldval, Sint64 newval)
+{
+#ifdef HAVE_MSC_ATOMICS64
+    return (_InterlockedCompareExchange64((__int64*)&a->value, (__int64)newval, (__int64)oldval) == (__int64)oldval);
+#elif defined(HAVE_GCC_ATOMICS64)
+    return (SDL_bool) __sync_bool_compare_and_swap(&a->value, oldval, newval);
+#elif defined(HAVE_SOLARIS_ATOMICS64)
+    return (SDL_bool) ((Sint64) atomic_cas_64((volatile uint64_t*)&a->value, (uint64_t)oldval, (uint64_t)newval) == oldval);
+#elif EMULATE_CAS64
+    SDL_bool retval = SDL_FALSE;
+
+    enterLock(a);
+    if (a->value == oldval) {
+        a->value = newval;
+        retval = SDL_TRUE;
+    }
+    leaveLock(a);
+
+    return retval;
+#else
+    #error Please define your platform.
+#endif
+}
+
+Sint64
+SDL_AtomicSet64(SDL_atomic64_t *a, Sint64 v)
+{
+#if defined(HAVE_MSC_ATOMICS64) && !defined(_M_IX86)
+    return _InterlockedExchange64((__int64*)&a->value, v);
+#elif defined(HAVE_GCC_ATOMICS64)
+    return __sync_lock_test_and_set(&a->value, v);
+#elif defined(HAVE_SOLARIS_ATOMICS64)
+    return (Sint64) atomic_swap_64((volatile uint64_t*)&a->value, (uint64_t)v);
+#else
+    Sint64 value;
+    do {
+        value = a->value;
+    } while (!SDL_AtomicCAS64(a, value, v));
+    return value;
+#endif
+}
+
+Sint64
+SDL_AtomicAdd64(SDL_atomic64_t *a, Sint64 v)
+{
+#if defined(HAVE_MSC_ATOMICS64) && !defined(_M_IX86)
+    return _InterlockedExchangeAdd64((__int64*)&a->value, v);
+#elif defined(HAVE_GCC_ATOMICS64)
+    return __sync_fetch_and_add(&a->value, v);
+#else
+    Sint64 value;
+    do {
+        value = a->value;
+    } while (!SDL_AtomicCAS64(a, value, (value + v)));
+    return value;
+#endif
+}
+
+Sint64
+SDL_AtomicGet64(SDL_atomic64_t *a)
+{
+#if defined(HAVE_ATOMIC_LOAD_N) && defined(HAVE_GCC_ATOMICS64)
+    return __atomic_load_n(&a->value, __ATOMIC_SEQ_CST);
+#else
+    /* A plain read may tear on 32-bit platforms, but the compare catches that */
+    Sint64 value;
+    do {
+        value = a->value;
+    } while (!SDL_AtomicCAS64(a, value, value));
+    return value;
+#endif
+}
+
 #ifdef SDL_MEMORY_BARRIER_USES_FUNCTION
 #error This file should be built in arm mode so the mcr instruction is available for memory barriers
 #endif
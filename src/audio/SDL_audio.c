@@ -709,6 +709,9 @@ SDL_RunAudio(void *devicep)
 
     /* Loop, filling the audio buffers */
     while (!SDL_AtomicGet(&device->shutdown)) {
+        Uint8 *devbuf = NULL;
+        SDL_bool direct = SDL_FALSE;
+
         current_audio.impl.BeginLoopIteration(device);
         data_len = device->callbackspec.size;
 
@@ -716,6 +719,24 @@ SDL_RunAudio(void *devicep)
         if (!device->stream && SDL_AtomicGet(&device->enabled)) {
             SDL_assert(data_len == device->spec.size);
             data = current_audio.impl.GetDeviceBuf(device);
+        } else if (device->stream && (device->callbackspec.samples == device->spec.samples) && SDL_AtomicGet(&device->enabled)) {
+            /* If the stream only has to convert (not resample or reblock),
+               let the callback write right into the buffer we convert in
+               place, instead of copying through the stream's queue. If the
+               conversion fits in the device's own buffer, use that and skip
+               the copy at the end, too. */
+            const int convertlen = SDL_AudioStreamDirectBufferSize(device->stream, data_len);
+            if (convertlen > 0) {
+                devbuf = current_audio.impl.GetDeviceBuf(device);
+                if (devbuf && (convertlen <= ((int) device->spec.size))) {
+                    data = devbuf;
+                } else {
+                    data = SDL_AudioStreamDirectBuffer(device->stream, data_len);
+                }
+                direct = data ? SDL_TRUE : SDL_FALSE;
+            } else {
+                data = NULL;
+            }
         } else {
             /* if the device isn't enabled, we still write to the
                work_buffer, so the app's callback will fire with
@@ -739,7 +760,24 @@ SDL_RunAudio(void *devicep)
         }
         SDL_UnlockMutex(device->mixer_lock);
 
-        if (device->stream) {
+        if (direct) {
+            /* Convert in place; this produces exactly one device buffer. */
+            const int got = SDL_AudioStreamConvertDirect(device->stream, data, data_len);
+            SDL_assert((got < 0) || (got == device->spec.size));
+
+            if (devbuf == NULL) {  /* device is having issues... */
+                const Uint32 delay = ((device->spec.samples * 1000) / device->spec.freq);
+                SDL_Delay(delay);  /* wait for as long as this buffer would have played. Maybe device recovers later? */
+            } else {
+                if (got != device->spec.size) {
+                    SDL_memset(devbuf, device->spec.silence, device->spec.size);
+                } else if (data != devbuf) {
+                    SDL_memcpy(devbuf, data, device->spec.size);
+                }
+                current_audio.impl.PlayDevice(device);
+                current_audio.impl.WaitDevice(device);
+            }
+        } else if (device->stream) {
             /* Stream available audio to device, converting/resampling. */
             /* if this fails...oh well. We'll play silence here. */
             SDL_AudioStreamPut(device->stream, data, data_len);
@@ -898,7 +936,7 @@ SDL_CaptureAudio(void *devicep)
 }
 
 
-static SDL_AudioFormat
+SDL_AudioFormat
 SDL_ParseAudioFormat(const char *string)
 {
 #define CHECK_FMT_STRING(x) if (SDL_strcmp(string, #x) == 0) return AUDIO_##x
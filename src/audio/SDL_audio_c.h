@@ -55,6 +55,9 @@ extern SDL_AudioFormat SDL_NextAudioFormat(void);
 extern Uint8 SDL_SilenceValueForFormat(const SDL_AudioFormat format);
 extern void SDL_CalculateAudioSpec(SDL_AudioSpec * spec);
 
+/* Parse a format name like "S16" or "F32LSB", or return 0 if it's not one */
+extern SDL_AudioFormat SDL_ParseAudioFormat(const char *string);
+
 /* Choose the audio filter functions below */
 extern void SDL_ChooseAudioConverters(void);
 
@@ -70,11 +73,31 @@ extern SDL_AudioFilter SDL_Convert_F32_to_S16;
 extern SDL_AudioFilter SDL_Convert_F32_to_U16;
 extern SDL_AudioFilter SDL_Convert_F32_to_S32;
 
+/* Same as above, but from/to the opposite byte order in a single pass.
+   These are NULL if the chosen implementation doesn't provide them. */
+extern SDL_AudioFilter SDL_Convert_Swapped_S16_to_F32;
+extern SDL_AudioFilter SDL_Convert_Swapped_U16_to_F32;
+extern SDL_AudioFilter SDL_Convert_Swapped_S32_to_F32;
+extern SDL_AudioFilter SDL_Convert_F32_to_Swapped_S16;
+extern SDL_AudioFilter SDL_Convert_F32_to_Swapped_U16;
+extern SDL_AudioFilter SDL_Convert_F32_to_Swapped_S32;
+
 /* You need to call SDL_PrepareResampleFilter() before using the internal resampler.
    SDL_AudioQuit() calls SDL_FreeResamplerFilter(), you should never call it yourself. */
 extern int SDL_PrepareResampleFilter(void);
 extern void SDL_FreeResampleFilter(void);
 
+/* Streams that don't resample can convert a buffer in place, in one pass,
+   instead of copying it in and out of the stream's queue. The device thread
+   uses this to have the app callback write straight into the buffer that
+   gets converted. SDL_AudioStreamDirectBufferSize() returns the bytes needed
+   to convert (len) bytes in place, or 0 if the stream can't do this right
+   now. SDL_AudioStreamDirectBuffer() returns a scratch buffer owned by the
+   stream that is at least that big. */
+extern int SDL_AudioStreamDirectBufferSize(SDL_AudioStream *stream, int len);
+extern Uint8 *SDL_AudioStreamDirectBuffer(SDL_AudioStream *stream, int len);
+extern int SDL_AudioStreamConvertDirect(SDL_AudioStream *stream, Uint8 *buf, int len);
+
 #endif /* SDL_audio_c_h_ */
 
 /* vi: set ts=4 sw=4 expandtab: */
@@ -615,25 +615,18 @@ static int
 SDL_BuildAudioTypeCVTToFloat(SDL_AudioCVT *cvt, const SDL_AudioFormat src_fmt)
 {
     int retval = 0;  /* 0 == no conversion necessary. */
-
-    if ((SDL_AUDIO_ISBIGENDIAN(src_fmt) != 0) == (SDL_BYTEORDER == SDL_LIL_ENDIAN)) {
-        if (SDL_AddAudioCVTFilter(cvt, SDL_Convert_Byteswap) < 0) {
-            return -1;
-        }
-        retval = 1;  /* added a converter. */
-    }
+    SDL_bool byteswap = ((SDL_AUDIO_ISBIGENDIAN(src_fmt) != 0) == (SDL_BYTEORDER == SDL_LIL_ENDIAN)) ? SDL_TRUE : SDL_FALSE;
+    SDL_AudioFilter filter = NULL;
 
     if (!SDL_AUDIO_ISFLOAT(src_fmt)) {
-        const Uint16 src_bitsize = SDL_AUDIO_BITSIZE(src_fmt);
-        const Uint16 dst_bitsize = 32;
-        SDL_AudioFilter filter = NULL;
+        SDL_AudioFilter swapped_filter = NULL;
 
         switch (src_fmt & ~SDL_AUDIO_MASK_ENDIAN) {
             case AUDIO_S8: filter = SDL_Convert_S8_to_F32; break;
             case AUDIO_U8: filter = SDL_Convert_U8_to_F32; break;
-            case AUDIO_S16: filter = SDL_Convert_S16_to_F32; break;
-            case AUDIO_U16: filter = SDL_Convert_U16_to_F32; break;
-            case AUDIO_S32: filter = SDL_Convert_S32_to_F32; break;
+            case AUDIO_S16: filter = SDL_Convert_S16_to_F32; swapped_filter = SDL_Convert_Swapped_S16_to_F32; break;
+            case AUDIO_U16: filter = SDL_Convert_U16_to_F32; swapped_filter = SDL_Convert_Swapped_U16_to_F32; break;
+            case AUDIO_S32: filter = SDL_Convert_S32_to_F32; swapped_filter = SDL_Convert_Swapped_S32_to_F32; break;
             default: SDL_assert(!"Unexpected audio format!"); break;
         }
 
@@ -641,6 +634,24 @@ SDL_BuildAudioTypeCVTToFloat(SDL_AudioCVT *cvt, const SDL_AudioFormat src_fmt)
             return SDL_SetError("No conversion from source format to float available");
         }
 
+        /* byteswap as part of the conversion, if we can. */
+        if (byteswap && swapped_filter) {
+            filter = swapped_filter;
+            byteswap = SDL_FALSE;
+        }
+    }
+
+    if (byteswap) {
+        if (SDL_AddAudioCVTFilter(cvt, SDL_Convert_Byteswap) < 0) {
+            return -1;
+        }
+        retval = 1;  /* added a converter. */
+    }
+
+    if (filter) {
+        const Uint16 src_bitsize = SDL_AUDIO_BITSIZE(src_fmt);
+        const Uint16 dst_bitsize = 32;
+
         if (SDL_AddAudioCVTFilter(cvt, filter) < 0) {
             return -1;
         }
@@ -662,17 +673,19 @@ static int
 SDL_BuildAudioTypeCVTFromFloat(SDL_AudioCVT *cvt, const SDL_AudioFormat dst_fmt)
 {
     int retval = 0;  /* 0 == no conversion necessary. */
+    SDL_bool byteswap = ((SDL_AUDIO_ISBIGENDIAN(dst_fmt) != 0) == (SDL_BYTEORDER == SDL_LIL_ENDIAN)) ? SDL_TRUE : SDL_FALSE;
 
     if (!SDL_AUDIO_ISFLOAT(dst_fmt)) {
         const Uint16 dst_bitsize = SDL_AUDIO_BITSIZE(dst_fmt);
         const Uint16 src_bitsize = 32;
         SDL_AudioFilter filter = NULL;
+        SDL_AudioFilter swapped_filter = NULL;
         switch (dst_fmt & ~SDL_AUDIO_MASK_ENDIAN) {
             case AUDIO_S8: filter = SDL_Convert_F32_to_S8; break;
             case AUDIO_U8: filter = SDL_Convert_F32_to_U8; break;
-            case AUDIO_S16: filter = SDL_Convert_F32_to_S16; break;
-            case AUDIO_U16: filter = SDL_Convert_F32_to_U16; break;
-            case AUDIO_S32: filter = SDL_Convert_F32_to_S32; break;
+            case AUDIO_S16: filter = SDL_Convert_F32_to_S16; swapped_filter = SDL_Convert_F32_to_Swapped_S16; break;
+            case AUDIO_U16: filter = SDL_Convert_F32_to_U16; swapped_filter = SDL_Convert_F32_to_Swapped_U16; break;
+            case AUDIO_S32: filter = SDL_Convert_F32_to_S32; swapped_filter = SDL_Convert_F32_to_Swapped_S32; break;
             default: SDL_assert(!"Unexpected audio format!"); break;
         }
 
@@ -680,6 +693,12 @@ SDL_BuildAudioTypeCVTFromFloat(SDL_AudioCVT *cvt, const SDL_AudioFormat dst_fmt)
             return SDL_SetError("No conversion from float to format 0x%.4x available", dst_fmt);
         }
 
+        /* byteswap as part of the conversion, if we can. */
+        if (byteswap && swapped_filter) {
+            filter = swapped_filter;
+            byteswap = SDL_FALSE;
+        }
+
         if (SDL_AddAudioCVTFilter(cvt, filter) < 0) {
             return -1;
         }
@@ -693,7 +712,7 @@ SDL_BuildAudioTypeCVTFromFloat(SDL_AudioCVT *cvt, const SDL_AudioFormat dst_fmt)
         retval = 1;  /* added a converter. */
     }
 
-    if ((SDL_AUDIO_ISBIGENDIAN(dst_fmt) != 0) == (SDL_BYTEORDER == SDL_LIL_ENDIAN)) {
+    if (byteswap) {
         if (SDL_AddAudioCVTFilter(cvt, SDL_Convert_Byteswap) < 0) {
             return -1;
         }
@@ -1620,6 +1639,52 @@ int SDL_AudioStreamFlush(SDL_AudioStream *stream)
     return 0;
 }
 
+int
+SDL_AudioStreamDirectBufferSize(SDL_AudioStream *stream, int len)
+{
+    /* can't skip the queue if resampling, or if there's still data queued up. */
+    if (!stream || (stream->src_rate != stream->dst_rate) || (SDL_CountDataQueue(stream->queue) > 0)) {
+        return 0;
+    }
+    return stream->cvt_after_resampling.needed ? (len * stream->cvt_after_resampling.len_mult) : len;
+}
+
+Uint8 *
+SDL_AudioStreamDirectBuffer(SDL_AudioStream *stream, int len)
+{
+    const int bufsize = SDL_AudioStreamDirectBufferSize(stream, len);
+    if (!bufsize) {
+        SDL_SetError("Audio stream can't convert directly");
+        return NULL;
+    }
+    return EnsureStreamBufferSize(stream, bufsize);
+}
+
+int
+SDL_AudioStreamConvertDirect(SDL_AudioStream *stream, Uint8 *buf, int len)
+{
+    if (!stream) {
+        return SDL_InvalidParamError("stream");
+    } else if (!buf) {
+        return SDL_InvalidParamError("buf");
+    } else if ((len % stream->src_sample_frame_size) != 0) {
+        return SDL_SetError("Can't add partial sample frames");
+    }
+
+    SDL_assert(stream->src_rate == stream->dst_rate);
+
+    if (!stream->cvt_after_resampling.needed || (len == 0)) {
+        return len;
+    }
+
+    stream->cvt_after_resampling.buf = buf;
+    stream->cvt_after_resampling.len = len;
+    if (SDL_ConvertAudio(&stream->cvt_after_resampling) == -1) {
+        return -1;   /* uhoh! */
+    }
+    return stream->cvt_after_resampling.len_cvt;
+}
+
 /* get converted/resampled data from the stream */
 int
 SDL_AudioStreamGet(SDL_AudioStream *stream, void *buf, int len)
@@ -33,6 +33,22 @@
 #define HAVE_SSE2_INTRINSICS 1
 #endif
 
+/* AVX2 converters are built with a per-function target attribute where the
+   compiler supports it, so they're available even if the rest of SDL isn't
+   compiled for AVX2, and are only chosen if SDL_HasAVX2() at runtime. */
+#if defined(__AVX2__)
+#define HAVE_AVX2_INTRINSICS 1
+#define SDL_TARGETING_AVX2
+#elif HAVE_SSE2_INTRINSICS && (defined(__x86_64__) || defined(__i386__)) && \
+      (defined(__clang__) || (defined(__GNUC__) && ((__GNUC__ > 4) || ((__GNUC__ == 4) && (__GNUC_MINOR__ >= 9)))))
+#define HAVE_AVX2_INTRINSICS 1
+#define SDL_TARGETING_AVX2 __attribute__((target("avx2")))
+#endif
+
+#if HAVE_AVX2_INTRINSICS
+#include <immintrin.h>
+#endif
+
 #if defined(__x86_64__) && HAVE_SSE2_INTRINSICS
 #define NEED_SCALAR_CONVERTER_FALLBACKS 0  /* x86_64 guarantees SSE2. */
 #elif __MACOSX__ && HAVE_SSE2_INTRINSICS
@@ -59,6 +75,12 @@ SDL_AudioFilter SDL_Convert_F32_to_U8 = NULL;
 SDL_AudioFilter SDL_Convert_F32_to_S16 = NULL;
 SDL_AudioFilter SDL_Convert_F32_to_U16 = NULL;
 SDL_AudioFilter SDL_Convert_F32_to_S32 = NULL;
+SDL_AudioFilter SDL_Convert_Swapped_S16_to_F32 = NULL;
+SDL_AudioFilter SDL_Convert_Swapped_U16_to_F32 = NULL;
+SDL_AudioFilter SDL_Convert_Swapped_S32_to_F32 = NULL;
+SDL_AudioFilter SDL_Convert_F32_to_Swapped_S16 = NULL;
+SDL_AudioFilter SDL_Convert_F32_to_Swapped_U16 = NULL;
+SDL_AudioFilter SDL_Convert_F32_to_Swapped_S32 = NULL;
 
 
 #define DIVBY128 0.0078125f
@@ -289,6 +311,147 @@ SDL_Convert_F32_to_S32_Scalar(SDL_AudioCVT *cvt, SDL_AudioFormat format)
         cvt->filters[cvt->filter_index](cvt, AUDIO_S32SYS);
     }
 }
+
+/* These do the byteswap from/to the non-native byte order in the same pass
+   as the type conversion, instead of a separate SDL_Convert_Byteswap pass. */
+static void SDLCALL
+SDL_Convert_Swapped_S16_to_F32_Scalar(SDL_AudioCVT *cvt, SDL_AudioFormat format)
+{
+    const Uint16 *src = ((const Uint16 *) (cvt->buf + cvt->len_cvt)) - 1;
+    float *dst = ((float *) (cvt->buf + cvt->len_cvt * 2)) - 1;
+    int i;
+
+    LOG_DEBUG_CONVERT("AUDIO_S16 (byteswapped)", "AUDIO_F32");
+
+    for (i = cvt->len_cvt / sizeof (Sint16); i; --i, --src, --dst) {
+        *dst = ((float) ((Sint16) SDL_Swap16(*src))) * DIVBY32768;
+    }
+
+    cvt->len_cvt *= 2;
+    if (cvt->filters[++cvt->filter_index]) {
+        cvt->filters[cvt->filter_index](cvt, AUDIO_F32SYS);
+    }
+}
+
+static void SDLCALL
+SDL_Convert_Swapped_U16_to_F32_Scalar(SDL_AudioCVT *cvt, SDL_AudioFormat format)
+{
+    const Uint16 *src = ((const Uint16 *) (cvt->buf + cvt->len_cvt)) - 1;
+    float *dst = ((float *) (cvt->buf + cvt->len_cvt * 2)) - 1;
+    int i;
+
+    LOG_DEBUG_CONVERT("AUDIO_U16 (byteswapped)", "AUDIO_F32");
+
+    for (i = cvt->len_cvt / sizeof (Uint16); i; --i, --src, --dst) {
+        *dst = (((float) SDL_Swap16(*src)) * DIVBY32768) - 1.0f;
+    }
+
+    cvt->len_cvt *= 2;
+    if (cvt->filters[++cvt->filter_index]) {
+        cvt->filters[cvt->filter_index](cvt, AUDIO_F32SYS);
+    }
+}
+
+static void SDLCALL
+SDL_Convert_Swapped_S32_to_F32_Scalar(SDL_AudioCVT *cvt, SDL_AudioFormat format)
+{
+    const Uint32 *src = (const Uint32 *) cvt->buf;
+    float *dst = (float *) cvt->buf;
+    int i;
+
+    LOG_DEBUG_CONVERT("AUDIO_S32 (byteswapped)", "AUDIO_F32");
+
+    for (i = cvt->len_cvt / sizeof (Sint32); i; --i, ++src, ++dst) {
+        *dst = ((float) (((Sint32) SDL_Swap32(*src)) >> 8)) * DIVBY8388607;
+    }
+
+    if (cvt->filters[++cvt->filter_index]) {
+        cvt->filters[cvt->filter_index](cvt, AUDIO_F32SYS);
+    }
+}
+
+static void SDLCALL
+SDL_Convert_F32_to_Swapped_S16_Scalar(SDL_AudioCVT *cvt, SDL_AudioFormat format)
+{
+    const float *src = (const float *) cvt->buf;
+    Uint16 *dst = (Uint16 *) cvt->buf;
+    int i;
+
+    LOG_DEBUG_CONVERT("AUDIO_F32", "AUDIO_S16 (byteswapped)");
+
+    for (i = cvt->len_cvt / sizeof (float); i; --i, ++src, ++dst) {
+        const float sample = *src;
+        Sint16 val;
+        if (sample >= 1.0f) {
+            val = 32767;
+        } else if (sample <= -1.0f) {
+            val = -32768;
+        } else {
+            val = (Sint16)(sample * 32767.0f);
+        }
+        *dst = SDL_Swap16((Uint16) val);
+    }
+
+    cvt->len_cvt /= 2;
+    if (cvt->filters[++cvt->filter_index]) {
+        cvt->filters[cvt->filter_index](cvt, AUDIO_S16SYS ^ SDL_AUDIO_MASK_ENDIAN);
+    }
+}
+
+static void SDLCALL
+SDL_Convert_F32_to_Swapped_U16_Scalar(SDL_AudioCVT *cvt, SDL_AudioFormat format)
+{
+    const float *src = (const float *) cvt->buf;
+    Uint16 *dst = (Uint16 *) cvt->buf;
+    int i;
+
+    LOG_DEBUG_CONVERT("AUDIO_F32", "AUDIO_U16 (byteswapped)");
+
+    for (i = cvt->len_cvt / sizeof (float); i; --i, ++src, ++dst) {
+        const float sample = *src;
+        Uint16 val;
+        if (sample >= 1.0f) {
+            val = 65535;
+        } else if (sample <= -1.0f) {
+            val = 0;
+        } else {
+            val = (Uint16)((sample + 1.0f) * 32767.0f);
+        }
+        *dst = SDL_Swap16(val);
+    }
+
+    cvt->len_cvt /= 2;
+    if (cvt->filters[++cvt->filter_index]) {
+        cvt->filters[cvt->filter_index](cvt, AUDIO_U16SYS ^ SDL_AUDIO_MASK_ENDIAN);
+    }
+}
+
+static void SDLCALL
+SDL_Convert_F32_to_Swapped_S32_Scalar(SDL_AudioCVT *cvt, SDL_AudioFormat format)
+{
+    const float *src = (const float *) cvt->buf;
+    Uint32 *dst = (Uint32 *) cvt->buf;
+    int i;
+
+    LOG_DEBUG_CONVERT("AUDIO_F32", "AUDIO_S32 (byteswapped)");
+
+    for (i = cvt->len_cvt / sizeof (float); i; --i, ++src, ++dst) {
+        const float sample = *src;
+        Sint32 val;
+        if (sample >= 1.0f) {
+            val = 2147483647;
+        } else if (sample <= -1.0f) {
+            val = (Sint32) -2147483648LL;
+        } else {
+            val = ((Sint32)(sample * 8388607.0f)) << 8;
+        }
+        *dst = SDL_Swap32((Uint32) val);
+    }
+
+    if (cvt->filters[++cvt->filter_index]) {
+        cvt->filters[cvt->filter_index](cvt, AUDIO_S32SYS ^ SDL_AUDIO_MASK_ENDIAN);
+    }
+}
 #endif
 
 
@@ -1382,6 +1545,408 @@ SDL_Convert_F32_to_S32_NEON(SDL_AudioCVT *cvt, SDL_AudioFormat format)
 #endif
 
 
+#if HAVE_AVX2_INTRINSICS
+/* AVX2 hardware doesn't penalize unaligned loads/stores on aligned data, so
+   these skip the alignment dance the SSE2 versions do and use unaligned
+   access throughout. The byteswapped variants share the same kernels, with
+   a pshufb to fix the byte order folded into the load or store. */
+
+SDL_FORCE_INLINE SDL_TARGETING_AVX2 __m128i
+SDL_Swap16_AVX2(const __m128i x)
+{
+    return _mm_shuffle_epi8(x, _mm_setr_epi8(1, 0, 3, 2, 5, 4, 7, 6, 9, 8, 11, 10, 13, 12, 15, 14));
+}
+
+SDL_FORCE_INLINE SDL_TARGETING_AVX2 __m256i
+SDL_Swap16x16_AVX2(const __m256i x)
+{
+    return _mm256_shuffle_epi8(x, _mm256_setr_epi8(1, 0, 3, 2, 5, 4, 7, 6, 9, 8, 11, 10, 13, 12, 15, 14,
+                                                   1, 0, 3, 2, 5, 4, 7, 6, 9, 8, 11, 10, 13, 12, 15, 14));
+}
+
+SDL_FORCE_INLINE SDL_TARGETING_AVX2 __m256i
+SDL_Swap32x8_AVX2(const __m256i x)
+{
+    return _mm256_shuffle_epi8(x, _mm256_setr_epi8(3, 2, 1, 0, 7, 6, 5, 4, 11, 10, 9, 8, 15, 14, 13, 12,
+                                                   3, 2, 1, 0, 7, 6, 5, 4, 11, 10, 9, 8, 15, 14, 13, 12));
+}
+
+/* load 8 floats, clamp to -1.0f..1.0f, scale, add a bias, convert to sint32. */
+SDL_FORCE_INLINE SDL_TARGETING_AVX2 __m256i
+SDL_ClampScaleF32_AVX2(const float *src, const __m256 mul, const __m256 bias)
+{
+    const __m256 clamped = _mm256_min_ps(_mm256_max_ps(_mm256_set1_ps(-1.0f), _mm256_loadu_ps(src)), _mm256_set1_ps(1.0f));
+    return _mm256_cvtps_epi32(_mm256_mul_ps(_mm256_add_ps(clamped, bias), mul));
+}
+
+SDL_FORCE_INLINE SDL_TARGETING_AVX2 void
+SDL_Convert_16_to_F32_AVX2(SDL_AudioCVT *cvt, const SDL_bool is_unsigned, const SDL_bool swap)
+{
+    const Uint16 *src = (const Uint16 *) cvt->buf;
+    float *dst = (float *) cvt->buf;
+    const __m256 divby32768 = _mm256_set1_ps(DIVBY32768);
+    const __m256 bias = _mm256_set1_ps(is_unsigned ? -1.0f : 0.0f);
+    int i = cvt->len_cvt / sizeof (Uint16);
+
+    /* Buffer is growing, so work from the end back to the start. Odd leftovers first. */
+    while (i & 7) {
+        Uint16 sample;
+        --i;
+        sample = swap ? SDL_Swap16(src[i]) : src[i];
+        dst[i] = is_unsigned ? ((((float) sample) * DIVBY32768) - 1.0f) : (((float) ((Sint16) sample)) * DIVBY32768);
+    }
+
+    while (i) {   /* 8 * 16-bit */
+        __m128i shorts;
+        __m256i ints;
+        i -= 8;
+        shorts = _mm_loadu_si128((const __m128i *) (src + i));
+        if (swap) {
+            shorts = SDL_Swap16_AVX2(shorts);
+        }
+        ints = is_unsigned ? _mm256_cvtepu16_epi32(shorts) : _mm256_cvtepi16_epi32(shorts);
+        _mm256_storeu_ps(dst + i, _mm256_add_ps(_mm256_mul_ps(_mm256_cvtepi32_ps(ints), divby32768), bias));
+    }
+
+    cvt->len_cvt *= 2;
+    if (cvt->filters[++cvt->filter_index]) {
+        cvt->filters[cvt->filter_index](cvt, AUDIO_F32SYS);
+    }
+}
+
+SDL_FORCE_INLINE SDL_TARGETING_AVX2 void
+SDL_Convert_S32_to_F32_AVX2_Impl(SDL_AudioCVT *cvt, const SDL_bool swap)
+{
+    const Sint32 *src = (const Sint32 *) cvt->buf;
+    float *dst = (float *) cvt->buf;
+    const __m256 divby8388607 = _mm256_set1_ps(DIVBY8388607);
+    const int total = cvt->len_cvt / sizeof (Sint32);
+    int i;
+
+    for (i = 0; i + 8 <= total; i += 8) {   /* 8 * sint32 */
+        __m256i ints = _mm256_loadu_si256((const __m256i *) (src + i));
+        if (swap) {
+            ints = SDL_Swap32x8_AVX2(ints);
+        }
+        /* shift out lowest bits so int fits in a float32. Small precision loss, but much faster. */
+        _mm256_storeu_ps(dst + i, _mm256_mul_ps(_mm256_cvtepi32_ps(_mm256_srai_epi32(ints, 8)), divby8388607));
+    }
+
+    for (; i < total; i++) {
+        const Sint32 sample = swap ? (Sint32) SDL_Swap32((Uint32) src[i]) : src[i];
+        dst[i] = ((float) (sample >> 8)) * DIVBY8388607;
+    }
+
+    if (cvt->filters[++cvt->filter_index]) {
+        cvt->filters[cvt->filter_index](cvt, AUDIO_F32SYS);
+    }
+}
+
+SDL_FORCE_INLINE SDL_TARGETING_AVX2 void
+SDL_Convert_F32_to_16_AVX2(SDL_AudioCVT *cvt, const SDL_bool is_unsigned, const SDL_bool swap)
+{
+    const float *src = (const float *) cvt->buf;
+    Uint16 *dst = (Uint16 *) cvt->buf;
+    const __m256 mulby32767 = _mm256_set1_ps(32767.0f);
+    const __m256 bias = _mm256_set1_ps(is_unsigned ? 1.0f : 0.0f);
+    const int total = cvt->len_cvt / sizeof (float);
+    SDL_AudioFormat dstfmt = is_unsigned ? AUDIO_U16SYS : AUDIO_S16SYS;
+    int i;
+
+    for (i = 0; i + 16 <= total; i += 16) {   /* 16 * float32 */
+        const __m256i ints1 = SDL_ClampScaleF32_AVX2(src + i, mulby32767, bias);
+        const __m256i ints2 = SDL_ClampScaleF32_AVX2(src + i + 8, mulby32767, bias);
+        /* packing works within 128-bit lanes, so put the 64-bit chunks back in order afterwards. */
+        __m256i shorts = is_unsigned ? _mm256_packus_epi32(ints1, ints2) : _mm256_packs_epi32(ints1, ints2);
+        shorts = _mm256_permute4x64_epi64(shorts, _MM_SHUFFLE(3, 1, 2, 0));
+        if (swap) {
+            shorts = SDL_Swap16x16_AVX2(shorts);
+        }
+        _mm256_storeu_si256((__m256i *) (dst + i), shorts);
+    }
+
+    for (; i < total; i++) {
+        const float sample = src[i];
+        Uint16 val;
+        if (is_unsigned) {
+            if (sample >= 1.0f) {
+                val = 65535;
+            } else if (sample <= -1.0f) {
+                val = 0;
+            } else {
+                val = (Uint16)((sample + 1.0f) * 32767.0f);
+            }
+        } else {
+            if (sample >= 1.0f) {
+                val = 32767;
+            } else if (sample <= -1.0f) {
+                val = (Uint16) -32768;
+            } else {
+                val = (Uint16) (Sint16)(sample * 32767.0f);
+            }
+        }
+        dst[i] = swap ? SDL_Swap16(val) : val;
+    }
+
+    if (swap) {
+        dstfmt ^= SDL_AUDIO_MASK_ENDIAN;
+    }
+
+    cvt->len_cvt /= 2;
+    if (cvt->filters[++cvt->filter_index]) {
+        cvt->filters[cvt->filter_index](cvt, dstfmt);
+    }
+}
+
+SDL_FORCE_INLINE SDL_TARGETING_AVX2 void
+SDL_Convert_F32_to_S32_AVX2_Impl(SDL_AudioCVT *cvt, const SDL_bool swap)
+{
+    const float *src = (const float *) cvt->buf;
+    Sint32 *dst = (Sint32 *) cvt->buf;
+    const __m256 mulby8388607 = _mm256_set1_ps(8388607.0f);
+    const __m256 zero = _mm256_setzero_ps();
+    const int total = cvt->len_cvt / sizeof (float);
+    int i;
+
+    for (i = 0; i + 8 <= total; i += 8) {   /* 8 * float32 */
+        __m256i ints = _mm256_slli_epi32(SDL_ClampScaleF32_AVX2(src + i, mulby8388607, zero), 8);
+        if (swap) {
+            ints = SDL_Swap32x8_AVX2(ints);
+        }
+        _mm256_storeu_si256((__m256i *) (dst + i), ints);
+    }
+
+    for (; i < total; i++) {
+        const float sample = src[i];
+        Sint32 val;
+        if (sample >= 1.0f) {
+            val = 2147483647;
+        } else if (sample <= -1.0f) {
+            val = (Sint32) -2147483648LL;
+        } else {
+            val = ((Sint32)(sample * 8388607.0f)) << 8;
+        }
+        dst[i] = swap ? (Sint32) SDL_Swap32((Uint32) val) : val;
+    }
+
+    if (cvt->filters[++cvt->filter_index]) {
+        cvt->filters[cvt->filter_index](cvt, swap ? (AUDIO_S32SYS ^ SDL_AUDIO_MASK_ENDIAN) : AUDIO_S32SYS);
+    }
+}
+
+static SDL_TARGETING_AVX2 void SDLCALL
+SDL_Convert_S8_to_F32_AVX2(SDL_AudioCVT *cvt, SDL_AudioFormat format)
+{
+    const Sint8 *src = (const Sint8 *) cvt->buf;
+    float *dst = (float *) cvt->buf;
+    const __m256 divby128 = _mm256_set1_ps(DIVBY128);
+    int i = cvt->len_cvt;
+
+    LOG_DEBUG_CONVERT("AUDIO_S8", "AUDIO_F32 (using AVX2)");
+
+    /* Buffer is growing, so work from the end back to the start. Odd leftovers first. */
+    while (i & 7) {
+        --i;
+        dst[i] = ((float) src[i]) * DIVBY128;
+    }
+
+    while (i) {   /* 8 * 8-bit */
+        i -= 8;
+        _mm256_storeu_ps(dst + i, _mm256_mul_ps(_mm256_cvtepi32_ps(_mm256_cvtepi8_epi32(_mm_loadl_epi64((const __m128i *) (src + i)))), divby128));
+    }
+
+    cvt->len_cvt *= 4;
+    if (cvt->filters[++cvt->filter_index]) {
+        cvt->filters[cvt->filter_index](cvt, AUDIO_F32SYS);
+    }
+}
+
+static SDL_TARGETING_AVX2 void SDLCALL
+SDL_Convert_U8_to_F32_AVX2(SDL_AudioCVT *cvt, SDL_AudioFormat format)
+{
+    const Uint8 *src = (const Uint8 *) cvt->buf;
+    float *dst = (float *) cvt->buf;
+    const __m256 divby128 = _mm256_set1_ps(DIVBY128);
+    const __m256 minus1 = _mm256_set1_ps(-1.0f);
+    int i = cvt->len_cvt;
+
+    LOG_DEBUG_CONVERT("AUDIO_U8", "AUDIO_F32 (using AVX2)");
+
+    /* Buffer is growing, so work from the end back to the start. Odd leftovers first. */
+    while (i & 7) {
+        --i;
+        dst[i] = (((float) src[i]) * DIVBY128) - 1.0f;
+    }
+
+    while (i) {   /* 8 * 8-bit */
+        i -= 8;
+        _mm256_storeu_ps(dst + i, _mm256_add_ps(_mm256_mul_ps(_mm256_cvtepi32_ps(_mm256_cvtepu8_epi32(_mm_loadl_epi64((const __m128i *) (src + i)))), divby128), minus1));
+    }
+
+    cvt->len_cvt *= 4;
+    if (cvt->filters[++cvt->filter_index]) {
+        cvt->filters[cvt->filter_index](cvt, AUDIO_F32SYS);
+    }
+}
+
+static SDL_TARGETING_AVX2 void SDLCALL
+SDL_Convert_S16_to_F32_AVX2(SDL_AudioCVT *cvt, SDL_AudioFormat format)
+{
+    LOG_DEBUG_CONVERT("AUDIO_S16", "AUDIO_F32 (using AVX2)");
+    SDL_Convert_16_to_F32_AVX2(cvt, SDL_FALSE, SDL_FALSE);
+}
+
+static SDL_TARGETING_AVX2 void SDLCALL
+SDL_Convert_U16_to_F32_AVX2(SDL_AudioCVT *cvt, SDL_AudioFormat format)
+{
+    LOG_DEBUG_CONVERT("AUDIO_U16", "AUDIO_F32 (using AVX2)");
+    SDL_Convert_16_to_F32_AVX2(cvt, SDL_TRUE, SDL_FALSE);
+}
+
+static SDL_TARGETING_AVX2 void SDLCALL
+SDL_Convert_S32_to_F32_AVX2(SDL_AudioCVT *cvt, SDL_AudioFormat format)
+{
+    LOG_DEBUG_CONVERT("AUDIO_S32", "AUDIO_F32 (using AVX2)");
+    SDL_Convert_S32_to_F32_AVX2_Impl(cvt, SDL_FALSE);
+}
+
+static SDL_TARGETING_AVX2 void SDLCALL
+SDL_Convert_Swapped_S16_to_F32_AVX2(SDL_AudioCVT *cvt, SDL_AudioFormat format)
+{
+    LOG_DEBUG_CONVERT("AUDIO_S16 (byteswapped)", "AUDIO_F32 (using AVX2)");
+    SDL_Convert_16_to_F32_AVX2(cvt, SDL_FALSE, SDL_TRUE);
+}
+
+static SDL_TARGETING_AVX2 void SDLCALL
+SDL_Convert_Swapped_U16_to_F32_AVX2(SDL_AudioCVT *cvt, SDL_AudioFormat format)
+{
+    LOG_DEBUG_CONVERT("AUDIO_U16 (byteswapped)", "AUDIO_F32 (using AVX2)");
+    SDL_Convert_16_to_F32_AVX2(cvt, SDL_TRUE, SDL_TRUE);
+}
+
+static SDL_TARGETING_AVX2 void SDLCALL
+SDL_Convert_Swapped_S32_to_F32_AVX2(SDL_AudioCVT *cvt, SDL_AudioFormat format)
+{
+    LOG_DEBUG_CONVERT("AUDIO_S32 (byteswapped)", "AUDIO_F32 (using AVX2)");
+    SDL_Convert_S32_to_F32_AVX2_Impl(cvt, SDL_TRUE);
+}
+
+static SDL_TARGETING_AVX2 void SDLCALL
+SDL_Convert_F32_to_S8_AVX2(SDL_AudioCVT *cvt, SDL_AudioFormat format)
+{
+    const float *src = (const float *) cvt->buf;
+    Sint8 *dst = (Sint8 *) cvt->buf;
+    const __m256 mulby127 = _mm256_set1_ps(127.0f);
+    const __m256 zero = _mm256_setzero_ps();
+    const int total = cvt->len_cvt / sizeof (float);
+    int i;
+
+    LOG_DEBUG_CONVERT("AUDIO_F32", "AUDIO_S8 (using AVX2)");
+
+    for (i = 0; i + 16 <= total; i += 16) {   /* 16 * float32 */
+        const __m256i ints1 = SDL_ClampScaleF32_AVX2(src + i, mulby127, zero);
+        const __m256i ints2 = SDL_ClampScaleF32_AVX2(src + i + 8, mulby127, zero);
+        const __m256i shorts = _mm256_permute4x64_epi64(_mm256_packs_epi32(ints1, ints2), _MM_SHUFFLE(3, 1, 2, 0));
+        _mm_storeu_si128((__m128i *) (dst + i), _mm_packs_epi16(_mm256_castsi256_si128(shorts), _mm256_extracti128_si256(shorts, 1)));
+    }
+
+    for (; i < total; i++) {
+        const float sample = src[i];
+        if (sample >= 1.0f) {
+            dst[i] = 127;
+        } else if (sample <= -1.0f) {
+            dst[i] = -128;
+        } else {
+            dst[i] = (Sint8)(sample * 127.0f);
+        }
+    }
+
+    cvt->len_cvt /= 4;
+    if (cvt->filters[++cvt->filter_index]) {
+        cvt->filters[cvt->filter_index](cvt, AUDIO_S8);
+    }
+}
+
+static SDL_TARGETING_AVX2 void SDLCALL
+SDL_Convert_F32_to_U8_AVX2(SDL_AudioCVT *cvt, SDL_AudioFormat format)
+{
+    const float *src = (const float *) cvt->buf;
+    Uint8 *dst = (Uint8 *) cvt->buf;
+    const __m256 mulby127 = _mm256_set1_ps(127.0f);
+    const __m256 one = _mm256_set1_ps(1.0f);
+    const int total = cvt->len_cvt / sizeof (float);
+    int i;
+
+    LOG_DEBUG_CONVERT("AUDIO_F32", "AUDIO_U8 (using AVX2)");
+
+    for (i = 0; i + 16 <= total; i += 16) {   /* 16 * float32 */
+        const __m256i ints1 = SDL_ClampScaleF32_AVX2(src + i, mulby127, one);
+        const __m256i ints2 = SDL_ClampScaleF32_AVX2(src + i + 8, mulby127, one);
+        const __m256i shorts = _mm256_permute4x64_epi64(_mm256_packs_epi32(ints1, ints2), _MM_SHUFFLE(3, 1, 2, 0));
+        _mm_storeu_si128((__m128i *) (dst + i), _mm_packus_epi16(_mm256_castsi256_si128(shorts), _mm256_extracti128_si256(shorts, 1)));
+    }
+
+    for (; i < total; i++) {
+        const float sample = src[i];
+        if (sample >= 1.0f) {
+            dst[i] = 255;
+        } else if (sample <= -1.0f) {
+            dst[i] = 0;
+        } else {
+            dst[i] = (Uint8)((sample + 1.0f) * 127.0f);
+        }
+    }
+
+    cvt->len_cvt /= 4;
+    if (cvt->filters[++cvt->filter_index]) {
+        cvt->filters[cvt->filter_index](cvt, AUDIO_U8);
+    }
+}
+
+static SDL_TARGETING_AVX2 void SDLCALL
+SDL_Convert_F32_to_S16_AVX2(SDL_AudioCVT *cvt, SDL_AudioFormat format)
+{
+    LOG_DEBUG_CONVERT("AUDIO_F32", "AUDIO_S16 (using AVX2)");
+    SDL_Convert_F32_to_16_AVX2(cvt, SDL_FALSE, SDL_FALSE);
+}
+
+static SDL_TARGETING_AVX2 void SDLCALL
+SDL_Convert_F32_to_U16_AVX2(SDL_AudioCVT *cvt, SDL_AudioFormat format)
+{
+    LOG_DEBUG_CONVERT("AUDIO_F32", "AUDIO_U16 (using AVX2)");
+    SDL_Convert_F32_to_16_AVX2(cvt, SDL_TRUE, SDL_FALSE);
+}
+
+static SDL_TARGETING_AVX2 void SDLCALL
+SDL_Convert_F32_to_S32_AVX2(SDL_AudioCVT *cvt, SDL_AudioFormat format)
+{
+    LOG_DEBUG_CONVERT("AUDIO_F32", "AUDIO_S32 (using AVX2)");
+    SDL_Convert_F32_to_S32_AVX2_Impl(cvt, SDL_FALSE);
+}
+
+static SDL_TARGETING_AVX2 void SDLCALL
+SDL_Convert_F32_to_Swapped_S16_AVX2(SDL_AudioCVT *cvt, SDL_AudioFormat format)
+{
+    LOG_DEBUG_CONVERT("AUDIO_F32", "AUDIO_S16 (byteswapped, using AVX2)");
+    SDL_Convert_F32_to_16_AVX2(cvt, SDL_FALSE, SDL_TRUE);
+}
+
+static SDL_TARGETING_AVX2 void SDLCALL
+SDL_Convert_F32_to_Swapped_U16_AVX2(SDL_AudioCVT *cvt, SDL_AudioFormat format)
+{
+    LOG_DEBUG_CONVERT("AUDIO_F32", "AUDIO_U16 (byteswapped, using AVX2)");
+    SDL_Convert_F32_to_16_AVX2(cvt, SDL_TRUE, SDL_TRUE);
+}
+
+static SDL_TARGETING_AVX2 void SDLCALL
+SDL_Convert_F32_to_Swapped_S32_AVX2(SDL_AudioCVT *cvt, SDL_AudioFormat format)
+{
+    LOG_DEBUG_CONVERT("AUDIO_F32", "AUDIO_S32 (byteswapped, using AVX2)");
+    SDL_Convert_F32_to_S32_AVX2_Impl(cvt, SDL_TRUE);
+}
+#endif
+
+
 
 void SDL_ChooseAudioConverters(void)
 {
@@ -1404,6 +1969,25 @@ void SDL_ChooseAudioConverters(void)
         SDL_Convert_F32_to_S32 = SDL_Convert_F32_to_S32_##fntype; \
         converters_chosen = SDL_TRUE
 
+    /* Implementations that can fold the byteswap for non-native byte order
+       into the conversion set these too; otherwise they stay NULL and
+       SDL_BuildAudioCVT adds a separate byteswap pass. */
+#define SET_SWAPPED_CONVERTER_FUNCS(fntype) \
+        SDL_Convert_Swapped_S16_to_F32 = SDL_Convert_Swapped_S16_to_F32_##fntype; \
+        SDL_Convert_Swapped_U16_to_F32 = SDL_Convert_Swapped_U16_to_F32_##fntype; \
+        SDL_Convert_Swapped_S32_to_F32 = SDL_Convert_Swapped_S32_to_F32_##fntype; \
+        SDL_Convert_F32_to_Swapped_S16 = SDL_Convert_F32_to_Swapped_S16_##fntype; \
+        SDL_Convert_F32_to_Swapped_U16 = SDL_Convert_F32_to_Swapped_U16_##fntype; \
+        SDL_Convert_F32_to_Swapped_S32 = SDL_Convert_F32_to_Swapped_S32_##fntype
+
+#if HAVE_AVX2_INTRINSICS
+    if (SDL_HasAVX2()) {
+        SET_CONVERTER_FUNCS(AVX2);
+        SET_SWAPPED_CONVERTER_FUNCS(AVX2);
+        return;
+    }
+#endif
+
 #if HAVE_SSE2_INTRINSICS
     if (SDL_HasSSE2()) {
         SET_CONVERTER_FUNCS(SSE2);
@@ -1420,9 +2004,11 @@ void SDL_ChooseAudioConverters(void)
 
 #if NEED_SCALAR_CONVERTER_FALLBACKS
     SET_CONVERTER_FUNCS(Scalar);
+    SET_SWAPPED_CONVERTER_FUNCS(Scalar);
 #endif
 
 #undef SET_CONVERTER_FUNCS
+#undef SET_SWAPPED_CONVERTER_FUNCS
 
     SDL_assert(converters_chosen == SDL_TRUE);
 }
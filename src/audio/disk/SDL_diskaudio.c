@@ -42,6 +42,8 @@
 #define DISKENVR_INFILE         "SDL_DISKAUDIOFILEIN"
 #define DISKDEFAULT_INFILE      "sdlaudio-in.raw"
 #define DISKENVR_IODELAY      "SDL_DISKAUDIODELAY"
+#define DISKENVR_FORMAT       "SDL_DISKAUDIOFORMAT"
+#define DISKENVR_CHANNELS     "SDL_DISKAUDIOCHANNELS"
 
 /* This function waits until it is possible to write a full sound buffer */
 static void
@@ -131,7 +133,9 @@ DISKAUDIO_OpenDevice(_THIS, void *handle, const char *devname, int iscapture)
 {
     /* handle != NULL means "user specified the placeholder name on the fake detected device list" */
     const char *fname = get_filename(iscapture, handle ? NULL : devname);
-    const char *envr = SDL_getenv(DISKENVR_IODELAY);
+    const char *envr;
+    SDL_AudioFormat format;
+    int channels;
 
     this->hidden = (struct SDL_PrivateAudioData *)
         SDL_malloc(sizeof(*this->hidden));
@@ -140,6 +144,21 @@ DISKAUDIO_OpenDevice(_THIS, void *handle, const char *devname, int iscapture)
     }
     SDL_zerop(this->hidden);
 
+    /* Pretend the device wants a different format, so SDL converts to it */
+    envr = SDL_getenv(DISKENVR_FORMAT);
+    format = envr ? SDL_ParseAudioFormat(envr) : 0;
+    if (format != 0) {
+        this->spec.format = format;
+    }
+    envr = SDL_getenv(DISKENVR_CHANNELS);
+    channels = envr ? SDL_atoi(envr) : 0;
+    if (channels > 0) {
+        /* SDL can't convert to more than 8 channels */
+        this->spec.channels = (Uint8) SDL_min(channels, 8);
+    }
+    SDL_CalculateAudioSpec(&this->spec);
+
+    envr = SDL_getenv(DISKENVR_IODELAY);
     if (envr != NULL) {
         this->hidden->io_delay = SDL_atoi(envr);
     } else {
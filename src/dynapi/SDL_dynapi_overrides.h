@@ -746,3 +746,55 @@
 #define SDL_OnApplicationWillEnterForeground SDL_OnApplicationWillEnterForeground_REAL
 #define SDL_OnApplicationDidBecomeActive SDL_OnApplicationDidBecomeActive_REAL
 #define SDL_OnApplicationDidChangeStatusBarOrientation SDL_OnApplicationDidChangeStatusBarOrientation_REAL
+#define SDL_AddTimerMicroseconds SDL_AddTimerMicroseconds_REAL
+#define SDL_DelayNS SDL_DelayNS_REAL
+#define SDL_DelayPrecise SDL_DelayPrecise_REAL
+#define SDL_DelayUntil SDL_DelayUntil_REAL
+#define SDL_RefreshHintEnvironment SDL_RefreshHintEnvironment_REAL
+#define SDL_CreateJobPool SDL_CreateJobPool_REAL
+#define SDL_GetJobPoolThreadCount SDL_GetJobPoolThreadCount_REAL
+#define SDL_DestroyJobPool SDL_DestroyJobPool_REAL
+#define SDL_CreateJobGroup SDL_CreateJobGroup_REAL
+#define SDL_DestroyJobGroup SDL_DestroyJobGroup_REAL
+#define SDL_SubmitJob SDL_SubmitJob_REAL
+#define SDL_SubmitJobAfter SDL_SubmitJobAfter_REAL
+#define SDL_WaitJobGroup SDL_WaitJobGroup_REAL
+#define SDL_ParallelFor SDL_ParallelFor_REAL
+#define SDL_AtomicCAS64 SDL_AtomicCAS64_REAL
+#define SDL_AtomicSet64 SDL_AtomicSet64_REAL
+#define SDL_AtomicGet64 SDL_AtomicGet64_REAL
+#define SDL_AtomicAdd64 SDL_AtomicAdd64_REAL
+#define SDL_CreateRWLock SDL_CreateRWLock_REAL
+#define SDL_LockRWLockForReading SDL_LockRWLockForReading_REAL
+#define SDL_LockRWLockForWriting SDL_LockRWLockForWriting_REAL
+#define SDL_TryLockRWLockForReading SDL_TryLockRWLockForReading_REAL
+#define SDL_TryLockRWLockForWriting SDL_TryLockRWLockForWriting_REAL
+#define SDL_UnlockRWLock SDL_UnlockRWLock_REAL
+#define SDL_DestroyRWLock SDL_DestroyRWLock_REAL
+#define SDL_RWFromFileMapped SDL_RWFromFileMapped_REAL
+#define SDL_RWGetMemory SDL_RWGetMemory_REAL
+#define SDL_CreateAsyncIOQueue SDL_CreateAsyncIOQueue_REAL
+#define SDL_ReadAsyncIO SDL_ReadAsyncIO_REAL
+#define SDL_LoadFileAsyncIO SDL_LoadFileAsyncIO_REAL
+#define SDL_GetAsyncIOResult SDL_GetAsyncIOResult_REAL
+#define SDL_WaitAsyncIOResult SDL_WaitAsyncIOResult_REAL
+#define SDL_DestroyAsyncIOQueue SDL_DestroyAsyncIOQueue_REAL
+#define SDL_RWFromRWBuffered SDL_RWFromRWBuffered_REAL
+#define SDL_RenderCopyBatch SDL_RenderCopyBatch_REAL
+#define SDL_RenderGetStats SDL_RenderGetStats_REAL
+#define SDL_CreateTextureAtlas SDL_CreateTextureAtlas_REAL
+#define SDL_AddAtlasImage SDL_AddAtlasImage_REAL
+#define SDL_UpdateAtlasImage SDL_UpdateAtlasImage_REAL
+#define SDL_RemoveAtlasImage SDL_RemoveAtlasImage_REAL
+#define SDL_QueryAtlasImage SDL_QueryAtlasImage_REAL
+#define SDL_RenderCopyAtlasImage SDL_RenderCopyAtlasImage_REAL
+#define SDL_DefragmentTextureAtlas SDL_DefragmentTextureAtlas_REAL
+#define SDL_DestroyTextureAtlas SDL_DestroyTextureAtlas_REAL
+#define SDL_CreateSurfaceTexture SDL_CreateSurfaceTexture_REAL
+#define SDL_UpdateSurfaceTexture SDL_UpdateSurfaceTexture_REAL
+#define SDL_CreateRenderReadback SDL_CreateRenderReadback_REAL
+#define SDL_RenderReadPixelsAsync SDL_RenderReadPixelsAsync_REAL
+#define SDL_GetRenderReadback SDL_GetRenderReadback_REAL
+#define SDL_ReleaseRenderReadback SDL_ReleaseRenderReadback_REAL
+#define SDL_DestroyRenderReadback SDL_DestroyRenderReadback_REAL
+#define SDL_RenderGeometry SDL_RenderGeometry_REAL
@@ -804,3 +804,55 @@ SDL_DYNAPI_PROC(void,SDL_OnApplicationDidBecomeActive,(void),(),)
 #ifdef __IPHONEOS__
 SDL_DYNAPI_PROC(void,SDL_OnApplicationDidChangeStatusBarOrientation,(void),(),)
 #endif
+SDL_DYNAPI_PROC(SDL_TimerID,SDL_AddTimerMicroseconds,(Uint32 a, SDL_TimerCallback b, void *c),(a,b,c),return)
+SDL_DYNAPI_PROC(void,SDL_DelayNS,(Uint64 a),(a),)
+SDL_DYNAPI_PROC(void,SDL_DelayPrecise,(Uint64 a),(a),)
+SDL_DYNAPI_PROC(void,SDL_DelayUntil,(Uint64 a),(a),)
+SDL_DYNAPI_PROC(void,SDL_RefreshHintEnvironment,(void),(),)
+SDL_DYNAPI_PROC(SDL_JobPool*,SDL_CreateJobPool,(int a),(a),return)
+SDL_DYNAPI_PROC(int,SDL_GetJobPoolThreadCount,(SDL_JobPool *a),(a),return)
+SDL_DYNAPI_PROC(void,SDL_DestroyJobPool,(SDL_JobPool *a),(a),)
+SDL_DYNAPI_PROC(SDL_JobGroup*,SDL_CreateJobGroup,(void),(),return)
+SDL_DYNAPI_PROC(void,SDL_DestroyJobGroup,(SDL_JobGroup *a),(a),)
+SDL_DYNAPI_PROC(int,SDL_SubmitJob,(SDL_JobPool *a, SDL_JobFunction b, void *c, SDL_JobGroup *d),(a,b,c,d),return)
+SDL_DYNAPI_PROC(int,SDL_SubmitJobAfter,(SDL_JobPool *a, SDL_JobGroup *b, SDL_JobFunction c, void *d, SDL_JobGroup *e),(a,b,c,d,e),return)
+SDL_DYNAPI_PROC(void,SDL_WaitJobGroup,(SDL_JobPool *a, SDL_JobGroup *b),(a,b),)
+SDL_DYNAPI_PROC(int,SDL_ParallelFor,(SDL_JobPool *a, int b, int c, int d, SDL_ParallelForFunction e, void *f),(a,b,c,d,e,f),return)
+SDL_DYNAPI_PROC(SDL_bool,SDL_AtomicCAS64,(SDL_atomic64_t *a, Sint64 b, Sint64 c),(a,b,c),return)
+SDL_DYNAPI_PROC(Sint64,SDL_AtomicSet64,(SDL_atomic64_t *a, Sint64 b),(a,b),return)
+SDL_DYNAPI_PROC(Sint64,SDL_AtomicGet64,(SDL_atomic64_t *a),(a),return)
+SDL_DYNAPI_PROC(Sint64,SDL_AtomicAdd64,(SDL_atomic64_t *a, Sint64 b),(a,b),return)
+SDL_DYNAPI_PROC(SDL_rwlock*,SDL_CreateRWLock,(void),(),return)
+SDL_DYNAPI_PROC(int,SDL_LockRWLockForReading,(SDL_rwlock *a),(a),return)
+SDL_DYNAPI_PROC(int,SDL_LockRWLockForWriting,(SDL_rwlock *a),(a),return)
+SDL_DYNAPI_PROC(int,SDL_TryLockRWLockForReading,(SDL_rwlock *a),(a),return)
+SDL_DYNAPI_PROC(int,SDL_TryLockRWLockForWriting,(SDL_rwlock *a),(a),return)
+SDL_DYNAPI_PROC(int,SDL_UnlockRWLock,(SDL_rwlock *a),(a),return)
+SDL_DYNAPI_PROC(void,SDL_DestroyRWLock,(SDL_rwlock *a),(a),)
+SDL_DYNAPI_PROC(SDL_RWops*,SDL_RWFromFileMapped,(const char *a),(a),return)
+SDL_DYNAPI_PROC(const void*,SDL_RWGetMemory,(SDL_RWops *a, size_t *b),(a,b),return)
+SDL_DYNAPI_PROC(SDL_AsyncIOQueue*,SDL_CreateAsyncIOQueue,(int a),(a),return)
+SDL_DYNAPI_PROC(int,SDL_ReadAsyncIO,(SDL_AsyncIOQueue *a, SDL_RWops *b, Sint64 c, void *d, size_t e, void *f),(a,b,c,d,e,f),return)
+SDL_DYNAPI_PROC(int,SDL_LoadFileAsyncIO,(SDL_AsyncIOQueue *a, const char *b, void *c),(a,b,c),return)
+SDL_DYNAPI_PROC(SDL_bool,SDL_GetAsyncIOResult,(SDL_AsyncIOQueue *a, SDL_AsyncIOOutcome *b),(a,b),return)
+SDL_DYNAPI_PROC(SDL_bool,SDL_WaitAsyncIOResult,(SDL_AsyncIOQueue *a, SDL_AsyncIOOutcome *b, Sint32 c),(a,b,c),return)
+SDL_DYNAPI_PROC(void,SDL_DestroyAsyncIOQueue,(SDL_AsyncIOQueue *a),(a),)
+SDL_DYNAPI_PROC(SDL_RWops*,SDL_RWFromRWBuffered,(SDL_RWops *a, size_t b, SDL_bool c),(a,b,c),return)
+SDL_DYNAPI_PROC(int,SDL_RenderCopyBatch,(SDL_Renderer *a, SDL_Texture *b, const SDL_Rect *c, const SDL_FRect *d, const SDL_Color *e, const double *f, const SDL_RendererFlip *g, int h),(a,b,c,d,e,f,g,h),return)
+SDL_DYNAPI_PROC(int,SDL_RenderGetStats,(SDL_Renderer *a, SDL_RenderStats *b),(a,b),return)
+SDL_DYNAPI_PROC(SDL_TextureAtlas*,SDL_CreateTextureAtlas,(SDL_Renderer *a, Uint32 b, int c, int d, Uint32 e),(a,b,c,d,e),return)
+SDL_DYNAPI_PROC(SDL_AtlasID,SDL_AddAtlasImage,(SDL_TextureAtlas *a, int b, int c),(a,b,c),return)
+SDL_DYNAPI_PROC(int,SDL_UpdateAtlasImage,(SDL_TextureAtlas *a, SDL_AtlasID b, const void *c, int d),(a,b,c,d),return)
+SDL_DYNAPI_PROC(void,SDL_RemoveAtlasImage,(SDL_TextureAtlas *a, SDL_AtlasID b),(a,b),)
+SDL_DYNAPI_PROC(int,SDL_QueryAtlasImage,(SDL_TextureAtlas *a, SDL_AtlasID b, SDL_Texture **c, SDL_Rect *d),(a,b,c,d),return)
+SDL_DYNAPI_PROC(int,SDL_RenderCopyAtlasImage,(SDL_Renderer *a, SDL_TextureAtlas *b, SDL_AtlasID c, const SDL_FRect *d),(a,b,c,d),return)
+SDL_DYNAPI_PROC(int,SDL_DefragmentTextureAtlas,(SDL_TextureAtlas *a),(a),return)
+SDL_DYNAPI_PROC(void,SDL_DestroyTextureAtlas,(SDL_TextureAtlas *a),(a),)
+SDL_DYNAPI_PROC(SDL_Texture*,SDL_CreateSurfaceTexture,(SDL_Renderer *a, SDL_Surface *b),(a,b),return)
+SDL_DYNAPI_PROC(int,SDL_UpdateSurfaceTexture,(SDL_Texture *a, const SDL_Rect *b),(a,b),return)
+SDL_DYNAPI_PROC(SDL_RenderReadback*,SDL_CreateRenderReadback,(SDL_Renderer *a, Uint32 b, int c),(a,b,c),return)
+SDL_DYNAPI_PROC(int,SDL_RenderReadPixelsAsync,(SDL_RenderReadback *a, const SDL_Rect *b),(a,b),return)
+SDL_DYNAPI_PROC(int,SDL_GetRenderReadback,(SDL_RenderReadback *a, SDL_RenderReadbackFrame *b, Sint32 c),(a,b,c),return)
+SDL_DYNAPI_PROC(void,SDL_ReleaseRenderReadback,(SDL_RenderReadback *a, const SDL_RenderReadbackFrame *b),(a,b),)
+SDL_DYNAPI_PROC(void,SDL_DestroyRenderReadback,(SDL_RenderReadback *a),(a),)
+SDL_DYNAPI_PROC(int,SDL_RenderGeometry,(SDL_Renderer *a, SDL_Texture *b, const SDL_Vertex *c, int d, const int *e, int f),(a,b,c,d,e,f),return)
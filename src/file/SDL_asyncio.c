@@ -0,0 +1,458 @@
+/*
+  Simple DirectMedia Layer
+  Copyright (C) 1997-2020 Sam Lantinga <slouken@libsdl.org>
+
+  This software is provided 'as-is', without any express or implied
+  warranty.  In no event will the authors be held liable for any damages
+  arising from the use of this software.
+
+  Permission is granted to anyone to use this software for any purpose,
+  including commercial applications, and to alter it and redistribute it
+  freely, subject to the following restrictions:
+
+  1. The origin of this software must not be misrepresented; you must not
+     claim that you wrote the original software. If you use this software
+     in a product, an acknowledgment in the product documentation would be
+     appreciated but is not required.
+  2. Altered source versions must be plainly marked as such, and must not be
+     misrepresented as being the original software.
+  3. This notice may not be removed or altered from any source distribution.
+*/
+#include "../SDL_internal.h"
+
+/* Asynchronous file I/O, run by a pool of I/O threads */
+
+#include "SDL_asyncio.h"
+#include "SDL_cpuinfo.h"
+#include "SDL_mutex.h"
+#include "SDL_thread.h"
+#include "SDL_timer.h"
+
+#if defined(HAVE_STDIO_H) && (defined(__unix__) || defined(__APPLE__) || defined(__serenity__)) && \
+    !defined(__EMSCRIPTEN__) && !defined(__NACL__)
+#define HAVE_PREAD_ASYNCIO 1
+#include <errno.h>
+#include <stdio.h>
+#include <unistd.h>
+#endif
+
+/* The most I/O threads we'll pick by default */
+#define SDL_ASYNCIO_MAX_THREADS 16
+
+/* The longest error message we keep for a failed request */
+#define SDL_ASYNCIO_ERROR_LEN   128
+
+typedef struct SDL_AsyncIORequest
+{
+    SDL_AsyncIOOutcome outcome;
+    char *file;                 /* the file to load, for SDL_ASYNCIO_LOAD_FILE */
+    char error[SDL_ASYNCIO_ERROR_LEN];
+    struct SDL_AsyncIORequest *next;
+} SDL_AsyncIORequest;
+
+struct SDL_AsyncIOQueue
+{
+    SDL_mutex *lock;
+    SDL_cond *submitted;        /* signaled when requests are queued, or at shutdown */
+    SDL_cond *completed;        /* signaled when requests finish */
+    SDL_AsyncIORequest *pending;
+    SDL_AsyncIORequest *pending_tail;
+    SDL_AsyncIORequest *done;
+    SDL_AsyncIORequest *done_tail;
+    int outstanding;            /* requests submitted and not yet returned */
+    SDL_bool shutdown;
+
+    /* Serializes seeking and reading streams that can't read at an offset */
+    SDL_mutex *stream_lock;
+
+    int num_threads;
+    SDL_Thread **threads;
+};
+
+#ifdef HAVE_PREAD_ASYNCIO
+static SDL_bool
+SDL_ReadFileAt(FILE *fp, Sint64 offset, void *ptr, size_t size, size_t *transferred)
+{
+    const int fd = fileno(fp);
+    size_t total = 0;
+
+    while (total < size) {
+        ssize_t amount = pread(fd, (Uint8 *)ptr + total, size - total, (off_t)(offset + total));
+        if (amount < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            *transferred = total;
+            SDL_SetError("Couldn't read file: %s", strerror(errno));
+            return SDL_FALSE;
+        }
+        if (amount == 0) {
+            break;
+        }
+        total += (size_t)amount;
+    }
+    *transferred = total;
+    return SDL_TRUE;
+}
+#endif /* HAVE_PREAD_ASYNCIO */
+
+static SDL_bool
+SDL_RunAsyncIORead(SDL_AsyncIOQueue *queue, SDL_AsyncIOOutcome *outcome)
+{
+    SDL_RWops *src = outcome->src;
+    const Uint8 *mem;
+    size_t memsize, total = 0;
+
+    /* Memory and memory-mapped streams can be read from any thread at once */
+    mem = (const Uint8 *)SDL_RWGetMemory(src, &memsize);
+    if (mem) {
+        if (outcome->offset < (Sint64)memsize) {
+            total = SDL_min(outcome->bytes_requested, memsize - (size_t)outcome->offset);
+            SDL_memcpy(outcome->buffer, mem + outcome->offset, total);
+        }
+        outcome->bytes_transferred = total;
+        return SDL_TRUE;
+    }
+
+#ifdef HAVE_PREAD_ASYNCIO
+    if (src->type == SDL_RWOPS_STDFILE) {
+        return SDL_ReadFileAt(src->hidden.stdio.fp, outcome->offset, outcome->buffer,
+                              outcome->bytes_requested, &outcome->bytes_transferred);
+    }
+#endif
+
+    /* Everything else has to seek, so only one request can use a stream at a time */
+    SDL_LockMutex(queue->stream_lock);
+    if (SDL_RWseek(src, outcome->offset, RW_SEEK_SET) < 0) {
+        SDL_UnlockMutex(queue->stream_lock);
+        return SDL_FALSE;
+    }
+    while (total < outcome->bytes_requested) {
+        size_t amount = SDL_RWread(src, (Uint8 *)outcome->buffer + total, 1, outcome->bytes_requested - total);
+        if (amount == 0) {
+            break;
+        }
+        total += amount;
+    }
+    SDL_UnlockMutex(queue->stream_lock);
+    outcome->bytes_transferred = total;
+    return SDL_TRUE;
+}
+
+static void
+SDL_RunAsyncIORequest(SDL_AsyncIOQueue *queue, SDL_AsyncIORequest *request)
+{
+    SDL_AsyncIOOutcome *outcome = &request->outcome;
+    SDL_bool succeeded = SDL_FALSE;
+
+    switch (outcome->type) {
+    case SDL_ASYNCIO_READ:
+        succeeded = SDL_RunAsyncIORead(queue, outcome);
+        break;
+    case SDL_ASYNCIO_LOAD_FILE:
+        outcome->buffer = SDL_LoadFile(request->file, &outcome->bytes_transferred);
+        outcome->bytes_requested = outcome->bytes_transferred;
+        succeeded = outcome->buffer ? SDL_TRUE : SDL_FALSE;
+        SDL_free(request->file);
+        request->file = NULL;
+        break;
+    }
+
+    if (succeeded) {
+        outcome->result = SDL_ASYNCIO_COMPLETE;
+    } else {
+        /* The error is set on this thread, so save it for the thread that gets the outcome */
+        outcome->result = SDL_ASYNCIO_FAILURE;
+        SDL_strlcpy(request->error, SDL_GetError(), sizeof (request->error));
+    }
+}
+
+/* This is called with the queue locked */
+static void
+SDL_CompleteAsyncIORequest(SDL_AsyncIOQueue *queue, SDL_AsyncIORequest *request)
+{
+    request->next = NULL;
+    if (queue->done_tail) {
+        queue->done_tail->next = request;
+    } else {
+        queue->done = request;
+    }
+    queue->done_tail = request;
+    SDL_CondBroadcast(queue->completed);
+}
+
+static int SDLCALL
+SDL_AsyncIOThread(void *data)
+{
+    SDL_AsyncIOQueue *queue = (SDL_AsyncIOQueue *)data;
+
+    SDL_LockMutex(queue->lock);
+    for (;;) {
+        SDL_AsyncIORequest *request;
+
+        while (!queue->pending && !queue->shutdown) {
+            SDL_CondWait(queue->submitted, queue->lock);
+        }
+
+        /* Finish everything that was submitted before shutting down */
+        request = queue->pending;
+        if (!request) {
+            break;
+        }
+        queue->pending = request->next;
+        if (!queue->pending) {
+            queue->pending_tail = NULL;
+        }
+
+        SDL_UnlockMutex(queue->lock);
+        SDL_RunAsyncIORequest(queue, request);
+        SDL_LockMutex(queue->lock);
+
+        SDL_CompleteAsyncIORequest(queue, request);
+    }
+    SDL_UnlockMutex(queue->lock);
+    return 0;
+}
+
+SDL_AsyncIOQueue *
+SDL_CreateAsyncIOQueue(int num_threads)
+{
+    SDL_AsyncIOQueue *queue;
+#if !SDL_THREADS_DISABLED
+    int i;
+#endif
+
+    if (num_threads < 0) {
+        SDL_InvalidParamError("num_threads");
+        return NULL;
+    }
+
+    queue = (SDL_AsyncIOQueue *) SDL_calloc(1, sizeof (*queue));
+    if (!queue) {
+        SDL_OutOfMemory();
+        return NULL;
+    }
+
+    queue->lock = SDL_CreateMutex();
+    queue->submitted = SDL_CreateCond();
+    queue->completed = SDL_CreateCond();
+    queue->stream_lock = SDL_CreateMutex();
+#if !SDL_THREADS_DISABLED
+    if (!queue->lock || !queue->submitted || !queue->completed || !queue->stream_lock) {
+        SDL_DestroyAsyncIOQueue(queue);
+        return NULL;
+    }
+
+    if (num_threads == 0) {
+        /* Most of the time is spent waiting on the disk, so have more threads than CPUs */
+        num_threads = SDL_min(SDL_max(SDL_GetCPUCount() * 2, 4), SDL_ASYNCIO_MAX_THREADS);
+    }
+
+    queue->threads = (SDL_Thread **) SDL_calloc(num_threads, sizeof (*queue->threads));
+    if (!queue->threads) {
+        SDL_OutOfMemory();
+        SDL_DestroyAsyncIOQueue(queue);
+        return NULL;
+    }
+    for (i = 0; i < num_threads; ++i) {
+        queue->threads[i] = SDL_CreateThread(SDL_AsyncIOThread, "SDLAsyncIO", queue);
+        if (!queue->threads[i]) {
+            SDL_DestroyAsyncIOQueue(queue);
+            return NULL;
+        }
+        ++queue->num_threads;
+    }
+#endif /* !SDL_THREADS_DISABLED */
+
+    return queue;
+}
+
+static int
+SDL_SubmitAsyncIORequest(SDL_AsyncIOQueue *queue, SDL_AsyncIORequest *request)
+{
+    request->next = NULL;
+
+    SDL_LockMutex(queue->lock);
+    ++queue->outstanding;
+    if (queue->num_threads == 0) {
+        /* There's nobody else to run it */
+        SDL_UnlockMutex(queue->lock);
+        SDL_RunAsyncIORequest(queue, request);
+        SDL_LockMutex(queue->lock);
+        SDL_CompleteAsyncIORequest(queue, request);
+    } else {
+        if (queue->pending_tail) {
+            queue->pending_tail->next = request;
+        } else {
+            queue->pending = request;
+        }
+        queue->pending_tail = request;
+        SDL_CondSignal(queue->submitted);
+    }
+    SDL_UnlockMutex(queue->lock);
+    return 0;
+}
+
+int
+SDL_ReadAsyncIO(SDL_AsyncIOQueue *queue, SDL_RWops *src,
+                Sint64 offset, void *ptr, size_t size, void *userdata)
+{
+    SDL_AsyncIORequest *request;
+
+    if (!queue) {
+        return SDL_InvalidParamError("queue");
+    }
+    if (!src) {
+        return SDL_InvalidParamError("src");
+    }
+    if (offset < 0) {
+        return SDL_InvalidParamError("offset");
+    }
+    if (!ptr && size > 0) {
+        return SDL_InvalidParamError("ptr");
+    }
+
+    request = (SDL_AsyncIORequest *) SDL_calloc(1, sizeof (*request));
+    if (!request) {
+        return SDL_OutOfMemory();
+    }
+    request->outcome.type = SDL_ASYNCIO_READ;
+    request->outcome.src = src;
+    request->outcome.buffer = ptr;
+    request->outcome.offset = offset;
+    request->outcome.bytes_requested = size;
+    request->outcome.userdata = userdata;
+    return SDL_SubmitAsyncIORequest(queue, request);
+}
+
+int
+SDL_LoadFileAsyncIO(SDL_AsyncIOQueue *queue, const char *file, void *userdata)
+{
+    SDL_AsyncIORequest *request;
+
+    if (!queue) {
+        return SDL_InvalidParamError("queue");
+    }
+    if (!file || !*file) {
+        return SDL_InvalidParamError("file");
+    }
+
+    request = (SDL_AsyncIORequest *) SDL_calloc(1, sizeof (*request));
+    if (!request) {
+        return SDL_OutOfMemory();
+    }
+    request->file = SDL_strdup(file);
+    if (!request->file) {
+        SDL_free(request);
+        return SDL_OutOfMemory();
+    }
+    request->outcome.type = SDL_ASYNCIO_LOAD_FILE;
+    request->outcome.userdata = userdata;
+    return SDL_SubmitAsyncIORequest(queue, request);
+}
+
+/* This is called with the queue locked and a finished request available */
+static void
+SDL_TakeAsyncIOResult(SDL_AsyncIOQueue *queue, SDL_AsyncIOOutcome *outcome)
+{
+    SDL_AsyncIORequest *request = queue->done;
+
+    queue->done = request->next;
+    if (!queue->done) {
+        queue->done_tail = NULL;
+    }
+    --queue->outstanding;
+
+    *outcome = request->outcome;
+    if (outcome->result == SDL_ASYNCIO_FAILURE) {
+        SDL_SetError("%s", request->error);
+    }
+    SDL_free(request);
+}
+
+SDL_bool
+SDL_GetAsyncIOResult(SDL_AsyncIOQueue *queue, SDL_AsyncIOOutcome *outcome)
+{
+    SDL_bool retval = SDL_FALSE;
+
+    if (!queue || !outcome) {
+        return SDL_FALSE;
+    }
+
+    SDL_LockMutex(queue->lock);
+    if (queue->done) {
+        SDL_TakeAsyncIOResult(queue, outcome);
+        retval = SDL_TRUE;
+    }
+    SDL_UnlockMutex(queue->lock);
+    return retval;
+}
+
+SDL_bool
+SDL_WaitAsyncIOResult(SDL_AsyncIOQueue *queue, SDL_AsyncIOOutcome *outcome, Sint32 timeout)
+{
+    const Uint32 start = SDL_GetTicks();
+    SDL_bool retval = SDL_FALSE;
+
+    if (!queue || !outcome) {
+        return SDL_FALSE;
+    }
+
+    SDL_LockMutex(queue->lock);
+    while (!queue->done && queue->outstanding > 0) {
+        if (timeout < 0) {
+            SDL_CondWait(queue->completed, queue->lock);
+        } else {
+            const Uint32 elapsed = SDL_GetTicks() - start;
+            if (elapsed >= (Uint32)timeout ||
+                SDL_CondWaitTimeout(queue->completed, queue->lock, (Uint32)timeout - elapsed) != 0) {
+                break;
+            }
+        }
+    }
+    if (queue->done) {
+        SDL_TakeAsyncIOResult(queue, outcome);
+        retval = SDL_TRUE;
+    }
+    SDL_UnlockMutex(queue->lock);
+    return retval;
+}
+
+void
+SDL_DestroyAsyncIOQueue(SDL_AsyncIOQueue *queue)
+{
+    int i;
+
+    if (!queue) {
+        return;
+    }
+
+    if (queue->threads) {
+        SDL_LockMutex(queue->lock);
+        queue->shutdown = SDL_TRUE;
+        SDL_CondBroadcast(queue->submitted);
+        SDL_UnlockMutex(queue->lock);
+
+        for (i = 0; i < queue->num_threads; ++i) {
+            SDL_WaitThread(queue->threads[i], NULL);
+        }
+        SDL_free(queue->threads);
+    }
+
+    while (queue->done) {
+        SDL_AsyncIORequest *request = queue->done;
+        queue->done = request->next;
+        if (request->outcome.type == SDL_ASYNCIO_LOAD_FILE) {
+            SDL_free(request->outcome.buffer);
+        }
+        SDL_free(request);
+    }
+
+    SDL_DestroyMutex(queue->stream_lock);
+    SDL_DestroyCond(queue->completed);
+    SDL_DestroyCond(queue->submitted);
+    SDL_DestroyMutex(queue->lock);
+    SDL_free(queue);
+}
+
+/* vi: set ts=4 sw=4 expandtab: */
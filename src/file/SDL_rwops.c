@@ -42,6 +42,10 @@
 #include <limits.h>
 #endif
 
+#ifndef SIZE_MAX
+#define SIZE_MAX ((size_t)-1)
+#endif
+
 /* This file provides a general interface for SDL to read and write
    data sources.  It can easily be extended to files, memory, etc.
 */
@@ -62,6 +66,14 @@
 #include "nacl_io/nacl_io.h"
 #endif
 
+#if (defined(__unix__) || defined(__serenity__)) && !defined(__EMSCRIPTEN__) && !defined(__NACL__)
+#define HAVE_MMAP_RWOPS 1
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
 #ifdef __WIN32__
 
 /* Functions to read/write Win32 API file pointers */
@@ -522,6 +534,293 @@ mem_close(SDL_RWops * context)
     return 0;
 }
 
+#ifdef HAVE_MMAP_RWOPS
+
+/* Functions to read memory-mapped files, which are otherwise memory streams */
+
+static int SDLCALL
+mmap_close(SDL_RWops * context)
+{
+    if (context) {
+        size_t size = (size_t)(context->hidden.mem.stop - context->hidden.mem.base);
+        if (size > 0) {
+            munmap(context->hidden.mem.base, size);
+        }
+        SDL_FreeRW(context);
+    }
+    return 0;
+}
+
+/* Returns NULL without setting an error if the file can't be mapped */
+static SDL_RWops *
+mmap_open(const char *file)
+{
+    static Uint8 empty;
+    SDL_RWops *rwops;
+    struct stat st;
+    void *base;
+    size_t size;
+    int fd;
+
+#ifdef O_CLOEXEC
+    fd = open(file, O_RDONLY | O_CLOEXEC);
+#else
+    fd = open(file, O_RDONLY);
+#endif
+    if (fd < 0) {
+        return NULL;
+    }
+    /* Leave devices, pipes, and files too big for the address space to stdio */
+    if (fstat(fd, &st) < 0 || !S_ISREG(st.st_mode) ||
+        (off_t)(size_t)st.st_size != st.st_size) {
+        close(fd);
+        return NULL;
+    }
+
+    size = (size_t)st.st_size;
+    if (size == 0) {
+        /* mmap() can't map an empty file, but there's nothing to read */
+        base = &empty;
+    } else {
+        base = mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (base == MAP_FAILED) {
+            close(fd);
+            return NULL;
+        }
+#ifdef MADV_SEQUENTIAL
+        madvise(base, size, MADV_SEQUENTIAL);
+#endif
+    }
+    /* The mapping keeps the file open */
+    close(fd);
+
+    rwops = SDL_AllocRW();
+    if (!rwops) {
+        if (size > 0) {
+            munmap(base, size);
+        }
+        return NULL;
+    }
+    rwops->size = mem_size;
+    rwops->seek = mem_seek;
+    rwops->read = mem_read;
+    rwops->write = mem_writeconst;
+    rwops->close = mmap_close;
+    rwops->hidden.mem.base = (Uint8 *) base;
+    rwops->hidden.mem.here = rwops->hidden.mem.base;
+    rwops->hidden.mem.stop = rwops->hidden.mem.base + size;
+    rwops->type = SDL_RWOPS_MAPPED;
+    return rwops;
+}
+#endif /* HAVE_MMAP_RWOPS */
+
+
+/* Functions to buffer reads and writes on another stream */
+
+#define SDL_RWBUFFER_DEFAULT_SIZE   (64 * 1024)
+
+typedef struct
+{
+    SDL_RWops *src;
+    SDL_bool autoclose;
+    Uint8 *buffer;
+    size_t size;
+    Sint64 position;    /* the offset in src of the start of the buffer */
+    SDL_bool writing;   /* whether the buffer holds data to write, or data read ahead */
+    Uint8 *here;        /* the next byte to read or write */
+    Uint8 *read_stop;   /* the end of the data read ahead, the buffer start while writing */
+} SDL_RWBuffer;
+
+static int
+buffered_flush(SDL_RWBuffer * b)
+{
+    size_t amount = (size_t)(b->here - b->buffer);
+    if (b->writing && amount > 0) {
+        if (SDL_RWwrite(b->src, b->buffer, 1, amount) != amount) {
+            return -1;
+        }
+        b->position += amount;
+        b->here = b->buffer;
+    }
+    return 0;
+}
+
+/* Drop whatever is buffered, with src at the given offset */
+static void
+buffered_reset(SDL_RWBuffer * b, Sint64 position, SDL_bool writing)
+{
+    b->position = position;
+    b->here = b->buffer;
+    b->read_stop = b->buffer;
+    b->writing = writing;
+}
+
+static Sint64 SDLCALL
+buffered_size(SDL_RWops * context)
+{
+    SDL_RWBuffer *b = (SDL_RWBuffer *) context->hidden.unknown.data1;
+
+    if (buffered_flush(b) < 0) {
+        return -1;
+    }
+    return SDL_RWsize(b->src);
+}
+
+static Sint64 SDLCALL
+buffered_seek(SDL_RWops * context, Sint64 offset, int whence)
+{
+    SDL_RWBuffer *b = (SDL_RWBuffer *) context->hidden.unknown.data1;
+    const Sint64 current = b->position + (b->here - b->buffer);
+    Sint64 target;
+
+    switch (whence) {
+    case RW_SEEK_SET:
+        target = offset;
+        break;
+    case RW_SEEK_CUR:
+        target = current + offset;
+        break;
+    case RW_SEEK_END:
+        if (buffered_flush(b) < 0) {
+            return -1;
+        }
+        target = SDL_RWseek(b->src, offset, RW_SEEK_END);
+        if (target < 0) {
+            return -1;
+        }
+        buffered_reset(b, target, SDL_FALSE);
+        return target;
+    default:
+        return SDL_SetError("Unknown value for 'whence'");
+    }
+
+    if (b->writing) {
+        if (target == current) {
+            return current;
+        }
+        if (buffered_flush(b) < 0) {
+            return -1;
+        }
+    } else if (target >= b->position && target <= b->position + (b->read_stop - b->buffer)) {
+        /* We already have the data, no need to touch the stream */
+        b->here = b->buffer + (size_t)(target - b->position);
+        return target;
+    }
+
+    target = SDL_RWseek(b->src, target, RW_SEEK_SET);
+    if (target < 0) {
+        return -1;
+    }
+    buffered_reset(b, target, SDL_FALSE);
+    return target;
+}
+
+static size_t SDLCALL
+buffered_read(SDL_RWops * context, void *ptr, size_t size, size_t maxnum)
+{
+    SDL_RWBuffer *b = (SDL_RWBuffer *) context->hidden.unknown.data1;
+    size_t total_bytes, amount, done = 0;
+
+    total_bytes = (maxnum * size);
+    if ((maxnum <= 0) || (size <= 0)
+        || ((total_bytes / maxnum) != size)) {
+        return 0;
+    }
+
+    if (b->writing) {
+        if (buffered_flush(b) < 0) {
+            return 0;
+        }
+        buffered_reset(b, b->position, SDL_FALSE);
+    }
+
+    while (done < total_bytes) {
+        amount = SDL_min((size_t)(b->read_stop - b->here), total_bytes - done);
+        if (amount > 0) {
+            SDL_memcpy((Uint8 *)ptr + done, b->here, amount);
+            b->here += amount;
+            done += amount;
+            continue;
+        }
+
+        /* The buffer is used up, move past it */
+        buffered_reset(b, b->position + (b->read_stop - b->buffer), SDL_FALSE);
+
+        if (total_bytes - done >= b->size) {
+            /* Big reads go straight to the caller */
+            amount = SDL_RWread(b->src, (Uint8 *)ptr + done, 1, total_bytes - done);
+            if (amount == 0) {
+                break;
+            }
+            b->position += amount;
+            done += amount;
+        } else {
+            amount = SDL_RWread(b->src, b->buffer, 1, b->size);
+            if (amount == 0) {
+                break;
+            }
+            b->read_stop = b->buffer + amount;
+        }
+    }
+    return (done / size);
+}
+
+static size_t SDLCALL
+buffered_write(SDL_RWops * context, const void *ptr, size_t size, size_t num)
+{
+    SDL_RWBuffer *b = (SDL_RWBuffer *) context->hidden.unknown.data1;
+    size_t total_bytes, amount;
+
+    total_bytes = (num * size);
+    if ((num <= 0) || (size <= 0)
+        || ((total_bytes / num) != size)) {
+        return 0;
+    }
+
+    if (!b->writing) {
+        Sint64 current = b->position + (b->here - b->buffer);
+        if (b->here != b->read_stop) {
+            /* The stream is ahead of us by what we read ahead */
+            if (SDL_RWseek(b->src, current, RW_SEEK_SET) < 0) {
+                return 0;
+            }
+        }
+        buffered_reset(b, current, SDL_TRUE);
+    }
+
+    if (total_bytes > b->size - (size_t)(b->here - b->buffer)) {
+        if (buffered_flush(b) < 0) {
+            return 0;
+        }
+        if (total_bytes >= b->size) {
+            /* Big writes go straight to the stream */
+            amount = SDL_RWwrite(b->src, ptr, size, num);
+            b->position += amount * size;
+            return amount;
+        }
+    }
+    SDL_memcpy(b->here, ptr, total_bytes);
+    b->here += total_bytes;
+    return num;
+}
+
+static int SDLCALL
+buffered_close(SDL_RWops * context)
+{
+    int status = 0;
+    if (context) {
+        SDL_RWBuffer *b = (SDL_RWBuffer *) context->hidden.unknown.data1;
+        status = buffered_flush(b);
+        if (b->autoclose && SDL_RWclose(b->src) < 0) {
+            status = -1;
+        }
+        SDL_free(b->buffer);
+        SDL_free(b);
+        SDL_FreeRW(context);
+    }
+    return status;
+}
+
 
 /* Functions to create SDL_RWops structures from various data sources */
 
@@ -697,6 +996,73 @@ SDL_RWFromConstMem(const void *mem, int size)
     return rwops;
 }
 
+SDL_RWops *
+SDL_RWFromFileMapped(const char *file)
+{
+#ifdef HAVE_MMAP_RWOPS
+    SDL_RWops *rwops;
+
+    if (!file || !*file) {
+        SDL_InvalidParamError("file");
+        return NULL;
+    }
+    rwops = mmap_open(file);
+    if (rwops) {
+        return rwops;
+    }
+#endif
+    /* Fall back to a file the usual way, which may also find it elsewhere,
+       like in the app bundle or Android assets. */
+    return SDL_RWFromFile(file, "rb");
+}
+
+SDL_RWops *
+SDL_RWFromRWBuffered(SDL_RWops *src, size_t buffer_size, SDL_bool autoclose)
+{
+    SDL_RWops *rwops;
+    SDL_RWBuffer *b;
+    Sint64 position;
+
+    if (!src) {
+        SDL_InvalidParamError("src");
+        return NULL;
+    }
+    if (buffer_size == 0) {
+        buffer_size = SDL_RWBUFFER_DEFAULT_SIZE;
+    }
+
+    b = (SDL_RWBuffer *) SDL_calloc(1, sizeof (*b));
+    if (b) {
+        b->buffer = (Uint8 *) SDL_malloc(buffer_size);
+    }
+    rwops = SDL_AllocRW();
+    if (!b || !b->buffer || !rwops) {
+        if (b) {
+            SDL_free(b->buffer);
+            SDL_free(b);
+        }
+        SDL_FreeRW(rwops);
+        SDL_OutOfMemory();
+        return NULL;
+    }
+
+    /* Streams that can't tell where they are can still be read and written in order */
+    position = SDL_RWtell(src);
+    b->src = src;
+    b->autoclose = autoclose;
+    b->size = buffer_size;
+    buffered_reset(b, SDL_max(position, 0), SDL_FALSE);
+
+    rwops->size = buffered_size;
+    rwops->seek = buffered_seek;
+    rwops->read = buffered_read;
+    rwops->write = buffered_write;
+    rwops->close = buffered_close;
+    rwops->hidden.unknown.data1 = b;
+    rwops->type = SDL_RWOPS_BUFFERED;
+    return rwops;
+}
+
 SDL_RWops *
 SDL_AllocRW(void)
 {
@@ -721,9 +1087,10 @@ SDL_FreeRW(SDL_RWops * area)
 void *
 SDL_LoadFile_RW(SDL_RWops * src, size_t *datasize, int freesrc)
 {
-    const int FILE_CHUNK_SIZE = 1024;
-    Sint64 size;
-    size_t size_read, size_total;
+    const size_t FILE_CHUNK_SIZE = 64 * 1024;
+    const Uint8 *mem;
+    Sint64 size, pos;
+    size_t size_read, size_total, capacity, memsize;
     void *data = NULL, *newdata;
 
     if (!src) {
@@ -731,17 +1098,60 @@ SDL_LoadFile_RW(SDL_RWops * src, size_t *datasize, int freesrc)
         return NULL;
     }
 
+    /* Memory and memory-mapped streams can be copied in one go */
+    mem = (const Uint8 *) SDL_RWGetMemory(src, &memsize);
+    if (mem) {
+        pos = SDL_RWtell(src);
+        size_total = memsize - (size_t)pos;
+        data = SDL_malloc(size_total + 1);
+        if (!data) {
+            SDL_OutOfMemory();
+            goto done;
+        }
+        SDL_memcpy(data, mem + pos, size_total);
+        SDL_RWseek(src, 0, RW_SEEK_END);
+        goto loaded;
+    }
+
+    /* If we know how much is left, we can usually read it all at once */
     size = SDL_RWsize(src);
-    if (size < 0) {
-        size = FILE_CHUNK_SIZE;
+    pos = (size >= 0) ? SDL_RWtell(src) : -1;
+    if (pos >= 0 && size >= pos && (Uint64)(size - pos) < SIZE_MAX) {
+        capacity = (size_t)(size - pos);
+    } else {
+        size = -1;
+        capacity = FILE_CHUNK_SIZE;
+    }
+    data = SDL_malloc(capacity + 1);
+    if (!data) {
+        SDL_OutOfMemory();
+        goto done;
     }
-    data = SDL_malloc((size_t)(size + 1));
 
     size_total = 0;
     for (;;) {
-        if ((((Sint64)size_total) + FILE_CHUNK_SIZE) > size) {
-            size = (size_total + FILE_CHUNK_SIZE);
-            newdata = SDL_realloc(data, (size_t)(size + 1));
+        if (size_total == capacity) {
+            Uint8 probe = 0;
+            SDL_bool have_probe = SDL_FALSE;
+
+            if (size >= 0) {
+                /* We have what the stream said it had, check for the end before making room for more */
+                if (SDL_RWread(src, &probe, 1, 1) == 0) {
+                    break;
+                }
+                have_probe = SDL_TRUE;
+                size = -1;
+            }
+
+            /* Grow geometrically, so unsized streams aren't copied over and over */
+            if (capacity >= SIZE_MAX / 2) {
+                SDL_free(data);
+                data = NULL;
+                SDL_OutOfMemory();
+                goto done;
+            }
+            capacity = SDL_max(capacity * 2, FILE_CHUNK_SIZE);
+            newdata = SDL_realloc(data, capacity + 1);
             if (!newdata) {
                 SDL_free(data);
                 data = NULL;
@@ -749,15 +1159,19 @@ SDL_LoadFile_RW(SDL_RWops * src, size_t *datasize, int freesrc)
                 goto done;
             }
             data = newdata;
+            if (have_probe) {
+                ((Uint8 *)data)[size_total++] = probe;
+            }
         }
 
-        size_read = SDL_RWread(src, (char *)data+size_total, 1, (size_t)(size-size_total));
+        size_read = SDL_RWread(src, (char *)data+size_total, 1, capacity-size_total);
         if (size_read == 0) {
             break;
         }
         size_total += size_read;
     }
 
+loaded:
     if (datasize) {
         *datasize = size_total;
     }
@@ -773,7 +1187,7 @@ done:
 void *
 SDL_LoadFile(const char *file, size_t *datasize)
 {
-   return SDL_LoadFile_RW(SDL_RWFromFile(file, "rb"), datasize, 1);
+   return SDL_LoadFile_RW(SDL_RWFromFileMapped(file), datasize, 1);
 }
 
 Sint64
@@ -812,14 +1226,83 @@ SDL_RWclose(SDL_RWops *context)
     return context->close(context);
 }
 
+const void *
+SDL_RWGetMemory(SDL_RWops *context, size_t *size)
+{
+    if (!context) {
+        SDL_InvalidParamError("context");
+        return NULL;
+    }
+    switch (context->type) {
+    case SDL_RWOPS_MEMORY:
+    case SDL_RWOPS_MEMORY_RO:
+    case SDL_RWOPS_MAPPED:
+        if (size) {
+            *size = (size_t)(context->hidden.mem.stop - context->hidden.mem.base);
+        }
+        return context->hidden.mem.base;
+    default:
+        break;
+    }
+    if (size) {
+        *size = 0;
+    }
+    return NULL;
+}
+
 /* Functions for dynamically reading and writing endian-specific values */
 
+/* Values in memory, or already in a stream's buffer, are copied without
+   going through the stream's functions */
+static SDL_INLINE void
+SDL_RWreadValue(SDL_RWops * src, void *value, size_t size)
+{
+    Uint8 **here = NULL, *stop = NULL;
+
+    switch (src->type) {
+    case SDL_RWOPS_MEMORY:
+    case SDL_RWOPS_MEMORY_RO:
+    case SDL_RWOPS_MAPPED:
+        here = &src->hidden.mem.here;
+        stop = src->hidden.mem.stop;
+        break;
+    case SDL_RWOPS_BUFFERED:
+        if (!((SDL_RWBuffer *) src->hidden.unknown.data1)->writing) {
+            here = &((SDL_RWBuffer *) src->hidden.unknown.data1)->here;
+            stop = ((SDL_RWBuffer *) src->hidden.unknown.data1)->read_stop;
+        }
+        break;
+    default:
+        break;
+    }
+    if (here && (size_t)(stop - *here) >= size) {
+        SDL_memcpy(value, *here, size);
+        *here += size;
+    } else {
+        SDL_RWread(src, value, size, 1);
+    }
+}
+
+static SDL_INLINE size_t
+SDL_RWwriteValue(SDL_RWops * dst, const void *value, size_t size)
+{
+    if (dst->type == SDL_RWOPS_BUFFERED) {
+        SDL_RWBuffer *b = (SDL_RWBuffer *) dst->hidden.unknown.data1;
+        if (b->writing && b->size - (size_t)(b->here - b->buffer) >= size) {
+            SDL_memcpy(b->here, value, size);
+            b->here += size;
+            return 1;
+        }
+    }
+    return SDL_RWwrite(dst, value, size, 1);
+}
+
 Uint8
 SDL_ReadU8(SDL_RWops * src)
 {
     Uint8 value = 0;
 
-    SDL_RWread(src, &value, sizeof (value), 1);
+    SDL_RWreadValue(src, &value, sizeof (value));
     return value;
 }
 
@@ -828,7 +1311,7 @@ SDL_ReadLE16(SDL_RWops * src)
 {
     Uint16 value = 0;
 
-    SDL_RWread(src, &value, sizeof (value), 1);
+    SDL_RWreadValue(src, &value, sizeof (value));
     return SDL_SwapLE16(value);
 }
 
@@ -837,7 +1320,7 @@ SDL_ReadBE16(SDL_RWops * src)
 {
     Uint16 value = 0;
 
-    SDL_RWread(src, &value, sizeof (value), 1);
+    SDL_RWreadValue(src, &value, sizeof (value));
     return SDL_SwapBE16(value);
 }
 
@@ -846,7 +1329,7 @@ SDL_ReadLE32(SDL_RWops * src)
 {
     Uint32 value = 0;
 
-    SDL_RWread(src, &value, sizeof (value), 1);
+    SDL_RWreadValue(src, &value, sizeof (value));
     return SDL_SwapLE32(value);
 }
 
@@ -855,7 +1338,7 @@ SDL_ReadBE32(SDL_RWops * src)
 {
     Uint32 value = 0;
 
-    SDL_RWread(src, &value, sizeof (value), 1);
+    SDL_RWreadValue(src, &value, sizeof (value));
     return SDL_SwapBE32(value);
 }
 
@@ -864,7 +1347,7 @@ SDL_ReadLE64(SDL_RWops * src)
 {
     Uint64 value = 0;
 
-    SDL_RWread(src, &value, sizeof (value), 1);
+    SDL_RWreadValue(src, &value, sizeof (value));
     return SDL_SwapLE64(value);
 }
 
@@ -873,56 +1356,56 @@ SDL_ReadBE64(SDL_RWops * src)
 {
     Uint64 value = 0;
 
-    SDL_RWread(src, &value, sizeof (value), 1);
+    SDL_RWreadValue(src, &value, sizeof (value));
     return SDL_SwapBE64(value);
 }
 
 size_t
 SDL_WriteU8(SDL_RWops * dst, Uint8 value)
 {
-    return SDL_RWwrite(dst, &value, sizeof (value), 1);
+    return SDL_RWwriteValue(dst, &value, sizeof (value));
 }
 
 size_t
 SDL_WriteLE16(SDL_RWops * dst, Uint16 value)
 {
     const Uint16 swapped = SDL_SwapLE16(value);
-    return SDL_RWwrite(dst, &swapped, sizeof (swapped), 1);
+    return SDL_RWwriteValue(dst, &swapped, sizeof (swapped));
 }
 
 size_t
 SDL_WriteBE16(SDL_RWops * dst, Uint16 value)
 {
     const Uint16 swapped = SDL_SwapBE16(value);
-    return SDL_RWwrite(dst, &swapped, sizeof (swapped), 1);
+    return SDL_RWwriteValue(dst, &swapped, sizeof (swapped));
 }
 
 size_t
 SDL_WriteLE32(SDL_RWops * dst, Uint32 value)
 {
     const Uint32 swapped = SDL_SwapLE32(value);
-    return SDL_RWwrite(dst, &swapped, sizeof (swapped), 1);
+    return SDL_RWwriteValue(dst, &swapped, sizeof (swapped));
 }
 
 size_t
 SDL_WriteBE32(SDL_RWops * dst, Uint32 value)
 {
     const Uint32 swapped = SDL_SwapBE32(value);
-    return SDL_RWwrite(dst, &swapped, sizeof (swapped), 1);
+    return SDL_RWwriteValue(dst, &swapped, sizeof (swapped));
 }
 
 size_t
 SDL_WriteLE64(SDL_RWops * dst, Uint64 value)
 {
     const Uint64 swapped = SDL_SwapLE64(value);
-    return SDL_RWwrite(dst, &swapped, sizeof (swapped), 1);
+    return SDL_RWwriteValue(dst, &swapped, sizeof (swapped));
 }
 
 size_t
 SDL_WriteBE64(SDL_RWops * dst, Uint64 value)
 {
     const Uint64 swapped = SDL_SwapBE64(value);
-    return SDL_RWwrite(dst, &swapped, sizeof (swapped), 1);
+    return SDL_RWwriteValue(dst, &swapped, sizeof (swapped));
 }
 
 /* vi: set ts=4 sw=4 expandtab: */
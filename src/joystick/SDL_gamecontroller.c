@@ -1825,7 +1825,7 @@ SDL_GameControllerFromInstanceID(SDL_JoystickID joyid)
 {
     SDL_GameController *gamecontroller;
 
-    SDL_LockJoysticks();
+    SDL_LockJoysticksForReading();
     gamecontroller = SDL_gamecontrollers;
     while (gamecontroller) {
         if (gamecontroller->joystick->instance_id == joyid) {
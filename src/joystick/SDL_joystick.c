@@ -81,16 +81,41 @@ static SDL_JoystickDriver *SDL_joystick_drivers[] = {
 static SDL_bool SDL_joystick_allows_background_events = SDL_FALSE;
 static SDL_Joystick *SDL_joysticks = NULL;
 static SDL_bool SDL_updating_joystick = SDL_FALSE;
-static SDL_mutex *SDL_joystick_lock = NULL; /* This needs to support recursive locks */
+static SDL_rwlock *SDL_joystick_lock = NULL;
+static SDL_atomic64_t SDL_joystick_lock_owner;  /* the thread holding the lock for writing */
+static int SDL_joystick_lock_depth = 0;         /* only changed by the owner */
 static SDL_atomic_t SDL_next_joystick_instance_id;
 static int SDL_joystick_player_count = 0;
 static SDL_JoystickID *SDL_joystick_players = NULL;
 
+/* The joystick lock is recursive for writing, which the drivers rely on */
 void
 SDL_LockJoysticks(void)
 {
     if (SDL_joystick_lock) {
-        SDL_LockMutex(SDL_joystick_lock);
+        const Sint64 this_thread = (Sint64) SDL_ThreadID();
+        if (SDL_AtomicGet64(&SDL_joystick_lock_owner) == this_thread) {
+            ++SDL_joystick_lock_depth;
+        } else {
+            SDL_LockRWLockForWriting(SDL_joystick_lock);
+            SDL_AtomicSet64(&SDL_joystick_lock_owner, this_thread);
+            SDL_joystick_lock_depth = 1;
+        }
+    }
+}
+
+/* Lock the joysticks for functions that only look at the joystick state, so
+   they can run at the same time. The thread must not lock the joysticks for
+   writing until it unlocks them, but it may already hold them for writing. */
+void
+SDL_LockJoysticksForReading(void)
+{
+    if (SDL_joystick_lock) {
+        if (SDL_AtomicGet64(&SDL_joystick_lock_owner) == (Sint64) SDL_ThreadID()) {
+            ++SDL_joystick_lock_depth;
+        } else {
+            SDL_LockRWLockForReading(SDL_joystick_lock);
+        }
     }
 }
 
@@ -98,7 +123,15 @@ void
 SDL_UnlockJoysticks(void)
 {
     if (SDL_joystick_lock) {
-        SDL_UnlockMutex(SDL_joystick_lock);
+        if (SDL_AtomicGet64(&SDL_joystick_lock_owner) == (Sint64) SDL_ThreadID()) {
+            if (--SDL_joystick_lock_depth == 0) {
+                SDL_AtomicSet64(&SDL_joystick_lock_owner, 0);
+                SDL_UnlockRWLock(SDL_joystick_lock);
+            }
+        } else {
+            /* This thread has the joysticks locked for reading */
+            SDL_UnlockRWLock(SDL_joystick_lock);
+        }
     }
 }
 
@@ -196,7 +229,7 @@ SDL_JoystickInit(void)
 
     /* Create the joystick list lock */
     if (!SDL_joystick_lock) {
-        SDL_joystick_lock = SDL_CreateMutex();
+        SDL_joystick_lock = SDL_CreateRWLock();
     }
 
     /* See if we should allow joystick events while in the background */
@@ -225,7 +258,7 @@ int
 SDL_NumJoysticks(void)
 {
     int i, total_joysticks = 0;
-    SDL_LockJoysticks();
+    SDL_LockJoysticksForReading();
     for (i = 0; i < SDL_arraysize(SDL_joystick_drivers); ++i) {
         total_joysticks += SDL_joystick_drivers[i]->GetCount();
     }
@@ -294,7 +327,7 @@ SDL_JoystickNameForIndex(int device_index)
     SDL_JoystickDriver *driver;
     const char *name = NULL;
 
-    SDL_LockJoysticks();
+    SDL_LockJoysticksForReading();
     if (SDL_GetDriverAndJoystickIndex(device_index, &driver, &device_index)) {
         name = SDL_FixupJoystickName(driver->GetDeviceName(device_index));
     }
@@ -312,7 +345,7 @@ SDL_JoystickGetDevicePlayerIndex(int device_index)
 {
     int player_index;
 
-    SDL_LockJoysticks();
+    SDL_LockJoysticksForReading();
     player_index = SDL_GetPlayerIndexForJoystickID(SDL_JoystickGetDeviceInstanceID(device_index));
     SDL_UnlockJoysticks();
 
@@ -671,7 +704,7 @@ SDL_JoystickFromInstanceID(SDL_JoystickID instance_id)
 {
     SDL_Joystick *joystick;
 
-    SDL_LockJoysticks();
+    SDL_LockJoysticksForReading();
     for (joystick = SDL_joysticks; joystick; joystick = joystick->next) {
         if (joystick->instance_id == instance_id) {
             break;
@@ -690,7 +723,7 @@ SDL_JoystickFromPlayerIndex(int player_index)
     SDL_JoystickID instance_id;
     SDL_Joystick *joystick;
 
-    SDL_LockJoysticks();
+    SDL_LockJoysticksForReading();
     instance_id = SDL_GetJoystickIDForPlayerIndex(player_index);
     for (joystick = SDL_joysticks; joystick; joystick = joystick->next) {
         if (joystick->instance_id == instance_id) {
@@ -726,7 +759,7 @@ SDL_JoystickGetPlayerIndex(SDL_Joystick * joystick)
         return -1;
     }
 
-    SDL_LockJoysticks();
+    SDL_LockJoysticksForReading();
     player_index = SDL_GetPlayerIndexForJoystickID(joystick->instance_id);
     SDL_UnlockJoysticks();
 
@@ -883,9 +916,9 @@ SDL_JoystickQuit(void)
                         SDL_JoystickAllowBackgroundEventsChanged, NULL);
 
     if (SDL_joystick_lock) {
-        SDL_mutex *mutex = SDL_joystick_lock;
+        SDL_rwlock *rwlock = SDL_joystick_lock;
         SDL_joystick_lock = NULL;
-        SDL_DestroyMutex(mutex);
+        SDL_DestroyRWLock(rwlock);
     }
 
     SDL_GameControllerQuitMappings();
@@ -1820,7 +1853,7 @@ SDL_JoystickGUID SDL_JoystickGetDeviceGUID(int device_index)
     SDL_JoystickDriver *driver;
     SDL_JoystickGUID guid;
 
-    SDL_LockJoysticks();
+    SDL_LockJoysticksForReading();
     if (SDL_GetDriverAndJoystickIndex(device_index, &driver, &device_index)) {
         guid = driver->GetDeviceGUID(device_index);
     } else {
@@ -1877,7 +1910,7 @@ SDL_JoystickID SDL_JoystickGetDeviceInstanceID(int device_index)
     SDL_JoystickDriver *driver;
     SDL_JoystickID instance_id = -1;
 
-    SDL_LockJoysticks();
+    SDL_LockJoysticksForReading();
     if (SDL_GetDriverAndJoystickIndex(device_index, &driver, &device_index)) {
         instance_id = driver->GetDeviceInstanceID(device_index);
     }
@@ -1890,7 +1923,7 @@ int SDL_JoystickGetDeviceIndexFromInstanceID(SDL_JoystickID instance_id)
 {
     int i, num_joysticks, device_index = -1;
 
-    SDL_LockJoysticks();
+    SDL_LockJoysticksForReading();
     num_joysticks = SDL_NumJoysticks();
     for (i = 0; i < num_joysticks; ++i) {
         if (SDL_JoystickGetDeviceInstanceID(i) == instance_id) {
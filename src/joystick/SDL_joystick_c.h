@@ -34,6 +34,9 @@ struct _SDL_JoystickDriver;
 extern int SDL_JoystickInit(void);
 extern void SDL_JoystickQuit(void);
 
+/* Lock the joysticks for reading, unlocked with SDL_UnlockJoysticks() */
+extern void SDL_LockJoysticksForReading(void);
+
 /* Function to get the next available joystick instance ID */
 extern SDL_JoystickID SDL_GetNextJoystickInstanceID(void);
 
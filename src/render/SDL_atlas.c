@@ -0,0 +1,703 @@
+/*
+  Simple DirectMedia Layer
+  Copyright (C) 1997-2020 Sam Lantinga <slouken@libsdl.org>
+
+  This software is provided 'as-is', without any express or implied
+  warranty.  In no event will the authors be held liable for any damages
+  arising from the use of this software.
+
+  Permission is granted to anyone to use this software for any purpose,
+  including commercial applications, and to alter it and redistribute it
+  freely, subject to the following restrictions:
+
+  1. The origin of this software must not be misrepresented; you must not
+     claim that you wrote the original software. If you use this software
+     in a product, an acknowledgment in the product documentation would be
+     appreciated but is not required.
+  2. Altered source versions must be plainly marked as such, and must not be
+     misrepresented as being the original software.
+  3. This notice may not be removed or altered from any source distribution.
+*/
+#include "../SDL_internal.h"
+
+/* Texture atlases: many small images packed into one texture.
+
+   New images go in the smallest hole left by a removed image that they
+   fit in, splitting off what's left of the hole, or else on the skyline,
+   the bottom edge of the images packed down from the top of the atlas.
+   The atlas keeps a copy of its pixels, so the images can be packed again
+   when the free space gets too fragmented, and uploads changed pixels to
+   the texture in one go the next time one of its images is used.
+*/
+
+#include "SDL_assert.h"
+#include "SDL_render.h"
+
+/* Image handles are the index of the image plus one, and a generation that
+   changes when the image is removed, so handles to removed images fail. */
+#define ATLAS_INDEX_BITS    20
+#define ATLAS_INDEX_MASK    ((1 << ATLAS_INDEX_BITS) - 1)
+#define ATLAS_MAX_IMAGES    (ATLAS_INDEX_MASK - 1)
+#define ATLAS_GENERATION_MASK   ((1 << (32 - ATLAS_INDEX_BITS)) - 1)
+
+typedef struct SDL_AtlasImage
+{
+    SDL_Rect rect;
+    Uint32 generation;
+    Uint32 last_used;
+    SDL_bool used;
+} SDL_AtlasImage;
+
+typedef struct SDL_SkylineNode
+{
+    int x, y, w;
+} SDL_SkylineNode;
+
+typedef struct SDL_Skyline
+{
+    SDL_SkylineNode *nodes;
+    int num_nodes;
+    int max_nodes;
+} SDL_Skyline;
+
+struct SDL_TextureAtlas
+{
+    SDL_Renderer *renderer;
+    SDL_Texture *texture;
+    Uint32 format;
+    Uint32 flags;
+    int w, h;
+    int bpp;
+
+    /* A copy of the texture, and the part of it not uploaded yet */
+    Uint8 *pixels;
+    int pitch;
+    SDL_Rect dirty;
+
+    SDL_AtlasImage *images;
+    int num_images;
+    int max_images;
+    int *free_slots;
+    int num_free_slots;
+    int max_free_slots;
+
+    SDL_Skyline skyline;
+    SDL_Rect *holes;
+    int num_holes;
+    int max_holes;
+
+    Sint64 used_area;
+    Uint32 clock;
+};
+
+static SDL_bool
+GrowArray(void **array, int *allocation, int needed, size_t size)
+{
+    void *ptr;
+    int newsize;
+
+    if (needed <= *allocation) {
+        return SDL_TRUE;
+    }
+    newsize = *allocation ? (*allocation * 2) : 16;
+    while (newsize < needed) {
+        newsize *= 2;
+    }
+    ptr = SDL_realloc(*array, newsize * size);
+    if (!ptr) {
+        SDL_OutOfMemory();
+        return SDL_FALSE;
+    }
+    *array = ptr;
+    *allocation = newsize;
+    return SDL_TRUE;
+}
+
+static SDL_bool
+SkylineReset(SDL_Skyline *skyline, int w)
+{
+    if (!GrowArray((void **) &skyline->nodes, &skyline->max_nodes, 1, sizeof (SDL_SkylineNode))) {
+        return SDL_FALSE;
+    }
+    skyline->nodes[0].x = 0;
+    skyline->nodes[0].y = 0;
+    skyline->nodes[0].w = w;
+    skyline->num_nodes = 1;
+    return SDL_TRUE;
+}
+
+/* Returns where a w x h image would go on the skyline at node i, or -1 */
+static int
+SkylineFit(const SDL_Skyline *skyline, int i, int w, int h, int atlas_w, int atlas_h)
+{
+    const SDL_SkylineNode *nodes = skyline->nodes;
+    int left = w;
+    int y = 0;
+
+    if (nodes[i].x + w > atlas_w) {
+        return -1;
+    }
+    while (left > 0) {
+        /* the nodes span the whole atlas, so this can't run off the end */
+        SDL_assert(i < skyline->num_nodes);
+        y = SDL_max(y, nodes[i].y);
+        if (y + h > atlas_h) {
+            return -1;
+        }
+        left -= nodes[i].w;
+        ++i;
+    }
+    return y;
+}
+
+/* Put an image where its bottom edge is highest, on the narrowest node if tied */
+static SDL_bool
+SkylineAlloc(SDL_Skyline *skyline, int w, int h, int atlas_w, int atlas_h, SDL_Rect *rect)
+{
+    SDL_SkylineNode *nodes;
+    int best_index = -1, best_bottom = atlas_h + 1, best_width = atlas_w + 1, best_y = 0;
+    int i;
+
+    for (i = 0; i < skyline->num_nodes; ++i) {
+        const int y = SkylineFit(skyline, i, w, h, atlas_w, atlas_h);
+        if (y >= 0) {
+            const int bottom = y + h;
+            if (bottom < best_bottom || (bottom == best_bottom && skyline->nodes[i].w < best_width)) {
+                best_index = i;
+                best_bottom = bottom;
+                best_width = skyline->nodes[i].w;
+                best_y = y;
+            }
+        }
+    }
+    if (best_index < 0) {
+        return SDL_FALSE;
+    }
+    if (!GrowArray((void **) &skyline->nodes, &skyline->max_nodes, skyline->num_nodes + 1, sizeof (SDL_SkylineNode))) {
+        return SDL_FALSE;
+    }
+    nodes = skyline->nodes;
+
+    rect->x = nodes[best_index].x;
+    rect->y = best_y;
+    rect->w = w;
+    rect->h = h;
+
+    SDL_memmove(&nodes[best_index + 1], &nodes[best_index], (skyline->num_nodes - best_index) * sizeof (*nodes));
+    nodes[best_index].x = rect->x;
+    nodes[best_index].y = best_y + h;
+    nodes[best_index].w = w;
+    ++skyline->num_nodes;
+
+    /* Cut the nodes the image now covers */
+    i = best_index + 1;
+    while (i < skyline->num_nodes) {
+        const int end = nodes[i - 1].x + nodes[i - 1].w;
+        if (nodes[i].x >= end) {
+            break;
+        }
+        nodes[i].w -= (end - nodes[i].x);
+        nodes[i].x = end;
+        if (nodes[i].w > 0) {
+            break;
+        }
+        SDL_memmove(&nodes[i], &nodes[i + 1], (skyline->num_nodes - i - 1) * sizeof (*nodes));
+        --skyline->num_nodes;
+    }
+
+    /* Join nodes at the same height */
+    i = 0;
+    while (i < skyline->num_nodes - 1) {
+        if (nodes[i].y == nodes[i + 1].y) {
+            nodes[i].w += nodes[i + 1].w;
+            SDL_memmove(&nodes[i + 1], &nodes[i + 2], (skyline->num_nodes - i - 2) * sizeof (*nodes));
+            --skyline->num_nodes;
+        } else {
+            ++i;
+        }
+    }
+    return SDL_TRUE;
+}
+
+static SDL_bool
+HoleAlloc(SDL_TextureAtlas *atlas, int w, int h, SDL_Rect *rect)
+{
+    SDL_Rect hole, right, bottom;
+    int best = -1;
+    Sint64 best_area = 0;
+    int i;
+
+    for (i = 0; i < atlas->num_holes; ++i) {
+        const SDL_Rect *r = &atlas->holes[i];
+        if (r->w >= w && r->h >= h) {
+            const Sint64 area = (Sint64) r->w * r->h;
+            if (best < 0 || area < best_area) {
+                best = i;
+                best_area = area;
+            }
+        }
+    }
+    if (best < 0) {
+        return SDL_FALSE;
+    }
+    if (!GrowArray((void **) &atlas->holes, &atlas->max_holes, atlas->num_holes + 1, sizeof (SDL_Rect))) {
+        return SDL_FALSE;
+    }
+
+    hole = atlas->holes[best];
+    rect->x = hole.x;
+    rect->y = hole.y;
+    rect->w = w;
+    rect->h = h;
+
+    /* Split what's left along the shorter leftover side, keeping the
+       bigger of the two pieces as large as possible */
+    right.x = hole.x + w;
+    right.y = hole.y;
+    right.w = hole.w - w;
+    bottom.x = hole.x;
+    bottom.y = hole.y + h;
+    bottom.h = hole.h - h;
+    if (right.w < bottom.h) {
+        right.h = h;
+        bottom.w = hole.w;
+    } else {
+        right.h = hole.h;
+        bottom.w = w;
+    }
+
+    atlas->holes[best] = atlas->holes[--atlas->num_holes];
+    if (right.w > 0 && right.h > 0) {
+        atlas->holes[atlas->num_holes++] = right;
+    }
+    if (bottom.w > 0 && bottom.h > 0) {
+        atlas->holes[atlas->num_holes++] = bottom;
+    }
+    return SDL_TRUE;
+}
+
+static void
+MarkDirty(SDL_TextureAtlas *atlas, const SDL_Rect *rect)
+{
+    if (atlas->dirty.w > 0) {
+        SDL_UnionRect(&atlas->dirty, rect, &atlas->dirty);
+    } else {
+        atlas->dirty = *rect;
+    }
+}
+
+static int
+UploadAtlas(SDL_TextureAtlas *atlas)
+{
+    if (atlas->dirty.w > 0) {
+        const SDL_Rect *rect = &atlas->dirty;
+        const Uint8 *src = atlas->pixels + rect->y * atlas->pitch + rect->x * atlas->bpp;
+        if (SDL_UpdateTexture(atlas->texture, rect, src, atlas->pitch) < 0) {
+            return -1;
+        }
+        atlas->dirty.w = 0;
+    }
+    return 0;
+}
+
+static SDL_AtlasImage *
+GetAtlasImage(SDL_TextureAtlas *atlas, SDL_AtlasID id)
+{
+    const int index = (int) (id & ATLAS_INDEX_MASK) - 1;
+    SDL_AtlasImage *image;
+
+    if (!atlas) {
+        SDL_InvalidParamError("atlas");
+        return NULL;
+    }
+    if (index < 0 || index >= atlas->num_images) {
+        SDL_SetError("Image isn't in the atlas");
+        return NULL;
+    }
+    image = &atlas->images[index];
+    if (!image->used || image->generation != (id >> ATLAS_INDEX_BITS)) {
+        SDL_SetError("Image isn't in the atlas");
+        return NULL;
+    }
+    return image;
+}
+
+static void
+RemoveImage(SDL_TextureAtlas *atlas, SDL_AtlasImage *image)
+{
+    /* If there's no room to remember the hole, defragmenting gets it back */
+    if (GrowArray((void **) &atlas->holes, &atlas->max_holes, atlas->num_holes + 1, sizeof (SDL_Rect))) {
+        atlas->holes[atlas->num_holes++] = image->rect;
+    }
+    atlas->used_area -= (Sint64) image->rect.w * image->rect.h;
+    image->used = SDL_FALSE;
+    image->generation = (image->generation + 1) & ATLAS_GENERATION_MASK;
+    atlas->free_slots[atlas->num_free_slots++] = (int) (image - atlas->images);
+}
+
+typedef struct
+{
+    Uint32 last_used;
+    int index;
+} SDL_AtlasUse;
+
+static int SDLCALL
+CompareUses(const void *a, const void *b)
+{
+    const Uint32 A = ((const SDL_AtlasUse *) a)->last_used;
+    const Uint32 B = ((const SDL_AtlasUse *) b)->last_used;
+    const Sint32 diff = (Sint32) (A - B);  /* the clock can wrap */
+    return (diff < 0) ? -1 : (diff > 0) ? 1 : 0;
+}
+
+/* Remove the least recently used images until at least area is free, or
+   the atlas is empty. Returns SDL_FALSE if there was nothing to evict. */
+static SDL_bool
+EvictImages(SDL_TextureAtlas *atlas, Sint64 area)
+{
+    SDL_AtlasUse *uses;
+    Sint64 freed = 0;
+    int i, count = 0;
+
+    uses = (SDL_AtlasUse *) SDL_malloc(SDL_max(atlas->num_images, 1) * sizeof (*uses));
+    if (!uses) {
+        SDL_OutOfMemory();
+        return SDL_FALSE;
+    }
+    for (i = 0; i < atlas->num_images; ++i) {
+        if (atlas->images[i].used) {
+            uses[count].last_used = atlas->images[i].last_used;
+            uses[count].index = i;
+            ++count;
+        }
+    }
+    SDL_qsort(uses, count, sizeof (*uses), CompareUses);
+
+    for (i = 0; i < count && freed < area; ++i) {
+        SDL_AtlasImage *image = &atlas->images[uses[i].index];
+        freed += (Sint64) image->rect.w * image->rect.h;
+        RemoveImage(atlas, image);
+    }
+    SDL_free(uses);
+    return (count > 0) ? SDL_TRUE : SDL_FALSE;
+}
+
+static SDL_bool
+AllocRect(SDL_TextureAtlas *atlas, int w, int h, SDL_Rect *rect)
+{
+    const Sint64 area = (Sint64) w * h;
+    const Sint64 atlas_area = (Sint64) atlas->w * atlas->h;
+
+    if (HoleAlloc(atlas, w, h, rect) ||
+        SkylineAlloc(&atlas->skyline, w, h, atlas->w, atlas->h, rect)) {
+        return SDL_TRUE;
+    }
+
+    /* There's room, it's just in pieces */
+    if ((atlas_area - atlas->used_area) >= area &&
+        SDL_DefragmentTextureAtlas(atlas) == 0 &&
+        SkylineAlloc(&atlas->skyline, w, h, atlas->w, atlas->h, rect)) {
+        return SDL_TRUE;
+    }
+
+    /* Evict a quarter of the atlas at a time, so images that are going to be
+       added next have room too, and the atlas isn't packed again for each. */
+    if (atlas->flags & SDL_ATLAS_EVICT) {
+        while (EvictImages(atlas, SDL_max(area, atlas_area / 4))) {
+            if (SDL_DefragmentTextureAtlas(atlas) == 0 &&
+                SkylineAlloc(&atlas->skyline, w, h, atlas->w, atlas->h, rect)) {
+                return SDL_TRUE;
+            }
+        }
+    }
+    return SDL_FALSE;
+}
+
+SDL_TextureAtlas *
+SDL_CreateTextureAtlas(SDL_Renderer * renderer, Uint32 format, int w, int h, Uint32 flags)
+{
+    SDL_TextureAtlas *atlas;
+
+    if (SDL_ISPIXELFORMAT_FOURCC(format)) {
+        SDL_SetError("Texture atlases can't use YUV formats");
+        return NULL;
+    }
+    if (w <= 0 || h <= 0) {
+        SDL_SetError("Texture atlas dimensions are not valid");
+        return NULL;
+    }
+
+    atlas = (SDL_TextureAtlas *) SDL_calloc(1, sizeof (*atlas));
+    if (!atlas) {
+        SDL_OutOfMemory();
+        return NULL;
+    }
+    atlas->renderer = renderer;
+    atlas->flags = flags;
+    atlas->w = w;
+    atlas->h = h;
+
+    atlas->texture = SDL_CreateTexture(renderer, format, SDL_TEXTUREACCESS_STATIC, w, h);
+    if (!atlas->texture) {
+        SDL_free(atlas);
+        return NULL;
+    }
+
+    /* The renderer picks the format if it was 0 */
+    SDL_QueryTexture(atlas->texture, &format, NULL, NULL, NULL);
+    atlas->format = format;
+    atlas->bpp = SDL_BYTESPERPIXEL(format);
+    atlas->pitch = w * atlas->bpp;
+    if (SDL_ISPIXELFORMAT_ALPHA(format)) {
+        SDL_SetTextureBlendMode(atlas->texture, SDL_BLENDMODE_BLEND);
+    }
+
+    atlas->pixels = (Uint8 *) SDL_calloc(h, atlas->pitch);
+    if (!atlas->pixels || !SkylineReset(&atlas->skyline, w)) {
+        SDL_DestroyTextureAtlas(atlas);
+        SDL_OutOfMemory();
+        return NULL;
+    }
+
+    /* Start out clear, in case images are drawn before they're updated */
+    atlas->dirty.w = w;
+    atlas->dirty.h = h;
+    return atlas;
+}
+
+SDL_AtlasID
+SDL_AddAtlasImage(SDL_TextureAtlas * atlas, int w, int h)
+{
+    SDL_AtlasImage *image;
+    SDL_Rect rect;
+    int index;
+
+    if (!atlas) {
+        SDL_InvalidParamError("atlas");
+        return 0;
+    }
+    if (w <= 0 || h <= 0) {
+        SDL_SetError("Image dimensions are not valid");
+        return 0;
+    }
+    if (w > atlas->w || h > atlas->h) {
+        SDL_SetError("Image is larger than the atlas");
+        return 0;
+    }
+
+    /* Make sure there's a slot for the image before making room for it */
+    if (atlas->num_free_slots == 0) {
+        if (atlas->num_images == ATLAS_MAX_IMAGES) {
+            SDL_SetError("Too many images in the atlas");
+            return 0;
+        }
+        if (!GrowArray((void **) &atlas->images, &atlas->max_images, atlas->num_images + 1, sizeof (SDL_AtlasImage)) ||
+            !GrowArray((void **) &atlas->free_slots, &atlas->max_free_slots, atlas->num_images + 1, sizeof (int))) {
+            return 0;
+        }
+        index = atlas->num_images++;
+        SDL_zero(atlas->images[index]);
+        atlas->free_slots[atlas->num_free_slots++] = index;
+    }
+
+    if (!AllocRect(atlas, w, h, &rect)) {
+        SDL_SetError("No room in the atlas for a %dx%d image", w, h);
+        return 0;
+    }
+
+    index = atlas->free_slots[--atlas->num_free_slots];
+    image = &atlas->images[index];
+    image->rect = rect;
+    image->last_used = ++atlas->clock;
+    image->used = SDL_TRUE;
+    atlas->used_area += (Sint64) w * h;
+
+    return (image->generation << ATLAS_INDEX_BITS) | (Uint32) (index + 1);
+}
+
+int
+SDL_UpdateAtlasImage(SDL_TextureAtlas * atlas, SDL_AtlasID id, const void *pixels, int pitch)
+{
+    SDL_AtlasImage *image = GetAtlasImage(atlas, id);
+    const Uint8 *src = (const Uint8 *) pixels;
+    Uint8 *dst;
+    size_t length;
+    int row;
+
+    if (!image) {
+        return -1;
+    }
+    if (!pixels) {
+        return SDL_InvalidParamError("pixels");
+    }
+
+    length = (size_t) image->rect.w * atlas->bpp;
+    dst = atlas->pixels + image->rect.y * atlas->pitch + image->rect.x * atlas->bpp;
+    for (row = 0; row < image->rect.h; ++row) {
+        SDL_memcpy(dst, src, length);
+        src += pitch;
+        dst += atlas->pitch;
+    }
+    MarkDirty(atlas, &image->rect);
+    return 0;
+}
+
+void
+SDL_RemoveAtlasImage(SDL_TextureAtlas * atlas, SDL_AtlasID id)
+{
+    SDL_AtlasImage *image = GetAtlasImage(atlas, id);
+
+    if (image) {
+        RemoveImage(atlas, image);
+    }
+}
+
+int
+SDL_QueryAtlasImage(SDL_TextureAtlas * atlas, SDL_AtlasID id, SDL_Texture ** texture, SDL_Rect * rect)
+{
+    SDL_AtlasImage *image = GetAtlasImage(atlas, id);
+
+    if (!image) {
+        return -1;
+    }
+    if (UploadAtlas(atlas) < 0) {
+        return -1;
+    }
+    image->last_used = ++atlas->clock;
+    if (texture) {
+        *texture = atlas->texture;
+    }
+    if (rect) {
+        *rect = image->rect;
+    }
+    return 0;
+}
+
+int
+SDL_RenderCopyAtlasImage(SDL_Renderer * renderer, SDL_TextureAtlas * atlas, SDL_AtlasID id,
+                         const SDL_FRect * dstrect)
+{
+    SDL_Texture *texture;
+    SDL_Rect srcrect;
+
+    if (SDL_QueryAtlasImage(atlas, id, &texture, &srcrect) < 0) {
+        return -1;
+    }
+    return SDL_RenderCopyF(renderer, texture, &srcrect, dstrect);
+}
+
+typedef struct
+{
+    int index;
+    SDL_Rect rect;
+} SDL_AtlasPlacement;
+
+static int SDLCALL
+ComparePlacements(const void *a, const void *b)
+{
+    const SDL_Rect *A = &((const SDL_AtlasPlacement *) a)->rect;
+    const SDL_Rect *B = &((const SDL_AtlasPlacement *) b)->rect;
+
+    /* Tallest first, then widest, packs best on a skyline */
+    if (A->h != B->h) {
+        return (A->h > B->h) ? -1 : 1;
+    }
+    if (A->w != B->w) {
+        return (A->w > B->w) ? -1 : 1;
+    }
+    return 0;
+}
+
+int
+SDL_DefragmentTextureAtlas(SDL_TextureAtlas * atlas)
+{
+    SDL_AtlasPlacement *placements;
+    SDL_Skyline skyline;
+    Uint8 *pixels;
+    int i, count = 0;
+
+    if (!atlas) {
+        return SDL_InvalidParamError("atlas");
+    }
+
+    placements = (SDL_AtlasPlacement *) SDL_malloc(SDL_max(atlas->num_images, 1) * sizeof (*placements));
+    if (!placements) {
+        return SDL_OutOfMemory();
+    }
+    for (i = 0; i < atlas->num_images; ++i) {
+        if (atlas->images[i].used) {
+            placements[count].index = i;
+            placements[count].rect = atlas->images[i].rect;
+            ++count;
+        }
+    }
+    SDL_qsort(placements, count, sizeof (*placements), ComparePlacements);
+
+    /* Lay out everything again before changing anything */
+    SDL_zero(skyline);
+    if (!SkylineReset(&skyline, atlas->w)) {
+        SDL_free(placements);
+        return -1;
+    }
+    for (i = 0; i < count; ++i) {
+        SDL_Rect *rect = &placements[i].rect;
+        if (!SkylineAlloc(&skyline, rect->w, rect->h, atlas->w, atlas->h, rect)) {
+            SDL_free(skyline.nodes);
+            SDL_free(placements);
+            return SDL_SetError("Couldn't fit the images in the atlas");
+        }
+    }
+
+    pixels = (Uint8 *) SDL_calloc(atlas->h, atlas->pitch);
+    if (!pixels) {
+        SDL_free(skyline.nodes);
+        SDL_free(placements);
+        return SDL_OutOfMemory();
+    }
+    for (i = 0; i < count; ++i) {
+        SDL_AtlasImage *image = &atlas->images[placements[i].index];
+        const SDL_Rect *from = &image->rect;
+        const SDL_Rect *to = &placements[i].rect;
+        const size_t length = (size_t) from->w * atlas->bpp;
+        const Uint8 *src = atlas->pixels + from->y * atlas->pitch + from->x * atlas->bpp;
+        Uint8 *dst = pixels + to->y * atlas->pitch + to->x * atlas->bpp;
+        int row;
+
+        for (row = 0; row < from->h; ++row) {
+            SDL_memcpy(dst, src, length);
+            src += atlas->pitch;
+            dst += atlas->pitch;
+        }
+        image->rect = *to;
+    }
+
+    SDL_free(atlas->pixels);
+    atlas->pixels = pixels;
+    SDL_free(atlas->skyline.nodes);
+    atlas->skyline = skyline;
+    atlas->num_holes = 0;
+    atlas->dirty.x = 0;
+    atlas->dirty.y = 0;
+    atlas->dirty.w = atlas->w;
+    atlas->dirty.h = atlas->h;
+
+    SDL_free(placements);
+    return 0;
+}
+
+void
+SDL_DestroyTextureAtlas(SDL_TextureAtlas * atlas)
+{
+    if (!atlas) {
+        return;
+    }
+    SDL_DestroyTexture(atlas->texture);
+    SDL_free(atlas->pixels);
+    SDL_free(atlas->images);
+    SDL_free(atlas->free_slots);
+    SDL_free(atlas->skyline.nodes);
+    SDL_free(atlas->holes);
+    SDL_free(atlas);
+}
+
+/* vi: set ts=4 sw=4 expandtab: */
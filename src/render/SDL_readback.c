@@ -0,0 +1,519 @@
+/*
+  Simple DirectMedia Layer
+  Copyright (C) 1997-2020 Sam Lantinga <slouken@libsdl.org>
+
+  This software is provided 'as-is', without any express or implied
+  warranty.  In no event will the authors be held liable for any damages
+  arising from the use of this software.
+
+  Permission is granted to anyone to use this software for any purpose,
+  including commercial applications, and to alter it and redistribute it
+  freely, subject to the following restrictions:
+
+  1. The origin of this software must not be misrepresented; you must not
+     claim that you wrote the original software. If you use this software
+     in a product, an acknowledgment in the product documentation would be
+     appreciated but is not required.
+  2. Altered source versions must be plainly marked as such, and must not be
+     misrepresented as being the original software.
+  3. This notice may not be removed or altered from any source distribution.
+*/
+#include "../SDL_internal.h"
+
+/* Asynchronous readback of the rendering target into a ring of buffers.
+
+   The backend copies the pixels out as they are, in whatever format and row
+   order it has them, when the read is requested (StartReadback), or starts
+   the copy then and finishes it later (FinishReadback). Pending reads are
+   finished when the next read is requested, so the GPU has a frame to get
+   them done, or when the application asks for them. A worker thread then
+   converts the pixels to the format the application asked for.
+   Backends without StartReadback read the pixels in the application's
+   format with RenderReadPixels when they're requested.
+   The software renderer copies the rows of its surface in StartReadback, so
+   the application only waits for a memcpy and not for the conversion.
+*/
+
+#include "SDL_mutex.h"
+#include "SDL_render.h"
+#include "SDL_thread.h"
+#include "SDL_timer.h"
+#include "SDL_sysrender.h"
+
+/* Sequence numbers are returned as non-negative ints */
+#define READBACK_SEQUENCE_MASK  0x7FFFFFFF
+
+typedef enum
+{
+    READBACK_FREE,
+    READBACK_PENDING,       /* waiting for FinishReadback() */
+    READBACK_CONVERTING,    /* waiting for the worker thread */
+    READBACK_READY,         /* waiting for SDL_GetRenderReadback() */
+    READBACK_HELD           /* returned to the application */
+} SDL_ReadbackState;
+
+typedef struct SDL_ReadbackSlot
+{
+    SDL_ReadbackBuffer buffer;      /* the pixels as the backend read them */
+    SDL_ReadbackBuffer converted;   /* the pixels in the requested format */
+    Uint32 sequence;
+    SDL_ReadbackState state;
+    SDL_bool failed;
+} SDL_ReadbackSlot;
+
+struct SDL_RenderReadback
+{
+    SDL_Renderer *renderer;
+    Uint32 format;
+    int num_slots;
+    SDL_ReadbackSlot *slots;
+    Uint32 next_sequence;       /* the sequence number of the next read */
+    Uint32 next_frame;          /* the sequence number of the next read to return */
+
+    SDL_mutex *lock;
+    SDL_cond *submitted;        /* signaled when there are pixels to convert, or at shutdown */
+    SDL_cond *converted;        /* signaled when pixels are converted */
+    SDL_bool shutdown;
+    SDL_Thread *thread;
+
+    SDL_RenderReadback *next;   /* the next readback ring of the renderer */
+};
+
+int
+SDL_ReallocReadbackPixels(SDL_ReadbackBuffer *buffer, int pitch)
+{
+    const size_t size = (size_t) pitch * buffer->rect.h;
+
+    if (size > buffer->allocation) {
+        void *pixels = SDL_realloc(buffer->pixels, size);
+        if (!pixels) {
+            return SDL_OutOfMemory();
+        }
+        buffer->pixels = pixels;
+        buffer->allocation = size;
+    }
+    buffer->pitch = pitch;
+    return 0;
+}
+
+static int
+ConvertReadbackPixels(SDL_ReadbackSlot *slot)
+{
+    SDL_ReadbackBuffer *buffer = &slot->buffer;
+    SDL_ReadbackBuffer *converted = &slot->converted;
+    const int w = buffer->rect.w;
+    const int h = buffer->rect.h;
+
+    if (buffer->bottom_up) {
+        const size_t length = (size_t) w * SDL_BYTESPERPIXEL(buffer->format);
+        Uint8 *top = (Uint8 *) buffer->pixels;
+        Uint8 *bottom = top + (h - 1) * buffer->pitch;
+        SDL_bool isstack;
+        Uint8 *tmp = SDL_small_alloc(Uint8, length, &isstack);
+
+        if (!tmp) {
+            return SDL_OutOfMemory();
+        }
+        while (top < bottom) {
+            SDL_memcpy(tmp, top, length);
+            SDL_memcpy(top, bottom, length);
+            SDL_memcpy(bottom, tmp, length);
+            top += buffer->pitch;
+            bottom -= buffer->pitch;
+        }
+        SDL_small_free(tmp, isstack);
+        buffer->bottom_up = SDL_FALSE;
+    }
+
+    if (buffer->format == converted->format) {
+        /* Nothing to convert, trade buffers with the backend */
+        SDL_ReadbackBuffer swap = *converted;
+
+        converted->pixels = buffer->pixels;
+        converted->pitch = buffer->pitch;
+        converted->allocation = buffer->allocation;
+        buffer->pixels = swap.pixels;
+        buffer->pitch = swap.pitch;
+        buffer->allocation = swap.allocation;
+        return 0;
+    }
+
+    if (SDL_ReallocReadbackPixels(converted, w * SDL_BYTESPERPIXEL(converted->format)) < 0) {
+        return -1;
+    }
+    return SDL_ConvertPixels(w, h, buffer->format, buffer->pixels, buffer->pitch,
+                             converted->format, converted->pixels, converted->pitch);
+}
+
+/* Find the oldest slot in the given state */
+static SDL_ReadbackSlot *
+FindReadbackSlot(SDL_RenderReadback *readback, SDL_ReadbackState state)
+{
+    SDL_ReadbackSlot *oldest = NULL;
+    Uint32 oldest_age = 0;
+    int i;
+
+    for (i = 0; i < readback->num_slots; ++i) {
+        SDL_ReadbackSlot *slot = &readback->slots[i];
+        if (slot->state == state) {
+            const Uint32 age = (slot->sequence - readback->next_frame) & READBACK_SEQUENCE_MASK;
+            if (!oldest || age < oldest_age) {
+                oldest = slot;
+                oldest_age = age;
+            }
+        }
+    }
+    return oldest;
+}
+
+static SDL_ReadbackSlot *
+FindReadbackFrame(SDL_RenderReadback *readback, Uint32 sequence)
+{
+    int i;
+
+    for (i = 0; i < readback->num_slots; ++i) {
+        SDL_ReadbackSlot *slot = &readback->slots[i];
+        if (slot->state != READBACK_FREE && slot->sequence == sequence) {
+            return slot;
+        }
+    }
+    return NULL;
+}
+
+static void
+ConvertReadbackSlot(SDL_RenderReadback *readback, SDL_ReadbackSlot *slot)
+{
+    /* Called with the lock held */
+    SDL_UnlockMutex(readback->lock);
+    slot->failed = (ConvertReadbackPixels(slot) < 0);
+    SDL_LockMutex(readback->lock);
+    slot->state = READBACK_READY;
+    SDL_CondBroadcast(readback->converted);
+}
+
+static int SDLCALL
+SDL_ReadbackThread(void *data)
+{
+    SDL_RenderReadback *readback = (SDL_RenderReadback *) data;
+
+    /* Converting is background work, the application should keep drawing */
+    SDL_SetThreadPriority(SDL_THREAD_PRIORITY_LOW);
+
+    SDL_LockMutex(readback->lock);
+    while (!readback->shutdown) {
+        SDL_ReadbackSlot *slot = FindReadbackSlot(readback, READBACK_CONVERTING);
+        if (slot) {
+            ConvertReadbackSlot(readback, slot);
+        } else {
+            SDL_CondWait(readback->submitted, readback->lock);
+        }
+    }
+    SDL_UnlockMutex(readback->lock);
+    return 0;
+}
+
+/* Hand pixels the backend has finished reading to the worker thread */
+static void
+SubmitReadbackSlot(SDL_RenderReadback *readback, SDL_ReadbackSlot *slot)
+{
+    SDL_LockMutex(readback->lock);
+    slot->state = READBACK_CONVERTING;
+    if (readback->thread) {
+        SDL_CondSignal(readback->submitted);
+    } else {
+        /* There's nobody else to convert it */
+        ConvertReadbackSlot(readback, slot);
+    }
+    SDL_UnlockMutex(readback->lock);
+}
+
+static void
+FinishReadbackSlot(SDL_RenderReadback *readback, SDL_ReadbackSlot *slot)
+{
+    SDL_Renderer *renderer = readback->renderer;
+
+    if (renderer->FinishReadback(renderer, &slot->buffer) < 0) {
+        SDL_LockMutex(readback->lock);
+        slot->failed = SDL_TRUE;
+        slot->state = READBACK_READY;
+        SDL_UnlockMutex(readback->lock);
+    } else {
+        slot->buffer.pending = SDL_FALSE;
+        SubmitReadbackSlot(readback, slot);
+    }
+}
+
+SDL_RenderReadback *
+SDL_CreateRenderReadback(SDL_Renderer * renderer, Uint32 format, int num_buffers)
+{
+    SDL_RenderReadback *readback;
+
+    if (!renderer) {
+        SDL_InvalidParamError("renderer");
+        return NULL;
+    }
+    if (!renderer->RenderReadPixels) {
+        SDL_Unsupported();
+        return NULL;
+    }
+    if (SDL_ISPIXELFORMAT_FOURCC(format) || (format && SDL_BYTESPERPIXEL(format) == 0)) {
+        SDL_SetError("Unsupported readback format %s", SDL_GetPixelFormatName(format));
+        return NULL;
+    }
+    if (num_buffers <= 0) {
+        SDL_InvalidParamError("num_buffers");
+        return NULL;
+    }
+
+    readback = (SDL_RenderReadback *) SDL_calloc(1, sizeof (*readback));
+    if (!readback) {
+        SDL_OutOfMemory();
+        return NULL;
+    }
+    readback->renderer = renderer;
+    readback->format = format;
+    readback->num_slots = num_buffers;
+    readback->slots = (SDL_ReadbackSlot *) SDL_calloc(num_buffers, sizeof (*readback->slots));
+
+    readback->next = renderer->readbacks;
+    renderer->readbacks = readback;
+
+    if (!readback->slots) {
+        SDL_OutOfMemory();
+        SDL_DestroyRenderReadback(readback);
+        return NULL;
+    }
+
+    readback->lock = SDL_CreateMutex();
+    readback->submitted = SDL_CreateCond();
+    readback->converted = SDL_CreateCond();
+#if !SDL_THREADS_DISABLED
+    if (!readback->lock || !readback->submitted || !readback->converted) {
+        SDL_DestroyRenderReadback(readback);
+        return NULL;
+    }
+
+    /* Backends that read in the requested format have nothing to convert */
+    if (renderer->StartReadback) {
+        readback->thread = SDL_CreateThread(SDL_ReadbackThread, "SDLReadback", readback);
+        if (!readback->thread) {
+            SDL_DestroyRenderReadback(readback);
+            return NULL;
+        }
+    }
+#endif /* !SDL_THREADS_DISABLED */
+
+    return readback;
+}
+
+int
+SDL_RenderReadPixelsAsync(SDL_RenderReadback * readback, const SDL_Rect * rect)
+{
+    SDL_Renderer *renderer;
+    SDL_ReadbackSlot *slot;
+    SDL_ReadbackState state;
+    SDL_Rect real_rect;
+    Uint32 format;
+    int i, sequence;
+
+    if (!readback) {
+        return SDL_InvalidParamError("readback");
+    }
+    renderer = readback->renderer;
+
+    real_rect.x = renderer->viewport.x;
+    real_rect.y = renderer->viewport.y;
+    real_rect.w = renderer->viewport.w;
+    real_rect.h = renderer->viewport.h;
+    if (rect ? !SDL_IntersectRect(rect, &real_rect, &real_rect) : SDL_RectEmpty(&real_rect)) {
+        return SDL_SetError("Readback rectangle is outside the viewport");
+    }
+
+    /* Give earlier reads a frame to finish before collecting them */
+    SDL_LockMutex(readback->lock);
+    while ((slot = FindReadbackSlot(readback, READBACK_PENDING)) != NULL) {
+        SDL_UnlockMutex(readback->lock);
+        FinishReadbackSlot(readback, slot);
+        SDL_LockMutex(readback->lock);
+    }
+
+    for (i = 0; i < readback->num_slots; ++i) {
+        if (readback->slots[i].state == READBACK_FREE) {
+            break;
+        }
+    }
+    slot = (i < readback->num_slots) ? &readback->slots[i] : NULL;
+    SDL_UnlockMutex(readback->lock);
+    if (!slot) {
+        return SDL_SetError("All readback buffers are in use");
+    }
+
+    SDL_FlushRenderCommandsForReadPixels(renderer);  /* we need to render before we read the results. */
+
+    format = readback->format;
+    if (!format) {
+        format = SDL_GetWindowPixelFormat(renderer->window);
+    }
+
+    slot->buffer.rect = real_rect;
+    slot->buffer.bottom_up = SDL_FALSE;
+    slot->buffer.pending = SDL_FALSE;
+    slot->converted.rect = real_rect;
+    slot->converted.format = format;
+    slot->failed = SDL_FALSE;
+
+    if (renderer->StartReadback && renderer->StartReadback(renderer, &slot->buffer) == 0) {
+        state = slot->buffer.pending ? READBACK_PENDING : READBACK_CONVERTING;
+    } else {
+        /* Read it now, in the format the application wants */
+        if (SDL_ReallocReadbackPixels(&slot->converted, real_rect.w * SDL_BYTESPERPIXEL(format)) < 0 ||
+            renderer->RenderReadPixels(renderer, &real_rect, format,
+                                       slot->converted.pixels, slot->converted.pitch) < 0) {
+            return -1;
+        }
+        state = READBACK_READY;
+    }
+
+    sequence = (int) readback->next_sequence;
+    slot->sequence = readback->next_sequence;
+    readback->next_sequence = (readback->next_sequence + 1) & READBACK_SEQUENCE_MASK;
+
+    if (state == READBACK_CONVERTING) {
+        SubmitReadbackSlot(readback, slot);
+    } else {
+        SDL_LockMutex(readback->lock);
+        slot->state = state;
+        SDL_UnlockMutex(readback->lock);
+    }
+    return sequence;
+}
+
+int
+SDL_GetRenderReadback(SDL_RenderReadback * readback, SDL_RenderReadbackFrame * frame, Sint32 timeout)
+{
+    const Uint32 start = SDL_GetTicks();
+    SDL_ReadbackSlot *slot;
+    int retval = 0;
+
+    if (!readback) {
+        return SDL_InvalidParamError("readback");
+    }
+    if (!frame) {
+        return SDL_InvalidParamError("frame");
+    }
+
+    SDL_LockMutex(readback->lock);
+    slot = FindReadbackFrame(readback, readback->next_frame);
+    if (!slot || slot->state == READBACK_HELD) {
+        SDL_UnlockMutex(readback->lock);
+        return 0;  /* nothing to return */
+    }
+
+    if (slot->state == READBACK_PENDING) {
+        SDL_UnlockMutex(readback->lock);
+        if (timeout == 0) {
+            return 0;  /* the GPU may still be working on it */
+        }
+        FinishReadbackSlot(readback, slot);
+        SDL_LockMutex(readback->lock);
+    }
+
+    while (slot->state == READBACK_CONVERTING) {
+        if (timeout < 0) {
+            SDL_CondWait(readback->converted, readback->lock);
+        } else {
+            const Uint32 elapsed = SDL_GetTicks() - start;
+            if (elapsed >= (Uint32)timeout ||
+                SDL_CondWaitTimeout(readback->converted, readback->lock, (Uint32)timeout - elapsed) != 0) {
+                break;
+            }
+        }
+    }
+    if (slot->state == READBACK_READY) {
+        readback->next_frame = (readback->next_frame + 1) & READBACK_SEQUENCE_MASK;
+        if (slot->failed) {
+            slot->state = READBACK_FREE;
+            retval = SDL_SetError("Couldn't read back pixels %u", (unsigned int) slot->sequence);
+        } else {
+            slot->state = READBACK_HELD;
+            frame->sequence = slot->sequence;
+            frame->rect = slot->converted.rect;
+            frame->format = slot->converted.format;
+            frame->pixels = slot->converted.pixels;
+            frame->pitch = slot->converted.pitch;
+            retval = 1;
+        }
+    }
+    SDL_UnlockMutex(readback->lock);
+    return retval;
+}
+
+void
+SDL_ReleaseRenderReadback(SDL_RenderReadback * readback, const SDL_RenderReadbackFrame * frame)
+{
+    SDL_ReadbackSlot *slot;
+
+    if (!readback || !frame) {
+        return;
+    }
+
+    SDL_LockMutex(readback->lock);
+    slot = FindReadbackFrame(readback, frame->sequence);
+    if (slot && slot->state == READBACK_HELD) {
+        slot->state = READBACK_FREE;
+    }
+    SDL_UnlockMutex(readback->lock);
+}
+
+void
+SDL_DestroyRenderReadback(SDL_RenderReadback * readback)
+{
+    SDL_Renderer *renderer;
+    SDL_RenderReadback **prev;
+    int i;
+
+    if (!readback) {
+        return;
+    }
+    renderer = readback->renderer;
+
+    if (readback->thread) {
+        SDL_LockMutex(readback->lock);
+        readback->shutdown = SDL_TRUE;
+        SDL_CondBroadcast(readback->submitted);
+        SDL_UnlockMutex(readback->lock);
+        SDL_WaitThread(readback->thread, NULL);
+    }
+
+    for (prev = &renderer->readbacks; *prev; prev = &(*prev)->next) {
+        if (*prev == readback) {
+            *prev = readback->next;
+            break;
+        }
+    }
+
+    for (i = 0; readback->slots && i < readback->num_slots; ++i) {
+        SDL_ReadbackSlot *slot = &readback->slots[i];
+        if (renderer->DestroyReadback) {
+            renderer->DestroyReadback(renderer, &slot->buffer);
+        }
+        SDL_free(slot->buffer.pixels);
+        SDL_free(slot->converted.pixels);
+    }
+    SDL_free(readback->slots);
+
+    SDL_DestroyCond(readback->converted);
+    SDL_DestroyCond(readback->submitted);
+    SDL_DestroyMutex(readback->lock);
+    SDL_free(readback);
+}
+
+void
+SDL_DestroyRenderReadbacks(SDL_Renderer *renderer)
+{
+    while (renderer->readbacks) {
+        SDL_DestroyRenderReadback(renderer->readbacks);
+    }
+}
+
+/* vi: set ts=4 sw=4 expandtab: */
@@ -26,6 +26,7 @@
 #include "SDL_hints.h"
 #include "SDL_log.h"
 #include "SDL_render.h"
+#include "SDL_timer.h"
 #include "SDL_sysrender.h"
 #include "software/SDL_render_sw_c.h"
 
@@ -199,15 +200,350 @@ DebugLogRenderCommands(const SDL_RenderCommand *cmd)
                         (int) cmd->data.draw.b, (int) cmd->data.draw.a,
                         (int) cmd->data.draw.blend, cmd->data.draw.texture);
                 break;
+
+            case SDL_RENDERCMD_COPY_BATCH:
+                SDL_Log(" %u. copy batch (first=%u, count=%u, r=%d, g=%d, b=%d, a=%d, blend=%d, tex=%p)", i++,
+                        (unsigned int) cmd->data.draw.first,
+                        (unsigned int) cmd->data.draw.count,
+                        (int) cmd->data.draw.r, (int) cmd->data.draw.g,
+                        (int) cmd->data.draw.b, (int) cmd->data.draw.a,
+                        (int) cmd->data.draw.blend, cmd->data.draw.texture);
+                break;
+
+            case SDL_RENDERCMD_GEOMETRY:
+                SDL_Log(" %u. geometry (first=%u, count=%u, blend=%d, tex=%p)", i++,
+                        (unsigned int) cmd->data.draw.first,
+                        (unsigned int) cmd->data.draw.count,
+                        (int) cmd->data.draw.blend, cmd->data.draw.texture);
+                break;
         }
         cmd = cmd->next;
     }
 #endif
 }
 
+/* How far back a draw is looked at to find one it can be drawn next to */
+#define MAX_REORDER_DISTANCE 32
+
+static SDL_bool
+IsDrawCommand(const SDL_RenderCommand *cmd)
+{
+    switch (cmd->command) {
+        case SDL_RENDERCMD_DRAW_POINTS:
+        case SDL_RENDERCMD_DRAW_LINES:
+        case SDL_RENDERCMD_FILL_RECTS:
+        case SDL_RENDERCMD_COPY:
+        case SDL_RENDERCMD_COPY_EX:
+        case SDL_RENDERCMD_COPY_BATCH:
+        case SDL_RENDERCMD_GEOMETRY:
+            return SDL_TRUE;
+        default:
+            return SDL_FALSE;
+    }
+}
+
+static SDL_bool
+SameDrawState(const SDL_RenderCommand *a, const SDL_RenderCommand *b)
+{
+    return (a->command == b->command &&
+            a->data.draw.texture == b->data.draw.texture &&
+            a->data.draw.blend == b->data.draw.blend &&
+            a->data.draw.r == b->data.draw.r &&
+            a->data.draw.g == b->data.draw.g &&
+            a->data.draw.b == b->data.draw.b &&
+            a->data.draw.a == b->data.draw.a);
+}
+
+static SDL_bool
+DrawsOverlap(const SDL_RenderCommand *a, const SDL_RenderCommand *b)
+{
+    const SDL_FRect *A = &a->data.draw.bounds;
+    const SDL_FRect *B = &b->data.draw.bounds;
+
+    if (!a->data.draw.bounded || !b->data.draw.bounded) {
+        return SDL_TRUE;
+    }
+    return (A->x < B->x + B->w && B->x < A->x + A->w &&
+            A->y < B->y + B->h && B->y < A->y + A->h);
+}
+
+static Uint32
+DrawColor(const SDL_RenderCommand *cmd)
+{
+    return (((Uint32) cmd->data.draw.a << 24) | ((Uint32) cmd->data.draw.r << 16) | ((Uint32) cmd->data.draw.g << 8) | cmd->data.draw.b);
+}
+
+/* Cut down the number of commands and state changes in the queue:
+   draws are moved back next to an earlier draw with the same state if they
+   don't overlap anything drawn in between, and then adjacent draws with the
+   same state are merged when the backend can run them as one command.
+   Every draw has its own color, so the draw color commands are dropped
+   and queued again where the color changes in the new order. */
+static void
+OptimizeRenderCommands(SDL_Renderer *renderer)
+{
+    SDL_RenderCommand **list;
+    SDL_RenderCommand *cmd, *next, *prev, *tail;
+    SDL_RenderCommand *colors = NULL;
+    SDL_bool reorder = SDL_TRUE;
+    SDL_bool moved = SDL_FALSE;
+    SDL_bool color_set = SDL_FALSE;
+    Uint32 color = 0;
+    size_t vertex_data_needed = 0;
+    int i, j, n = 0, total, start, num_colors = 0, colors_needed = 0;
+
+    for (cmd = renderer->render_commands; cmd != NULL; cmd = cmd->next) {
+        if (cmd->command == SDL_RENDERCMD_SETDRAWCOLOR) {
+            ++num_colors;
+        } else {
+            ++n;
+            if (IsDrawCommand(cmd)) {
+                /* Moved draws may need more padding to stay aligned */
+                vertex_data_needed += cmd->data.draw.vertsize + cmd->data.draw.alignment;
+            }
+        }
+    }
+    total = n + num_colors;
+    if (n < 2) {
+        return;
+    }
+
+    if (n > renderer->optimize_list_allocation) {
+        int allocation = renderer->optimize_list_allocation ? renderer->optimize_list_allocation : 128;
+        while (allocation < n) {
+            allocation *= 2;
+        }
+        list = (SDL_RenderCommand **) SDL_realloc(renderer->optimize_list, allocation * sizeof (*list));
+        if (!list) {
+            return;  /* just draw them as they are */
+        }
+        renderer->optimize_list = list;
+        renderer->optimize_list_allocation = allocation;
+    }
+    list = renderer->optimize_list;
+
+    /* Draws that are moved need their vertex data moved with them */
+    vertex_data_needed = SDL_max(vertex_data_needed, renderer->vertex_data_allocation);
+    if (renderer->optimize_vertex_data_allocation < vertex_data_needed) {
+        void *ptr = SDL_realloc(renderer->optimize_vertex_data, vertex_data_needed);
+        if (ptr) {
+            renderer->optimize_vertex_data = ptr;
+            renderer->optimize_vertex_data_allocation = vertex_data_needed;
+        } else {
+            reorder = SDL_FALSE;
+        }
+    }
+
+    i = 0;
+    for (cmd = renderer->render_commands; cmd != NULL; cmd = cmd->next) {
+        if (cmd->command != SDL_RENDERCMD_SETDRAWCOLOR) {
+            list[i++] = cmd;
+        }
+    }
+
+    /* Draws only move within a run of draws, since the commands between
+       runs change the state the draws use. */
+    start = 0;
+    for (i = 0; reorder && i < n; ++i) {
+        cmd = list[i];
+        if (!IsDrawCommand(cmd)) {
+            start = i + 1;
+            continue;
+        }
+        for (j = i - 1; j >= start && j >= i - MAX_REORDER_DISTANCE; --j) {
+            if (SameDrawState(list[j], cmd)) {
+                if (j < i - 1) {
+                    SDL_memmove(&list[j + 2], &list[j + 1], (i - j - 1) * sizeof (*list));
+                    list[j + 1] = cmd;
+                    moved = SDL_TRUE;
+                }
+                break;
+            }
+            if (DrawsOverlap(list[j], cmd)) {
+                break;
+            }
+        }
+    }
+
+    /* Make sure there are enough draw color commands for the new order
+       before anything is changed, the pool has the ones we have to add. */
+    for (i = 0; i < n; ++i) {
+        cmd = list[i];
+        if (IsDrawCommand(cmd) && (!color_set || DrawColor(cmd) != color)) {
+            color = DrawColor(cmd);
+            color_set = SDL_TRUE;
+            ++colors_needed;
+        }
+    }
+    for (j = num_colors; j < colors_needed; ++j) {
+        cmd = (SDL_RenderCommand *) SDL_calloc(1, sizeof (*cmd));
+        if (!cmd) {
+            return;  /* the queue hasn't been touched, draw it as it is */
+        }
+        cmd->next = renderer->render_commands_pool;
+        renderer->render_commands_pool = cmd;
+    }
+
+    for (cmd = renderer->render_commands; cmd != NULL; cmd = next) {
+        next = cmd->next;
+        if (cmd->command == SDL_RENDERCMD_SETDRAWCOLOR) {
+            cmd->next = colors;
+            colors = cmd;
+        }
+    }
+
+    if (moved) {
+        const Uint8 *src = (const Uint8 *) renderer->vertex_data;
+        Uint8 *dst = (Uint8 *) renderer->optimize_vertex_data;
+        size_t used = 0, allocation;
+        void *ptr;
+
+        for (i = 0; i < n; ++i) {
+            cmd = list[i];
+            if (IsDrawCommand(cmd)) {
+                const size_t alignment = cmd->data.draw.alignment;
+                if (alignment && (used & (alignment - 1)) != 0) {
+                    used += alignment - (used & (alignment - 1));
+                }
+                SDL_memcpy(dst + used, src + cmd->data.draw.first, cmd->data.draw.vertsize);
+                cmd->data.draw.first = used;
+                used += cmd->data.draw.vertsize;
+            }
+        }
+
+        ptr = renderer->vertex_data;
+        renderer->vertex_data = renderer->optimize_vertex_data;
+        renderer->optimize_vertex_data = ptr;
+        allocation = renderer->vertex_data_allocation;
+        renderer->vertex_data_allocation = renderer->optimize_vertex_data_allocation;
+        renderer->optimize_vertex_data_allocation = allocation;
+        renderer->vertex_data_used = used;
+    }
+
+    /* Link the commands back up, merging draws and setting colors */
+    prev = NULL;
+    tail = NULL;
+    renderer->render_commands = NULL;
+    color_set = SDL_FALSE;
+    for (i = 0; i < n; ++i) {
+        cmd = list[i];
+        if (prev && (renderer->mergeable_commands & (1 << cmd->command)) && SameDrawState(prev, cmd) &&
+            (prev->data.draw.first + prev->data.draw.vertsize) == cmd->data.draw.first) {
+            prev->data.draw.count += cmd->data.draw.count;
+            prev->data.draw.vertsize += cmd->data.draw.vertsize;
+            if (prev->data.draw.bounded && cmd->data.draw.bounded) {
+                SDL_FRect *A = &prev->data.draw.bounds;
+                const SDL_FRect *B = &cmd->data.draw.bounds;
+                const float maxx = SDL_max(A->x + A->w, B->x + B->w);
+                const float maxy = SDL_max(A->y + A->h, B->y + B->h);
+                A->x = SDL_min(A->x, B->x);
+                A->y = SDL_min(A->y, B->y);
+                A->w = maxx - A->x;
+                A->h = maxy - A->y;
+            } else {
+                prev->data.draw.bounded = SDL_FALSE;
+            }
+            cmd->next = renderer->render_commands_pool;
+            renderer->render_commands_pool = cmd;
+            --total;
+            continue;
+        }
+
+        if (IsDrawCommand(cmd) && (!color_set || DrawColor(cmd) != color)) {
+            SDL_RenderCommand *colorcmd = colors;
+            if (colorcmd) {
+                colors = colorcmd->next;
+            } else {
+                colorcmd = renderer->render_commands_pool;
+                renderer->render_commands_pool = colorcmd->next;
+                ++total;
+            }
+            color = DrawColor(cmd);
+            color_set = SDL_TRUE;
+            colorcmd->command = SDL_RENDERCMD_SETDRAWCOLOR;
+            colorcmd->data.color.first = 0;
+            colorcmd->data.color.r = cmd->data.draw.r;
+            colorcmd->data.color.g = cmd->data.draw.g;
+            colorcmd->data.color.b = cmd->data.draw.b;
+            colorcmd->data.color.a = cmd->data.draw.a;
+            if (tail) {
+                tail->next = colorcmd;
+            } else {
+                renderer->render_commands = colorcmd;
+            }
+            tail = colorcmd;
+        }
+
+        if (tail) {
+            tail->next = cmd;
+        } else {
+            renderer->render_commands = cmd;
+        }
+        tail = cmd;
+        prev = IsDrawCommand(cmd) ? cmd : NULL;
+    }
+    tail->next = NULL;
+    renderer->render_commands_tail = tail;
+
+    /* Give back the draw color commands that aren't needed anymore */
+    while (colors) {
+        cmd = colors;
+        colors = cmd->next;
+        cmd->next = renderer->render_commands_pool;
+        renderer->render_commands_pool = cmd;
+        --total;
+    }
+}
+
+static void
+CountRenderCommands(SDL_Renderer *renderer)
+{
+    SDL_RenderStats *stats = &renderer->stats;
+    const SDL_RenderCommand *cmd;
+
+    for (cmd = renderer->render_commands; cmd != NULL; cmd = cmd->next) {
+        ++stats->commands_executed;
+        switch (cmd->command) {
+            case SDL_RENDERCMD_SETVIEWPORT:
+            case SDL_RENDERCMD_SETCLIPRECT:
+            case SDL_RENDERCMD_SETDRAWCOLOR:
+                ++stats->state_changes;
+                break;
+            case SDL_RENDERCMD_CLEAR:
+                ++stats->clears;
+                break;
+            case SDL_RENDERCMD_DRAW_POINTS:
+                ++stats->point_draws;
+                break;
+            case SDL_RENDERCMD_DRAW_LINES:
+                ++stats->line_draws;
+                break;
+            case SDL_RENDERCMD_FILL_RECTS:
+                ++stats->rect_fills;
+                break;
+            case SDL_RENDERCMD_COPY:
+                ++stats->copies;
+                break;
+            case SDL_RENDERCMD_COPY_EX:
+                ++stats->copies_ex;
+                break;
+            case SDL_RENDERCMD_COPY_BATCH:
+                ++stats->copy_batches;
+                break;
+            case SDL_RENDERCMD_GEOMETRY:
+                ++stats->geometry_draws;
+                break;
+            case SDL_RENDERCMD_NO_OP:
+                break;
+        }
+    }
+    stats->vertex_bytes += renderer->vertex_data_used;
+}
+
 static int
-FlushRenderCommands(SDL_Renderer *renderer)
+FlushRenderCommands(SDL_Renderer *renderer, SDL_RenderFlushCause cause)
 {
+    Uint64 start;
     int retval;
 
     SDL_assert((renderer->render_commands == NULL) == (renderer->render_commands_tail == NULL));
@@ -217,9 +553,19 @@ FlushRenderCommands(SDL_Renderer *renderer)
         return 0;
     }
 
+    if (renderer->optimize_commands) {
+        OptimizeRenderCommands(renderer);
+    }
+
     DebugLogRenderCommands(renderer->render_commands);
 
+    CountRenderCommands(renderer);
+    ++renderer->stats.flushes;
+    ++renderer->stats.flush_causes[cause];
+
+    start = SDL_GetPerformanceCounter();
     retval = renderer->RunCommandQueue(renderer, renderer->render_commands, renderer->vertex_data, renderer->vertex_data_used);
+    renderer->run_time += SDL_GetPerformanceCounter() - start;
 
     /* Move the whole render command queue to the unused pool so we can reuse them next time. */
     if (renderer->render_commands_tail != NULL) {
@@ -242,7 +588,7 @@ FlushRenderCommandsIfTextureNeeded(SDL_Texture *texture)
     SDL_Renderer *renderer = texture->renderer;
     if (texture->last_command_generation == renderer->render_command_generation) {
         /* the current command queue depends on this texture, flush the queue now before it changes */
-        return FlushRenderCommands(renderer);
+        return FlushRenderCommands(renderer, SDL_RENDERFLUSH_TEXTURE);
     }
     return 0;
 }
@@ -250,13 +596,31 @@ FlushRenderCommandsIfTextureNeeded(SDL_Texture *texture)
 static SDL_INLINE int
 FlushRenderCommandsIfNotBatching(SDL_Renderer *renderer)
 {
-    return renderer->batching ? 0 : FlushRenderCommands(renderer);
+    return renderer->batching ? 0 : FlushRenderCommands(renderer, SDL_RENDERFLUSH_NOT_BATCHING);
+}
+
+int
+SDL_FlushRenderCommandsForReadPixels(SDL_Renderer *renderer)
+{
+    return FlushRenderCommands(renderer, SDL_RENDERFLUSH_READ_PIXELS);
 }
 
 int
 SDL_RenderFlush(SDL_Renderer * renderer)
 {
-    return FlushRenderCommands(renderer);
+    return FlushRenderCommands(renderer, SDL_RENDERFLUSH_EXPLICIT);
+}
+
+int
+SDL_RenderGetStats(SDL_Renderer * renderer, SDL_RenderStats * stats)
+{
+    CHECK_RENDERER_MAGIC(renderer, -1);
+
+    if (!stats) {
+        return SDL_InvalidParamError("stats");
+    }
+    *stats = renderer->last_stats;
+    return 0;
 }
 
 void *
@@ -268,6 +632,10 @@ SDL_AllocateRenderVertices(SDL_Renderer *renderer, const size_t numbytes, const
     size_t aligner = (alignment && ((current_offset & (alignment - 1)) != 0)) ? (alignment - (current_offset & (alignment - 1))) : 0;
     size_t aligned = current_offset + aligner;
 
+    if (alignment > renderer->vertex_data_alignment) {
+        renderer->vertex_data_alignment = alignment;
+    }
+
     if (renderer->vertex_data_allocation < needed) {
         const size_t current_allocation = renderer->vertex_data ? renderer->vertex_data_allocation : 1024;
         size_t newsize = current_allocation * 2;
@@ -319,6 +687,8 @@ AllocateRenderCommand(SDL_Renderer *renderer)
     }
     renderer->render_commands_tail = retval;
 
+    ++renderer->stats.commands_queued;
+
     return retval;
 }
 
@@ -370,7 +740,7 @@ QueueCmdSetClipRect(SDL_Renderer *renderer)
 static int
 QueueCmdSetDrawColor(SDL_Renderer *renderer, const Uint8 r, const Uint8 g, const Uint8 b, const Uint8 a)
 {
-    const Uint32 color = ((a << 24) | (r << 16) | (g << 8) | b);
+    const Uint32 color = (((Uint32) a << 24) | ((Uint32) r << 16) | ((Uint32) g << 8) | b);
     int retval = 0;
     
     if (!renderer->color_queued || (color != renderer->last_queued_color)) {
@@ -451,6 +821,83 @@ PrepQueueCmdDrawSolid(SDL_Renderer *renderer, const SDL_RenderCommandType cmdtyp
     return cmd;
 }
 
+/* The optimizer needs the size of a draw's vertex data to move it, and
+   the pixels it may touch to know which draws it can be moved past. */
+static void
+SetDrawUnbounded(SDL_Renderer *renderer, SDL_RenderCommand *cmd)
+{
+    cmd->data.draw.vertsize = renderer->vertex_data_used - cmd->data.draw.first;
+    cmd->data.draw.alignment = renderer->vertex_data_alignment;
+    cmd->data.draw.bounded = SDL_FALSE;
+    renderer->vertex_data_alignment = 0;
+}
+
+static void
+SetDrawBounds(SDL_Renderer *renderer, SDL_RenderCommand *cmd, float minx, float miny, float maxx, float maxy)
+{
+    SDL_FRect *bounds = &cmd->data.draw.bounds;
+
+    /* Round out to whole pixels, the backends snap to them differently */
+    cmd->data.draw.vertsize = renderer->vertex_data_used - cmd->data.draw.first;
+    cmd->data.draw.alignment = renderer->vertex_data_alignment;
+    cmd->data.draw.bounded = SDL_TRUE;
+    renderer->vertex_data_alignment = 0;
+    bounds->x = SDL_floorf(minx);
+    bounds->y = SDL_floorf(miny);
+    bounds->w = SDL_max(SDL_ceilf(maxx) - bounds->x, 1.0f);
+    bounds->h = SDL_max(SDL_ceilf(maxy) - bounds->y, 1.0f);
+}
+
+static void
+SetDrawBoundsFromPoints(SDL_Renderer *renderer, SDL_RenderCommand *cmd, const SDL_FPoint * points, const int count)
+{
+    float minx, miny, maxx, maxy;
+    int i;
+
+    /* An empty command can't be bounded */
+    if (count <= 0) {
+        SetDrawUnbounded(renderer, cmd);
+        return;
+    }
+
+    minx = maxx = points[0].x;
+    miny = maxy = points[0].y;
+    for (i = 1; i < count; ++i) {
+        minx = SDL_min(minx, points[i].x);
+        miny = SDL_min(miny, points[i].y);
+        maxx = SDL_max(maxx, points[i].x);
+        maxy = SDL_max(maxy, points[i].y);
+    }
+    /* Points and line ends can land on a neighboring pixel */
+    SetDrawBounds(renderer, cmd, minx - 1.0f, miny - 1.0f, maxx + 1.0f, maxy + 1.0f);
+}
+
+static void
+SetDrawBoundsFromRects(SDL_Renderer *renderer, SDL_RenderCommand *cmd, const SDL_FRect * rects, const int count)
+{
+    float minx, miny, maxx, maxy;
+    int i;
+
+    /* An empty command can't be bounded */
+    if (count <= 0) {
+        SetDrawUnbounded(renderer, cmd);
+        return;
+    }
+
+    minx = SDL_min(rects[0].x, rects[0].x + rects[0].w);
+    miny = SDL_min(rects[0].y, rects[0].y + rects[0].h);
+    maxx = SDL_max(rects[0].x, rects[0].x + rects[0].w);
+    maxy = SDL_max(rects[0].y, rects[0].y + rects[0].h);
+
+    for (i = 1; i < count; ++i) {
+        minx = SDL_min(minx, SDL_min(rects[i].x, rects[i].x + rects[i].w));
+        miny = SDL_min(miny, SDL_min(rects[i].y, rects[i].y + rects[i].h));
+        maxx = SDL_max(maxx, SDL_max(rects[i].x, rects[i].x + rects[i].w));
+        maxy = SDL_max(maxy, SDL_max(rects[i].y, rects[i].y + rects[i].h));
+    }
+    SetDrawBounds(renderer, cmd, minx, miny, maxx, maxy);
+}
+
 static int
 QueueCmdDrawPoints(SDL_Renderer *renderer, const SDL_FPoint * points, const int count)
 {
@@ -460,6 +907,8 @@ QueueCmdDrawPoints(SDL_Renderer *renderer, const SDL_FPoint * points, const int
         retval = renderer->QueueDrawPoints(renderer, cmd, points, count);
         if (retval < 0) {
             cmd->command = SDL_RENDERCMD_NO_OP;
+        } else if (renderer->optimize_commands) {
+            SetDrawBoundsFromPoints(renderer, cmd, points, count);
         }
     }
     return retval;
@@ -474,6 +923,8 @@ QueueCmdDrawLines(SDL_Renderer *renderer, const SDL_FPoint * points, const int c
         retval = renderer->QueueDrawLines(renderer, cmd, points, count);
         if (retval < 0) {
             cmd->command = SDL_RENDERCMD_NO_OP;
+        } else if (renderer->optimize_commands) {
+            SetDrawBoundsFromPoints(renderer, cmd, points, count);
         }
     }
     return retval;
@@ -488,26 +939,29 @@ QueueCmdFillRects(SDL_Renderer *renderer, const SDL_FRect * rects, const int cou
         retval = renderer->QueueFillRects(renderer, cmd, rects, count);
         if (retval < 0) {
             cmd->command = SDL_RENDERCMD_NO_OP;
+        } else if (renderer->optimize_commands) {
+            SetDrawBoundsFromRects(renderer, cmd, rects, count);
         }
     }
     return retval;
 }
 
 static SDL_RenderCommand *
-PrepQueueCmdDrawTexture(SDL_Renderer *renderer, SDL_Texture *texture, const SDL_RenderCommandType cmdtype)
+PrepQueueCmdDrawTexture(SDL_Renderer *renderer, SDL_Texture *texture, const SDL_RenderCommandType cmdtype,
+                        const Uint8 r, const Uint8 g, const Uint8 b, const Uint8 a)
 {
     /* !!! FIXME: drop this draw if viewport w or h is zero. */
     SDL_RenderCommand *cmd = NULL;
-    if (PrepQueueCmdDraw(renderer, texture->r, texture->g, texture->b, texture->a) == 0) {
+    if (PrepQueueCmdDraw(renderer, r, g, b, a) == 0) {
         cmd = AllocateRenderCommand(renderer);
         if (cmd != NULL) {
             cmd->command = cmdtype;
             cmd->data.draw.first = 0;  /* render backend will fill this in. */
             cmd->data.draw.count = 0;  /* render backend will fill this in. */
-            cmd->data.draw.r = texture->r;
-            cmd->data.draw.g = texture->g;
-            cmd->data.draw.b = texture->b;
-            cmd->data.draw.a = texture->a;
+            cmd->data.draw.r = r;
+            cmd->data.draw.g = g;
+            cmd->data.draw.b = b;
+            cmd->data.draw.a = a;
             cmd->data.draw.blend = texture->blendMode;
             cmd->data.draw.texture = texture;
         }
@@ -518,12 +972,15 @@ PrepQueueCmdDrawTexture(SDL_Renderer *renderer, SDL_Texture *texture, const SDL_
 static int
 QueueCmdCopy(SDL_Renderer *renderer, SDL_Texture * texture, const SDL_Rect * srcrect, const SDL_FRect * dstrect)
 {
-    SDL_RenderCommand *cmd = PrepQueueCmdDrawTexture(renderer, texture, SDL_RENDERCMD_COPY);
+    SDL_RenderCommand *cmd = PrepQueueCmdDrawTexture(renderer, texture, SDL_RENDERCMD_COPY,
+                                                       texture->r, texture->g, texture->b, texture->a);
     int retval = -1;
     if (cmd != NULL) {
         retval = renderer->QueueCopy(renderer, cmd, texture, srcrect, dstrect);
         if (retval < 0) {
             cmd->command = SDL_RENDERCMD_NO_OP;
+        } else if (renderer->optimize_commands) {
+            SetDrawBoundsFromRects(renderer, cmd, dstrect, 1);
         }
     }
     return retval;
@@ -534,13 +991,105 @@ QueueCmdCopyEx(SDL_Renderer *renderer, SDL_Texture * texture,
                const SDL_Rect * srcquad, const SDL_FRect * dstrect,
                const double angle, const SDL_FPoint *center, const SDL_RendererFlip flip)
 {
-    SDL_RenderCommand *cmd = PrepQueueCmdDrawTexture(renderer, texture, SDL_RENDERCMD_COPY_EX);
+    SDL_RenderCommand *cmd = PrepQueueCmdDrawTexture(renderer, texture, SDL_RENDERCMD_COPY_EX,
+                                                       texture->r, texture->g, texture->b, texture->a);
     int retval = -1;
     SDL_assert(renderer->QueueCopyEx != NULL);  /* should have caught at higher level. */
     if (cmd != NULL) {
         retval = renderer->QueueCopyEx(renderer, cmd, texture, srcquad, dstrect, angle, center, flip);
         if (retval < 0) {
             cmd->command = SDL_RENDERCMD_NO_OP;
+        } else if (renderer->optimize_commands) {
+            SetDrawUnbounded(renderer, cmd);
+        }
+    }
+    return retval;
+}
+
+static int
+QueueCmdCopyBatch(SDL_Renderer *renderer, SDL_Texture * texture,
+                  const SDL_RenderCopyInstance * instances, const int count)
+{
+    SDL_RenderCommand *cmd;
+    int i, retval = -1;
+
+    if (renderer->QueueCopyBatch) {
+        cmd = PrepQueueCmdDrawTexture(renderer, texture, SDL_RENDERCMD_COPY_BATCH,
+                                      texture->r, texture->g, texture->b, texture->a);
+        if (cmd != NULL) {
+            retval = renderer->QueueCopyBatch(renderer, cmd, texture, instances, count);
+            if (retval < 0) {
+                cmd->command = SDL_RENDERCMD_NO_OP;
+            } else if (renderer->optimize_commands) {
+                float minx = instances[0].corners[0].x, miny = instances[0].corners[0].y;
+                float maxx = minx, maxy = miny;
+                int j;
+                for (i = 0; i < count; ++i) {
+                    for (j = 0; j < 4; ++j) {
+                        minx = SDL_min(minx, instances[i].corners[j].x);
+                        miny = SDL_min(miny, instances[i].corners[j].y);
+                        maxx = SDL_max(maxx, instances[i].corners[j].x);
+                        maxy = SDL_max(maxy, instances[i].corners[j].y);
+                    }
+                }
+                SetDrawBounds(renderer, cmd, minx, miny, maxx, maxy);
+            }
+        }
+        return retval;
+    }
+
+    /* The backend can't draw a batch, queue the copies one at a time */
+    for (i = 0; i < count; ++i) {
+        const SDL_RenderCopyInstance *instance = &instances[i];
+        if (instance->angle == 0.0 && instance->flip == SDL_FLIP_NONE) {
+            cmd = PrepQueueCmdDrawTexture(renderer, texture, SDL_RENDERCMD_COPY,
+                                          instance->r, instance->g, instance->b, instance->a);
+            retval = cmd ? renderer->QueueCopy(renderer, cmd, texture, &instance->srcrect, &instance->dstrect) : -1;
+        } else {
+            cmd = PrepQueueCmdDrawTexture(renderer, texture, SDL_RENDERCMD_COPY_EX,
+                                          instance->r, instance->g, instance->b, instance->a);
+            retval = cmd ? renderer->QueueCopyEx(renderer, cmd, texture, &instance->srcrect, &instance->dstrect,
+                                                 instance->angle, &instance->center, instance->flip) : -1;
+        }
+        if (retval < 0) {
+            if (cmd != NULL) {
+                cmd->command = SDL_RENDERCMD_NO_OP;
+            }
+            break;
+        }
+        if (renderer->optimize_commands) {
+            SetDrawUnbounded(renderer, cmd);
+        }
+    }
+    return retval;
+}
+
+static int
+QueueCmdGeometry(SDL_Renderer *renderer, SDL_Texture * texture,
+                 const SDL_Vertex * vertices, const int count)
+{
+    /* The vertices have their own colors, the draw color is left as it is */
+    SDL_RenderCommand *cmd = PrepQueueCmdDrawSolid(renderer, SDL_RENDERCMD_GEOMETRY);
+    int retval = -1;
+    if (cmd != NULL) {
+        if (texture) {
+            cmd->data.draw.blend = texture->blendMode;
+            cmd->data.draw.texture = texture;
+        }
+        retval = renderer->QueueGeometry(renderer, cmd, texture, vertices, count);
+        if (retval < 0) {
+            cmd->command = SDL_RENDERCMD_NO_OP;
+        } else if (renderer->optimize_commands) {
+            float minx = vertices[0].position.x, miny = vertices[0].position.y;
+            float maxx = minx, maxy = miny;
+            int i;
+            for (i = 1; i < count; ++i) {
+                minx = SDL_min(minx, vertices[i].position.x);
+                miny = SDL_min(miny, vertices[i].position.y);
+                maxx = SDL_max(maxx, vertices[i].position.x);
+                maxy = SDL_max(maxy, vertices[i].position.y);
+            }
+            SetDrawBounds(renderer, cmd, minx, miny, maxx, maxy);
         }
     }
     return retval;
@@ -852,6 +1401,9 @@ SDL_CreateRenderer(SDL_Window * window, int index, Uint32 flags)
     }
 
     renderer->batching = batching;
+    if (renderer->mergeable_commands) {
+        renderer->optimize_commands = SDL_GetHintBoolean(SDL_HINT_RENDER_OPTIMIZE_COMMANDS, SDL_FALSE);
+    }
     renderer->magic = &renderer_magic;
     renderer->window = window;
     renderer->target_mutex = SDL_CreateMutex();
@@ -916,6 +1468,9 @@ SDL_CreateSoftwareRenderer(SDL_Surface * surface)
 
     if (renderer) {
         VerifyDrawQueueFunctions(renderer);
+        if (renderer->mergeable_commands) {
+            renderer->optimize_commands = SDL_GetHintBoolean(SDL_HINT_RENDER_OPTIMIZE_COMMANDS, SDL_FALSE);
+        }
         renderer->magic = &renderer_magic;
         renderer->target_mutex = SDL_CreateMutex();
         renderer->scale.x = 1.0f;
@@ -1039,16 +1594,12 @@ static SDL_ScaleMode SDL_GetScaleMode(void)
     }
 }
 
-SDL_Texture *
-SDL_CreateTexture(SDL_Renderer * renderer, Uint32 format, int access, int w, int h)
+/* Allocate a texture and add it to the renderer, without creating it in the backend */
+static SDL_Texture *
+AllocateTexture(SDL_Renderer * renderer, Uint32 format, int access, int w, int h)
 {
     SDL_Texture *texture;
 
-    CHECK_RENDERER_MAGIC(renderer, NULL);
-
-    if (!format) {
-        format = renderer->info.texture_formats[0];
-    }
     if (SDL_BYTESPERPIXEL(format) == 0) {
         SDL_SetError("Invalid texture format");
         return NULL;
@@ -1087,6 +1638,23 @@ SDL_CreateTexture(SDL_Renderer * renderer, Uint32 format, int access, int w, int
         renderer->textures->prev = texture;
     }
     renderer->textures = texture;
+    return texture;
+}
+
+SDL_Texture *
+SDL_CreateTexture(SDL_Renderer * renderer, Uint32 format, int access, int w, int h)
+{
+    SDL_Texture *texture;
+
+    CHECK_RENDERER_MAGIC(renderer, NULL);
+
+    if (!format) {
+        format = renderer->info.texture_formats[0];
+    }
+    texture = AllocateTexture(renderer, format, access, w, h);
+    if (!texture) {
+        return NULL;
+    }
 
     if (IsSupportedFormat(renderer, format)) {
         if (renderer->CreateTexture(renderer, texture) < 0) {
@@ -1138,6 +1706,27 @@ SDL_CreateTexture(SDL_Renderer * renderer, Uint32 format, int access, int w, int
     return texture;
 }
 
+static void
+SetTextureModsFromSurface(SDL_Texture * texture, SDL_Surface * surface)
+{
+    Uint8 r, g, b, a;
+    SDL_BlendMode blendMode;
+
+    SDL_GetSurfaceColorMod(surface, &r, &g, &b);
+    SDL_SetTextureColorMod(texture, r, g, b);
+
+    SDL_GetSurfaceAlphaMod(surface, &a);
+    SDL_SetTextureAlphaMod(texture, a);
+
+    if (SDL_HasColorKey(surface)) {
+        /* We converted to a texture with alpha format */
+        SDL_SetTextureBlendMode(texture, SDL_BLENDMODE_BLEND);
+    } else {
+        SDL_GetSurfaceBlendMode(surface, &blendMode);
+        SDL_SetTextureBlendMode(texture, blendMode);
+    }
+}
+
 SDL_Texture *
 SDL_CreateTextureFromSurface(SDL_Renderer * renderer, SDL_Surface * surface)
 {
@@ -1263,24 +1852,50 @@ SDL_CreateTextureFromSurface(SDL_Renderer * renderer, SDL_Surface * surface)
         }
     }
 
-    {
-        Uint8 r, g, b, a;
-        SDL_BlendMode blendMode;
+    SetTextureModsFromSurface(texture, surface);
+    return texture;
+}
+
+SDL_Texture *
+SDL_CreateSurfaceTexture(SDL_Renderer * renderer, SDL_Surface * surface)
+{
+    SDL_Texture *texture = NULL;
+    Uint32 format;
 
-        SDL_GetSurfaceColorMod(surface, &r, &g, &b);
-        SDL_SetTextureColorMod(texture, r, g, b);
+    CHECK_RENDERER_MAGIC(renderer, NULL);
 
-        SDL_GetSurfaceAlphaMod(surface, &a);
-        SDL_SetTextureAlphaMod(texture, a);
+    if (!surface) {
+        SDL_SetError("SDL_CreateSurfaceTexture() passed NULL surface");
+        return NULL;
+    }
 
-        if (SDL_HasColorKey(surface)) {
-            /* We converted to a texture with alpha format */
-            SDL_SetTextureBlendMode(texture, SDL_BLENDMODE_BLEND);
+    /* Share the pixels if the backend can draw the surface as it is */
+    format = surface->format->format;
+    if (renderer->CreateSurfaceTexture && surface->pixels &&
+        !SDL_MUSTLOCK(surface) && !SDL_HasColorKey(surface) &&
+        IsSupportedFormat(renderer, format)) {
+        texture = AllocateTexture(renderer, format, SDL_TEXTUREACCESS_STATIC, surface->w, surface->h);
+        if (!texture) {
+            return NULL;
+        }
+        if (renderer->CreateSurfaceTexture(renderer, texture, surface) < 0) {
+            SDL_DestroyTexture(texture);
+            texture = NULL;
         } else {
-            SDL_GetSurfaceBlendMode(surface, &blendMode);
-            SDL_SetTextureBlendMode(texture, blendMode);
+            texture->shares_surface = SDL_TRUE;
+            SetTextureModsFromSurface(texture, surface);
         }
     }
+
+    if (!texture) {
+        texture = SDL_CreateTextureFromSurface(renderer, surface);
+        if (!texture) {
+            return NULL;
+        }
+    }
+
+    texture->surface = surface;
+    ++surface->refcount;
     return texture;
 }
 
@@ -1426,6 +2041,32 @@ SDL_GetTextureScaleMode(SDL_Texture * texture, SDL_ScaleMode *scaleMode)
     return 0;
 }
 
+static void
+CountTextureUpload(SDL_Texture * texture, const SDL_Rect * rect)
+{
+    SDL_RenderStats *stats = &texture->renderer->stats;
+    const size_t w = (size_t) rect->w;
+    const size_t h = (size_t) rect->h;
+
+    ++stats->texture_uploads;
+    switch (texture->format) {
+        case SDL_PIXELFORMAT_YV12:
+        case SDL_PIXELFORMAT_IYUV:
+        case SDL_PIXELFORMAT_NV12:
+        case SDL_PIXELFORMAT_NV21:
+            stats->texture_upload_bytes += w * h + 2 * ((w + 1) / 2) * ((h + 1) / 2);
+            break;
+        case SDL_PIXELFORMAT_YUY2:
+        case SDL_PIXELFORMAT_UYVY:
+        case SDL_PIXELFORMAT_YVYU:
+            stats->texture_upload_bytes += ((w + 1) / 2) * 4 * h;
+            break;
+        default:
+            stats->texture_upload_bytes += w * h * SDL_BYTESPERPIXEL(texture->format);
+            break;
+    }
+}
+
 #if SDL_HAVE_YUV
 static int
 SDL_UpdateTextureYUV(SDL_Texture * texture, const SDL_Rect * rect,
@@ -1551,10 +2192,88 @@ SDL_UpdateTexture(SDL_Texture * texture, const SDL_Rect * rect,
         if (FlushRenderCommandsIfTextureNeeded(texture) < 0) {
             return -1;
         }
+        CountTextureUpload(texture, rect);
         return renderer->UpdateTexture(renderer, texture, rect, pixels, pitch);
     }
 }
 
+int
+SDL_UpdateSurfaceTexture(SDL_Texture * texture, const SDL_Rect * rect)
+{
+    SDL_Surface *surface;
+    SDL_Rect full_rect, real_rect;
+    Uint8 *pixels;
+    int retval;
+
+    CHECK_TEXTURE_MAGIC(texture, -1);
+
+    surface = texture->surface;
+    if (!surface) {
+        return SDL_SetError("Texture wasn't created with SDL_CreateSurfaceTexture()");
+    }
+
+    full_rect.x = 0;
+    full_rect.y = 0;
+    full_rect.w = texture->w;
+    full_rect.h = texture->h;
+    if (!rect) {
+        real_rect = full_rect;
+    } else if (!SDL_IntersectRect(rect, &full_rect, &real_rect)) {
+        return 0;  /* nothing to do. */
+    }
+
+    if (texture->shares_surface) {
+        /* The renderer draws straight from the surface, so it already has the changes */
+        return 0;
+    }
+
+    /* Pixels smaller than a byte are updated a whole row at a time */
+    if (surface->format->BitsPerPixel < 8) {
+        real_rect.x = 0;
+        real_rect.w = surface->w;
+    }
+
+    if (SDL_MUSTLOCK(surface) && SDL_LockSurface(surface) < 0) {
+        return -1;
+    }
+    pixels = (Uint8 *) surface->pixels + real_rect.y * surface->pitch +
+             real_rect.x * surface->format->BytesPerPixel;
+
+    if (texture->format == surface->format->format &&
+        !(surface->format->Amask && SDL_HasColorKey(surface))) {
+        retval = SDL_UpdateTexture(texture, &real_rect, pixels, surface->pitch);
+    } else {
+        /* Convert the area the same way SDL_CreateTextureFromSurface() converted the whole surface */
+        SDL_Surface *area, *temp = NULL;
+        Uint32 colorkey;
+
+        area = SDL_CreateRGBSurfaceWithFormatFrom(pixels, real_rect.w, real_rect.h,
+                                                  surface->format->BitsPerPixel,
+                                                  surface->pitch, surface->format->format);
+        if (area) {
+            if (surface->format->palette) {
+                SDL_SetSurfacePalette(area, surface->format->palette);
+            }
+            if (SDL_GetColorKey(surface, &colorkey) == 0) {
+                SDL_SetColorKey(area, SDL_TRUE, colorkey);
+            }
+            temp = SDL_ConvertSurfaceFormat(area, texture->format, 0);
+            SDL_FreeSurface(area);
+        }
+        if (temp) {
+            retval = SDL_UpdateTexture(texture, &real_rect, temp->pixels, temp->pitch);
+            SDL_FreeSurface(temp);
+        } else {
+            retval = -1;
+        }
+    }
+
+    if (SDL_MUSTLOCK(surface)) {
+        SDL_UnlockSurface(surface);
+    }
+    return retval;
+}
+
 #if SDL_HAVE_YUV
 static int
 SDL_UpdateTextureYUVPlanar(SDL_Texture * texture, const SDL_Rect * rect,
@@ -1666,6 +2385,7 @@ int SDL_UpdateYUVTexture(SDL_Texture * texture, const SDL_Rect * rect,
             if (FlushRenderCommandsIfTextureNeeded(texture) < 0) {
                 return -1;
             }
+            CountTextureUpload(texture, rect);
             return renderer->UpdateTextureYUV(renderer, texture, rect, Yplane, Ypitch, Uplane, Upitch, Vplane, Vpitch);
         } else {
             return SDL_Unsupported();
@@ -1733,6 +2453,7 @@ SDL_LockTexture(SDL_Texture * texture, const SDL_Rect * rect,
         if (FlushRenderCommandsIfTextureNeeded(texture) < 0) {
             return -1;
         }
+        texture->locked_rect = *rect;  /* counted as an upload when unlocked */
         return renderer->LockTexture(renderer, texture, rect, pixels, pitch);
     }
 }
@@ -1834,6 +2555,7 @@ SDL_UnlockTexture(SDL_Texture * texture)
         SDL_UnlockTextureNative(texture);
     } else {
         SDL_Renderer *renderer = texture->renderer;
+        CountTextureUpload(texture, &texture->locked_rect);
         renderer->UnlockTexture(renderer, texture);
     }
 
@@ -1861,7 +2583,7 @@ SDL_SetRenderTarget(SDL_Renderer *renderer, SDL_Texture *texture)
         return 0;
     }
 
-    FlushRenderCommands(renderer);  /* time to send everything to the GPU! */
+    FlushRenderCommands(renderer, SDL_RENDERFLUSH_TARGET);  /* time to send everything to the GPU! */
 
     /* texture == NULL is valid and means reset the target to the window */
     if (texture) {
@@ -2286,9 +3008,14 @@ RenderDrawPointsWithRects(SDL_Renderer * renderer,
 {
     int retval = -1;
     SDL_bool isstack;
-    SDL_FRect *frects = SDL_small_alloc(SDL_FRect, count, &isstack);
+    SDL_FRect *frects;
     int i;
 
+    if (count < 1) {
+        return 0;
+    }
+
+    frects = SDL_small_alloc(SDL_FRect, count, &isstack);
     if (!frects) {
         return SDL_OutOfMemory();
     }
@@ -2356,9 +3083,14 @@ RenderDrawPointsWithRectsF(SDL_Renderer * renderer,
 {
     int retval = -1;
     SDL_bool isstack;
-    SDL_FRect *frects = SDL_small_alloc(SDL_FRect, count, &isstack);
+    SDL_FRect *frects;
     int i;
 
+    if (count < 1) {
+        return 0;
+    }
+
+    frects = SDL_small_alloc(SDL_FRect, count, &isstack);
     if (!frects) {
         return SDL_OutOfMemory();
     }
@@ -2487,7 +3219,9 @@ RenderDrawLinesWithRects(SDL_Renderer * renderer,
         }
     }
 
-    retval += QueueCmdFillRects(renderer, frects, nrects);
+    if (nrects > 0) {
+        retval += QueueCmdFillRects(renderer, frects, nrects);
+    }
 
     SDL_small_free(frects, isstack);
 
@@ -2542,7 +3276,9 @@ RenderDrawLinesWithRectsF(SDL_Renderer * renderer,
         }
     }
 
-    retval += QueueCmdFillRects(renderer, frects, nrects);
+    if (nrects > 0) {
+        retval += QueueCmdFillRects(renderer, frects, nrects);
+    }
 
     SDL_small_free(frects, isstack);
 
@@ -3104,6 +3840,287 @@ SDL_RenderCopyExF(SDL_Renderer * renderer, SDL_Texture * texture,
     return retval < 0 ? retval : FlushRenderCommandsIfNotBatching(renderer);
 }
 
+int
+SDL_RenderCopyBatch(SDL_Renderer * renderer, SDL_Texture * texture,
+                    const SDL_Rect * srcrects, const SDL_FRect * dstrects,
+                    const SDL_Color * colors, const double * angles,
+                    const SDL_RendererFlip * flips, int count)
+{
+    SDL_RenderCopyInstance *instance;
+    SDL_Rect texture_rect;
+    SDL_FRect viewport;
+    SDL_Rect r;
+    int i, num_instances, retval;
+
+    CHECK_RENDERER_MAGIC(renderer, -1);
+    CHECK_TEXTURE_MAGIC(texture, -1);
+
+    if (renderer != texture->renderer) {
+        return SDL_SetError("Texture was not created with this renderer");
+    }
+    if (!dstrects) {
+        return SDL_InvalidParamError("SDL_RenderCopyBatch(): dstrects");
+    }
+    if (count < 1) {
+        return 0;
+    }
+    if ((angles || flips) && !renderer->QueueCopyBatch && !renderer->QueueCopyEx) {
+        return SDL_SetError("Renderer does not support RenderCopyEx");
+    }
+
+    /* Don't draw while we're hidden */
+    if (renderer->hidden) {
+        return 0;
+    }
+
+    if (count > renderer->copy_instances_allocation) {
+        int allocation = renderer->copy_instances_allocation ? renderer->copy_instances_allocation : 64;
+        SDL_RenderCopyInstance *instances;
+        while (allocation < count) {
+            allocation *= 2;
+        }
+        instances = (SDL_RenderCopyInstance *) SDL_realloc(renderer->copy_instances, allocation * sizeof (*instances));
+        if (!instances) {
+            return SDL_OutOfMemory();
+        }
+        renderer->copy_instances = instances;
+        renderer->copy_instances_allocation = allocation;
+    }
+
+    texture_rect.x = 0;
+    texture_rect.y = 0;
+    texture_rect.w = texture->w;
+    texture_rect.h = texture->h;
+
+    SDL_zero(r);
+    SDL_RenderGetViewport(renderer, &r);
+    viewport.x = 0.0f;
+    viewport.y = 0.0f;
+    viewport.w = (float) r.w;
+    viewport.h = (float) r.h;
+
+    if (texture->native) {
+        texture = texture->native;
+    }
+
+    instance = renderer->copy_instances;
+    for (i = 0; i < count; ++i) {
+        const SDL_FRect *dstrect = &dstrects[i];
+        const SDL_RendererFlip flip = flips ? flips[i] : SDL_FLIP_NONE;
+        double angle = angles ? angles[i] : 0.0;
+        float x0, y0, x1, y1, cx, cy, c, s;
+        int j;
+
+        if (flip == SDL_FLIP_NONE && (int)(angle/360) == angle/360) {
+            /* Like SDL_RenderCopyF(), drop copies that are entirely outside the viewport */
+            if (!SDL_HasIntersectionF(dstrect, &viewport)) {
+                continue;
+            }
+            angle = 0.0;
+        }
+
+        if (srcrects) {
+            if (!SDL_IntersectRect(&srcrects[i], &texture_rect, &instance->srcrect)) {
+                continue;
+            }
+        } else {
+            instance->srcrect = texture_rect;
+        }
+
+        instance->dstrect.x = dstrect->x * renderer->scale.x;
+        instance->dstrect.y = dstrect->y * renderer->scale.y;
+        instance->dstrect.w = dstrect->w * renderer->scale.x;
+        instance->dstrect.h = dstrect->h * renderer->scale.y;
+        instance->angle = angle;
+        instance->center.x = instance->dstrect.w / 2.0f;
+        instance->center.y = instance->dstrect.h / 2.0f;
+        instance->flip = flip;
+
+        if (colors) {
+            instance->r = colors[i].r;
+            instance->g = colors[i].g;
+            instance->b = colors[i].b;
+            instance->a = colors[i].a;
+        } else {
+            instance->r = texture->r;
+            instance->g = texture->g;
+            instance->b = texture->b;
+            instance->a = texture->a;
+        }
+
+        /* The corners relative to the center, flipped if needed */
+        cx = instance->center.x;
+        cy = instance->center.y;
+        x0 = (flip & SDL_FLIP_HORIZONTAL) ? cx : -cx;
+        x1 = -x0;
+        y0 = (flip & SDL_FLIP_VERTICAL) ? cy : -cy;
+        y1 = -y0;
+        instance->corners[0].x = x0;
+        instance->corners[0].y = y0;
+        instance->corners[1].x = x1;
+        instance->corners[1].y = y0;
+        instance->corners[2].x = x0;
+        instance->corners[2].y = y1;
+        instance->corners[3].x = x1;
+        instance->corners[3].y = y1;
+
+        if (angle != 0.0) {
+            const double radians = angle * M_PI / 180.0;
+            c = (float) SDL_cos(radians);
+            s = (float) SDL_sin(radians);
+        } else {
+            c = 1.0f;
+            s = 0.0f;
+        }
+        cx += instance->dstrect.x;
+        cy += instance->dstrect.y;
+        for (j = 0; j < 4; ++j) {
+            const float x = instance->corners[j].x;
+            const float y = instance->corners[j].y;
+            instance->corners[j].x = cx + x * c - y * s;
+            instance->corners[j].y = cy + x * s + y * c;
+        }
+        ++instance;
+    }
+
+    num_instances = (int) (instance - renderer->copy_instances);
+    if (num_instances == 0) {
+        return 0;
+    }
+
+    texture->last_command_generation = renderer->render_command_generation;
+
+    retval = QueueCmdCopyBatch(renderer, texture, renderer->copy_instances, num_instances);
+    return retval < 0 ? retval : FlushRenderCommandsIfNotBatching(renderer);
+}
+
+int
+SDL_RenderGeometry(SDL_Renderer * renderer, SDL_Texture * texture,
+                   const SDL_Vertex * vertices, int num_vertices,
+                   const int * indices, int num_indices)
+{
+    SDL_Vertex *vertex;
+    SDL_Rect r;
+    float w, h;
+    Uint8 modr = 0xFF, modg = 0xFF, modb = 0xFF, moda = 0xFF;
+    SDL_bool modulate = SDL_FALSE;
+    int i, j, count, num_queued, retval;
+
+    CHECK_RENDERER_MAGIC(renderer, -1);
+
+    if (texture) {
+        CHECK_TEXTURE_MAGIC(texture, -1);
+
+        if (renderer != texture->renderer) {
+            return SDL_SetError("Texture was not created with this renderer");
+        }
+    }
+    if (!vertices) {
+        return SDL_InvalidParamError("vertices");
+    }
+    if (num_vertices < 0) {
+        return SDL_InvalidParamError("num_vertices");
+    }
+    if (indices) {
+        if (num_indices < 0 || (num_indices % 3) != 0) {
+            return SDL_InvalidParamError("num_indices");
+        }
+        for (i = 0; i < num_indices; ++i) {
+            if (indices[i] < 0 || indices[i] >= num_vertices) {
+                return SDL_SetError("Vertex index %d is out of range", indices[i]);
+            }
+        }
+        count = num_indices;
+    } else {
+        if ((num_vertices % 3) != 0) {
+            return SDL_InvalidParamError("num_vertices");
+        }
+        count = num_vertices;
+    }
+    if (count == 0) {
+        return 0;
+    }
+    if (!renderer->QueueGeometry) {
+        return SDL_Unsupported();
+    }
+
+    /* Don't draw while we're hidden */
+    if (renderer->hidden) {
+        return 0;
+    }
+
+    if (count > renderer->geometry_vertices_allocation) {
+        int allocation = renderer->geometry_vertices_allocation ? renderer->geometry_vertices_allocation : 192;
+        SDL_Vertex *ptr;
+        while (allocation < count) {
+            allocation *= 2;
+        }
+        ptr = (SDL_Vertex *) SDL_realloc(renderer->geometry_vertices, allocation * sizeof (*ptr));
+        if (!ptr) {
+            return SDL_OutOfMemory();
+        }
+        renderer->geometry_vertices = ptr;
+        renderer->geometry_vertices_allocation = allocation;
+    }
+
+    if (texture) {
+        modr = texture->r;
+        modg = texture->g;
+        modb = texture->b;
+        moda = texture->a;
+        modulate = ((modr & modg & modb & moda) != 0xFF);
+        if (texture->native) {
+            texture = texture->native;
+        }
+    }
+
+    SDL_zero(r);
+    SDL_RenderGetViewport(renderer, &r);
+    w = (float) r.w;
+    h = (float) r.h;
+
+    vertex = renderer->geometry_vertices;
+    for (i = 0; i < count; i += 3) {
+        const SDL_Vertex *v[3];
+        for (j = 0; j < 3; ++j) {
+            v[j] = &vertices[indices ? indices[i + j] : (i + j)];
+        }
+
+        /* Like the other draws, drop triangles that are entirely outside the viewport */
+        if ((v[0]->position.x < 0.0f && v[1]->position.x < 0.0f && v[2]->position.x < 0.0f) ||
+            (v[0]->position.y < 0.0f && v[1]->position.y < 0.0f && v[2]->position.y < 0.0f) ||
+            (v[0]->position.x > w && v[1]->position.x > w && v[2]->position.x > w) ||
+            (v[0]->position.y > h && v[1]->position.y > h && v[2]->position.y > h)) {
+            continue;
+        }
+
+        for (j = 0; j < 3; ++j, ++vertex) {
+            vertex->position.x = v[j]->position.x * renderer->scale.x;
+            vertex->position.y = v[j]->position.y * renderer->scale.y;
+            vertex->color = v[j]->color;
+            if (modulate) {
+                vertex->color.r = (Uint8) ((vertex->color.r * modr) / 255);
+                vertex->color.g = (Uint8) ((vertex->color.g * modg) / 255);
+                vertex->color.b = (Uint8) ((vertex->color.b * modb) / 255);
+                vertex->color.a = (Uint8) ((vertex->color.a * moda) / 255);
+            }
+            vertex->tex_coord = v[j]->tex_coord;
+        }
+    }
+
+    num_queued = (int) (vertex - renderer->geometry_vertices);
+    if (num_queued == 0) {
+        return 0;
+    }
+
+    if (texture) {
+        texture->last_command_generation = renderer->render_command_generation;
+    }
+
+    retval = QueueCmdGeometry(renderer, texture, renderer->geometry_vertices, num_queued);
+    return retval < 0 ? retval : FlushRenderCommandsIfNotBatching(renderer);
+}
+
 int
 SDL_RenderReadPixels(SDL_Renderer * renderer, const SDL_Rect * rect,
                      Uint32 format, void * pixels, int pitch)
@@ -3116,7 +4133,7 @@ SDL_RenderReadPixels(SDL_Renderer * renderer, const SDL_Rect * rect,
         return SDL_Unsupported();
     }
 
-    FlushRenderCommands(renderer);  /* we need to render before we read the results. */
+    FlushRenderCommands(renderer, SDL_RENDERFLUSH_READ_PIXELS);  /* we need to render before we read the results. */
 
     if (!format) {
         format = SDL_GetWindowPixelFormat(renderer->window);
@@ -3148,7 +4165,12 @@ SDL_RenderPresent(SDL_Renderer * renderer)
 {
     CHECK_RENDERER_MAGIC(renderer, );
 
-    FlushRenderCommands(renderer);  /* time to send everything to the GPU! */
+    FlushRenderCommands(renderer, SDL_RENDERFLUSH_PRESENT);  /* time to send everything to the GPU! */
+
+    renderer->stats.run_time_us = (Uint32) (((double) renderer->run_time * 1000000.0) / SDL_GetPerformanceFrequency());
+    renderer->last_stats = renderer->stats;
+    SDL_zero(renderer->stats);
+    renderer->run_time = 0;
 
     /* Don't present while we're hidden */
     if (renderer->hidden) {
@@ -3197,6 +4219,9 @@ SDL_DestroyTexture(SDL_Texture * texture)
     SDL_FreeSurface(texture->locked_surface);
     texture->locked_surface = NULL;
 
+    SDL_FreeSurface(texture->surface);
+    texture->surface = NULL;
+
     SDL_free(texture);
 }
 
@@ -3227,6 +4252,12 @@ SDL_DestroyRenderer(SDL_Renderer * renderer)
     }
 
     SDL_free(renderer->vertex_data);
+    SDL_free(renderer->copy_instances);
+    SDL_free(renderer->geometry_vertices);
+    SDL_free(renderer->optimize_list);
+    SDL_free(renderer->optimize_vertex_data);
+
+    SDL_DestroyRenderReadbacks(renderer);
 
     /* Free existing textures for this renderer */
     while (renderer->textures) {
@@ -3288,7 +4319,7 @@ SDL_RenderGetMetalLayer(SDL_Renderer * renderer)
     CHECK_RENDERER_MAGIC(renderer, NULL);
 
     if (renderer->GetMetalLayer) {
-        FlushRenderCommands(renderer);  /* in case the app is going to mess with it. */
+        FlushRenderCommands(renderer, SDL_RENDERFLUSH_EXPLICIT);  /* in case the app is going to mess with it. */
         return renderer->GetMetalLayer(renderer);
     }
     return NULL;
@@ -3300,7 +4331,7 @@ SDL_RenderGetMetalCommandEncoder(SDL_Renderer * renderer)
     CHECK_RENDERER_MAGIC(renderer, NULL);
 
     if (renderer->GetMetalCommandEncoder) {
-        FlushRenderCommands(renderer);  /* in case the app is going to mess with it. */
+        FlushRenderCommands(renderer, SDL_RENDERFLUSH_EXPLICIT);  /* in case the app is going to mess with it. */
         return renderer->GetMetalCommandEncoder(renderer);
     }
     return NULL;
@@ -55,6 +55,10 @@ struct SDL_Texture
     SDL_Rect locked_rect;
     SDL_Surface *locked_surface;  /**< Locked region exposed as a SDL surface */
 
+    /* Support for textures created with SDL_CreateSurfaceTexture() */
+    SDL_Surface *surface;       /**< The surface the texture was created from */
+    SDL_bool shares_surface;    /**< SDL_TRUE if the texture uses the surface's pixels */
+
     Uint32 last_command_generation; /* last command queue generation this texture was in. */
 
     void *driverdata;           /**< Driver specific texture representation */
@@ -74,7 +78,9 @@ typedef enum
     SDL_RENDERCMD_DRAW_LINES,
     SDL_RENDERCMD_FILL_RECTS,
     SDL_RENDERCMD_COPY,
-    SDL_RENDERCMD_COPY_EX
+    SDL_RENDERCMD_COPY_EX,
+    SDL_RENDERCMD_COPY_BATCH,
+    SDL_RENDERCMD_GEOMETRY
 } SDL_RenderCommandType;
 
 typedef struct SDL_RenderCommand
@@ -95,6 +101,10 @@ typedef struct SDL_RenderCommand
             Uint8 r, g, b, a;
             SDL_BlendMode blend;
             SDL_Texture *texture;
+            size_t vertsize;  /* filled in when optimizing commands */
+            size_t alignment; /* of the vertex data, kept when it's moved */
+            SDL_bool bounded;
+            SDL_FRect bounds;
         } draw;
         struct {
             size_t first;
@@ -104,6 +114,31 @@ typedef struct SDL_RenderCommand
     struct SDL_RenderCommand *next;
 } SDL_RenderCommand;
 
+/* One copy of a batch, already clipped to the texture and scaled to the output */
+typedef struct SDL_RenderCopyInstance
+{
+    SDL_Rect srcrect;
+    SDL_FRect dstrect;
+    SDL_FPoint corners[4];  /* dstrect rotated and flipped: top left, top right, bottom left, bottom right */
+    double angle;
+    SDL_FPoint center;
+    SDL_RendererFlip flip;
+    Uint8 r, g, b, a;
+} SDL_RenderCopyInstance;
+
+
+/* Pixels read from the rendering target for an asynchronous readback */
+typedef struct SDL_ReadbackBuffer
+{
+    SDL_Rect rect;              /**< The area of the target to read */
+    Uint32 format;              /**< The format of the pixels, set by StartReadback() */
+    void *pixels;               /**< The pixels, in SDL_ReallocReadbackPixels() memory */
+    int pitch;
+    size_t allocation;
+    SDL_bool bottom_up;         /**< The pixels are stored bottom row first */
+    SDL_bool pending;           /**< FinishReadback() still has to fill in the pixels */
+    void *driverdata;           /**< Driver specific readback data */
+} SDL_ReadbackBuffer;
 
 /* Define the SDL renderer structure */
 struct SDL_Renderer
@@ -114,6 +149,7 @@ struct SDL_Renderer
     int (*GetOutputSize) (SDL_Renderer * renderer, int *w, int *h);
     SDL_bool (*SupportsBlendMode)(SDL_Renderer * renderer, SDL_BlendMode blendMode);
     int (*CreateTexture) (SDL_Renderer * renderer, SDL_Texture * texture);
+    int (*CreateSurfaceTexture) (SDL_Renderer * renderer, SDL_Texture * texture, SDL_Surface * surface);
     int (*QueueSetViewport) (SDL_Renderer * renderer, SDL_RenderCommand *cmd);
     int (*QueueSetDrawColor) (SDL_Renderer * renderer, SDL_RenderCommand *cmd);
     int (*QueueDrawPoints) (SDL_Renderer * renderer, SDL_RenderCommand *cmd, const SDL_FPoint * points,
@@ -127,6 +163,11 @@ struct SDL_Renderer
     int (*QueueCopyEx) (SDL_Renderer * renderer, SDL_RenderCommand *cmd, SDL_Texture * texture,
                         const SDL_Rect * srcquad, const SDL_FRect * dstrect,
                         const double angle, const SDL_FPoint *center, const SDL_RendererFlip flip);
+    int (*QueueCopyBatch) (SDL_Renderer * renderer, SDL_RenderCommand *cmd, SDL_Texture * texture,
+                           const SDL_RenderCopyInstance * instances, int count);
+    /* The vertices are a list of triangles, scaled and with the texture modulation applied */
+    int (*QueueGeometry) (SDL_Renderer * renderer, SDL_RenderCommand *cmd, SDL_Texture * texture,
+                          const SDL_Vertex * vertices, int count);
     int (*RunCommandQueue) (SDL_Renderer * renderer, SDL_RenderCommand *cmd, void *vertices, size_t vertsize);
     int (*UpdateTexture) (SDL_Renderer * renderer, SDL_Texture * texture,
                           const SDL_Rect * rect, const void *pixels,
@@ -143,6 +184,9 @@ struct SDL_Renderer
     int (*SetRenderTarget) (SDL_Renderer * renderer, SDL_Texture * texture);
     int (*RenderReadPixels) (SDL_Renderer * renderer, const SDL_Rect * rect,
                              Uint32 format, void * pixels, int pitch);
+    int (*StartReadback) (SDL_Renderer * renderer, SDL_ReadbackBuffer * buffer);
+    int (*FinishReadback) (SDL_Renderer * renderer, SDL_ReadbackBuffer * buffer);
+    void (*DestroyReadback) (SDL_Renderer * renderer, SDL_ReadbackBuffer * buffer);
     void (*RenderPresent) (SDL_Renderer * renderer);
     void (*DestroyTexture) (SDL_Renderer * renderer, SDL_Texture * texture);
 
@@ -199,6 +243,22 @@ struct SDL_Renderer
 
     SDL_bool always_batch;
     SDL_bool batching;
+
+    /* The draw commands the backend can run with the items of adjacent
+       commands put together, (1 << SDL_RenderCommandType) for each.
+       Only draw commands may have vertex data for these to be merged,
+       the optimizer moves it and queues draw colors again as needed. */
+    Uint32 mergeable_commands;
+    SDL_bool optimize_commands;
+    SDL_RenderCommand **optimize_list;
+    int optimize_list_allocation;
+    void *optimize_vertex_data;
+    size_t optimize_vertex_data_allocation;
+
+    SDL_RenderStats stats;
+    SDL_RenderStats last_stats;
+    Uint64 run_time;  /* performance counter ticks spent in RunCommandQueue this frame */
+
     SDL_RenderCommand *render_commands;
     SDL_RenderCommand *render_commands_tail;
     SDL_RenderCommand *render_commands_pool;
@@ -214,6 +274,15 @@ struct SDL_Renderer
     void *vertex_data;
     size_t vertex_data_used;
     size_t vertex_data_allocation;
+    size_t vertex_data_alignment;   /* largest asked for since the last draw was queued */
+
+    SDL_RenderCopyInstance *copy_instances;
+    int copy_instances_allocation;
+
+    SDL_Vertex *geometry_vertices;
+    int geometry_vertices_allocation;
+
+    SDL_RenderReadback *readbacks;
 
     void *driverdata;
 };
@@ -251,6 +320,15 @@ extern SDL_BlendOperation SDL_GetBlendModeAlphaOperation(SDL_BlendMode blendMode
    the next call, because it might be in an array that gets realloc()'d. */
 extern void *SDL_AllocateRenderVertices(SDL_Renderer *renderer, const size_t numbytes, const size_t alignment, size_t *offset);
 
+/* Render everything queued before reading from the rendering target */
+extern int SDL_FlushRenderCommandsForReadPixels(SDL_Renderer *renderer);
+
+/* Readback drivers call this to make room for the pixels of a readback buffer */
+extern int SDL_ReallocReadbackPixels(SDL_ReadbackBuffer *buffer, int pitch);
+
+/* Destroy a renderer's readback rings along with it */
+extern void SDL_DestroyRenderReadbacks(SDL_Renderer *renderer);
+
 #endif /* SDL_sysrender_h_ */
 
 /* vi: set ts=4 sw=4 expandtab: */
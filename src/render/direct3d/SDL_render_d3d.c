@@ -1431,6 +1431,8 @@ D3D_RunCommandQueue(SDL_Renderer * renderer, SDL_RenderCommand *cmd, void *verti
                 break;
             }
 
+            case SDL_RENDERCMD_COPY_BATCH:  /* not queued, this backend has no QueueCopyBatch */
+            case SDL_RENDERCMD_GEOMETRY:  /* not queued, this backend has no QueueGeometry */
             case SDL_RENDERCMD_NO_OP:
                 break;
         }
@@ -2310,6 +2310,8 @@ D3D11_RunCommandQueue(SDL_Renderer * renderer, SDL_RenderCommand *cmd, void *ver
                 break;
             }
 
+            case SDL_RENDERCMD_COPY_BATCH:  /* not queued, this backend has no QueueCopyBatch */
+            case SDL_RENDERCMD_GEOMETRY:  /* not queued, this backend has no QueueGeometry */
             case SDL_RENDERCMD_NO_OP:
                 break;
         }
@@ -1456,6 +1456,8 @@ METAL_RunCommandQueue(SDL_Renderer * renderer, SDL_RenderCommand *cmd, void *ver
                 break;
             }
 
+            case SDL_RENDERCMD_COPY_BATCH:  /* not queued, this backend has no QueueCopyBatch */
+            case SDL_RENDERCMD_GEOMETRY:  /* not queued, this backend has no QueueGeometry */
             case SDL_RENDERCMD_NO_OP:
                 break;
         }
@@ -113,6 +113,14 @@ typedef struct
     PFNGLBINDFRAMEBUFFEREXTPROC glBindFramebufferEXT;
     PFNGLCHECKFRAMEBUFFERSTATUSEXTPROC glCheckFramebufferStatusEXT;
 
+    /* Pixel buffer object support, for asynchronous readback */
+    PFNGLGENBUFFERSARBPROC glGenBuffersARB;
+    PFNGLDELETEBUFFERSARBPROC glDeleteBuffersARB;
+    PFNGLBINDBUFFERARBPROC glBindBufferARB;
+    PFNGLBUFFERDATAARBPROC glBufferDataARB;
+    PFNGLMAPBUFFERARBPROC glMapBufferARB;
+    PFNGLUNMAPBUFFERARBPROC glUnmapBufferARB;
+
     /* Shader support */
     GL_ShaderContext *shaders;
 
@@ -139,6 +147,11 @@ typedef struct
     GL_FBOList *fbo;
 } GL_TextureData;
 
+typedef struct
+{
+    GLuint PBO;
+} GL_ReadbackData;
+
 SDL_FORCE_INLINE const char*
 GL_TranslateError (GLenum error)
 {
@@ -1042,6 +1055,78 @@ GL_QueueCopyEx(SDL_Renderer * renderer, SDL_RenderCommand *cmd, SDL_Texture * te
     return 0;
 }
 
+typedef struct GL_CopyBatchData
+{
+    GLfloat corners[8];
+    GLfloat minu, maxu, minv, maxv;
+    Uint32 color;
+} GL_CopyBatchData;
+
+static int
+GL_QueueCopyBatch(SDL_Renderer * renderer, SDL_RenderCommand *cmd, SDL_Texture * texture,
+                  const SDL_RenderCopyInstance * instances, int count)
+{
+    GL_TextureData *texturedata = (GL_TextureData *) texture->driverdata;
+    const GLfloat texw = texturedata->texw / texture->w;
+    const GLfloat texh = texturedata->texh / texture->h;
+    GL_CopyBatchData *verts = (GL_CopyBatchData *) SDL_AllocateRenderVertices(renderer, count * sizeof (GL_CopyBatchData), 0, &cmd->data.draw.first);
+    int i, j;
+
+    if (!verts) {
+        return -1;
+    }
+
+    cmd->data.draw.count = count;
+
+    for (i = 0; i < count; i++, verts++, instances++) {
+        const SDL_Rect *srcrect = &instances->srcrect;
+        for (j = 0; j < 4; j++) {
+            verts->corners[j * 2] = instances->corners[j].x;
+            verts->corners[j * 2 + 1] = instances->corners[j].y;
+        }
+        verts->minu = srcrect->x * texw;
+        verts->maxu = (srcrect->x + srcrect->w) * texw;
+        verts->minv = srcrect->y * texh;
+        verts->maxv = (srcrect->y + srcrect->h) * texh;
+        verts->color = (((Uint32) instances->a << 24) | ((Uint32) instances->r << 16) | ((Uint32) instances->g << 8) | instances->b);
+    }
+    return 0;
+}
+
+typedef struct
+{
+    GLfloat x, y, u, v;
+    Uint32 color;
+} GL_GeometryVertex;
+
+static int
+GL_QueueGeometry(SDL_Renderer * renderer, SDL_RenderCommand *cmd, SDL_Texture * texture,
+                 const SDL_Vertex * vertices, int count)
+{
+    const GL_TextureData *texturedata = texture ? (GL_TextureData *) texture->driverdata : NULL;
+    const GLfloat texw = texturedata ? texturedata->texw : 0.0f;
+    const GLfloat texh = texturedata ? texturedata->texh : 0.0f;
+    GL_GeometryVertex *verts = (GL_GeometryVertex *) SDL_AllocateRenderVertices(renderer, count * sizeof (GL_GeometryVertex), 0, &cmd->data.draw.first);
+    int i;
+
+    if (!verts) {
+        return -1;
+    }
+
+    cmd->data.draw.count = count;
+
+    /* Rectangle textures are addressed in texels, and textures may be padded to a power of two */
+    for (i = 0; i < count; i++, verts++, vertices++) {
+        const SDL_Color *color = &vertices->color;
+        verts->x = vertices->position.x;
+        verts->y = vertices->position.y;
+        verts->u = vertices->tex_coord.x * texw;
+        verts->v = vertices->tex_coord.y * texh;
+        verts->color = (((Uint32) color->a << 24) | ((Uint32) color->r << 16) | ((Uint32) color->g << 8) | color->b);
+    }
+    return 0;
+}
+
 static void
 SetDrawState(GL_RenderData *data, const SDL_RenderCommand *cmd, const GL_Shader shader)
 {
@@ -1305,25 +1390,29 @@ GL_RunCommandQueue(SDL_Renderer * renderer, SDL_RenderCommand *cmd, void *vertic
 
             case SDL_RENDERCMD_COPY: {
                 const GLfloat *verts = (GLfloat *) (((Uint8 *) vertices) + cmd->data.draw.first);
-                const GLfloat minx = verts[0];
-                const GLfloat miny = verts[1];
-                const GLfloat maxx = verts[2];
-                const GLfloat maxy = verts[3];
-                const GLfloat minu = verts[4];
-                const GLfloat maxu = verts[5];
-                const GLfloat minv = verts[6];
-                const GLfloat maxv = verts[7];
+                const size_t count = cmd->data.draw.count;
                 SetCopyState(data, cmd);
-                data->glBegin(GL_TRIANGLE_STRIP);
-                data->glTexCoord2f(minu, minv);
-                data->glVertex2f(minx, miny);
-                data->glTexCoord2f(maxu, minv);
-                data->glVertex2f(maxx, miny);
-                data->glTexCoord2f(minu, maxv);
-                data->glVertex2f(minx, maxy);
-                data->glTexCoord2f(maxu, maxv);
-                data->glVertex2f(maxx, maxy);
-                data->glEnd();
+                /* There's more than one copy if adjacent copies were merged */
+                for (i = 0; i < count; ++i, verts += 8) {
+                    const GLfloat minx = verts[0];
+                    const GLfloat miny = verts[1];
+                    const GLfloat maxx = verts[2];
+                    const GLfloat maxy = verts[3];
+                    const GLfloat minu = verts[4];
+                    const GLfloat maxu = verts[5];
+                    const GLfloat minv = verts[6];
+                    const GLfloat maxv = verts[7];
+                    data->glBegin(GL_TRIANGLE_STRIP);
+                    data->glTexCoord2f(minu, minv);
+                    data->glVertex2f(minx, miny);
+                    data->glTexCoord2f(maxu, minv);
+                    data->glVertex2f(maxx, miny);
+                    data->glTexCoord2f(minu, maxv);
+                    data->glVertex2f(minx, maxy);
+                    data->glTexCoord2f(maxu, maxv);
+                    data->glVertex2f(maxx, maxy);
+                    data->glEnd();
+                }
                 break;
             }
 
@@ -1360,6 +1449,84 @@ GL_RunCommandQueue(SDL_Renderer * renderer, SDL_RenderCommand *cmd, void *vertic
                 break;
             }
 
+            case SDL_RENDERCMD_COPY_BATCH: {
+                const GL_CopyBatchData *verts = (GL_CopyBatchData *) (((Uint8 *) vertices) + cmd->data.draw.first);
+                const size_t count = cmd->data.draw.count;
+                const Uint32 color = data->drawstate.color;
+                SetCopyState(data, cmd);
+
+                /* The corners are already rotated, so the whole batch is one list of triangles */
+                data->glBegin(GL_TRIANGLES);
+                for (i = 0; i < count; ++i, ++verts) {
+                    const GLfloat *corners = verts->corners;
+                    if (verts->color != data->drawstate.color) {
+                        data->glColor4f((GLfloat) ((verts->color >> 16) & 0xFF) * inv255f,
+                                        (GLfloat) ((verts->color >> 8) & 0xFF) * inv255f,
+                                        (GLfloat) (verts->color & 0xFF) * inv255f,
+                                        (GLfloat) (verts->color >> 24) * inv255f);
+                        data->drawstate.color = verts->color;
+                    }
+                    data->glTexCoord2f(verts->minu, verts->minv);
+                    data->glVertex2f(corners[0], corners[1]);
+                    data->glTexCoord2f(verts->maxu, verts->minv);
+                    data->glVertex2f(corners[2], corners[3]);
+                    data->glTexCoord2f(verts->minu, verts->maxv);
+                    data->glVertex2f(corners[4], corners[5]);
+                    data->glTexCoord2f(verts->minu, verts->maxv);
+                    data->glVertex2f(corners[4], corners[5]);
+                    data->glTexCoord2f(verts->maxu, verts->minv);
+                    data->glVertex2f(corners[2], corners[3]);
+                    data->glTexCoord2f(verts->maxu, verts->maxv);
+                    data->glVertex2f(corners[6], corners[7]);
+                }
+                data->glEnd();
+
+                /* Later commands expect the color that was queued before this one */
+                if (data->drawstate.color != color) {
+                    data->glColor4f((GLfloat) ((color >> 16) & 0xFF) * inv255f,
+                                    (GLfloat) ((color >> 8) & 0xFF) * inv255f,
+                                    (GLfloat) (color & 0xFF) * inv255f,
+                                    (GLfloat) (color >> 24) * inv255f);
+                    data->drawstate.color = color;
+                }
+                break;
+            }
+
+            case SDL_RENDERCMD_GEOMETRY: {
+                const GL_GeometryVertex *verts = (GL_GeometryVertex *) (((Uint8 *) vertices) + cmd->data.draw.first);
+                const size_t count = cmd->data.draw.count;
+                const Uint32 color = data->drawstate.color;
+                if (cmd->data.draw.texture) {
+                    SetCopyState(data, cmd);
+                } else {
+                    SetDrawState(data, cmd, SHADER_SOLID);
+                }
+
+                data->glBegin(GL_TRIANGLES);
+                for (i = 0; i < count; ++i, ++verts) {
+                    if (verts->color != data->drawstate.color) {
+                        data->glColor4f((GLfloat) ((verts->color >> 16) & 0xFF) * inv255f,
+                                        (GLfloat) ((verts->color >> 8) & 0xFF) * inv255f,
+                                        (GLfloat) (verts->color & 0xFF) * inv255f,
+                                        (GLfloat) (verts->color >> 24) * inv255f);
+                        data->drawstate.color = verts->color;
+                    }
+                    data->glTexCoord2f(verts->u, verts->v);
+                    data->glVertex2f(verts->x, verts->y);
+                }
+                data->glEnd();
+
+                /* Later commands expect the color that was queued before this one */
+                if (data->drawstate.color != color) {
+                    data->glColor4f((GLfloat) ((color >> 16) & 0xFF) * inv255f,
+                                    (GLfloat) ((color >> 8) & 0xFF) * inv255f,
+                                    (GLfloat) (color & 0xFF) * inv255f,
+                                    (GLfloat) (color >> 24) * inv255f);
+                    data->drawstate.color = color;
+                }
+                break;
+            }
+
             case SDL_RENDERCMD_NO_OP:
                 break;
         }
@@ -1441,6 +1608,104 @@ GL_RenderReadPixels(SDL_Renderer * renderer, const SDL_Rect * rect,
     return status;
 }
 
+static int
+GL_StartReadback(SDL_Renderer * renderer, SDL_ReadbackBuffer * buffer)
+{
+    GL_RenderData *data = (GL_RenderData *) renderer->driverdata;
+    GL_ReadbackData *readbackdata = (GL_ReadbackData *) buffer->driverdata;
+    Uint32 temp_format = renderer->target ? renderer->target->format : SDL_PIXELFORMAT_ARGB8888;
+    const SDL_Rect *rect = &buffer->rect;
+    GLint internalFormat;
+    GLenum format, type;
+    int w, h;
+
+    GL_ActivateRenderer(renderer);
+
+    if (!convert_format(data, temp_format, &internalFormat, &format, &type)) {
+        return SDL_SetError("Texture format %s not supported by OpenGL",
+                            SDL_GetPixelFormatName(temp_format));
+    }
+
+    if (!readbackdata) {
+        readbackdata = (GL_ReadbackData *) SDL_calloc(1, sizeof(*readbackdata));
+        if (!readbackdata) {
+            return SDL_OutOfMemory();
+        }
+        data->glGenBuffersARB(1, &readbackdata->PBO);
+        buffer->driverdata = readbackdata;
+    }
+
+    SDL_GetRendererOutputSize(renderer, &w, &h);
+
+    /* Read into the pixel buffer object, which returns without waiting for the GPU */
+    data->glBindBufferARB(GL_PIXEL_PACK_BUFFER_ARB, readbackdata->PBO);
+    data->glBufferDataARB(GL_PIXEL_PACK_BUFFER_ARB,
+                          (GLsizeiptrARB) rect->w * rect->h * SDL_BYTESPERPIXEL(temp_format),
+                          NULL, GL_STREAM_READ_ARB);
+    data->glPixelStorei(GL_PACK_ALIGNMENT, 1);
+    data->glPixelStorei(GL_PACK_ROW_LENGTH, rect->w);
+    data->glReadPixels(rect->x, renderer->target ? rect->y : (h-rect->y)-rect->h,
+                       rect->w, rect->h, format, type, NULL);
+    data->glBindBufferARB(GL_PIXEL_PACK_BUFFER_ARB, 0);
+
+    if (GL_CheckError("glReadPixels()", renderer) < 0) {
+        return -1;
+    }
+
+    buffer->format = temp_format;
+    buffer->bottom_up = !renderer->target;
+    buffer->pending = SDL_TRUE;
+    return 0;
+}
+
+static int
+GL_FinishReadback(SDL_Renderer * renderer, SDL_ReadbackBuffer * buffer)
+{
+    GL_RenderData *data = (GL_RenderData *) renderer->driverdata;
+    GL_ReadbackData *readbackdata = (GL_ReadbackData *) buffer->driverdata;
+    const int pitch = buffer->rect.w * SDL_BYTESPERPIXEL(buffer->format);
+    const void *mapped;
+    int retval = 0;
+
+    GL_ActivateRenderer(renderer);
+
+    if (SDL_ReallocReadbackPixels(buffer, pitch) < 0) {
+        return -1;
+    }
+
+    data->glBindBufferARB(GL_PIXEL_PACK_BUFFER_ARB, readbackdata->PBO);
+    mapped = data->glMapBufferARB(GL_PIXEL_PACK_BUFFER_ARB, GL_READ_ONLY_ARB);
+    if (mapped) {
+        SDL_memcpy(buffer->pixels, mapped, (size_t) pitch * buffer->rect.h);
+        data->glUnmapBufferARB(GL_PIXEL_PACK_BUFFER_ARB);
+    } else {
+        retval = SDL_SetError("Couldn't map the readback pixel buffer");
+    }
+    data->glBindBufferARB(GL_PIXEL_PACK_BUFFER_ARB, 0);
+
+    if (GL_CheckError("glMapBufferARB()", renderer) < 0) {
+        return -1;
+    }
+    return retval;
+}
+
+static void
+GL_DestroyReadback(SDL_Renderer * renderer, SDL_ReadbackBuffer * buffer)
+{
+    GL_RenderData *data = (GL_RenderData *) renderer->driverdata;
+    GL_ReadbackData *readbackdata = (GL_ReadbackData *) buffer->driverdata;
+
+    if (!readbackdata) {
+        return;
+    }
+
+    GL_ActivateRenderer(renderer);
+
+    data->glDeleteBuffersARB(1, &readbackdata->PBO);
+    SDL_free(readbackdata);
+    buffer->driverdata = NULL;
+}
+
 static void
 GL_RenderPresent(SDL_Renderer * renderer)
 {
@@ -1632,6 +1897,11 @@ GL_CreateRenderer(SDL_Window * window, Uint32 flags)
     renderer->QueueFillRects = GL_QueueFillRects;
     renderer->QueueCopy = GL_QueueCopy;
     renderer->QueueCopyEx = GL_QueueCopyEx;
+    renderer->QueueCopyBatch = GL_QueueCopyBatch;
+    renderer->QueueGeometry = GL_QueueGeometry;
+    renderer->mergeable_commands = (1 << SDL_RENDERCMD_DRAW_POINTS) | (1 << SDL_RENDERCMD_FILL_RECTS) |
+                                   (1 << SDL_RENDERCMD_COPY) | (1 << SDL_RENDERCMD_COPY_BATCH) |
+                                   (1 << SDL_RENDERCMD_GEOMETRY);
     renderer->RunCommandQueue = GL_RunCommandQueue;
     renderer->RenderReadPixels = GL_RenderReadPixels;
     renderer->RenderPresent = GL_RenderPresent;
@@ -1759,6 +2029,28 @@ GL_CreateRenderer(SDL_Window * window, Uint32 flags)
     }
     data->framebuffers = NULL;
 
+    if (SDL_GL_ExtensionSupported("GL_ARB_pixel_buffer_object") &&
+        SDL_GL_ExtensionSupported("GL_ARB_vertex_buffer_object")) {
+        data->glGenBuffersARB = (PFNGLGENBUFFERSARBPROC)
+            SDL_GL_GetProcAddress("glGenBuffersARB");
+        data->glDeleteBuffersARB = (PFNGLDELETEBUFFERSARBPROC)
+            SDL_GL_GetProcAddress("glDeleteBuffersARB");
+        data->glBindBufferARB = (PFNGLBINDBUFFERARBPROC)
+            SDL_GL_GetProcAddress("glBindBufferARB");
+        data->glBufferDataARB = (PFNGLBUFFERDATAARBPROC)
+            SDL_GL_GetProcAddress("glBufferDataARB");
+        data->glMapBufferARB = (PFNGLMAPBUFFERARBPROC)
+            SDL_GL_GetProcAddress("glMapBufferARB");
+        data->glUnmapBufferARB = (PFNGLUNMAPBUFFERARBPROC)
+            SDL_GL_GetProcAddress("glUnmapBufferARB");
+        if (data->glGenBuffersARB && data->glDeleteBuffersARB && data->glBindBufferARB &&
+            data->glBufferDataARB && data->glMapBufferARB && data->glUnmapBufferARB) {
+            renderer->StartReadback = GL_StartReadback;
+            renderer->FinishReadback = GL_FinishReadback;
+            renderer->DestroyReadback = GL_DestroyReadback;
+        }
+    }
+
     /* Set up parameters for rendering */
     data->glMatrixMode(GL_MODELVIEW);
     data->glLoadIdentity();
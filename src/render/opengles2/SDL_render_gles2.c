@@ -108,6 +108,7 @@ typedef enum
     GLES2_ATTRIBUTE_TEXCOORD = 1,
     GLES2_ATTRIBUTE_ANGLE = 2,
     GLES2_ATTRIBUTE_CENTER = 3,
+    GLES2_ATTRIBUTE_COLOR = 4,
 } GLES2_Attribute;
 
 typedef enum
@@ -146,6 +147,7 @@ typedef struct
     SDL_Rect cliprect;
     SDL_bool texturing;
     SDL_bool is_copy_ex;
+    SDL_bool is_geometry;
     Uint32 color;
     Uint32 clear_color;
     int drawablew;
@@ -463,6 +465,7 @@ GLES2_CacheProgram(GLES2_RenderData *data, GLES2_ShaderCacheEntry *vertex,
     data->glBindAttribLocation(entry->id, GLES2_ATTRIBUTE_TEXCOORD, "a_texCoord");
     data->glBindAttribLocation(entry->id, GLES2_ATTRIBUTE_ANGLE, "a_angle");
     data->glBindAttribLocation(entry->id, GLES2_ATTRIBUTE_CENTER, "a_center");
+    data->glBindAttribLocation(entry->id, GLES2_ATTRIBUTE_COLOR, "a_color");
     data->glLinkProgram(entry->id);
     data->glGetProgramiv(entry->id, GL_LINK_STATUS, &linkSuccessful);
     if (!linkSuccessful) {
@@ -995,11 +998,106 @@ GLES2_QueueCopyEx(SDL_Renderer * renderer, SDL_RenderCommand *cmd, SDL_Texture *
     return 0;
 }
 
+static int
+GLES2_QueueCopyBatch(SDL_Renderer * renderer, SDL_RenderCommand *cmd, SDL_Texture * texture,
+                     const SDL_RenderCopyInstance * instances, int count)
+{
+    /* Two triangles per copy: all the positions, then all the texture coordinates, then the colors */
+    const size_t size = count * (24 * sizeof (GLfloat) + sizeof (Uint32));
+    GLfloat *verts = (GLfloat *) SDL_AllocateRenderVertices(renderer, size, 0, &cmd->data.draw.first);
+    GLfloat *texcoords = verts + count * 12;
+    Uint32 *colors = (Uint32 *) (texcoords + count * 12);
+    int i;
+
+    if (!verts) {
+        return -1;
+    }
+
+    cmd->data.draw.count = count;
+
+    for (i = 0; i < count; i++, instances++) {
+        const SDL_FPoint *corners = instances->corners;
+        const SDL_Rect *srcrect = &instances->srcrect;
+        const GLfloat minu = (GLfloat) srcrect->x / texture->w;
+        const GLfloat maxu = (GLfloat) (srcrect->x + srcrect->w) / texture->w;
+        const GLfloat minv = (GLfloat) srcrect->y / texture->h;
+        const GLfloat maxv = (GLfloat) (srcrect->y + srcrect->h) / texture->h;
+
+        *(verts++) = corners[0].x;
+        *(verts++) = corners[0].y;
+        *(verts++) = corners[1].x;
+        *(verts++) = corners[1].y;
+        *(verts++) = corners[2].x;
+        *(verts++) = corners[2].y;
+        *(verts++) = corners[2].x;
+        *(verts++) = corners[2].y;
+        *(verts++) = corners[1].x;
+        *(verts++) = corners[1].y;
+        *(verts++) = corners[3].x;
+        *(verts++) = corners[3].y;
+
+        *(texcoords++) = minu;
+        *(texcoords++) = minv;
+        *(texcoords++) = maxu;
+        *(texcoords++) = minv;
+        *(texcoords++) = minu;
+        *(texcoords++) = maxv;
+        *(texcoords++) = minu;
+        *(texcoords++) = maxv;
+        *(texcoords++) = maxu;
+        *(texcoords++) = minv;
+        *(texcoords++) = maxu;
+        *(texcoords++) = maxv;
+
+        *(colors++) = (((Uint32) instances->a << 24) | ((Uint32) instances->r << 16) | ((Uint32) instances->g << 8) | instances->b);
+    }
+
+    return 0;
+}
+
+static int
+GLES2_QueueGeometry(SDL_Renderer * renderer, SDL_RenderCommand *cmd, SDL_Texture * texture,
+                    const SDL_Vertex * vertices, int count)
+{
+    /* All the positions, then all the texture coordinates, then the colors */
+    const SDL_bool colorswap = (renderer->target && (renderer->target->format == SDL_PIXELFORMAT_ARGB8888 || renderer->target->format == SDL_PIXELFORMAT_RGB888));
+    const size_t size = count * ((texture ? 4 : 2) * sizeof (GLfloat) + 4);
+    GLfloat *verts = (GLfloat *) SDL_AllocateRenderVertices(renderer, size, 0, &cmd->data.draw.first);
+    GLfloat *texcoords = verts + count * 2;
+    Uint8 *colors = (Uint8 *) (verts + count * (texture ? 4 : 2));
+    int i;
+
+    if (!verts) {
+        return -1;
+    }
+
+    cmd->data.draw.count = count;
+
+    for (i = 0; i < count; i++, vertices++) {
+        *(verts++) = vertices->position.x;
+        *(verts++) = vertices->position.y;
+
+        if (texture) {
+            *(texcoords++) = vertices->tex_coord.x;
+            *(texcoords++) = vertices->tex_coord.y;
+        }
+
+        *(colors++) = colorswap ? vertices->color.b : vertices->color.r;
+        *(colors++) = vertices->color.g;
+        *(colors++) = colorswap ? vertices->color.r : vertices->color.b;
+        *(colors++) = vertices->color.a;
+    }
+
+    return 0;
+}
+
 static int
 SetDrawState(GLES2_RenderData *data, const SDL_RenderCommand *cmd, const GLES2_ImageSource imgsrc)
 {
     const SDL_bool was_copy_ex = data->drawstate.is_copy_ex;
     const SDL_bool is_copy_ex = (cmd->command == SDL_RENDERCMD_COPY_EX);
+    const SDL_bool was_geometry = data->drawstate.is_geometry;
+    const SDL_bool is_geometry = (cmd->command == SDL_RENDERCMD_GEOMETRY);
     SDL_Texture *texture = cmd->data.draw.texture;
     const SDL_BlendMode blend = cmd->data.draw.blend;
     GLES2_ProgramCacheEntry *program;
@@ -1071,7 +1169,13 @@ SetDrawState(GLES2_RenderData *data, const SDL_RenderCommand *cmd, const GLES2_I
     }
 
     if (texture) {
-        data->glVertexAttribPointer(GLES2_ATTRIBUTE_TEXCOORD, 2, GL_FLOAT, GL_FALSE, 0, (const GLvoid *) (cmd->data.draw.first + (sizeof (GLfloat) * 8)));
+        size_t texcoords = 8;
+        if (cmd->command == SDL_RENDERCMD_COPY_BATCH) {
+            texcoords = cmd->data.draw.count * 12;
+        } else if (is_geometry) {
+            texcoords = cmd->data.draw.count * 2;
+        }
+        data->glVertexAttribPointer(GLES2_ATTRIBUTE_TEXCOORD, 2, GL_FLOAT, GL_FALSE, 0, (const GLvoid *) (cmd->data.draw.first + (sizeof (GLfloat) * texcoords)));
     }
 
     if (GLES2_SelectProgram(data, imgsrc, texture ? texture->w : 0, texture ? texture->h : 0) < 0) {
@@ -1132,6 +1236,22 @@ SetDrawState(GLES2_RenderData *data, const SDL_RenderCommand *cmd, const GLES2_I
         data->glVertexAttribPointer(GLES2_ATTRIBUTE_CENTER, 2, GL_FLOAT, GL_FALSE, 0, (const GLvoid *) (cmd->data.draw.first + (sizeof (GLfloat) * 24)));
     }
 
+    /* Everything else is drawn with a constant white vertex color */
+    if (is_geometry != was_geometry) {
+        if (is_geometry) {
+            data->glEnableVertexAttribArray((GLenum) GLES2_ATTRIBUTE_COLOR);
+        } else {
+            data->glDisableVertexAttribArray((GLenum) GLES2_ATTRIBUTE_COLOR);
+            data->glVertexAttrib4f(GLES2_ATTRIBUTE_COLOR, 1.0f, 1.0f, 1.0f, 1.0f);
+        }
+        data->drawstate.is_geometry = is_geometry;
+    }
+
+    if (is_geometry) {
+        const size_t colors = cmd->data.draw.count * (texture ? 4 : 2);
+        data->glVertexAttribPointer(GLES2_ATTRIBUTE_COLOR, 4, GL_UNSIGNED_BYTE, GL_TRUE, 0, (const GLvoid *) (cmd->data.draw.first + (sizeof (GLfloat) * colors)));
+    }
+
     return 0;
 }
 
@@ -1375,6 +1495,51 @@ GLES2_RunCommandQueue(SDL_Renderer * renderer, SDL_RenderCommand *cmd, void *ver
                 break;
             }
 
+            case SDL_RENDERCMD_COPY_BATCH: {
+                const size_t count = cmd->data.draw.count;
+                const Uint32 *colors = (const Uint32 *) (((Uint8 *) vertices) + cmd->data.draw.first + count * 24 * sizeof (GLfloat));
+                const Uint32 color = data->drawstate.color;
+                size_t start = 0, end;
+
+                /* The color is a uniform, so draw each run of copies with the same color at once */
+                while (start < count) {
+                    const Uint32 argb = colors[start];
+                    for (end = start + 1; end < count && colors[end] == argb; ++end) {
+                        continue;
+                    }
+                    if (colorswap) {
+                        data->drawstate.color = (argb & 0xFF00FF00) | ((argb >> 16) & 0xFF) | ((argb & 0xFF) << 16);
+                    } else {
+                        data->drawstate.color = argb;
+                    }
+                    if (SetCopyState(renderer, cmd) < 0) {
+                        break;
+                    }
+                    data->glDrawArrays(GL_TRIANGLES, (GLint) (start * 6), (GLsizei) ((end - start) * 6));
+                    start = end;
+                }
+                data->drawstate.color = color;
+                break;
+            }
+
+            case SDL_RENDERCMD_GEOMETRY: {
+                const Uint32 color = data->drawstate.color;
+                int ret;
+
+                /* The colors are in the vertices */
+                data->drawstate.color = 0xFFFFFFFF;
+                if (cmd->data.draw.texture) {
+                    ret = SetCopyState(renderer, cmd);
+                } else {
+                    ret = SetDrawState(data, cmd, GLES2_IMAGESOURCE_SOLID);
+                }
+                if (ret == 0) {
+                    data->glDrawArrays(GL_TRIANGLES, 0, (GLsizei) cmd->data.draw.count);
+                }
+                data->drawstate.color = color;
+                break;
+            }
+
             case SDL_RENDERCMD_NO_OP:
                 break;
         }
@@ -2150,6 +2315,10 @@ GLES2_CreateRenderer(SDL_Window *window, Uint32 flags)
     renderer->QueueFillRects      = GLES2_QueueFillRects;
     renderer->QueueCopy           = GLES2_QueueCopy;
     renderer->QueueCopyEx         = GLES2_QueueCopyEx;
+    renderer->QueueCopyBatch      = GLES2_QueueCopyBatch;
+    renderer->QueueGeometry       = GLES2_QueueGeometry;
+    /* copies and geometry keep their positions and texture coordinates apart, so they can't be merged */
+    renderer->mergeable_commands  = (1 << SDL_RENDERCMD_DRAW_POINTS) | (1 << SDL_RENDERCMD_FILL_RECTS);
     renderer->RunCommandQueue     = GLES2_RunCommandQueue;
     renderer->RenderReadPixels    = GLES2_RenderReadPixels;
     renderer->RenderPresent       = GLES2_RenderPresent;
@@ -2173,6 +2342,7 @@ GLES2_CreateRenderer(SDL_Window *window, Uint32 flags)
 
     data->glEnableVertexAttribArray(GLES2_ATTRIBUTE_POSITION);
     data->glDisableVertexAttribArray(GLES2_ATTRIBUTE_TEXCOORD);
+    data->glVertexAttrib4f(GLES2_ATTRIBUTE_COLOR, 1.0f, 1.0f, 1.0f, 1.0f);
 
     data->glClearColor(1.0f, 1.0f, 1.0f, 1.0f);
 
@@ -34,6 +34,7 @@
 #include "SDL_drawline.h"
 #include "SDL_drawpoint.h"
 #include "SDL_rotate.h"
+#include "SDL_triangle.h"
 
 /* SDL surface based renderer implementation */
 
@@ -48,6 +49,8 @@ typedef struct
 {
     SDL_Surface *surface;
     SDL_Surface *window;
+    int num_threads;            /* From SDL_HINT_RENDER_SOFTWARE_THREADS, 0 for one per CPU */
+    SDL_JobPool *pool;          /* Created the first time geometry is drawn with threads */
 } SW_RenderData;
 
 
@@ -135,6 +138,25 @@ SW_CreateTexture(SDL_Renderer * renderer, SDL_Texture * texture)
     return 0;
 }
 
+static int
+SW_CreateSurfaceTexture(SDL_Renderer * renderer, SDL_Texture * texture, SDL_Surface * surface)
+{
+    /* A surface of our own that points at the same pixels, so the blit
+       state we set for drawing doesn't change the application's surface */
+    texture->driverdata =
+        SDL_CreateRGBSurfaceWithFormatFrom(surface->pixels, surface->w, surface->h,
+                                           surface->format->BitsPerPixel,
+                                           surface->pitch, texture->format);
+    if (!texture->driverdata) {
+        return -1;
+    }
+    SDL_SetSurfaceColorMod(texture->driverdata, texture->r, texture->g,
+                           texture->b);
+    SDL_SetSurfaceAlphaMod(texture->driverdata, texture->a);
+    SDL_SetSurfaceBlendMode(texture->driverdata, texture->blendMode);
+    return 0;
+}
+
 static int
 SW_UpdateTexture(SDL_Renderer * renderer, SDL_Texture * texture,
                  const SDL_Rect * rect, const void *pixels, int pitch)
@@ -151,10 +173,13 @@ SW_UpdateTexture(SDL_Renderer * renderer, SDL_Texture * texture,
                         rect->y * surface->pitch +
                         rect->x * surface->format->BytesPerPixel;
     length = rect->w * surface->format->BytesPerPixel;
-    for (row = 0; row < rect->h; ++row) {
-        SDL_memcpy(dst, src, length);
-        src += pitch;
-        dst += surface->pitch;
+    /* A surface texture updated from its own pixels has nothing to copy */
+    if (src != dst) {
+        for (row = 0; row < rect->h; ++row) {
+            SDL_memcpy(dst, src, length);
+            src += pitch;
+            dst += surface->pitch;
+        }
     }
     if(SDL_MUSTLOCK(surface))
         SDL_UnlockSurface(surface);
@@ -308,7 +333,7 @@ SW_QueueCopyEx(SDL_Renderer * renderer, SDL_RenderCommand *cmd, SDL_Texture * te
                const SDL_Rect * srcrect, const SDL_FRect * dstrect,
                const double angle, const SDL_FPoint *center, const SDL_RendererFlip flip)
 {
-    CopyExData *verts = (CopyExData *) SDL_AllocateRenderVertices(renderer, sizeof (CopyExData), 0, &cmd->data.draw.first);
+    CopyExData *verts = (CopyExData *) SDL_AllocateRenderVertices(renderer, sizeof (CopyExData), sizeof (double), &cmd->data.draw.first);
 
     if (!verts) {
         return -1;
@@ -334,6 +359,90 @@ SW_QueueCopyEx(SDL_Renderer * renderer, SDL_RenderCommand *cmd, SDL_Texture * te
     return 0;
 }
 
+typedef struct CopyBatchData
+{
+    CopyExData copy;
+    Uint8 r, g, b, a;
+} CopyBatchData;
+
+static int
+SW_QueueCopyBatch(SDL_Renderer * renderer, SDL_RenderCommand *cmd, SDL_Texture * texture,
+                  const SDL_RenderCopyInstance * instances, int count)
+{
+    CopyBatchData *verts = (CopyBatchData *) SDL_AllocateRenderVertices(renderer, count * sizeof (CopyBatchData), sizeof (double), &cmd->data.draw.first);
+    const int x = renderer->viewport.x;
+    const int y = renderer->viewport.y;
+    int i;
+
+    if (!verts) {
+        return -1;
+    }
+
+    cmd->data.draw.count = count;
+
+    for (i = 0; i < count; i++, verts++, instances++) {
+        verts->copy.srcrect = instances->srcrect;
+        verts->copy.dstrect.x = (int)(x + instances->dstrect.x);
+        verts->copy.dstrect.y = (int)(y + instances->dstrect.y);
+        verts->copy.dstrect.w = (int)instances->dstrect.w;
+        verts->copy.dstrect.h = (int)instances->dstrect.h;
+        verts->copy.angle = instances->angle;
+        verts->copy.center = instances->center;
+        verts->copy.flip = instances->flip;
+        verts->r = instances->r;
+        verts->g = instances->g;
+        verts->b = instances->b;
+        verts->a = instances->a;
+    }
+
+    return 0;
+}
+
+static int
+SW_QueueGeometry(SDL_Renderer * renderer, SDL_RenderCommand *cmd, SDL_Texture * texture,
+                 const SDL_Vertex * vertices, int count)
+{
+    SDL_Vertex *verts = (SDL_Vertex *) SDL_AllocateRenderVertices(renderer, count * sizeof (SDL_Vertex), 0, &cmd->data.draw.first);
+    const float x = (float) renderer->viewport.x;
+    const float y = (float) renderer->viewport.y;
+    const float w = texture ? (float) texture->w : 0.0f;
+    const float h = texture ? (float) texture->h : 0.0f;
+    int i;
+
+    if (!verts) {
+        return -1;
+    }
+
+    cmd->data.draw.count = count;
+
+    /* The rasterizer works in surface pixels and texels */
+    for (i = 0; i < count; i++, verts++, vertices++) {
+        verts->position.x = x + vertices->position.x;
+        verts->position.y = y + vertices->position.y;
+        verts->color = vertices->color;
+        verts->tex_coord.x = vertices->tex_coord.x * w;
+        verts->tex_coord.y = vertices->tex_coord.y * h;
+    }
+
+    return 0;
+}
+
+static SDL_JobPool *
+SW_GetJobPool(SW_RenderData *data)
+{
+    if (data->num_threads == 1) {
+        return NULL;
+    }
+    if (!data->pool) {
+        data->pool = SDL_CreateJobPool(data->num_threads > 1 ? data->num_threads - 1 : 0);
+        if (!data->pool) {
+            /* Draw on this thread from now on */
+            data->num_threads = 1;
+        }
+    }
+    return data->pool;
+}
+
 static int
 SW_RenderCopyEx(SDL_Renderer * renderer, SDL_Surface *surface, SDL_Texture * texture,
                 const SDL_Rect * srcrect, const SDL_Rect * final_rect,
@@ -591,18 +700,23 @@ SetDrawState(SDL_Surface *surface, SW_DrawStateCache *drawstate)
     if (drawstate->surface_cliprect_dirty) {
         const SDL_Rect *viewport = drawstate->viewport;
         const SDL_Rect *cliprect = drawstate->cliprect;
+        SDL_Rect clip_rect;
         SDL_assert(viewport != NULL);  /* the higher level should have forced a SDL_RENDERCMD_SETVIEWPORT */
 
         if (cliprect != NULL) {
-            SDL_Rect clip_rect;
             clip_rect.x = cliprect->x + viewport->x;
             clip_rect.y = cliprect->y + viewport->y;
             clip_rect.w = cliprect->w;
             clip_rect.h = cliprect->h;
             SDL_IntersectRect(viewport, &clip_rect, &clip_rect);
-            SDL_SetClipRect(surface, &clip_rect);
         } else {
-            SDL_SetClipRect(surface, drawstate->viewport);
+            clip_rect = *viewport;
+        }
+
+        /* Each target surface keeps the clip rect it was last drawn with, so
+           switching back to a target usually finds it already set up */
+        if (!SDL_RectEquals(&surface->clip_rect, &clip_rect)) {
+            SDL_SetClipRect(surface, &clip_rect);
         }
         drawstate->surface_cliprect_dirty = SDL_FALSE;
     }
@@ -645,10 +759,12 @@ SW_RunCommandQueue(SDL_Renderer * renderer, SDL_RenderCommand *cmd, void *vertic
                 const Uint8 g = cmd->data.color.g;
                 const Uint8 b = cmd->data.color.b;
                 const Uint8 a = cmd->data.color.a;
-                /* By definition the clear ignores the clip rect */
+                /* By definition the clear ignores the clip rect, put it back
+                   afterwards so the target keeps its draw state */
+                const SDL_Rect clip_rect = surface->clip_rect;
                 SDL_SetClipRect(surface, NULL);
                 SDL_FillRect(surface, NULL, SDL_MapRGBA(surface->format, r, g, b, a));
-                drawstate.surface_cliprect_dirty = SDL_TRUE;
+                SDL_SetClipRect(surface, &clip_rect);
                 break;
             }
 
@@ -705,23 +821,29 @@ SW_RunCommandQueue(SDL_Renderer * renderer, SDL_RenderCommand *cmd, void *vertic
 
             case SDL_RENDERCMD_COPY: {
                 SDL_Rect *verts = (SDL_Rect *) (((Uint8 *) vertices) + cmd->data.draw.first);
-                const SDL_Rect *srcrect = verts;
-                SDL_Rect *dstrect = verts + 1;
+                const size_t count = cmd->data.draw.count;
                 SDL_Texture *texture = cmd->data.draw.texture;
                 SDL_Surface *src = (SDL_Surface *) texture->driverdata;
+                size_t i;
 
                 SetDrawState(surface, &drawstate);
 
                 PrepTextureForCopy(cmd);
 
-                if ( srcrect->w == dstrect->w && srcrect->h == dstrect->h ) {
-                    SDL_BlitSurface(src, srcrect, surface, dstrect);
-                } else {
-                    /* If scaling is ever done, permanently disable RLE (which doesn't support scaling)
-                     * to avoid potentially frequent RLE encoding/decoding.
-                     */
-                    SDL_SetSurfaceRLE(surface, 0);
-                    SDL_BlitScaled(src, srcrect, surface, dstrect);
+                /* There's more than one copy if adjacent copies were merged */
+                for (i = 0; i < count; i++, verts += 2) {
+                    const SDL_Rect *srcrect = verts;
+                    SDL_Rect *dstrect = verts + 1;
+
+                    if ( srcrect->w == dstrect->w && srcrect->h == dstrect->h ) {
+                        SDL_BlitSurface(src, srcrect, surface, dstrect);
+                    } else {
+                        /* If scaling is ever done, permanently disable RLE (which doesn't support scaling)
+                         * to avoid potentially frequent RLE encoding/decoding.
+                         */
+                        SDL_SetSurfaceRLE(surface, 0);
+                        SDL_BlitScaled(src, srcrect, surface, dstrect);
+                    }
                 }
                 break;
             }
@@ -735,6 +857,66 @@ SW_RunCommandQueue(SDL_Renderer * renderer, SDL_RenderCommand *cmd, void *vertic
                 break;
             }
 
+            case SDL_RENDERCMD_COPY_BATCH: {
+                const CopyBatchData *copydata = (CopyBatchData *) (((Uint8 *) vertices) + cmd->data.draw.first);
+                const size_t count = cmd->data.draw.count;
+                SDL_Texture *texture = cmd->data.draw.texture;
+                SDL_Surface *src = (SDL_Surface *) texture->driverdata;
+                Uint8 r = cmd->data.draw.r;
+                Uint8 g = cmd->data.draw.g;
+                Uint8 b = cmd->data.draw.b;
+                Uint8 a = cmd->data.draw.a;
+                size_t i;
+
+                SetDrawState(surface, &drawstate);
+                PrepTextureForCopy(cmd);
+
+                /* The blit map only changes if the modulation does, and then
+                   only to one it has seen recently, so this stays a tight loop */
+                for (i = 0; i < count; i++, copydata++) {
+                    SDL_Rect dstrect = copydata->copy.dstrect;
+
+                    if (copydata->r != r || copydata->g != g || copydata->b != b) {
+                        r = copydata->r;
+                        g = copydata->g;
+                        b = copydata->b;
+                        if ((r & g & b) != 0xFF) {
+                            SDL_SetSurfaceRLE(src, 0);
+                        }
+                        SDL_SetSurfaceColorMod(src, r, g, b);
+                    }
+                    if (copydata->a != a) {
+                        a = copydata->a;
+                        if (a != 0xFF) {
+                            SDL_SetSurfaceRLE(src, 0);
+                        }
+                        SDL_SetSurfaceAlphaMod(src, a);
+                    }
+
+                    if (copydata->copy.angle != 0.0 || copydata->copy.flip != SDL_FLIP_NONE) {
+                        SW_RenderCopyEx(renderer, surface, texture, &copydata->copy.srcrect,
+                                        &dstrect, copydata->copy.angle, &copydata->copy.center, copydata->copy.flip);
+                    } else if (copydata->copy.srcrect.w == dstrect.w && copydata->copy.srcrect.h == dstrect.h) {
+                        SDL_BlitSurface(src, &copydata->copy.srcrect, surface, &dstrect);
+                    } else {
+                        SDL_SetSurfaceRLE(src, 0);
+                        SDL_BlitScaled(src, &copydata->copy.srcrect, surface, &dstrect);
+                    }
+                }
+                break;
+            }
+
+            case SDL_RENDERCMD_GEOMETRY: {
+                const SDL_Vertex *verts = (SDL_Vertex *) (((Uint8 *) vertices) + cmd->data.draw.first);
+                const int count = (int) cmd->data.draw.count;
+                SDL_Texture *texture = cmd->data.draw.texture;
+                SDL_Surface *src = texture ? (SDL_Surface *) texture->driverdata : NULL;
+                SetDrawState(surface, &drawstate);
+                SDL_SW_RenderGeometry(surface, src, verts, count, cmd->data.draw.blend,
+                                      SW_GetJobPool((SW_RenderData *) renderer->driverdata));
+                break;
+            }
+
             case SDL_RENDERCMD_NO_OP:
                 break;
         }
@@ -776,6 +958,52 @@ SW_RenderReadPixels(SDL_Renderer * renderer, const SDL_Rect * rect,
                              format, pixels, pitch);
 }
 
+static int
+SW_StartReadback(SDL_Renderer * renderer, SDL_ReadbackBuffer * buffer)
+{
+    SDL_Surface *surface = SW_ActivateRenderer(renderer);
+    const SDL_Rect *rect = &buffer->rect;
+    Uint8 *src, *dst;
+    size_t length;
+    int row;
+
+    if (!surface) {
+        return -1;
+    }
+
+    /* NOTE: The rect is already adjusted according to the viewport by
+     * SDL_RenderReadPixelsAsync.
+     */
+
+    if (rect->x < 0 || rect->x+rect->w > surface->w ||
+        rect->y < 0 || rect->y+rect->h > surface->h) {
+        return SDL_SetError("Tried to read outside of surface bounds");
+    }
+
+    /* Just copy the pixels, so the application can keep drawing while
+       they're converted on another thread */
+    length = rect->w * surface->format->BytesPerPixel;
+    if (SDL_ReallocReadbackPixels(buffer, (int) length) < 0) {
+        return -1;
+    }
+    buffer->format = surface->format->format;
+
+    src = (Uint8 *) surface->pixels +
+                        rect->y * surface->pitch +
+                        rect->x * surface->format->BytesPerPixel;
+    dst = (Uint8 *) buffer->pixels;
+    if (length == (size_t) surface->pitch) {
+        SDL_memcpy(dst, src, length * rect->h);
+        return 0;
+    }
+    for (row = 0; row < rect->h; ++row) {
+        SDL_memcpy(dst, src, length);
+        src += surface->pitch;
+        dst += buffer->pitch;
+    }
+    return 0;
+}
+
 static void
 SW_RenderPresent(SDL_Renderer * renderer)
 {
@@ -799,6 +1027,9 @@ SW_DestroyRenderer(SDL_Renderer * renderer)
 {
     SW_RenderData *data = (SW_RenderData *) renderer->driverdata;
 
+    if (data && data->pool) {
+        SDL_DestroyJobPool(data->pool);
+    }
     SDL_free(data);
     SDL_free(renderer);
 }
@@ -808,6 +1039,7 @@ SW_CreateRendererForSurface(SDL_Surface * surface)
 {
     SDL_Renderer *renderer;
     SW_RenderData *data;
+    const char *hint;
 
     if (!surface) {
         SDL_SetError("Can't create renderer for NULL surface");
@@ -828,10 +1060,16 @@ SW_CreateRendererForSurface(SDL_Surface * surface)
     }
     data->surface = surface;
     data->window = surface;
+    hint = SDL_GetHint(SDL_HINT_RENDER_SOFTWARE_THREADS);
+    data->num_threads = hint ? SDL_atoi(hint) : 1;
+    if (data->num_threads < 0) {
+        data->num_threads = 1;
+    }
 
     renderer->WindowEvent = SW_WindowEvent;
     renderer->GetOutputSize = SW_GetOutputSize;
     renderer->CreateTexture = SW_CreateTexture;
+    renderer->CreateSurfaceTexture = SW_CreateSurfaceTexture;
     renderer->UpdateTexture = SW_UpdateTexture;
     renderer->LockTexture = SW_LockTexture;
     renderer->UnlockTexture = SW_UnlockTexture;
@@ -844,8 +1082,14 @@ SW_CreateRendererForSurface(SDL_Surface * surface)
     renderer->QueueFillRects = SW_QueueFillRects;
     renderer->QueueCopy = SW_QueueCopy;
     renderer->QueueCopyEx = SW_QueueCopyEx;
+    renderer->QueueCopyBatch = SW_QueueCopyBatch;
+    renderer->QueueGeometry = SW_QueueGeometry;
+    renderer->mergeable_commands = (1 << SDL_RENDERCMD_DRAW_POINTS) | (1 << SDL_RENDERCMD_FILL_RECTS) |
+                                   (1 << SDL_RENDERCMD_COPY) | (1 << SDL_RENDERCMD_COPY_BATCH) |
+                                   (1 << SDL_RENDERCMD_GEOMETRY);
     renderer->RunCommandQueue = SW_RunCommandQueue;
     renderer->RenderReadPixels = SW_RenderReadPixels;
+    renderer->StartReadback = SW_StartReadback;
     renderer->RenderPresent = SW_RenderPresent;
     renderer->DestroyTexture = SW_DestroyTexture;
     renderer->DestroyRenderer = SW_DestroyRenderer;
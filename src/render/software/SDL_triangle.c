@@ -0,0 +1,862 @@
+/*
+  Simple DirectMedia Layer
+  Copyright (C) 1997-2020 Sam Lantinga <slouken@libsdl.org>
+
+  This software is provided 'as-is', without any express or implied
+  warranty.  In no event will the authors be held liable for any damages
+  arising from the use of this software.
+
+  Permission is granted to anyone to use this software for any purpose,
+  including commercial applications, and to alter it and redistribute it
+  freely, subject to the following restrictions:
+
+  1. The origin of this software must not be misrepresented; you must not
+     claim that you wrote the original software. If you use this software
+     in a product, an acknowledgment in the product documentation would be
+     appreciated but is not required.
+  2. Altered source versions must be plainly marked as such, and must not be
+     misrepresented as being the original software.
+  3. This notice may not be removed or altered from any source distribution.
+*/
+#include "../../SDL_internal.h"
+
+#if SDL_VIDEO_RENDER_SW && !SDL_RENDER_DISABLED
+
+#include "SDL_cpuinfo.h"
+#include "SDL_triangle.h"
+
+/* A fixed point half-space rasterizer.
+
+   The vertex positions are snapped to 1/16 of a pixel. A pixel is drawn if
+   its center is inside all three edges of the triangle, and the top-left
+   rule decides centers right on an edge, so triangles sharing an edge never
+   draw a pixel twice.
+
+   The bounding box of a triangle is walked in 8x8 blocks. Blocks outside an
+   edge are skipped, blocks inside all the edges are drawn without testing
+   their pixels, and only the blocks along the edges are tested pixel by
+   pixel. Each row of the triangle is then drawn as one span, with the
+   texture coordinates and colors stepped in 16.16 fixed point.
+
+   Spans are drawn on 32-bit pixels with alpha in the top byte, from a
+   texture with the same red, green and blue layout. Other targets and
+   textures are converted first.
+ */
+
+#if defined(__SSE2__)
+#define HAVE_SSE2_INTRINSICS 1
+#endif
+
+#define SUBPIXEL_BITS   4
+#define BLOCK_SIZE      8
+
+/* Keeps the edge functions well inside 64 bits. Triangles with a vertex
+   further out than this (or at NaN) aren't drawn at all. */
+#define MAX_COORDINATE  4194304.0f
+/* Keeps the texture coordinates inside 16.16 fixed point */
+#define MAX_TEXCOORD    16384.0f
+
+/* Long lists are split into bands of rows when a job pool is given */
+#define MIN_PARALLEL_TRIANGLES  64
+#define MIN_BAND_HEIGHT         16
+
+#define ATTR_U      0
+#define ATTR_V      1
+#define ATTR_COLOR  2   /* the four color channels, in the order of the pixel bytes */
+#define NUM_ATTRS   6
+
+/* x / 255, rounded, for x up to 255 * 255 */
+#define DIV255(x)   ((((x) + 128) + (((x) + 128) >> 8)) >> 8)
+
+typedef struct
+{
+    Uint8 *pixels;
+    int pitch;
+    int x, y;                   /* The position of the pixels on the target, if drawing to a copy */
+    Uint32 dstmask;             /* Leaves the unused byte of targets without alpha alone */
+    const Uint32 *texels;       /* NULL if there's no texture */
+    int texpitch;               /* In texels */
+    int texw, texh;
+    Uint32 texalpha;            /* Makes textures without alpha opaque */
+    int shift[4];               /* The position of the red, green, blue and alpha bytes */
+    SDL_BlendMode blend;
+} SW_GeometryTarget;
+
+typedef struct
+{
+    /* The edge functions at the center of pixel (0, 0), biased for the fill rule, and their steps */
+    Sint64 e[3];
+    Sint64 e_dx[3], e_dy[3];
+    /* The pixels the triangle can cover */
+    int minx, miny, maxx, maxy;
+    /* The attributes at the first vertex, relative to pixel centers, and their steps */
+    float ox, oy;
+    float attr[NUM_ATTRS];
+    float attr_dx[NUM_ATTRS];
+    float attr_dy[NUM_ATTRS];
+    Sint64 du, dv;
+    int dc[4];
+    SDL_bool gouraud;           /* The colors are interpolated */
+    SDL_bool modulate;          /* The texture is modulated by the colors */
+    Uint32 color;               /* The color of every pixel, if it isn't interpolated */
+} SW_Triangle;
+
+typedef struct
+{
+    Sint64 u, v, du, dv;
+    int c[4], dc[4];
+} SW_SpanState;
+
+
+static int
+FloorDiv16(int value)
+{
+    return (value >= 0) ? (value >> SUBPIXEL_BITS) : -((-value + 15) >> SUBPIXEL_BITS);
+}
+
+static float
+ClampFloat(float value, float limit)
+{
+    /* NaN goes to the lower limit */
+    if (!(value >= -limit)) {
+        return -limit;
+    }
+    return (value > limit) ? limit : value;
+}
+
+/* Returns SDL_FALSE if there's nothing to draw: the triangle has no area,
+   misses the clip rect, or has a vertex beyond MAX_COORDINATE */
+static SDL_bool
+SetupTriangle(const SW_GeometryTarget *target, const SDL_Vertex *vertices, const SDL_Rect *clip, SW_Triangle *tri)
+{
+    const SDL_Vertex *v[3];
+    int X[3], Y[3];
+    float x[3], y[3], f[NUM_ATTRS][3];
+    float inv_area;
+    Sint64 area;
+    int i, k, minX, maxX, minY, maxY;
+
+    v[0] = &vertices[0];
+    v[1] = &vertices[1];
+    v[2] = &vertices[2];
+    for (i = 0; i < 3; ++i) {
+        const float vx = v[i]->position.x;
+        const float vy = v[i]->position.y;
+        if (!(vx >= -MAX_COORDINATE && vx <= MAX_COORDINATE && vy >= -MAX_COORDINATE && vy <= MAX_COORDINATE)) {
+            return SDL_FALSE;
+        }
+        X[i] = (int) SDL_floorf(vx * (1 << SUBPIXEL_BITS) + 0.5f);
+        Y[i] = (int) SDL_floorf(vy * (1 << SUBPIXEL_BITS) + 0.5f);
+    }
+
+    area = (Sint64) (X[1] - X[0]) * (Y[2] - Y[0]) - (Sint64) (Y[1] - Y[0]) * (X[2] - X[0]);
+    if (area == 0) {
+        return SDL_FALSE;
+    }
+    if (area < 0) {
+        /* Wind the triangle the other way, so the inside is positive */
+        const SDL_Vertex *tmpv = v[1];
+        const int tmpx = X[1], tmpy = Y[1];
+        v[1] = v[2];
+        X[1] = X[2];
+        Y[1] = Y[2];
+        v[2] = tmpv;
+        X[2] = tmpx;
+        Y[2] = tmpy;
+        area = -area;
+    }
+
+    /* The pixels whose centers are inside the bounding box */
+    minX = SDL_min(X[0], SDL_min(X[1], X[2]));
+    maxX = SDL_max(X[0], SDL_max(X[1], X[2]));
+    minY = SDL_min(Y[0], SDL_min(Y[1], Y[2]));
+    maxY = SDL_max(Y[0], SDL_max(Y[1], Y[2]));
+    tri->minx = SDL_max(-FloorDiv16(8 - minX), clip->x);
+    tri->maxx = SDL_min(FloorDiv16(maxX - 8), clip->x + clip->w - 1);
+    tri->miny = SDL_max(-FloorDiv16(8 - minY), clip->y);
+    tri->maxy = SDL_min(FloorDiv16(maxY - 8), clip->y + clip->h - 1);
+    if (tri->minx > tri->maxx || tri->miny > tri->maxy) {
+        return SDL_FALSE;
+    }
+
+    /* Edge k is the one opposite vertex k, from vertex k+1 to vertex k+2 */
+    for (k = 0; k < 3; ++k) {
+        const int a = (k + 1) % 3;
+        const int b = (k + 2) % 3;
+        const Sint64 dx = X[b] - X[a];
+        const Sint64 dy = Y[b] - Y[a];
+        const SDL_bool top_left = (dy < 0 || (dy == 0 && dx > 0));
+        tri->e_dx[k] = -dy * (1 << SUBPIXEL_BITS);
+        tri->e_dy[k] = dx * (1 << SUBPIXEL_BITS);
+        tri->e[k] = (dy * X[a] - dx * Y[a]) + (dx - dy) * (1 << (SUBPIXEL_BITS - 1)) - (top_left ? 0 : 1);
+    }
+
+    /* The attributes are planes through the vertices */
+    for (i = 0; i < 3; ++i) {
+        const SDL_Color *c = &v[i]->color;
+        x[i] = (float) X[i] / (1 << SUBPIXEL_BITS);
+        y[i] = (float) Y[i] / (1 << SUBPIXEL_BITS);
+        f[ATTR_U][i] = ClampFloat(v[i]->tex_coord.x, MAX_TEXCOORD);
+        f[ATTR_V][i] = ClampFloat(v[i]->tex_coord.y, MAX_TEXCOORD);
+        f[ATTR_COLOR + target->shift[0] / 8][i] = (float) c->r;
+        f[ATTR_COLOR + target->shift[1] / 8][i] = (float) c->g;
+        f[ATTR_COLOR + target->shift[2] / 8][i] = (float) c->b;
+        f[ATTR_COLOR + target->shift[3] / 8][i] = (float) c->a;
+    }
+    inv_area = (float) (256.0 / (double) area);
+    tri->ox = x[0] - 0.5f;
+    tri->oy = y[0] - 0.5f;
+    for (k = 0; k < NUM_ATTRS; ++k) {
+        const float d1 = f[k][1] - f[k][0];
+        const float d2 = f[k][2] - f[k][0];
+        tri->attr[k] = f[k][0];
+        tri->attr_dx[k] = (d1 * (y[2] - y[0]) - d2 * (y[1] - y[0])) * inv_area;
+        tri->attr_dy[k] = (d2 * (x[1] - x[0]) - d1 * (x[2] - x[0])) * inv_area;
+    }
+    tri->du = (Sint64) (tri->attr_dx[ATTR_U] * 65536.0f);
+    tri->dv = (Sint64) (tri->attr_dx[ATTR_V] * 65536.0f);
+    for (k = 0; k < 4; ++k) {
+        tri->dc[k] = (int) (tri->attr_dx[ATTR_COLOR + k] * 65536.0f);
+    }
+
+    tri->gouraud = (SDL_memcmp(&v[0]->color, &v[1]->color, sizeof (SDL_Color)) != 0 ||
+                    SDL_memcmp(&v[0]->color, &v[2]->color, sizeof (SDL_Color)) != 0);
+    tri->color = ((Uint32) v[0]->color.r << target->shift[0]) | ((Uint32) v[0]->color.g << target->shift[1]) |
+                 ((Uint32) v[0]->color.b << target->shift[2]) | ((Uint32) v[0]->color.a << target->shift[3]);
+    tri->modulate = (target->texels && (tri->gouraud || tri->color != 0xFFFFFFFF));
+    return SDL_TRUE;
+}
+
+SDL_FORCE_INLINE Uint32
+NextTexel(const SW_GeometryTarget *target, SW_SpanState *s)
+{
+    const int tx = (s->u < 0) ? 0 : (int) SDL_min(s->u >> 16, target->texw - 1);
+    const int ty = (s->v < 0) ? 0 : (int) SDL_min(s->v >> 16, target->texh - 1);
+    s->u += s->du;
+    s->v += s->dv;
+    return target->texels[ty * target->texpitch + tx] | target->texalpha;
+}
+
+/* Get the texel and color for the next pixel of a span */
+SDL_FORCE_INLINE void
+NextPixel(const SW_GeometryTarget *target, const SW_Triangle *tri, SW_SpanState *s, Uint32 *texel, Uint32 *color)
+{
+    if (tri->gouraud) {
+        *color = (Uint32) (s->c[0] >> 16) | ((Uint32) (s->c[1] >> 16) << 8) |
+                 ((Uint32) (s->c[2] >> 16) << 16) | ((Uint32) (s->c[3] >> 16) << 24);
+        s->c[0] += s->dc[0];
+        s->c[1] += s->dc[1];
+        s->c[2] += s->dc[2];
+        s->c[3] += s->dc[3];
+    } else {
+        *color = tri->color;
+    }
+
+    if (target->texels) {
+        *texel = NextTexel(target, s);
+    } else {
+        *texel = 0xFFFFFFFF;
+    }
+}
+
+SDL_FORCE_INLINE Uint32
+ModulatePixel(Uint32 texel, Uint32 color)
+{
+    Uint32 result = 0;
+    int shift;
+
+    for (shift = 0; shift < 32; shift += 8) {
+        const Uint32 x = ((texel >> shift) & 0xFF) * ((color >> shift) & 0xFF);
+        result |= DIV255(x) << shift;
+    }
+    return result;
+}
+
+/* These are the formulas in SDL_blendmode.h, rounded to the nearest value.
+   The SSE2 versions give exactly the same results. */
+SDL_FORCE_INLINE Uint32
+BlendPixel(Uint32 src, Uint32 dst)
+{
+    const Uint32 sa = src >> 24;
+    const Uint32 da = dst >> 24;
+    Uint32 result = DIV255(sa * 255 + da * (255 - sa)) << 24;
+    int shift;
+
+    for (shift = 0; shift < 24; shift += 8) {
+        const Uint32 x = ((src >> shift) & 0xFF) * sa + ((dst >> shift) & 0xFF) * (255 - sa);
+        result |= DIV255(x) << shift;
+    }
+    return result;
+}
+
+SDL_FORCE_INLINE Uint32
+AddPixel(Uint32 src, Uint32 dst)
+{
+    const Uint32 sa = src >> 24;
+    Uint32 result = dst & 0xFF000000;
+    int shift;
+
+    for (shift = 0; shift < 24; shift += 8) {
+        const Uint32 x = ((src >> shift) & 0xFF) * sa;
+        const Uint32 c = ((dst >> shift) & 0xFF) + DIV255(x);
+        result |= SDL_min(c, 255) << shift;
+    }
+    return result;
+}
+
+SDL_FORCE_INLINE Uint32
+ModPixel(Uint32 src, Uint32 dst)
+{
+    Uint32 result = dst & 0xFF000000;
+    int shift;
+
+    for (shift = 0; shift < 24; shift += 8) {
+        const Uint32 x = ((src >> shift) & 0xFF) * ((dst >> shift) & 0xFF);
+        result |= DIV255(x) << shift;
+    }
+    return result;
+}
+
+SDL_FORCE_INLINE Uint32
+MulPixel(Uint32 src, Uint32 dst)
+{
+    const Uint32 sa = src >> 24;
+    Uint32 result = dst & 0xFF000000;
+    int shift;
+
+    for (shift = 0; shift < 24; shift += 8) {
+        const Uint32 d = (dst >> shift) & 0xFF;
+        const Uint32 x = ((src >> shift) & 0xFF) * d;
+        const Uint32 y = d * (255 - sa);
+        const Uint32 c = DIV255(x) + DIV255(y);
+        result |= SDL_min(c, 255) << shift;
+    }
+    return result;
+}
+
+#define SPAN_LOOP(op)                                                   \
+    for (i = 0; i < count; ++i) {                                       \
+        Uint32 texel, color, src;                                       \
+        NextPixel(target, tri, s, &texel, &color);                      \
+        if (tri->modulate) {                                            \
+            src = ModulatePixel(texel, color);                          \
+        } else {                                                        \
+            src = target->texels ? texel : color;                       \
+        }                                                               \
+        dst[i] = (op) & dstmask;                                        \
+    }
+
+static void
+DrawSpan(const SW_GeometryTarget *target, const SW_Triangle *tri, Uint32 *dst, int count, SW_SpanState *s)
+{
+    const Uint32 dstmask = target->dstmask;
+    int i;
+
+    switch (target->blend) {
+    case SDL_BLENDMODE_BLEND:
+        SPAN_LOOP(BlendPixel(src, dst[i]));
+        break;
+    case SDL_BLENDMODE_ADD:
+        SPAN_LOOP(AddPixel(src, dst[i]));
+        break;
+    case SDL_BLENDMODE_MOD:
+        SPAN_LOOP(ModPixel(src, dst[i]));
+        break;
+    case SDL_BLENDMODE_MUL:
+        SPAN_LOOP(MulPixel(src, dst[i]));
+        break;
+    default:
+        SPAN_LOOP(src);
+        break;
+    }
+}
+
+#undef SPAN_LOOP
+
+#if HAVE_SSE2_INTRINSICS
+/* Two pixels at a time, with a channel in each 16-bit lane and alpha in lanes 3 and 7 */
+
+SDL_FORCE_INLINE __m128i
+Div255_SSE2(__m128i x)
+{
+    x = _mm_add_epi16(x, _mm_set1_epi16(128));
+    return _mm_srli_epi16(_mm_add_epi16(x, _mm_srli_epi16(x, 8)), 8);
+}
+
+SDL_FORCE_INLINE __m128i
+Mul255_SSE2(__m128i a, __m128i b)
+{
+    return Div255_SSE2(_mm_mullo_epi16(a, b));
+}
+
+SDL_FORCE_INLINE __m128i
+Alpha_SSE2(__m128i x)
+{
+    return _mm_shufflehi_epi16(_mm_shufflelo_epi16(x, _MM_SHUFFLE(3, 3, 3, 3)), _MM_SHUFFLE(3, 3, 3, 3));
+}
+
+SDL_FORCE_INLINE __m128i
+BlendPixels_SSE2(__m128i src, __m128i dst)
+{
+    const __m128i sa = Alpha_SSE2(src);
+    /* The alpha of the result is sa * 255 + da * (255 - sa) */
+    const __m128i factor = _mm_or_si128(_mm_and_si128(sa, _mm_set_epi16(0, -1, -1, -1, 0, -1, -1, -1)),
+                                        _mm_set_epi16(255, 0, 0, 0, 255, 0, 0, 0));
+    return Div255_SSE2(_mm_add_epi16(_mm_mullo_epi16(src, factor),
+                                     _mm_mullo_epi16(dst, _mm_sub_epi16(_mm_set1_epi16(255), sa))));
+}
+
+SDL_FORCE_INLINE __m128i
+AddPixels_SSE2(__m128i src, __m128i dst)
+{
+    const __m128i rgb = _mm_set_epi16(0, -1, -1, -1, 0, -1, -1, -1);
+    return _mm_add_epi16(dst, _mm_and_si128(Mul255_SSE2(src, Alpha_SSE2(src)), rgb));
+}
+
+SDL_FORCE_INLINE __m128i
+ModPixels_SSE2(__m128i src, __m128i dst)
+{
+    const __m128i rgb = _mm_set_epi16(0, -1, -1, -1, 0, -1, -1, -1);
+    return _mm_or_si128(_mm_and_si128(Mul255_SSE2(src, dst), rgb), _mm_andnot_si128(rgb, dst));
+}
+
+SDL_FORCE_INLINE __m128i
+MulPixels_SSE2(__m128i src, __m128i dst)
+{
+    const __m128i rgb = _mm_set_epi16(0, -1, -1, -1, 0, -1, -1, -1);
+    const __m128i x = _mm_add_epi16(Mul255_SSE2(src, dst),
+                                    Mul255_SSE2(dst, _mm_sub_epi16(_mm_set1_epi16(255), Alpha_SSE2(src))));
+    return _mm_or_si128(_mm_and_si128(x, rgb), _mm_andnot_si128(rgb, dst));
+}
+
+/* The texels are fetched one at a time, the rest is done four pixels at a time.
+   The colors are stepped in 32-bit lanes, one channel per lane, and the
+   results over 255 are saturated when the pixels are packed again. */
+#define SPAN_LOOP_SSE2(op)                                                          \
+    for (i = 0; i + 4 <= count; i += 4) {                                           \
+        __m128i src_lo, src_hi, color_lo, color_hi, dstpixels, dst_lo, dst_hi;      \
+        if (tri->gouraud) {                                                         \
+            const __m128i c1 = _mm_add_epi32(c, dc);                                \
+            const __m128i c2 = _mm_add_epi32(c1, dc);                               \
+            const __m128i c3 = _mm_add_epi32(c2, dc);                               \
+            color_lo = _mm_packs_epi32(_mm_srai_epi32(c, 16), _mm_srai_epi32(c1, 16)); \
+            color_hi = _mm_packs_epi32(_mm_srai_epi32(c2, 16), _mm_srai_epi32(c3, 16)); \
+            c = _mm_add_epi32(c3, dc);                                              \
+        } else {                                                                    \
+            color_lo = color_hi = flat;                                             \
+        }                                                                           \
+        if (target->texels) {                                                       \
+            Uint32 texels[4];                                                       \
+            __m128i src;                                                            \
+            for (j = 0; j < 4; ++j) {                                               \
+                texels[j] = NextTexel(target, s);                                   \
+            }                                                                       \
+            src = _mm_loadu_si128((const __m128i *) texels);                        \
+            src_lo = _mm_unpacklo_epi8(src, zero);                                  \
+            src_hi = _mm_unpackhi_epi8(src, zero);                                  \
+            if (tri->modulate) {                                                    \
+                src_lo = Mul255_SSE2(src_lo, color_lo);                             \
+                src_hi = Mul255_SSE2(src_hi, color_hi);                             \
+            }                                                                       \
+        } else {                                                                    \
+            src_lo = color_lo;                                                      \
+            src_hi = color_hi;                                                      \
+        }                                                                           \
+        dstpixels = _mm_loadu_si128((const __m128i *) &dst[i]);                     \
+        dst_lo = _mm_unpacklo_epi8(dstpixels, zero);                                \
+        dst_hi = _mm_unpackhi_epi8(dstpixels, zero);                                \
+        dst_lo = op(src_lo, dst_lo);                                                \
+        dst_hi = op(src_hi, dst_hi);                                                \
+        _mm_storeu_si128((__m128i *) &dst[i],                                       \
+                         _mm_and_si128(_mm_packus_epi16(dst_lo, dst_hi), dstmask)); \
+    }
+
+#define COPY_PIXELS_SSE2(src, dst)  (src)
+
+/* Draw the first count & ~3 pixels of the span, returns how many were drawn */
+static int
+DrawSpan_SSE2(const SW_GeometryTarget *target, const SW_Triangle *tri, Uint32 *dst, int count, SW_SpanState *s)
+{
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i dstmask = _mm_set1_epi32((int) target->dstmask);
+    const __m128i flat = _mm_unpacklo_epi8(_mm_set1_epi32((int) tri->color), zero);
+    __m128i c = zero, dc = zero;
+    int i, j;
+
+    if (tri->gouraud) {
+        c = _mm_loadu_si128((const __m128i *) s->c);
+        dc = _mm_loadu_si128((const __m128i *) s->dc);
+    }
+
+    switch (target->blend) {
+    case SDL_BLENDMODE_BLEND:
+        SPAN_LOOP_SSE2(BlendPixels_SSE2);
+        break;
+    case SDL_BLENDMODE_ADD:
+        SPAN_LOOP_SSE2(AddPixels_SSE2);
+        break;
+    case SDL_BLENDMODE_MOD:
+        SPAN_LOOP_SSE2(ModPixels_SSE2);
+        break;
+    case SDL_BLENDMODE_MUL:
+        SPAN_LOOP_SSE2(MulPixels_SSE2);
+        break;
+    default:
+        SPAN_LOOP_SSE2(COPY_PIXELS_SSE2);
+        break;
+    }
+
+    if (tri->gouraud) {
+        _mm_storeu_si128((__m128i *) s->c, c);
+    }
+    return i;
+}
+
+#undef SPAN_LOOP_SSE2
+#undef COPY_PIXELS_SSE2
+#endif /* HAVE_SSE2_INTRINSICS */
+
+static void
+DrawRow(const SW_GeometryTarget *target, const SW_Triangle *tri, int y, int left, int right)
+{
+    const int count = right - left + 1;
+    const float fx = (float) left - tri->ox;
+    const float fy = (float) y - tri->oy;
+    Uint32 *dst = (Uint32 *) (target->pixels + (y - target->y) * target->pitch) + (left - target->x);
+    SW_SpanState s;
+    int k;
+
+    if (target->texels) {
+        s.u = (Sint64) ((tri->attr[ATTR_U] + tri->attr_dx[ATTR_U] * fx + tri->attr_dy[ATTR_U] * fy) * 65536.0f);
+        s.v = (Sint64) ((tri->attr[ATTR_V] + tri->attr_dx[ATTR_V] * fx + tri->attr_dy[ATTR_V] * fy) * 65536.0f);
+        s.du = tri->du;
+        s.dv = tri->dv;
+    }
+
+    if (tri->gouraud) {
+        for (k = 0; k < 4; ++k) {
+            const int a = ATTR_COLOR + k;
+            const float c = tri->attr[a] + tri->attr_dx[a] * fx + tri->attr_dy[a] * fy;
+            const int limit = (256 << 16) - 1;
+            Sint64 end;
+
+            /* Round, and keep the whole span in range in case the float math is a little off */
+            s.c[k] = (int) (ClampFloat(c, 256.0f) * 65536.0f + 32768.0f);
+            s.c[k] = SDL_max(SDL_min(s.c[k], limit), 0);
+            s.dc[k] = tri->dc[k];
+            end = (Sint64) s.c[k] + (Sint64) s.dc[k] * (count - 1);
+            if (end < 0 || end > limit) {
+                end = (end < 0) ? 0 : limit;
+                s.dc[k] = (int) ((end - s.c[k]) / SDL_max(count - 1, 1));
+            }
+        }
+    }
+
+#if HAVE_SSE2_INTRINSICS
+    if (count >= 4) {
+        const int drawn = DrawSpan_SSE2(target, tri, dst, count, &s);
+        DrawSpan(target, tri, dst + drawn, count - drawn, &s);
+        return;
+    }
+#endif
+    DrawSpan(target, tri, dst, count, &s);
+}
+
+static void
+RasterizeTriangle(const SW_GeometryTarget *target, const SW_Triangle *tri)
+{
+    int left[BLOCK_SIZE], right[BLOCK_SIZE];
+    int bx, by, x, y, k;
+
+    for (by = tri->miny & ~(BLOCK_SIZE - 1); by <= tri->maxy; by += BLOCK_SIZE) {
+        const int y0 = SDL_max(by, tri->miny);
+        const int y1 = SDL_min(by + BLOCK_SIZE - 1, tri->maxy);
+        SDL_bool covered = SDL_FALSE;
+
+        for (y = y0; y <= y1; ++y) {
+            left[y - by] = tri->maxx + 1;
+            right[y - by] = tri->minx - 1;
+        }
+
+        for (bx = tri->minx & ~(BLOCK_SIZE - 1); bx <= tri->maxx; bx += BLOCK_SIZE) {
+            const int x0 = SDL_max(bx, tri->minx);
+            const int x1 = SDL_min(bx + BLOCK_SIZE - 1, tri->maxx);
+            Sint64 e[3];
+            int inside = 0;
+
+            /* The edge functions are linear, so their extremes in the block are at its corners */
+            for (k = 0; k < 3; ++k) {
+                const Sint64 ex = tri->e_dx[k] * (x1 - x0);
+                const Sint64 ey = tri->e_dy[k] * (y1 - y0);
+                e[k] = tri->e[k] + tri->e_dx[k] * x0 + tri->e_dy[k] * y0;
+                if (e[k] + SDL_max(ex, 0) + SDL_max(ey, 0) < 0) {
+                    break;
+                }
+                if (e[k] + SDL_min(ex, 0) + SDL_min(ey, 0) >= 0) {
+                    ++inside;
+                }
+            }
+            if (k < 3) {
+                /* The rows of a triangle are contiguous, so nothing more to the right is covered */
+                if (covered) {
+                    break;
+                }
+                continue;
+            }
+
+            if (inside == 3) {
+                for (y = y0; y <= y1; ++y) {
+                    left[y - by] = SDL_min(left[y - by], x0);
+                    right[y - by] = x1;
+                }
+                covered = SDL_TRUE;
+                continue;
+            }
+
+            for (y = y0; y <= y1; ++y) {
+                Sint64 e0 = e[0] + tri->e_dy[0] * (y - y0);
+                Sint64 e1 = e[1] + tri->e_dy[1] * (y - y0);
+                Sint64 e2 = e[2] + tri->e_dy[2] * (y - y0);
+                int first = x1 + 1, last = x0 - 1;
+
+                for (x = x0; x <= x1; ++x) {
+                    if ((e0 | e1 | e2) >= 0) {
+                        if (first > x1) {
+                            first = x;
+                        }
+                        last = x;
+                    } else if (first <= x1) {
+                        break;
+                    }
+                    e0 += tri->e_dx[0];
+                    e1 += tri->e_dx[1];
+                    e2 += tri->e_dx[2];
+                }
+                if (first <= last) {
+                    left[y - by] = SDL_min(left[y - by], first);
+                    right[y - by] = SDL_max(right[y - by], last);
+                    covered = SDL_TRUE;
+                }
+            }
+        }
+
+        for (y = y0; y <= y1; ++y) {
+            if (left[y - by] <= right[y - by]) {
+                DrawRow(target, tri, y, left[y - by], right[y - by]);
+            }
+        }
+    }
+}
+
+static void
+RasterizeTriangles(const SW_GeometryTarget *target, const SDL_Vertex *vertices, int num_triangles, const SDL_Rect *clip)
+{
+    const float left = (float) clip->x - 1.0f;
+    const float top = (float) clip->y - 1.0f;
+    const float right = (float) (clip->x + clip->w) + 1.0f;
+    const float bottom = (float) (clip->y + clip->h) + 1.0f;
+    SW_Triangle tri;
+    int i;
+
+    for (i = 0; i < num_triangles; ++i, vertices += 3) {
+        const SDL_FPoint *p0 = &vertices[0].position;
+        const SDL_FPoint *p1 = &vertices[1].position;
+        const SDL_FPoint *p2 = &vertices[2].position;
+
+        /* Quickly skip triangles outside the clip rect before setting them up */
+        if ((p0->x < left && p1->x < left && p2->x < left) ||
+            (p0->y < top && p1->y < top && p2->y < top) ||
+            (p0->x > right && p1->x > right && p2->x > right) ||
+            (p0->y > bottom && p1->y > bottom && p2->y > bottom)) {
+            continue;
+        }
+        if (SetupTriangle(target, vertices, clip, &tri)) {
+            RasterizeTriangle(target, &tri);
+        }
+    }
+}
+
+typedef struct
+{
+    const SW_GeometryTarget *target;
+    const SDL_Vertex *vertices;
+    int num_triangles;
+    SDL_Rect area;
+    int top;                    /* The first row of the first band, a multiple of BLOCK_SIZE */
+    int band_height;            /* Also a multiple of BLOCK_SIZE, so bands don't share blocks */
+} SW_GeometryBands;
+
+static void SDLCALL
+RasterizeBands(int start, int end, void *data)
+{
+    const SW_GeometryBands *bands = (const SW_GeometryBands *) data;
+    int band;
+
+    for (band = start; band < end; ++band) {
+        const int y0 = SDL_max(bands->top + band * bands->band_height, bands->area.y);
+        const int y1 = SDL_min(bands->top + (band + 1) * bands->band_height, bands->area.y + bands->area.h);
+        SDL_Rect clip;
+
+        clip.x = bands->area.x;
+        clip.w = bands->area.w;
+        clip.y = y0;
+        clip.h = y1 - y0;
+        if (clip.h > 0) {
+            RasterizeTriangles(bands->target, bands->vertices, bands->num_triangles, &clip);
+        }
+    }
+}
+
+/* Targets that can be drawn to directly: 32-bit, with alpha (if any) in the top byte */
+static SDL_bool
+IsDirectTarget(const SDL_PixelFormat *format)
+{
+    return (format->BytesPerPixel == 4 &&
+            (format->Amask == 0 || format->Amask == 0xFF000000) &&
+            (format->Rmask | format->Gmask | format->Bmask) == 0x00FFFFFF &&
+            format->Rloss == 0 && format->Gloss == 0 && format->Bloss == 0);
+}
+
+static SDL_bool
+IsDirectTexture(const SDL_PixelFormat *format, const SDL_PixelFormat *target)
+{
+    return (format->BytesPerPixel == 4 &&
+            (format->Amask == 0 || format->Amask == 0xFF000000) &&
+            format->Rmask == target->Rmask && format->Gmask == target->Gmask && format->Bmask == target->Bmask);
+}
+
+int
+SDL_SW_RenderGeometry(SDL_Surface * dst, SDL_Surface * src,
+                      const SDL_Vertex * vertices, int num_vertices,
+                      SDL_BlendMode blend, SDL_JobPool * pool)
+{
+    SW_GeometryTarget target;
+    SDL_Surface *copy = NULL;
+    SDL_Surface *converted = NULL;
+    const SDL_PixelFormat *format = dst->format;
+    const int num_triangles = num_vertices / 3;
+    SDL_Rect area;
+    float minx, miny, maxx, maxy;
+    int i, retval = 0;
+
+    if (num_triangles == 0) {
+        return 0;
+    }
+
+    /* Only the part of the target inside the triangles is touched */
+    minx = maxx = vertices[0].position.x;
+    miny = maxy = vertices[0].position.y;
+    for (i = 1; i < num_triangles * 3; ++i) {
+        minx = SDL_min(minx, vertices[i].position.x);
+        miny = SDL_min(miny, vertices[i].position.y);
+        maxx = SDL_max(maxx, vertices[i].position.x);
+        maxy = SDL_max(maxy, vertices[i].position.y);
+    }
+    minx = SDL_max(minx, (float) dst->clip_rect.x);
+    miny = SDL_max(miny, (float) dst->clip_rect.y);
+    maxx = SDL_min(maxx, (float) (dst->clip_rect.x + dst->clip_rect.w));
+    maxy = SDL_min(maxy, (float) (dst->clip_rect.y + dst->clip_rect.h));
+    if (!(minx < maxx && miny < maxy)) {
+        return 0;
+    }
+    area.x = (int) SDL_floorf(minx);
+    area.y = (int) SDL_floorf(miny);
+    area.w = (int) SDL_ceilf(maxx) - area.x;
+    area.h = (int) SDL_ceilf(maxy) - area.y;
+
+    SDL_zero(target);
+    if (IsDirectTarget(format)) {
+        if (SDL_MUSTLOCK(dst) && SDL_LockSurface(dst) < 0) {
+            return -1;
+        }
+        target.pixels = (Uint8 *) dst->pixels;
+        target.pitch = dst->pitch;
+    } else {
+        /* Draw to a copy of the area, then convert it back */
+        copy = SDL_CreateRGBSurfaceWithFormat(0, area.w, area.h, 32, SDL_PIXELFORMAT_ARGB8888);
+        if (!copy) {
+            return -1;
+        }
+        if (SDL_MUSTLOCK(dst) && SDL_LockSurface(dst) < 0) {
+            SDL_FreeSurface(copy);
+            return -1;
+        }
+        SDL_ConvertPixels(area.w, area.h, format->format,
+                          (Uint8 *) dst->pixels + area.y * dst->pitch + area.x * format->BytesPerPixel, dst->pitch,
+                          copy->format->format, copy->pixels, copy->pitch);
+        format = copy->format;
+        target.pixels = (Uint8 *) copy->pixels;
+        target.pitch = copy->pitch;
+        target.x = area.x;
+        target.y = area.y;
+    }
+    target.dstmask = format->Amask ? 0xFFFFFFFF : 0x00FFFFFF;
+    target.shift[0] = format->Rshift;
+    target.shift[1] = format->Gshift;
+    target.shift[2] = format->Bshift;
+    target.shift[3] = 24;
+    target.blend = blend;
+
+    if (src) {
+        if (!IsDirectTexture(src->format, format)) {
+            converted = SDL_ConvertSurfaceFormat(src, SDL_MasksToPixelFormatEnum(32, format->Rmask, format->Gmask, format->Bmask, 0xFF000000), 0);
+            if (!converted) {
+                retval = -1;
+                goto done;
+            }
+            src = converted;
+        }
+        if (SDL_MUSTLOCK(src) && SDL_LockSurface(src) < 0) {
+            retval = -1;
+            goto done;
+        }
+        target.texels = (const Uint32 *) src->pixels;
+        target.texpitch = src->pitch / 4;
+        target.texw = src->w;
+        target.texh = src->h;
+        target.texalpha = src->format->Amask ? 0 : 0xFF000000;
+    }
+
+    if (pool && num_triangles >= MIN_PARALLEL_TRIANGLES && area.h >= 2 * MIN_BAND_HEIGHT) {
+        SW_GeometryBands bands;
+        const int num_threads = SDL_GetJobPoolThreadCount(pool) + 1;
+        int num_bands;
+
+        /* A few bands per thread, so uneven bands even out */
+        bands.target = &target;
+        bands.vertices = vertices;
+        bands.num_triangles = num_triangles;
+        bands.area = area;
+        bands.top = area.y & ~(BLOCK_SIZE - 1);
+        bands.band_height = (area.y + area.h - bands.top) / (num_threads * 4);
+        bands.band_height = SDL_max(bands.band_height, MIN_BAND_HEIGHT);
+        bands.band_height = (bands.band_height + BLOCK_SIZE - 1) & ~(BLOCK_SIZE - 1);
+        num_bands = (area.y + area.h - bands.top + bands.band_height - 1) / bands.band_height;
+        retval = SDL_ParallelFor(pool, 0, num_bands, 1, RasterizeBands, &bands);
+    } else {
+        RasterizeTriangles(&target, vertices, num_triangles, &area);
+    }
+
+    if (src && SDL_MUSTLOCK(src)) {
+        SDL_UnlockSurface(src);
+    }
+
+done:
+    if (copy) {
+        /* dst->pixels is only valid while the surface is locked */
+        if (retval == 0) {
+            SDL_ConvertPixels(area.w, area.h, copy->format->format, copy->pixels, copy->pitch, dst->format->format,
+                              (Uint8 *) dst->pixels + area.y * dst->pitch + area.x * dst->format->BytesPerPixel, dst->pitch);
+        }
+        SDL_FreeSurface(copy);
+    }
+    if (SDL_MUSTLOCK(dst)) {
+        SDL_UnlockSurface(dst);
+    }
+    SDL_FreeSurface(converted);
+    return retval;
+}
+
+#endif /* SDL_VIDEO_RENDER_SW && !SDL_RENDER_DISABLED */
+
+/* vi: set ts=4 sw=4 expandtab: */
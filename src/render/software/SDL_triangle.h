@@ -0,0 +1,41 @@
+/*
+  Simple DirectMedia Layer
+  Copyright (C) 1997-2020 Sam Lantinga <slouken@libsdl.org>
+
+  This software is provided 'as-is', without any express or implied
+  warranty.  In no event will the authors be held liable for any damages
+  arising from the use of this software.
+
+  Permission is granted to anyone to use this software for any purpose,
+  including commercial applications, and to alter it and redistribute it
+  freely, subject to the following restrictions:
+
+  1. The origin of this software must not be misrepresented; you must not
+     claim that you wrote the original software. If you use this software
+     in a product, an acknowledgment in the product documentation would be
+     appreciated but is not required.
+  2. Altered source versions must be plainly marked as such, and must not be
+     misrepresented as being the original software.
+  3. This notice may not be removed or altered from any source distribution.
+*/
+
+#ifndef SDL_triangle_h_
+#define SDL_triangle_h_
+
+#include "../../SDL_internal.h"
+
+#include "SDL_render.h"
+#include "SDL_jobs.h"
+
+/* Draw a list of triangles, clipped to the surface's clip rect.
+   The positions are in surface pixels and the texture coordinates in texels.
+   Triangles with a vertex more than 4194304 pixels from the origin are
+   skipped rather than clipped.
+   If a job pool is given, long lists are split across its threads. */
+extern int SDL_SW_RenderGeometry(SDL_Surface * dst, SDL_Surface * src,
+                                 const SDL_Vertex * vertices, int num_vertices,
+                                 SDL_BlendMode blend, SDL_JobPool * pool);
+
+#endif /* SDL_triangle_h_ */
+
+/* vi: set ts=4 sw=4 expandtab: */
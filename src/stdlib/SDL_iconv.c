@@ -29,6 +29,7 @@
 
 #include "SDL_stdinc.h"
 #include "SDL_endian.h"
+#include "SDL_cpuinfo.h"
 
 #if defined(HAVE_ICONV) && defined(HAVE_ICONV_H)
 #include <iconv.h>
@@ -244,6 +245,619 @@ SDL_iconv_open(const char *tocode, const char *fromcode)
     return (SDL_iconv_t) - 1;
 }
 
+/* Fast paths for the conversions SDL makes most, between UTF-8 and UTF-16,
+   UTF-32 and Latin-1. Runs of ASCII are converted a vector at a time, and
+   other characters directly from one encoding to the other. These convert
+   as much as they can, and stop at anything the general loop in SDL_iconv()
+   has to deal with: malformed or truncated input, characters that are
+   replaced in the output, or output that doesn't fit.
+
+   Like the rest of this converter, they're only built when SDL doesn't use
+   the system iconv. */
+
+#if defined(__SSE2__)
+#define HAVE_SSE2_INTRINSICS 1
+#elif defined(__ARM_NEON) && (SDL_BYTEORDER == SDL_LIL_ENDIAN)
+#define HAVE_NEON_INTRINSICS 1
+#endif
+
+#if HAVE_NEON_INTRINSICS
+SDL_FORCE_INLINE SDL_bool
+SDL_IsASCII_NEON(uint8x16_t v)
+{
+    uint8x8_t bits = vorr_u8(vget_low_u8(v), vget_high_u8(v));
+    return (vget_lane_u64(vreinterpret_u64_u8(bits), 0) & 0x8080808080808080ULL) ? SDL_FALSE : SDL_TRUE;
+}
+#endif
+
+/* Copy the ASCII characters at the start of src, up to count of them */
+static size_t
+SDL_CopyASCII(const Uint8 *src, Uint8 *dst, size_t count)
+{
+    size_t i = 0;
+
+#if HAVE_SSE2_INTRINSICS
+    for (; i + 16 <= count; i += 16) {
+        const __m128i v = _mm_loadu_si128((const __m128i *) (src + i));
+        if (_mm_movemask_epi8(v)) {
+            break;
+        }
+        _mm_storeu_si128((__m128i *) (dst + i), v);
+    }
+#elif HAVE_NEON_INTRINSICS
+    for (; i + 16 <= count; i += 16) {
+        const uint8x16_t v = vld1q_u8(src + i);
+        if (!SDL_IsASCII_NEON(v)) {
+            break;
+        }
+        vst1q_u8(dst + i, v);
+    }
+#endif
+    for (; i < count && src[i] < 0x80; ++i) {
+        dst[i] = src[i];
+    }
+    return i;
+}
+
+/* Widen the ASCII characters at the start of src to UTF-16LE */
+static size_t
+SDL_WidenASCII16(const Uint8 *src, Uint8 *dst, size_t count)
+{
+    size_t i = 0;
+
+#if HAVE_SSE2_INTRINSICS
+    const __m128i zero = _mm_setzero_si128();
+    for (; i + 16 <= count; i += 16) {
+        const __m128i v = _mm_loadu_si128((const __m128i *) (src + i));
+        if (_mm_movemask_epi8(v)) {
+            break;
+        }
+        _mm_storeu_si128((__m128i *) (dst + i * 2), _mm_unpacklo_epi8(v, zero));
+        _mm_storeu_si128((__m128i *) (dst + i * 2 + 16), _mm_unpackhi_epi8(v, zero));
+    }
+#elif HAVE_NEON_INTRINSICS
+    for (; i + 16 <= count; i += 16) {
+        const uint8x16_t v = vld1q_u8(src + i);
+        if (!SDL_IsASCII_NEON(v)) {
+            break;
+        }
+        vst1q_u8(dst + i * 2, vreinterpretq_u8_u16(vmovl_u8(vget_low_u8(v))));
+        vst1q_u8(dst + i * 2 + 16, vreinterpretq_u8_u16(vmovl_u8(vget_high_u8(v))));
+    }
+#endif
+    for (; i < count && src[i] < 0x80; ++i) {
+        dst[i * 2] = src[i];
+        dst[i * 2 + 1] = 0;
+    }
+    return i;
+}
+
+/* Widen the ASCII characters at the start of src to UTF-32LE */
+static size_t
+SDL_WidenASCII32(const Uint8 *src, Uint8 *dst, size_t count)
+{
+    size_t i = 0;
+
+#if HAVE_SSE2_INTRINSICS
+    const __m128i zero = _mm_setzero_si128();
+    for (; i + 16 <= count; i += 16) {
+        const __m128i v = _mm_loadu_si128((const __m128i *) (src + i));
+        __m128i lo, hi;
+        if (_mm_movemask_epi8(v)) {
+            break;
+        }
+        lo = _mm_unpacklo_epi8(v, zero);
+        hi = _mm_unpackhi_epi8(v, zero);
+        _mm_storeu_si128((__m128i *) (dst + i * 4), _mm_unpacklo_epi16(lo, zero));
+        _mm_storeu_si128((__m128i *) (dst + i * 4 + 16), _mm_unpackhi_epi16(lo, zero));
+        _mm_storeu_si128((__m128i *) (dst + i * 4 + 32), _mm_unpacklo_epi16(hi, zero));
+        _mm_storeu_si128((__m128i *) (dst + i * 4 + 48), _mm_unpackhi_epi16(hi, zero));
+    }
+#elif HAVE_NEON_INTRINSICS
+    for (; i + 16 <= count; i += 16) {
+        const uint8x16_t v = vld1q_u8(src + i);
+        uint16x8_t lo, hi;
+        if (!SDL_IsASCII_NEON(v)) {
+            break;
+        }
+        lo = vmovl_u8(vget_low_u8(v));
+        hi = vmovl_u8(vget_high_u8(v));
+        vst1q_u8(dst + i * 4, vreinterpretq_u8_u32(vmovl_u16(vget_low_u16(lo))));
+        vst1q_u8(dst + i * 4 + 16, vreinterpretq_u8_u32(vmovl_u16(vget_high_u16(lo))));
+        vst1q_u8(dst + i * 4 + 32, vreinterpretq_u8_u32(vmovl_u16(vget_low_u16(hi))));
+        vst1q_u8(dst + i * 4 + 48, vreinterpretq_u8_u32(vmovl_u16(vget_high_u16(hi))));
+    }
+#endif
+    for (; i < count && src[i] < 0x80; ++i) {
+        dst[i * 4] = src[i];
+        dst[i * 4 + 1] = 0;
+        dst[i * 4 + 2] = 0;
+        dst[i * 4 + 3] = 0;
+    }
+    return i;
+}
+
+/* Narrow the ASCII characters at the start of UTF-16LE src to bytes */
+static size_t
+SDL_NarrowASCII16(const Uint8 *src, Uint8 *dst, size_t count)
+{
+    size_t i = 0;
+
+#if HAVE_SSE2_INTRINSICS
+    const __m128i mask = _mm_set1_epi16((short) 0xFF80);
+    const __m128i zero = _mm_setzero_si128();
+    for (; i + 16 <= count; i += 16) {
+        const __m128i a = _mm_loadu_si128((const __m128i *) (src + i * 2));
+        const __m128i b = _mm_loadu_si128((const __m128i *) (src + i * 2 + 16));
+        const __m128i high = _mm_and_si128(_mm_or_si128(a, b), mask);
+        if (_mm_movemask_epi8(_mm_cmpeq_epi16(high, zero)) != 0xFFFF) {
+            break;
+        }
+        _mm_storeu_si128((__m128i *) (dst + i), _mm_packus_epi16(a, b));
+    }
+#elif HAVE_NEON_INTRINSICS
+    for (; i + 16 <= count; i += 16) {
+        const uint16x8_t a = vreinterpretq_u16_u8(vld1q_u8(src + i * 2));
+        const uint16x8_t b = vreinterpretq_u16_u8(vld1q_u8(src + i * 2 + 16));
+        const uint16x8_t high = vandq_u16(vorrq_u16(a, b), vdupq_n_u16(0xFF80));
+        const uint16x4_t bits = vorr_u16(vget_low_u16(high), vget_high_u16(high));
+        if (vget_lane_u64(vreinterpret_u64_u16(bits), 0)) {
+            break;
+        }
+        vst1q_u8(dst + i, vcombine_u8(vmovn_u16(a), vmovn_u16(b)));
+    }
+#endif
+    for (; i < count && src[i * 2] < 0x80 && src[i * 2 + 1] == 0; ++i) {
+        dst[i] = src[i * 2];
+    }
+    return i;
+}
+
+/* Narrow the ASCII characters at the start of UTF-32LE src to bytes */
+static size_t
+SDL_NarrowASCII32(const Uint8 *src, Uint8 *dst, size_t count)
+{
+    size_t i = 0;
+
+#if HAVE_SSE2_INTRINSICS
+    const __m128i mask = _mm_set1_epi32((int) 0xFFFFFF80);
+    const __m128i zero = _mm_setzero_si128();
+    for (; i + 16 <= count; i += 16) {
+        const __m128i a = _mm_loadu_si128((const __m128i *) (src + i * 4));
+        const __m128i b = _mm_loadu_si128((const __m128i *) (src + i * 4 + 16));
+        const __m128i c = _mm_loadu_si128((const __m128i *) (src + i * 4 + 32));
+        const __m128i d = _mm_loadu_si128((const __m128i *) (src + i * 4 + 48));
+        const __m128i high = _mm_and_si128(_mm_or_si128(_mm_or_si128(a, b), _mm_or_si128(c, d)), mask);
+        if (_mm_movemask_epi8(_mm_cmpeq_epi32(high, zero)) != 0xFFFF) {
+            break;
+        }
+        _mm_storeu_si128((__m128i *) (dst + i), _mm_packus_epi16(_mm_packs_epi32(a, b), _mm_packs_epi32(c, d)));
+    }
+#elif HAVE_NEON_INTRINSICS
+    for (; i + 16 <= count; i += 16) {
+        const uint32x4_t a = vreinterpretq_u32_u8(vld1q_u8(src + i * 4));
+        const uint32x4_t b = vreinterpretq_u32_u8(vld1q_u8(src + i * 4 + 16));
+        const uint32x4_t c = vreinterpretq_u32_u8(vld1q_u8(src + i * 4 + 32));
+        const uint32x4_t d = vreinterpretq_u32_u8(vld1q_u8(src + i * 4 + 48));
+        const uint32x4_t high = vandq_u32(vorrq_u32(vorrq_u32(a, b), vorrq_u32(c, d)), vdupq_n_u32(0xFFFFFF80));
+        const uint32x2_t bits = vorr_u32(vget_low_u32(high), vget_high_u32(high));
+        if (vget_lane_u64(vreinterpret_u64_u32(bits), 0)) {
+            break;
+        }
+        vst1q_u8(dst + i, vcombine_u8(vmovn_u16(vcombine_u16(vmovn_u32(a), vmovn_u32(b))),
+                                      vmovn_u16(vcombine_u16(vmovn_u32(c), vmovn_u32(d)))));
+    }
+#endif
+    for (; i < count && src[i * 4] < 0x80 && !src[i * 4 + 1] && !src[i * 4 + 2] && !src[i * 4 + 3]; ++i) {
+        dst[i] = src[i * 4];
+    }
+    return i;
+}
+
+/* Decode a well formed UTF-8 sequence, returning its length, or 0 if it's
+   malformed, truncated, or a character the general loop replaces. */
+SDL_FORCE_INLINE size_t
+SDL_DecodeUTF8(const Uint8 *p, size_t len, Uint32 *ch)
+{
+    if (p[0] < 0x80) {
+        *ch = p[0];
+        return 1;
+    } else if (p[0] < 0xC2) {
+        return 0;
+    } else if (p[0] < 0xE0) {
+        if (len < 2 || (p[1] & 0xC0) != 0x80) {
+            return 0;
+        }
+        *ch = ((Uint32) (p[0] & 0x1F) << 6) | (p[1] & 0x3F);
+        return 2;
+    } else if (p[0] < 0xF0) {
+        if (len < 3 || (p[1] & 0xC0) != 0x80 || (p[2] & 0xC0) != 0x80) {
+            return 0;
+        }
+        *ch = ((Uint32) (p[0] & 0x0F) << 12) | ((Uint32) (p[1] & 0x3F) << 6) | (p[2] & 0x3F);
+        if (*ch < 0x800 || (*ch >= 0xD800 && *ch <= 0xDFFF) || *ch >= 0xFFFE) {
+            return 0;
+        }
+        return 3;
+    } else if (p[0] < 0xF5) {
+        if (len < 4 || (p[1] & 0xC0) != 0x80 || (p[2] & 0xC0) != 0x80 || (p[3] & 0xC0) != 0x80) {
+            return 0;
+        }
+        *ch = ((Uint32) (p[0] & 0x07) << 18) | ((Uint32) (p[1] & 0x3F) << 12) |
+              ((Uint32) (p[2] & 0x3F) << 6) | (p[3] & 0x3F);
+        if (*ch < 0x10000 || *ch > 0x10FFFF) {
+            return 0;
+        }
+        return 4;
+    }
+    return 0;
+}
+
+/* Encode a character up to U+10FFFF as UTF-8, returning its length, or 0
+   if there isn't room for it. */
+SDL_FORCE_INLINE size_t
+SDL_EncodeUTF8(Uint32 ch, Uint8 *p, size_t len)
+{
+    if (ch <= 0x7F) {
+        if (len < 1) {
+            return 0;
+        }
+        p[0] = (Uint8) ch;
+        return 1;
+    } else if (ch <= 0x7FF) {
+        if (len < 2) {
+            return 0;
+        }
+        p[0] = 0xC0 | (Uint8) (ch >> 6);
+        p[1] = 0x80 | (Uint8) (ch & 0x3F);
+        return 2;
+    } else if (ch <= 0xFFFF) {
+        if (len < 3) {
+            return 0;
+        }
+        p[0] = 0xE0 | (Uint8) (ch >> 12);
+        p[1] = 0x80 | (Uint8) ((ch >> 6) & 0x3F);
+        p[2] = 0x80 | (Uint8) (ch & 0x3F);
+        return 3;
+    } else {
+        if (len < 4) {
+            return 0;
+        }
+        p[0] = 0xF0 | (Uint8) (ch >> 18);
+        p[1] = 0x80 | (Uint8) ((ch >> 12) & 0x3F);
+        p[2] = 0x80 | (Uint8) ((ch >> 6) & 0x3F);
+        p[3] = 0x80 | (Uint8) (ch & 0x3F);
+        return 4;
+    }
+}
+
+typedef size_t (*SDL_iconv_fastpath)(const Uint8 **src, size_t *srclen, Uint8 **dst, size_t *dstlen);
+
+static size_t
+SDL_iconv_UTF8_to_UTF16LE(const Uint8 **src, size_t *srclen, Uint8 **dst, size_t *dstlen)
+{
+    const Uint8 *s = *src;
+    Uint8 *d = *dst;
+    size_t slen = *srclen, dlen = *dstlen, total = 0;
+
+    while (slen > 0) {
+        size_t n;
+        Uint32 ch;
+
+        if (s[0] < 0x80) {
+            n = SDL_WidenASCII16(s, d, SDL_min(slen, dlen / 2));
+            if (!n) {
+                break;
+            }
+            s += n;
+            slen -= n;
+            d += n * 2;
+            dlen -= n * 2;
+            total += n;
+            continue;
+        }
+
+        n = SDL_DecodeUTF8(s, slen, &ch);
+        if (!n) {
+            break;
+        }
+        if (ch < 0x10000) {
+            if (dlen < 2) {
+                break;
+            }
+            d[0] = (Uint8) ch;
+            d[1] = (Uint8) (ch >> 8);
+            d += 2;
+            dlen -= 2;
+        } else {
+            Uint16 W1, W2;
+            if (dlen < 4) {
+                break;
+            }
+            ch -= 0x10000;
+            W1 = 0xD800 | (Uint16) (ch >> 10);
+            W2 = 0xDC00 | (Uint16) (ch & 0x3FF);
+            d[0] = (Uint8) W1;
+            d[1] = (Uint8) (W1 >> 8);
+            d[2] = (Uint8) W2;
+            d[3] = (Uint8) (W2 >> 8);
+            d += 4;
+            dlen -= 4;
+        }
+        s += n;
+        slen -= n;
+        ++total;
+    }
+
+    *src = s;
+    *srclen = slen;
+    *dst = d;
+    *dstlen = dlen;
+    return total;
+}
+
+static size_t
+SDL_iconv_UTF8_to_UTF32LE(const Uint8 **src, size_t *srclen, Uint8 **dst, size_t *dstlen)
+{
+    const Uint8 *s = *src;
+    Uint8 *d = *dst;
+    size_t slen = *srclen, dlen = *dstlen, total = 0;
+
+    while (slen > 0) {
+        size_t n;
+        Uint32 ch;
+
+        if (s[0] < 0x80) {
+            n = SDL_WidenASCII32(s, d, SDL_min(slen, dlen / 4));
+            if (!n) {
+                break;
+            }
+            s += n;
+            slen -= n;
+            d += n * 4;
+            dlen -= n * 4;
+            total += n;
+            continue;
+        }
+
+        n = SDL_DecodeUTF8(s, slen, &ch);
+        if (!n || dlen < 4) {
+            break;
+        }
+        d[0] = (Uint8) ch;
+        d[1] = (Uint8) (ch >> 8);
+        d[2] = (Uint8) (ch >> 16);
+        d[3] = 0;
+        d += 4;
+        dlen -= 4;
+        s += n;
+        slen -= n;
+        ++total;
+    }
+
+    *src = s;
+    *srclen = slen;
+    *dst = d;
+    *dstlen = dlen;
+    return total;
+}
+
+static size_t
+SDL_iconv_UTF8_to_LATIN1(const Uint8 **src, size_t *srclen, Uint8 **dst, size_t *dstlen)
+{
+    const Uint8 *s = *src;
+    Uint8 *d = *dst;
+    size_t slen = *srclen, dlen = *dstlen, total = 0;
+
+    while (slen > 0) {
+        size_t n;
+        Uint32 ch;
+
+        if (s[0] < 0x80) {
+            n = SDL_CopyASCII(s, d, SDL_min(slen, dlen));
+            if (!n) {
+                break;
+            }
+            s += n;
+            slen -= n;
+            d += n;
+            dlen -= n;
+            total += n;
+            continue;
+        }
+
+        n = SDL_DecodeUTF8(s, slen, &ch);
+        if (!n || ch > 0xFF || !dlen) {
+            break;
+        }
+        *d++ = (Uint8) ch;
+        --dlen;
+        s += n;
+        slen -= n;
+        ++total;
+    }
+
+    *src = s;
+    *srclen = slen;
+    *dst = d;
+    *dstlen = dlen;
+    return total;
+}
+
+static size_t
+SDL_iconv_LATIN1_to_UTF8(const Uint8 **src, size_t *srclen, Uint8 **dst, size_t *dstlen)
+{
+    const Uint8 *s = *src;
+    Uint8 *d = *dst;
+    size_t slen = *srclen, dlen = *dstlen, total = 0;
+
+    while (slen > 0) {
+        if (s[0] < 0x80) {
+            size_t n = SDL_CopyASCII(s, d, SDL_min(slen, dlen));
+            if (!n) {
+                break;
+            }
+            s += n;
+            slen -= n;
+            d += n;
+            dlen -= n;
+            total += n;
+            continue;
+        }
+
+        if (dlen < 2) {
+            break;
+        }
+        d[0] = 0xC0 | (s[0] >> 6);
+        d[1] = 0x80 | (s[0] & 0x3F);
+        d += 2;
+        dlen -= 2;
+        ++s;
+        --slen;
+        ++total;
+    }
+
+    *src = s;
+    *srclen = slen;
+    *dst = d;
+    *dstlen = dlen;
+    return total;
+}
+
+static size_t
+SDL_iconv_UTF16LE_to_UTF8(const Uint8 **src, size_t *srclen, Uint8 **dst, size_t *dstlen)
+{
+    const Uint8 *s = *src;
+    Uint8 *d = *dst;
+    size_t slen = *srclen, dlen = *dstlen, total = 0;
+
+    while (slen >= 2) {
+        Uint32 ch = ((Uint32) s[1] << 8) | s[0];
+        size_t n, used;
+
+        if (ch < 0x80) {
+            n = SDL_NarrowASCII16(s, d, SDL_min(slen / 2, dlen));
+            if (!n) {
+                break;
+            }
+            s += n * 2;
+            slen -= n * 2;
+            d += n;
+            dlen -= n;
+            total += n;
+            continue;
+        }
+
+        if (ch >= 0xD800 && ch <= 0xDBFF) {
+            const Uint32 W2 = (slen < 4) ? 0 : (((Uint32) s[3] << 8) | s[2]);
+            if (W2 < 0xDC00 || W2 > 0xDFFF) {
+                break;
+            }
+            ch = (((ch & 0x3FF) << 10) | (W2 & 0x3FF)) + 0x10000;
+            n = 4;
+        } else if (ch >= 0xDC00 && ch <= 0xDFFF) {
+            break;
+        } else {
+            n = 2;
+        }
+        used = SDL_EncodeUTF8(ch, d, dlen);
+        if (!used) {
+            break;
+        }
+        d += used;
+        dlen -= used;
+        s += n;
+        slen -= n;
+        ++total;
+    }
+
+    *src = s;
+    *srclen = slen;
+    *dst = d;
+    *dstlen = dlen;
+    return total;
+}
+
+static size_t
+SDL_iconv_UTF32LE_to_UTF8(const Uint8 **src, size_t *srclen, Uint8 **dst, size_t *dstlen)
+{
+    const Uint8 *s = *src;
+    Uint8 *d = *dst;
+    size_t slen = *srclen, dlen = *dstlen, total = 0;
+
+    while (slen >= 4) {
+        const Uint32 ch = ((Uint32) s[3] << 24) | ((Uint32) s[2] << 16) | ((Uint32) s[1] << 8) | s[0];
+        size_t n;
+
+        if (ch < 0x80) {
+            n = SDL_NarrowASCII32(s, d, SDL_min(slen / 4, dlen));
+            if (!n) {
+                break;
+            }
+            s += n * 4;
+            slen -= n * 4;
+            d += n;
+            dlen -= n;
+            total += n;
+            continue;
+        }
+
+        if (ch > 0x10FFFF) {
+            break;
+        }
+        n = SDL_EncodeUTF8(ch, d, dlen);
+        if (!n) {
+            break;
+        }
+        d += n;
+        dlen -= n;
+        s += 4;
+        slen -= 4;
+        ++total;
+    }
+
+    *src = s;
+    *srclen = slen;
+    *dst = d;
+    *dstlen = dlen;
+    return total;
+}
+
+static SDL_iconv_fastpath
+SDL_iconv_GetFastPath(int src_fmt, int dst_fmt)
+{
+    switch (src_fmt) {
+    case ENCODING_UTF8:
+        switch (dst_fmt) {
+        case ENCODING_UTF16LE:
+            return SDL_iconv_UTF8_to_UTF16LE;
+        case ENCODING_UTF32LE:
+        case ENCODING_UCS4LE:
+            return SDL_iconv_UTF8_to_UTF32LE;
+        case ENCODING_LATIN1:
+            return SDL_iconv_UTF8_to_LATIN1;
+        }
+        break;
+    case ENCODING_LATIN1:
+        if (dst_fmt == ENCODING_UTF8) {
+            return SDL_iconv_LATIN1_to_UTF8;
+        }
+        break;
+    case ENCODING_UTF16LE:
+        if (dst_fmt == ENCODING_UTF8) {
+            return SDL_iconv_UTF16LE_to_UTF8;
+        }
+        break;
+    case ENCODING_UTF32LE:
+    case ENCODING_UCS4LE:
+        if (dst_fmt == ENCODING_UTF8) {
+            return SDL_iconv_UTF32LE_to_UTF8;
+        }
+        break;
+    }
+    return NULL;
+}
+
 size_t
 SDL_iconv(SDL_iconv_t cd,
           const char **inbuf, size_t * inbytesleft,
@@ -255,6 +869,7 @@ SDL_iconv(SDL_iconv_t cd,
     size_t srclen, dstlen;
     Uint32 ch = 0;
     size_t total;
+    SDL_iconv_fastpath fastpath;
 
     if (!inbuf || !*inbuf) {
         /* Reset the context */
@@ -340,8 +955,24 @@ SDL_iconv(SDL_iconv_t cd,
         break;
     }
 
+    fastpath = SDL_iconv_GetFastPath(cd->src_fmt, cd->dst_fmt);
+
     total = 0;
     while (srclen > 0) {
+        if (fastpath) {
+            size_t converted = fastpath((const Uint8 **) &src, &srclen, (Uint8 **) &dst, &dstlen);
+            if (converted) {
+                *inbuf = src;
+                *inbytesleft = srclen;
+                *outbuf = dst;
+                *outbytesleft = dstlen;
+                total += converted;
+                if (!srclen) {
+                    break;
+                }
+            }
+        }
+
         /* Decode a character */
         switch (cd->src_fmt) {
         case ENCODING_ASCII:
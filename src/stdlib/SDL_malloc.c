@@ -28,7 +28,9 @@
 /* This file contains portable memory management functions for SDL */
 #include "SDL_stdinc.h"
 #include "SDL_atomic.h"
+#include "SDL_cpuinfo.h"
 #include "SDL_error.h"
+#include "../thread/SDL_thread_c.h"
 
 #ifndef HAVE_MALLOC
 #define LACKS_SYS_TYPES_H
@@ -5322,11 +5324,163 @@ static struct
     SDL_calloc_func calloc_func;
     SDL_realloc_func realloc_func;
     SDL_free_func free_func;
-    SDL_atomic_t num_allocations;
 } s_mem = {
-    real_malloc, real_calloc, real_realloc, real_free, { 0 }
+    real_malloc, real_calloc, real_realloc, real_free
 };
 
+/* The number of outstanding allocations is split across several counters,
+   each on its own cache line, and each thread only updates the one it was
+   given. SDL_GetNumAllocations() adds them up. */
+#ifdef SDL_THREAD_LOCAL
+#define NUM_ALLOCATION_COUNTERS 16
+#else
+#define NUM_ALLOCATION_COUNTERS 1
+#endif
+
+typedef struct
+{
+    SDL_atomic_t count;
+    char padding[SDL_CACHELINE_SIZE - sizeof (SDL_atomic_t)];
+} SDL_AllocationCounter;
+
+static SDL_AllocationCounter s_num_allocations[NUM_ALLOCATION_COUNTERS];
+
+#ifdef SDL_THREAD_LOCAL
+static SDL_THREAD_LOCAL SDL_atomic_t *SDL_allocation_counter;
+static SDL_atomic_t s_next_allocation_counter;
+
+static SDL_atomic_t *
+SDL_GetAllocationCounter(void)
+{
+    SDL_atomic_t *counter = SDL_allocation_counter;
+
+    if (!counter) {
+        unsigned int index = (unsigned int) SDL_AtomicAdd(&s_next_allocation_counter, 1);
+        counter = &s_num_allocations[index % NUM_ALLOCATION_COUNTERS].count;
+        SDL_allocation_counter = counter;
+    }
+    return counter;
+}
+#else
+#define SDL_GetAllocationCounter() (&s_num_allocations[0].count)
+#endif
+
+#if !defined(HAVE_MALLOC) && defined(SDL_THREAD_LOCAL)
+/* Small blocks freed by a thread are kept on freelists of that thread, one
+   per size class, and handed out again by it without taking the allocator
+   lock. The freelists are given back to dlmalloc when the thread exits. */
+#define SDL_MALLOC_THREAD_CACHE
+
+#define CACHE_GRANULARITY   16
+#define CACHE_NUM_CLASSES   16  /* blocks of up to 256 bytes */
+#define CACHE_CLASS_DEPTH   32  /* blocks kept for each size class */
+
+typedef struct SDL_CachedBlock
+{
+    struct SDL_CachedBlock *next;
+} SDL_CachedBlock;
+
+typedef struct
+{
+    SDL_CachedBlock *blocks[CACHE_NUM_CLASSES + 1];
+    int num_blocks[CACHE_NUM_CLASSES + 1];
+    SDL_bool registered;
+    SDL_bool disabled;
+} SDL_MallocCache;
+
+static SDL_THREAD_LOCAL SDL_MallocCache SDL_malloc_cache;
+static SDL_TLSID SDL_malloc_cache_tls;
+static SDL_SpinLock SDL_malloc_cache_lock;
+
+static void SDLCALL
+SDL_FlushMallocCache(void *data)
+{
+    SDL_MallocCache *cache = (SDL_MallocCache *) data;
+    int i;
+
+    /* Anything freed by this thread from now on goes straight to dlmalloc */
+    cache->disabled = SDL_TRUE;
+
+    for (i = 0; i <= CACHE_NUM_CLASSES; ++i) {
+        SDL_CachedBlock *block = cache->blocks[i];
+        while (block) {
+            SDL_CachedBlock *next = block->next;
+            dlfree(block);
+            block = next;
+        }
+        cache->blocks[i] = NULL;
+        cache->num_blocks[i] = 0;
+    }
+}
+
+static void
+SDL_RegisterMallocCache(SDL_MallocCache *cache)
+{
+    /* Set first, SDL_TLSSet() allocates memory itself */
+    cache->registered = SDL_TRUE;
+
+    if (!SDL_malloc_cache_tls) {
+        SDL_AtomicLock(&SDL_malloc_cache_lock);
+        if (!SDL_malloc_cache_tls) {
+            SDL_TLSID tls = SDL_TLSCreate();
+            SDL_MemoryBarrierRelease();
+            SDL_malloc_cache_tls = tls;
+        }
+        SDL_AtomicUnlock(&SDL_malloc_cache_lock);
+    }
+    SDL_MemoryBarrierAcquire();
+
+    if (SDL_TLSSet(SDL_malloc_cache_tls, cache, SDL_FlushMallocCache) < 0) {
+        /* The blocks couldn't be given back at thread exit */
+        cache->disabled = SDL_TRUE;
+    }
+}
+
+static void *
+SDL_CacheAlloc(size_t size)
+{
+    SDL_MallocCache *cache = &SDL_malloc_cache;
+    size_t index = (size + CACHE_GRANULARITY - 1) / CACHE_GRANULARITY;
+    SDL_CachedBlock *block;
+
+    if (index > CACHE_NUM_CLASSES) {
+        return NULL;
+    }
+
+    block = cache->blocks[index];
+    if (block) {
+        cache->blocks[index] = block->next;
+        --cache->num_blocks[index];
+    }
+    return block;
+}
+
+static SDL_bool
+SDL_CacheFree(void *ptr)
+{
+    SDL_MallocCache *cache = &SDL_malloc_cache;
+    /* Every block in a size class holds at least that class's largest size */
+    size_t index = dlmalloc_usable_size(ptr) / CACHE_GRANULARITY;
+    SDL_CachedBlock *block = (SDL_CachedBlock *) ptr;
+
+    if (index == 0 || index > CACHE_NUM_CLASSES) {
+        return SDL_FALSE;
+    }
+
+    if (!cache->registered) {
+        SDL_RegisterMallocCache(cache);
+    }
+    if (cache->disabled || cache->num_blocks[index] == CACHE_CLASS_DEPTH) {
+        return SDL_FALSE;
+    }
+
+    block->next = cache->blocks[index];
+    cache->blocks[index] = block;
+    ++cache->num_blocks[index];
+    return SDL_TRUE;
+}
+#endif /* !HAVE_MALLOC && SDL_THREAD_LOCAL */
+
 void SDL_GetMemoryFunctions(SDL_malloc_func *malloc_func,
                             SDL_calloc_func *calloc_func,
                             SDL_realloc_func *realloc_func,
@@ -5373,36 +5527,60 @@ int SDL_SetMemoryFunctions(SDL_malloc_func malloc_func,
 
 int SDL_GetNumAllocations(void)
 {
-    return SDL_AtomicGet(&s_mem.num_allocations);
+    int i, count = 0;
+
+    for (i = 0; i < NUM_ALLOCATION_COUNTERS; ++i) {
+        count += SDL_AtomicGet(&s_num_allocations[i].count);
+    }
+    return count;
 }
 
 void *SDL_malloc(size_t size)
 {
-    void *mem;
+    void *mem = NULL;
 
     if (!size) {
         size = 1;
     }
 
-    mem = s_mem.malloc_func(size);
+#ifdef SDL_MALLOC_THREAD_CACHE
+    if (s_mem.malloc_func == real_malloc) {
+        mem = SDL_CacheAlloc(size);
+    }
+#endif
+    if (!mem) {
+        mem = s_mem.malloc_func(size);
+    }
     if (mem) {
-        SDL_AtomicIncRef(&s_mem.num_allocations);
+        SDL_AtomicIncRef(SDL_GetAllocationCounter());
     }
     return mem;
 }
 
 void *SDL_calloc(size_t nmemb, size_t size)
 {
-    void *mem;
+    void *mem = NULL;
 
     if (!nmemb || !size) {
         nmemb = 1;
         size = 1;
     }
 
-    mem = s_mem.calloc_func(nmemb, size);
+#ifdef SDL_MALLOC_THREAD_CACHE
+    if (s_mem.calloc_func == real_calloc &&
+        nmemb <= CACHE_NUM_CLASSES * CACHE_GRANULARITY &&
+        size <= CACHE_NUM_CLASSES * CACHE_GRANULARITY) {
+        mem = SDL_CacheAlloc(nmemb * size);
+        if (mem) {
+            SDL_memset(mem, 0, nmemb * size);
+        }
+    }
+#endif
+    if (!mem) {
+        mem = s_mem.calloc_func(nmemb, size);
+    }
     if (mem) {
-        SDL_AtomicIncRef(&s_mem.num_allocations);
+        SDL_AtomicIncRef(SDL_GetAllocationCounter());
     }
     return mem;
 }
@@ -5417,7 +5595,7 @@ void *SDL_realloc(void *ptr, size_t size)
 
     mem = s_mem.realloc_func(ptr, size);
     if (mem && !ptr) {
-        SDL_AtomicIncRef(&s_mem.num_allocations);
+        SDL_AtomicIncRef(SDL_GetAllocationCounter());
     }
     return mem;
 }
@@ -5428,8 +5606,14 @@ void SDL_free(void *ptr)
         return;
     }
 
+#ifdef SDL_MALLOC_THREAD_CACHE
+    if (s_mem.free_func == real_free && SDL_CacheFree(ptr)) {
+        (void)SDL_AtomicDecRef(SDL_GetAllocationCounter());
+        return;
+    }
+#endif
     s_mem.free_func(ptr);
-    (void)SDL_AtomicDecRef(&s_mem.num_allocations);
+    (void)SDL_AtomicDecRef(SDL_GetAllocationCounter());
 }
 
 /* vi: set ts=4 sw=4 expandtab: */
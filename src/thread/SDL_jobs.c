@@ -0,0 +1,667 @@
+/*
+  Simple DirectMedia Layer
+  Copyright (C) 1997-2020 Sam Lantinga <slouken@libsdl.org>
+
+  This software is provided 'as-is', without any express or implied
+  warranty.  In no event will the authors be held liable for any damages
+  arising from the use of this software.
+
+  Permission is granted to anyone to use this software for any purpose,
+  including commercial applications, and to alter it and redistribute it
+  freely, subject to the following restrictions:
+
+  1. The origin of this software must not be misrepresented; you must not
+     claim that you wrote the original software. If you use this software
+     in a product, an acknowledgment in the product documentation would be
+     appreciated but is not required.
+  2. Altered source versions must be plainly marked as such, and must not be
+     misrepresented as being the original software.
+  3. This notice may not be removed or altered from any source distribution.
+*/
+#include "../SDL_internal.h"
+
+/* The SDL job system, a pool of worker threads with work stealing */
+
+#include "SDL_jobs.h"
+#include "SDL_thread.h"
+#include "SDL_cpuinfo.h"
+#include "SDL_systhread.h"
+
+/* The number of jobs each worker can queue locally, must be a power of two.
+   Jobs that don't fit go on the shared queue. */
+#define SDL_JOB_DEQUE_SIZE  1024
+
+typedef struct SDL_Job
+{
+    SDL_JobPool *pool;
+    SDL_JobFunction func;
+    void *data;
+    SDL_JobGroup *group;
+    struct SDL_Job *next;       /* next in the shared queue, free list, or a group's waiting list */
+} SDL_Job;
+
+struct SDL_JobGroup
+{
+    SDL_atomic_t count;         /* jobs in the group that haven't finished */
+    SDL_SpinLock lock;
+    SDL_Job *after;             /* jobs waiting for the group to finish */
+};
+
+/* A Chase-Lev work stealing deque. The owning worker pushes and pops jobs
+   at the bottom, any other thread may steal jobs from the top. */
+typedef struct
+{
+    SDL_atomic_t top;
+    char cache_pad[SDL_CACHELINE_SIZE];
+    SDL_atomic_t bottom;
+    SDL_Job *jobs[SDL_JOB_DEQUE_SIZE];
+} SDL_JobDeque;
+
+typedef struct
+{
+    SDL_JobPool *pool;
+    SDL_Thread *thread;
+    Uint32 seed;                /* for picking workers to steal from */
+    SDL_JobDeque deque;
+    char cache_pad[SDL_CACHELINE_SIZE];
+} SDL_JobWorker;
+
+struct SDL_JobPool
+{
+    int num_workers;
+    SDL_JobWorker *workers;
+    SDL_atomic_t active;
+    SDL_atomic_t queued;        /* jobs waiting in any queue */
+    SDL_atomic_t sleeping;      /* workers waiting for jobs */
+    SDL_sem *wake;
+
+    /* The shared queue, also used to wait for job groups */
+    SDL_mutex *lock;
+    SDL_cond *done;
+    SDL_Job *head;
+    SDL_Job *tail;
+
+    SDL_SpinLock freelist_lock;
+    SDL_Job *freelist;
+};
+
+/* Remembers which worker, if any, the current thread is */
+static SDL_TLSID SDL_job_worker_tls;
+static SDL_SpinLock SDL_job_worker_tls_lock;
+
+static SDL_JobWorker *
+SDL_GetCurrentJobWorker(SDL_JobPool *pool)
+{
+    SDL_JobWorker *worker = (SDL_JobWorker *) SDL_TLSGet(SDL_job_worker_tls);
+    if (worker && worker->pool == pool) {
+        return worker;
+    }
+    return NULL;
+}
+
+/* Add a job to the bottom of a deque, only called by its owner */
+static SDL_bool
+SDL_PushJobDeque(SDL_JobDeque *deque, SDL_Job *job)
+{
+    const int b = SDL_AtomicGet(&deque->bottom);
+    const int t = SDL_AtomicGet(&deque->top);
+
+    if ((int) ((unsigned) b - (unsigned) t) >= SDL_JOB_DEQUE_SIZE) {
+        return SDL_FALSE;
+    }
+    SDL_AtomicSetPtr((void **) &deque->jobs[b & (SDL_JOB_DEQUE_SIZE - 1)], job);
+    SDL_AtomicSet(&deque->bottom, (int) ((unsigned) b + 1));
+    return SDL_TRUE;
+}
+
+/* Take the newest job from the bottom of a deque, only called by its owner */
+static SDL_Job *
+SDL_PopJobDeque(SDL_JobDeque *deque)
+{
+    const int b = (int) ((unsigned) SDL_AtomicAdd(&deque->bottom, -1) - 1);
+    const int t = SDL_AtomicGet(&deque->top);
+    const int size = (int) ((unsigned) b - (unsigned) t);
+    SDL_Job *job;
+
+    if (size < 0) {
+        /* It was empty, put the bottom back */
+        SDL_AtomicSet(&deque->bottom, t);
+        return NULL;
+    }
+
+    job = (SDL_Job *) SDL_AtomicGetPtr((void **) &deque->jobs[b & (SDL_JOB_DEQUE_SIZE - 1)]);
+    if (size > 0) {
+        return job;
+    }
+
+    /* This is the last job, so we race the thieves for it */
+    if (!SDL_AtomicCAS(&deque->top, t, (int) ((unsigned) t + 1))) {
+        job = NULL;
+    }
+    SDL_AtomicSet(&deque->bottom, (int) ((unsigned) t + 1));
+    return job;
+}
+
+/* Take the oldest job from the top of a deque, called by any thread */
+static SDL_Job *
+SDL_StealJobDeque(SDL_JobDeque *deque)
+{
+    const int t = SDL_AtomicGet(&deque->top);
+    const int b = SDL_AtomicGet(&deque->bottom);
+    SDL_Job *job;
+
+    if ((int) ((unsigned) b - (unsigned) t) <= 0) {
+        return NULL;
+    }
+
+    job = (SDL_Job *) SDL_AtomicGetPtr((void **) &deque->jobs[t & (SDL_JOB_DEQUE_SIZE - 1)]);
+    if (!SDL_AtomicCAS(&deque->top, t, (int) ((unsigned) t + 1))) {
+        return NULL;  /* someone else got it first */
+    }
+    return job;
+}
+
+static SDL_Job *
+SDL_AllocJob(SDL_JobPool *pool)
+{
+    SDL_Job *job;
+
+    SDL_AtomicLock(&pool->freelist_lock);
+    job = pool->freelist;
+    if (job) {
+        pool->freelist = job->next;
+    }
+    SDL_AtomicUnlock(&pool->freelist_lock);
+
+    if (!job) {
+        job = (SDL_Job *) SDL_malloc(sizeof (*job));
+        if (!job) {
+            SDL_OutOfMemory();
+            return NULL;
+        }
+    }
+    job->pool = pool;
+    job->next = NULL;
+    return job;
+}
+
+static void
+SDL_FreeJob(SDL_JobPool *pool, SDL_Job *job)
+{
+    SDL_AtomicLock(&pool->freelist_lock);
+    job->next = pool->freelist;
+    pool->freelist = job;
+    SDL_AtomicUnlock(&pool->freelist_lock);
+}
+
+/* Queue a job, on the current worker's deque if possible */
+static void
+SDL_QueueJob(SDL_JobPool *pool, SDL_Job *job)
+{
+    SDL_JobWorker *worker = SDL_GetCurrentJobWorker(pool);
+
+    /* Count it first, so a worker taking it never sees the count go negative */
+    SDL_AtomicIncRef(&pool->queued);
+
+    if (!worker || !SDL_PushJobDeque(&worker->deque, job)) {
+        SDL_LockMutex(pool->lock);
+        job->next = NULL;
+        if (pool->tail) {
+            pool->tail->next = job;
+        } else {
+            pool->head = job;
+        }
+        pool->tail = job;
+        SDL_UnlockMutex(pool->lock);
+    }
+
+    if (SDL_AtomicGet(&pool->sleeping) > 0) {
+        SDL_SemPost(pool->wake);
+    }
+}
+
+/* Find a job to run: our own newest job, then the shared queue, then steal */
+static SDL_Job *
+SDL_FindJob(SDL_JobPool *pool, SDL_JobWorker *worker)
+{
+    SDL_Job *job = NULL;
+    int i, start;
+
+    if (worker) {
+        job = SDL_PopJobDeque(&worker->deque);
+    }
+
+    if (!job && SDL_AtomicGetPtr((void **) &pool->head)) {
+        SDL_LockMutex(pool->lock);
+        job = pool->head;
+        if (job) {
+            pool->head = job->next;
+            if (!pool->head) {
+                pool->tail = NULL;
+            }
+        }
+        SDL_UnlockMutex(pool->lock);
+    }
+
+    if (!job) {
+        if (worker) {
+            /* xorshift, so workers don't all gang up on the same victim */
+            worker->seed ^= worker->seed << 13;
+            worker->seed ^= worker->seed >> 17;
+            worker->seed ^= worker->seed << 5;
+            start = (int) (worker->seed % pool->num_workers);
+        } else {
+            start = 0;
+        }
+        for (i = 0; i < pool->num_workers && !job; ++i) {
+            SDL_JobWorker *victim = &pool->workers[(start + i) % pool->num_workers];
+            if (victim != worker) {
+                job = SDL_StealJobDeque(&victim->deque);
+            }
+        }
+    }
+
+    if (job) {
+        SDL_AtomicAdd(&pool->queued, -1);
+    }
+    return job;
+}
+
+/* Count a job in a group as finished, releasing the jobs waiting for the group
+   if it was the last one. Once the count reaches zero a waiting thread may free
+   the group, so the count only changes with the group locked, and the group
+   isn't touched after it's unlocked. */
+static void
+SDL_FinishGroupJob(SDL_JobPool *pool, SDL_JobGroup *group)
+{
+    SDL_Job *after = NULL;
+    SDL_bool finished = SDL_FALSE;
+
+    SDL_AtomicLock(&group->lock);
+    if (SDL_AtomicAdd(&group->count, -1) == 1) {
+        after = group->after;
+        group->after = NULL;
+        finished = SDL_TRUE;
+    }
+    SDL_AtomicUnlock(&group->lock);
+
+    while (after) {
+        SDL_Job *job = after;
+        after = job->next;
+        SDL_QueueJob(job->pool, job);
+    }
+
+    if (finished) {
+        SDL_LockMutex(pool->lock);
+        SDL_CondBroadcast(pool->done);
+        SDL_UnlockMutex(pool->lock);
+    }
+}
+
+static int
+SDL_GetJobGroupCount(SDL_JobGroup *group)
+{
+    int count;
+
+    SDL_AtomicLock(&group->lock);
+    count = SDL_AtomicGet(&group->count);
+    SDL_AtomicUnlock(&group->lock);
+    return count;
+}
+
+static void
+SDL_RunJob(SDL_JobPool *pool, SDL_Job *job)
+{
+    SDL_JobGroup *group = job->group;
+
+    job->func(job->data);
+    SDL_FreeJob(pool, job);
+
+    if (group) {
+        SDL_FinishGroupJob(pool, group);
+    }
+}
+
+static int SDLCALL
+SDL_JobWorkerThread(void *data)
+{
+    SDL_JobWorker *worker = (SDL_JobWorker *) data;
+    SDL_JobPool *pool = worker->pool;
+    SDL_Job *job;
+
+    SDL_TLSSet(SDL_job_worker_tls, worker, NULL);
+
+    for ( ; ; ) {
+        job = SDL_FindJob(pool, worker);
+        if (job) {
+            SDL_RunJob(pool, job);
+            continue;
+        }
+
+        if (!SDL_AtomicGet(&pool->active)) {
+            break;
+        }
+
+        /* Nothing to do, sleep until a job is queued. Checking the queued
+           count after saying we're sleeping means a new job can't be missed. */
+        SDL_AtomicIncRef(&pool->sleeping);
+        if (SDL_AtomicGet(&pool->queued) == 0 && SDL_AtomicGet(&pool->active)) {
+            SDL_SemWait(pool->wake);
+        }
+        (void)SDL_AtomicDecRef(&pool->sleeping);
+    }
+
+    SDL_TLSSet(SDL_job_worker_tls, NULL, NULL);
+    return 0;
+}
+
+SDL_JobPool *
+SDL_CreateJobPool(int num_threads)
+{
+    SDL_JobPool *pool;
+    int i;
+
+    if (num_threads < 0) {
+        SDL_InvalidParamError("num_threads");
+        return NULL;
+    }
+    if (num_threads == 0) {
+        num_threads = SDL_max(SDL_GetCPUCount() - 1, 1);
+    }
+
+    SDL_AtomicLock(&SDL_job_worker_tls_lock);
+    if (!SDL_job_worker_tls) {
+        SDL_job_worker_tls = SDL_TLSCreate();
+    }
+    SDL_AtomicUnlock(&SDL_job_worker_tls_lock);
+    if (!SDL_job_worker_tls) {
+        return NULL;
+    }
+
+    pool = (SDL_JobPool *) SDL_calloc(1, sizeof (*pool));
+    if (!pool) {
+        SDL_OutOfMemory();
+        return NULL;
+    }
+
+    pool->workers = (SDL_JobWorker *) SDL_calloc(num_threads, sizeof (*pool->workers));
+    pool->wake = SDL_CreateSemaphore(0);
+    pool->lock = SDL_CreateMutex();
+    pool->done = SDL_CreateCond();
+    if (!pool->workers || !pool->wake || !pool->lock || !pool->done) {
+        if (!pool->workers) {
+            SDL_OutOfMemory();
+        }
+        SDL_DestroyJobPool(pool);
+        return NULL;
+    }
+
+    /* The deques start out empty, so workers can safely try to steal from
+       the ones that haven't started yet */
+    pool->num_workers = num_threads;
+    SDL_AtomicSet(&pool->active, 1);
+
+    for (i = 0; i < num_threads; ++i) {
+        SDL_JobWorker *worker = &pool->workers[i];
+        worker->pool = pool;
+        worker->seed = 2463534242u + i;
+        worker->thread = SDL_CreateThreadInternal(SDL_JobWorkerThread, "SDLJobWorker", 0, worker);
+        if (!worker->thread) {
+            SDL_DestroyJobPool(pool);
+            return NULL;
+        }
+    }
+
+    return pool;
+}
+
+int
+SDL_GetJobPoolThreadCount(SDL_JobPool *pool)
+{
+    if (!pool) {
+        return SDL_InvalidParamError("pool");
+    }
+    return pool->num_workers;
+}
+
+void
+SDL_DestroyJobPool(SDL_JobPool *pool)
+{
+    SDL_Job *job;
+    int i;
+
+    if (!pool) {
+        return;
+    }
+
+    /* The workers run everything that's queued before they exit */
+    SDL_AtomicSet(&pool->active, 0);
+    for (i = 0; i < pool->num_workers; ++i) {
+        SDL_SemPost(pool->wake);
+    }
+    for (i = 0; i < pool->num_workers; ++i) {
+        SDL_WaitThread(pool->workers[i].thread, NULL);  /* NULL if creating it failed */
+    }
+
+    /* If there were no workers left, run any stragglers here */
+    while ((job = SDL_FindJob(pool, NULL)) != NULL) {
+        SDL_RunJob(pool, job);
+    }
+
+    while (pool->freelist) {
+        job = pool->freelist;
+        pool->freelist = job->next;
+        SDL_free(job);
+    }
+
+    SDL_DestroyCond(pool->done);
+    SDL_DestroyMutex(pool->lock);
+    SDL_DestroySemaphore(pool->wake);
+    SDL_free(pool->workers);
+    SDL_free(pool);
+}
+
+SDL_JobGroup *
+SDL_CreateJobGroup(void)
+{
+    SDL_JobGroup *group = (SDL_JobGroup *) SDL_calloc(1, sizeof (*group));
+    if (!group) {
+        SDL_OutOfMemory();
+        return NULL;
+    }
+    return group;
+}
+
+void
+SDL_DestroyJobGroup(SDL_JobGroup *group)
+{
+    SDL_Job *after;
+
+    if (!group) {
+        return;
+    }
+
+    SDL_AtomicLock(&group->lock);
+    after = group->after;
+    group->after = NULL;
+    SDL_AtomicUnlock(&group->lock);
+
+    /* Jobs still waiting for the group will never run, but they count as
+       finished in their own groups, so nothing waits for them forever */
+    while (after) {
+        SDL_Job *job = after;
+        SDL_JobPool *pool = job->pool;
+        SDL_JobGroup *job_group = job->group;
+
+        after = job->next;
+        SDL_FreeJob(pool, job);
+        if (job_group) {
+            SDL_FinishGroupJob(pool, job_group);
+        }
+    }
+    SDL_free(group);
+}
+
+static SDL_Job *
+SDL_CreateJob(SDL_JobPool *pool, SDL_JobFunction func, void *data, SDL_JobGroup *group)
+{
+    SDL_Job *job;
+
+    if (!pool) {
+        SDL_InvalidParamError("pool");
+        return NULL;
+    }
+    if (!func) {
+        SDL_InvalidParamError("func");
+        return NULL;
+    }
+
+    job = SDL_AllocJob(pool);
+    if (!job) {
+        return NULL;
+    }
+    job->func = func;
+    job->data = data;
+    job->group = group;
+    if (group) {
+        SDL_AtomicIncRef(&group->count);
+    }
+    return job;
+}
+
+int
+SDL_SubmitJob(SDL_JobPool *pool, SDL_JobFunction func, void *data, SDL_JobGroup *group)
+{
+    SDL_Job *job = SDL_CreateJob(pool, func, data, group);
+    if (!job) {
+        return -1;
+    }
+    SDL_QueueJob(pool, job);
+    return 0;
+}
+
+int
+SDL_SubmitJobAfter(SDL_JobPool *pool, SDL_JobGroup *after, SDL_JobFunction func, void *data, SDL_JobGroup *group)
+{
+    SDL_Job *job;
+    SDL_bool queued = SDL_FALSE;
+
+    if (!after) {
+        return SDL_InvalidParamError("after");
+    }
+
+    job = SDL_CreateJob(pool, func, data, group);
+    if (!job) {
+        return -1;
+    }
+
+    SDL_AtomicLock(&after->lock);
+    if (SDL_AtomicGet(&after->count) > 0) {
+        job->next = after->after;
+        after->after = job;
+        queued = SDL_TRUE;
+    }
+    SDL_AtomicUnlock(&after->lock);
+
+    if (!queued) {
+        SDL_QueueJob(pool, job);
+    }
+    return 0;
+}
+
+void
+SDL_WaitJobGroup(SDL_JobPool *pool, SDL_JobGroup *group)
+{
+    SDL_JobWorker *worker;
+    SDL_Job *job;
+
+    if (!pool || !group) {
+        return;
+    }
+
+    worker = SDL_GetCurrentJobWorker(pool);
+    while (SDL_GetJobGroupCount(group) > 0) {
+        /* Help out while we wait */
+        job = SDL_FindJob(pool, worker);
+        if (job) {
+            SDL_RunJob(pool, job);
+            continue;
+        }
+
+        /* Nothing queued, the last jobs are running elsewhere */
+        SDL_LockMutex(pool->lock);
+        if (SDL_GetJobGroupCount(group) > 0 && SDL_AtomicGet(&pool->queued) == 0) {
+            SDL_CondWait(pool->done, pool->lock);
+        }
+        SDL_UnlockMutex(pool->lock);
+    }
+}
+
+typedef struct
+{
+    SDL_ParallelForFunction func;
+    void *data;
+    int start;
+    int end;
+} SDL_ParallelForBatch;
+
+static void SDLCALL
+SDL_RunParallelForBatch(void *data)
+{
+    SDL_ParallelForBatch *batch = (SDL_ParallelForBatch *) data;
+    batch->func(batch->start, batch->end, batch->data);
+}
+
+int
+SDL_ParallelFor(SDL_JobPool *pool, int start, int end, int grain, SDL_ParallelForFunction func, void *data)
+{
+    SDL_ParallelForBatch *batches;
+    SDL_JobGroup group;
+    int count, num_batches, i;
+
+    if (!pool) {
+        return SDL_InvalidParamError("pool");
+    }
+    if (!func) {
+        return SDL_InvalidParamError("func");
+    }
+    if (end <= start) {
+        return 0;
+    }
+
+    count = end - start;
+    if (grain <= 0) {
+        /* A few batches per thread, so faster threads can steal from slower ones */
+        grain = SDL_max(count / ((pool->num_workers + 1) * 4), 1);
+    }
+    num_batches = (count + grain - 1) / grain;
+    if (num_batches == 1) {
+        func(start, end, data);
+        return 0;
+    }
+
+    batches = (SDL_ParallelForBatch *) SDL_malloc(num_batches * sizeof (*batches));
+    if (!batches) {
+        /* Still get the work done, just not in parallel */
+        func(start, end, data);
+        return 0;
+    }
+
+    SDL_zero(group);
+    for (i = 0; i < num_batches; ++i) {
+        SDL_ParallelForBatch *batch = &batches[i];
+        batch->func = func;
+        batch->data = data;
+        batch->start = start + i * grain;
+        batch->end = (i == num_batches - 1) ? end : (batch->start + grain);
+        if (SDL_SubmitJob(pool, SDL_RunParallelForBatch, batch, &group) < 0) {
+            SDL_RunParallelForBatch(batch);
+        }
+    }
+    SDL_WaitJobGroup(pool, &group);
+
+    SDL_free(batches);
+    return 0;
+}
+
+/* vi: set ts=4 sw=4 expandtab: */
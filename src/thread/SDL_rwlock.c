@@ -0,0 +1,207 @@
+/*
+  Simple DirectMedia Layer
+  Copyright (C) 1997-2020 Sam Lantinga <slouken@libsdl.org>
+
+  This software is provided 'as-is', without any express or implied
+  warranty.  In no event will the authors be held liable for any damages
+  arising from the use of this software.
+
+  Permission is granted to anyone to use this software for any purpose,
+  including commercial applications, and to alter it and redistribute it
+  freely, subject to the following restrictions:
+
+  1. The origin of this software must not be misrepresented; you must not
+     claim that you wrote the original software. If you use this software
+     in a product, an acknowledgment in the product documentation would be
+     appreciated but is not required.
+  2. Altered source versions must be plainly marked as such, and must not be
+     misrepresented as being the original software.
+  3. This notice may not be removed or altered from any source distribution.
+*/
+#include "../SDL_internal.h"
+
+/* Reader-writer locks built on SDL atomics, using a mutex and condition
+   variable only to sleep when the lock is contended. Taking an uncontended
+   lock, for reading or writing, is a single compare-and-swap.
+
+   Readers get in whenever no writer holds the lock, so a thread can lock
+   for reading recursively without deadlocking against a waiting writer.
+   The price is that a steady stream of overlapping readers can starve a
+   writer; SDL_LockRWLockForReading() documents this.
+ */
+
+#include "SDL_atomic.h"
+#include "SDL_cpuinfo.h"
+#include "SDL_mutex.h"
+#include "../atomic/SDL_cpupause.h"
+
+/* The most times to try the lock before sleeping, and the most pause
+   instructions between tries */
+#define SDL_RWLOCK_MAX_SPINS    40
+#define SDL_RWLOCK_MAX_BACKOFF  64
+
+/* The state of a lock held for writing, otherwise it's the number of readers */
+#define SDL_RWLOCK_WRITER   -1
+
+struct SDL_rwlock
+{
+    SDL_atomic_t state;
+    SDL_atomic_t waiters;       /* threads that may be sleeping on wake */
+    SDL_bool spin;
+    SDL_mutex *lock;
+    SDL_cond *wake;
+};
+
+static SDL_bool
+SDL_TryLockRWLockState(SDL_rwlock * rwlock, SDL_bool writing)
+{
+    if (writing) {
+        return SDL_AtomicCAS(&rwlock->state, 0, SDL_RWLOCK_WRITER);
+    } else {
+        int state = SDL_AtomicGet(&rwlock->state);
+        while (state != SDL_RWLOCK_WRITER) {
+            if (SDL_AtomicCAS(&rwlock->state, state, state + 1)) {
+                return SDL_TRUE;
+            }
+            state = SDL_AtomicGet(&rwlock->state);
+        }
+        return SDL_FALSE;
+    }
+}
+
+static int
+SDL_LockRWLockState(SDL_rwlock * rwlock, SDL_bool writing)
+{
+    if (!rwlock) {
+        return SDL_SetError("Passed a NULL rwlock");
+    }
+
+    if (SDL_TryLockRWLockState(rwlock, writing)) {
+        return 0;
+    }
+
+    if (rwlock->spin) {
+        int spins, backoff = 1;
+        for (spins = 0; spins < SDL_RWLOCK_MAX_SPINS; ++spins) {
+            int i;
+            for (i = 0; i < backoff; ++i) {
+                SDL_CPUPauseInstruction();
+            }
+            backoff = SDL_min(backoff * 2, SDL_RWLOCK_MAX_BACKOFF);
+
+            if (SDL_TryLockRWLockState(rwlock, writing)) {
+                return 0;
+            }
+        }
+    }
+
+#if SDL_THREADS_DISABLED
+    /* There's nobody else who could unlock it */
+    return SDL_SetError("rwlock would deadlock");
+#else
+    /* Say we're waiting before trying again, so an unlock either sees us
+       waiting or we see the new state, and no wakeup is lost. */
+    SDL_LockMutex(rwlock->lock);
+    SDL_AtomicIncRef(&rwlock->waiters);
+    while (!SDL_TryLockRWLockState(rwlock, writing)) {
+        SDL_CondWait(rwlock->wake, rwlock->lock);
+    }
+    (void)SDL_AtomicDecRef(&rwlock->waiters);
+    SDL_UnlockMutex(rwlock->lock);
+    return 0;
+#endif
+}
+
+SDL_rwlock *
+SDL_CreateRWLock(void)
+{
+    SDL_rwlock *rwlock = (SDL_rwlock *) SDL_calloc(1, sizeof (*rwlock));
+    if (!rwlock) {
+        SDL_OutOfMemory();
+        return NULL;
+    }
+
+#if !SDL_THREADS_DISABLED
+    rwlock->lock = SDL_CreateMutex();
+    rwlock->wake = SDL_CreateCond();
+    if (!rwlock->lock || !rwlock->wake) {
+        SDL_DestroyRWLock(rwlock);
+        return NULL;
+    }
+#endif
+
+    /* Spinning can't help if the holder can't run at the same time */
+    rwlock->spin = (SDL_GetCPUCount() > 1) ? SDL_TRUE : SDL_FALSE;
+    return rwlock;
+}
+
+int
+SDL_LockRWLockForReading(SDL_rwlock * rwlock)
+{
+    return SDL_LockRWLockState(rwlock, SDL_FALSE);
+}
+
+int
+SDL_LockRWLockForWriting(SDL_rwlock * rwlock)
+{
+    return SDL_LockRWLockState(rwlock, SDL_TRUE);
+}
+
+int
+SDL_TryLockRWLockForReading(SDL_rwlock * rwlock)
+{
+    if (!rwlock) {
+        return SDL_SetError("Passed a NULL rwlock");
+    }
+    return SDL_TryLockRWLockState(rwlock, SDL_FALSE) ? 0 : SDL_MUTEX_TIMEDOUT;
+}
+
+int
+SDL_TryLockRWLockForWriting(SDL_rwlock * rwlock)
+{
+    if (!rwlock) {
+        return SDL_SetError("Passed a NULL rwlock");
+    }
+    return SDL_TryLockRWLockState(rwlock, SDL_TRUE) ? 0 : SDL_MUTEX_TIMEDOUT;
+}
+
+int
+SDL_UnlockRWLock(SDL_rwlock * rwlock)
+{
+    int state;
+
+    if (!rwlock) {
+        return SDL_SetError("Passed a NULL rwlock");
+    }
+
+    state = SDL_AtomicGet(&rwlock->state);
+    if (state == 0) {
+        return SDL_SetError("rwlock not locked");
+    }
+
+    if (state == SDL_RWLOCK_WRITER) {
+        SDL_AtomicSet(&rwlock->state, 0);
+    } else if (SDL_AtomicAdd(&rwlock->state, -1) != 1) {
+        /* There are still readers, so nobody waiting could get in yet */
+        return 0;
+    }
+
+    if (SDL_AtomicGet(&rwlock->waiters) > 0) {
+        SDL_LockMutex(rwlock->lock);
+        SDL_CondBroadcast(rwlock->wake);
+        SDL_UnlockMutex(rwlock->lock);
+    }
+    return 0;
+}
+
+void
+SDL_DestroyRWLock(SDL_rwlock * rwlock)
+{
+    if (rwlock) {
+        SDL_DestroyCond(rwlock->wake);
+        SDL_DestroyMutex(rwlock->lock);
+        SDL_free(rwlock);
+    }
+}
+
+/* vi: set ts=4 sw=4 expandtab: */
@@ -30,6 +30,13 @@
 #include "../SDL_error_c.h"
 
 
+#ifdef SDL_THREAD_LOCAL
+/* This thread's storage, always the same as SDL_SYS_GetTLSData() since it
+   only changes here. The system storage is still set so backends can clean
+   up when the thread exits. */
+static SDL_THREAD_LOCAL SDL_TLSData *SDL_tls_storage;
+#endif
+
 SDL_TLSID
 SDL_TLSCreate()
 {
@@ -42,7 +49,11 @@ SDL_TLSGet(SDL_TLSID id)
 {
     SDL_TLSData *storage;
 
+#ifdef SDL_THREAD_LOCAL
+    storage = SDL_tls_storage;
+#else
     storage = SDL_SYS_GetTLSData();
+#endif
     if (!storage || id == 0 || id > storage->limit) {
         return NULL;
     }
@@ -76,6 +87,9 @@ SDL_TLSSet(SDL_TLSID id, const void *value, void (SDLCALL *destructor)(void *))
         if (SDL_SYS_SetTLSData(storage) != 0) {
             return -1;
         }
+#ifdef SDL_THREAD_LOCAL
+        SDL_tls_storage = storage;
+#endif
     }
 
     storage->array[id-1].data = SDL_const_cast(void*, value);
@@ -83,6 +97,22 @@ SDL_TLSSet(SDL_TLSID id, const void *value, void (SDLCALL *destructor)(void *))
     return 0;
 }
 
+void
+SDL_TLSCleanupStorage(SDL_TLSData *storage)
+{
+    unsigned int i;
+    for (i = 0; i < storage->limit; ++i) {
+        if (storage->array[i].destructor) {
+            storage->array[i].destructor(storage->array[i].data);
+        }
+    }
+    SDL_SYS_SetTLSData(NULL);
+#ifdef SDL_THREAD_LOCAL
+    SDL_tls_storage = NULL;
+#endif
+    SDL_free(storage);
+}
+
 static void
 SDL_TLSCleanup()
 {
@@ -90,14 +120,7 @@ SDL_TLSCleanup()
 
     storage = SDL_SYS_GetTLSData();
     if (storage) {
-        unsigned int i;
-        for (i = 0; i < storage->limit; ++i) {
-            if (storage->array[i].destructor) {
-                storage->array[i].destructor(storage->array[i].data);
-            }
-        }
-        SDL_SYS_SetTLSData(NULL);
-        SDL_free(storage);
+        SDL_TLSCleanupStorage(storage);
     }
 }
 
@@ -201,6 +224,20 @@ SDL_Generic_SetTLSData(SDL_TLSData *storage)
     return 0;
 }
 
+#ifdef SDL_THREAD_LOCAL
+/* This thread's error buffer, once it has been allocated */
+static SDL_THREAD_LOCAL SDL_error *SDL_errbuf;
+
+static void SDLCALL
+SDL_FreeErrBuf(void *errbuf)
+{
+    SDL_errbuf = NULL;
+    SDL_free(errbuf);
+}
+#else
+#define SDL_FreeErrBuf SDL_free
+#endif
+
 /* Routine to get the thread-specific error variable */
 SDL_error *
 SDL_GetErrBuf(void)
@@ -217,6 +254,12 @@ SDL_GetErrBuf(void)
     const SDL_error *ALLOCATION_IN_PROGRESS = (SDL_error *)-1;
     SDL_error *errbuf;
 
+#ifdef SDL_THREAD_LOCAL
+    if (SDL_errbuf) {
+        return SDL_errbuf;
+    }
+#endif
+
     /* tls_being_created is there simply to prevent recursion if SDL_TLSCreate() fails.
        It also means it's possible for another thread to also use SDL_global_errbuf,
        but that's very unlikely and hopefully won't cause issues.
@@ -251,7 +294,10 @@ SDL_GetErrBuf(void)
             return &SDL_global_errbuf;
         }
         SDL_zerop(errbuf);
-        SDL_TLSSet(tls_errbuf, errbuf, SDL_free);
+        SDL_TLSSet(tls_errbuf, errbuf, SDL_FreeErrBuf);
+#ifdef SDL_THREAD_LOCAL
+        SDL_errbuf = errbuf;
+#endif
     }
     return errbuf;
 #endif /* SDL_THREADS_DISABLED */
@@ -78,6 +78,19 @@ typedef struct {
 /* This is how many TLS entries we allocate at once */
 #define TLS_ALLOC_CHUNKSIZE 4
 
+/* Compilers that support thread-local variables let us keep a pointer to
+   the current thread's storage, so looking up a value doesn't have to call
+   into the system. Windows and Apple platforms already look up thread-local
+   storage quickly, and their compilers don't support this everywhere. */
+#if (defined(__GNUC__) || defined(__clang__)) && !SDL_THREADS_DISABLED && \
+    !defined(__WIN32__) && !defined(__WINRT__) && !defined(__APPLE__) && !defined(__PSP__)
+#define SDL_THREAD_LOCAL __thread
+#endif
+
+/* Run the destructors for a thread's local storage and free it.
+   Backends with thread exit callbacks call this for threads SDL didn't create. */
+extern void SDL_TLSCleanupStorage(SDL_TLSData *storage);
+
 /* Get cross-platform, slow, thread local storage for this thread.
    This is only intended as a fallback if getting real thread-local
    storage fails or isn't supported on this platform.
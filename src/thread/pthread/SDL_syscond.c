@@ -29,6 +29,14 @@
 #include "SDL_thread.h"
 #include "SDL_sysmutex_c.h"
 
+/* Time out waits against the monotonic clock where we can, so they aren't
+   thrown off when the wall clock changes */
+#if defined(HAVE_CLOCK_GETTIME) && defined(__LINUX__)
+#define SDL_COND_CLOCK CLOCK_MONOTONIC
+#elif defined(HAVE_CLOCK_GETTIME)
+#define SDL_COND_CLOCK CLOCK_REALTIME
+#endif
+
 struct SDL_cond
 {
     pthread_cond_t cond;
@@ -39,14 +47,20 @@ SDL_cond *
 SDL_CreateCond(void)
 {
     SDL_cond *cond;
+    pthread_condattr_t attr;
 
     cond = (SDL_cond *) SDL_malloc(sizeof(SDL_cond));
     if (cond) {
-        if (pthread_cond_init(&cond->cond, NULL) != 0) {
+        pthread_condattr_init(&attr);
+#if defined(HAVE_CLOCK_GETTIME) && defined(__LINUX__)
+        pthread_condattr_setclock(&attr, SDL_COND_CLOCK);
+#endif
+        if (pthread_cond_init(&cond->cond, &attr) != 0) {
             SDL_SetError("pthread_cond_init() failed");
             SDL_free(cond);
             cond = NULL;
         }
+        pthread_condattr_destroy(&attr);
     }
     return (cond);
 }
@@ -109,7 +123,7 @@ SDL_CondWaitTimeout(SDL_cond * cond, SDL_mutex * mutex, Uint32 ms)
     }
 
 #ifdef HAVE_CLOCK_GETTIME
-    clock_gettime(CLOCK_REALTIME, &abstime);
+    clock_gettime(SDL_COND_CLOCK, &abstime);
 
     abstime.tv_nsec += (ms % 1000) * 1000000;
     abstime.tv_sec += ms / 1000;
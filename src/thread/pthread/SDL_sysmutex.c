@@ -24,20 +24,54 @@
 #include <pthread.h>
 
 #include "SDL_thread.h"
+#include "SDL_cpuinfo.h"
+#include "SDL_sysmutex_c.h"
+#include "../../atomic/SDL_cpupause.h"
+
+/* Critical sections in SDL are usually short, so when a mutex is held by a
+   thread running on another CPU it's cheaper to spin for a little while than
+   to sleep in the kernel. Each mutex remembers how long it usually takes to
+   get, and spins a little longer than that before blocking, up to a limit. */
+#define SDL_MUTEX_MAX_SPINS     100
+
+/* The most pause instructions between attempts to take the lock */
+#define SDL_MUTEX_MAX_BACKOFF   64
+
+/* Lock the underlying mutex, spinning first if it's contended */
+static int
+SDL_LockMutexAdaptive(SDL_mutex * mutex)
+{
+    int max_spins, spins, backoff;
+    int result = pthread_mutex_trylock(&mutex->id);
 
-#if !SDL_THREAD_PTHREAD_RECURSIVE_MUTEX && \
-    !SDL_THREAD_PTHREAD_RECURSIVE_MUTEX_NP
-#define FAKE_RECURSIVE_MUTEX 1
-#endif
+    if (result != EBUSY || !mutex->spins) {
+        return (result == EBUSY) ? pthread_mutex_lock(&mutex->id) : result;
+    }
 
-struct SDL_mutex
-{
-    pthread_mutex_t id;
-#if FAKE_RECURSIVE_MUTEX
-    int recursive;
-    pthread_t owner;
-#endif
-};
+    max_spins = SDL_min(mutex->spins * 2 + 10, SDL_MUTEX_MAX_SPINS);
+    backoff = 1;
+    for (spins = 1; spins < max_spins; ++spins) {
+        int i;
+        for (i = 0; i < backoff; ++i) {
+            SDL_CPUPauseInstruction();
+        }
+        backoff = SDL_min(backoff * 2, SDL_MUTEX_MAX_BACKOFF);
+
+        result = pthread_mutex_trylock(&mutex->id);
+        if (result != EBUSY) {
+            break;
+        }
+    }
+    if (result == EBUSY) {
+        result = pthread_mutex_lock(&mutex->id);
+    }
+
+    /* We own the lock now (if we got it), so we can update the average */
+    if (result == 0) {
+        mutex->spins = SDL_max(mutex->spins + (spins - mutex->spins) / 8, 1);
+    }
+    return result;
+}
 
 SDL_mutex *
 SDL_CreateMutex(void)
@@ -60,6 +94,9 @@ SDL_CreateMutex(void)
             SDL_SetError("pthread_mutex_init() failed");
             SDL_free(mutex);
             mutex = NULL;
+        } else if (SDL_GetCPUCount() > 1) {
+            /* Spinning can't help if the owner can't run at the same time */
+            mutex->spins = 1;
         }
     } else {
         SDL_OutOfMemory();
@@ -97,7 +134,7 @@ SDL_LockMutex(SDL_mutex * mutex)
            We set the locking thread id after we obtain the lock
            so unlocks from other threads will fail.
          */
-        if (pthread_mutex_lock(&mutex->id) == 0) {
+        if (SDL_LockMutexAdaptive(mutex) == 0) {
             mutex->owner = this_thread;
             mutex->recursive = 0;
         } else {
@@ -105,7 +142,7 @@ SDL_LockMutex(SDL_mutex * mutex)
         }
     }
 #else
-    if (pthread_mutex_lock(&mutex->id) != 0) {
+    if (SDL_LockMutexAdaptive(mutex) != 0) {
         return SDL_SetError("pthread_mutex_lock() failed");
     }
 #endif
@@ -34,6 +34,185 @@
 #if defined(__MACOSX__) || defined(__IPHONEOS__)
 /* Mac OS X doesn't support sem_getvalue() as of version 10.4 */
 #include "../generic/SDL_syssem.c"
+#elif defined(__LINUX__)
+
+/* Semaphores built directly on futexes. The count lives in user space, so
+   posting and taking an available semaphore never enter the kernel, and a
+   thread that finds it empty spins briefly before it goes to sleep.
+   Timed waits are measured against CLOCK_MONOTONIC by the kernel, so they
+   aren't thrown off when the wall clock changes. */
+
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include "SDL_atomic.h"
+#include "SDL_cpuinfo.h"
+#include "../../atomic/SDL_cpupause.h"
+#include "../../timer/SDL_timer_c.h"
+
+/* The most times to try taking the semaphore before sleeping, and the most
+   pause instructions between tries */
+#define SDL_SEM_MAX_SPINS   40
+#define SDL_SEM_MAX_BACKOFF 64
+
+struct SDL_semaphore
+{
+    SDL_atomic_t count;
+    SDL_atomic_t waiters;       /* threads that may be sleeping on count */
+    SDL_bool spin;
+};
+
+static SDL_bool
+SDL_SemTryTake(SDL_sem * sem)
+{
+    int value = SDL_AtomicGet(&sem->count);
+    while (value > 0) {
+        if (SDL_AtomicCAS(&sem->count, value, value - 1)) {
+            return SDL_TRUE;
+        }
+        value = SDL_AtomicGet(&sem->count);
+    }
+    return SDL_FALSE;
+}
+
+/* Create a semaphore, initialized with value */
+SDL_sem *
+SDL_CreateSemaphore(Uint32 initial_value)
+{
+    SDL_sem *sem;
+
+    if (initial_value > SDL_MAX_SINT32) {
+        SDL_SetError("Semaphore value too large");
+        return NULL;
+    }
+
+    sem = (SDL_sem *) SDL_calloc(1, sizeof(SDL_sem));
+    if (sem) {
+        SDL_AtomicSet(&sem->count, (int) initial_value);
+        /* Spinning can't help if the poster can't run at the same time */
+        sem->spin = (SDL_GetCPUCount() > 1) ? SDL_TRUE : SDL_FALSE;
+    } else {
+        SDL_OutOfMemory();
+    }
+    return sem;
+}
+
+void
+SDL_DestroySemaphore(SDL_sem * sem)
+{
+    SDL_free(sem);
+}
+
+int
+SDL_SemTryWait(SDL_sem * sem)
+{
+    if (!sem) {
+        return SDL_SetError("Passed a NULL semaphore");
+    }
+    return SDL_SemTryTake(sem) ? 0 : SDL_MUTEX_TIMEDOUT;
+}
+
+int
+SDL_SemWait(SDL_sem * sem)
+{
+    return SDL_SemWaitTimeout(sem, SDL_MUTEX_MAXWAIT);
+}
+
+int
+SDL_SemWaitTimeout(SDL_sem * sem, Uint32 timeout)
+{
+    Uint64 deadline = 0;
+
+    if (!sem) {
+        return SDL_SetError("Passed a NULL semaphore");
+    }
+
+    if (SDL_SemTryTake(sem)) {
+        return 0;
+    }
+    if (timeout == 0) {
+        return SDL_MUTEX_TIMEDOUT;
+    }
+
+    if (sem->spin) {
+        int spins, backoff = 1;
+        for (spins = 0; spins < SDL_SEM_MAX_SPINS; ++spins) {
+            int i;
+            for (i = 0; i < backoff; ++i) {
+                SDL_CPUPauseInstruction();
+            }
+            backoff = SDL_min(backoff * 2, SDL_SEM_MAX_BACKOFF);
+
+            if (SDL_SemTryTake(sem)) {
+                return 0;
+            }
+        }
+    }
+
+    if (timeout != SDL_MUTEX_MAXWAIT) {
+        deadline = SDL_GetPerformanceCounter() + SDL_NSToCounter((Uint64) timeout * 1000000);
+    }
+
+    for (;;) {
+        struct timespec ts_timeout;
+        struct timespec *pts_timeout = NULL;
+        int retval;
+
+        if (timeout != SDL_MUTEX_MAXWAIT) {
+            const Uint64 now = SDL_GetPerformanceCounter();
+            Uint64 ns;
+
+            if (now >= deadline) {
+                return SDL_MUTEX_TIMEDOUT;
+            }
+            ns = SDL_CounterToNS(deadline - now);
+            ts_timeout.tv_sec = (time_t) (ns / 1000000000);
+            ts_timeout.tv_nsec = (long) (ns % 1000000000);
+            pts_timeout = &ts_timeout;
+        }
+
+        /* Say we're waiting before checking the count, so a post either
+           sees us waiting or we see the new count, and no wakeup is lost. */
+        SDL_AtomicIncRef(&sem->waiters);
+        retval = 0;
+        if (SDL_AtomicGet(&sem->count) == 0) {
+            retval = (int) syscall(SYS_futex, &sem->count.value, FUTEX_WAIT_PRIVATE, 0, pts_timeout, NULL, 0);
+        }
+        (void)SDL_AtomicDecRef(&sem->waiters);
+
+        if (retval < 0 && errno != EAGAIN && errno != EINTR && errno != ETIMEDOUT) {
+            return SDL_SetError("futex() failed: %s", strerror(errno));
+        }
+        if (SDL_SemTryTake(sem)) {
+            return 0;
+        }
+    }
+}
+
+Uint32
+SDL_SemValue(SDL_sem * sem)
+{
+    if (sem) {
+        return (Uint32) SDL_AtomicGet(&sem->count);
+    }
+    return 0;
+}
+
+int
+SDL_SemPost(SDL_sem * sem)
+{
+    if (!sem) {
+        return SDL_SetError("Passed a NULL semaphore");
+    }
+
+    SDL_AtomicAdd(&sem->count, 1);
+    if (SDL_AtomicGet(&sem->waiters) > 0) {
+        syscall(SYS_futex, &sem->count.value, FUTEX_WAKE_PRIVATE, 1, NULL, NULL, 0);
+    }
+    return 0;
+}
+
 #else
 
 struct SDL_semaphore
@@ -205,5 +384,5 @@ SDL_SemPost(SDL_sem * sem)
     return retval;
 }
 
-#endif /* __MACOSX__ */
+#endif /* __MACOSX__ || __LINUX__ */
 /* vi: set ts=4 sw=4 expandtab: */
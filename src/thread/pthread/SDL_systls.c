@@ -31,6 +31,13 @@
 static pthread_key_t thread_local_storage = INVALID_PTHREAD_KEY;
 static SDL_bool generic_local_storage = SDL_FALSE;
 
+/* Clean up after threads SDL didn't create, when they exit */
+static void
+SDL_SYS_TLSDestructor(void *data)
+{
+    SDL_TLSCleanupStorage((SDL_TLSData *)data);
+}
+
 SDL_TLSData *
 SDL_SYS_GetTLSData(void)
 {
@@ -39,7 +46,7 @@ SDL_SYS_GetTLSData(void)
         SDL_AtomicLock(&lock);
         if (thread_local_storage == INVALID_PTHREAD_KEY && !generic_local_storage) {
             pthread_key_t storage;
-            if (pthread_key_create(&storage, NULL) == 0) {
+            if (pthread_key_create(&storage, SDL_SYS_TLSDestructor) == 0) {
                 SDL_MemoryBarrierRelease();
                 thread_local_storage = storage;
             } else {
@@ -24,6 +24,7 @@
 #include "SDL_timer_c.h"
 #include "SDL_atomic.h"
 #include "SDL_cpuinfo.h"
+#include "../atomic/SDL_cpupause.h"
 #include "../thread/SDL_systhread.h"
 
 /* #define DEBUG_TIMERS */
@@ -34,9 +35,11 @@ typedef struct _SDL_Timer
     SDL_TimerCallback callback;
     void *param;
     Uint32 interval;
-    Uint32 scheduled;
+    Uint64 scheduled;           /* in performance counter ticks */
+    SDL_bool microseconds;      /* interval is in microseconds instead of milliseconds */
     SDL_atomic_t canceled;
-    struct _SDL_Timer *next;
+    struct _SDL_Timer *child;   /* first child, while in the timer heap */
+    struct _SDL_Timer *next;    /* next sibling in the timer heap, or next in the pending and free lists */
 } SDL_Timer;
 
 typedef struct _SDL_TimerMap
@@ -46,13 +49,19 @@ typedef struct _SDL_TimerMap
     struct _SDL_TimerMap *next;
 } SDL_TimerMap;
 
-/* The timers are kept in a sorted list */
+/* Number of buckets the timer ID hash table starts with, must be a power of two */
+#define SDL_TIMERMAP_INITIAL_SIZE 64
+
+/* The timers are kept in a pairing heap, ordered by scheduling time */
 typedef struct {
     /* Data used by the main thread */
     SDL_Thread *thread;
     SDL_atomic_t nextID;
-    SDL_TimerMap *timermap;
+    SDL_TimerMap **timermap;    /* hash table of timermap_size buckets, indexed by timer ID */
+    int timermap_size;
+    int timermap_count;
     SDL_mutex *timermap_lock;
+    Uint64 freq;
 
     /* Padding to separate cache lines between threads */
     char cache_pad[SDL_CACHELINE_SIZE];
@@ -64,37 +73,87 @@ typedef struct {
     SDL_Timer *freelist;
     SDL_atomic_t active;
 
-    /* List of timers - this is only touched by the timer thread */
+    /* Heap of timers - this is only touched by the timer thread */
     SDL_Timer *timers;
 } SDL_TimerData;
 
 static SDL_TimerData SDL_timer_data;
 
 /* The idea here is that any thread might add a timer, but a single
- * thread manages the active timer queue, sorted by scheduling time.
+ * thread manages the active timer queue, ordered by scheduling time.
  *
  * Timers are removed by simply setting a canceled flag
  */
 
+static Uint64
+SDL_TimerIntervalToTicks(const SDL_TimerData *data, const SDL_Timer *timer, Uint32 interval)
+{
+    return ((Uint64) interval * data->freq) / (timer->microseconds ? 1000000 : 1000);
+}
+
+/* Merge two heaps, each root must have no siblings */
+static SDL_Timer *
+SDL_MeldTimers(SDL_Timer *a, SDL_Timer *b)
+{
+    if (!a) {
+        return b;
+    }
+    if (!b) {
+        return a;
+    }
+    if (b->scheduled < a->scheduled) {
+        SDL_Timer *tmp = a;
+        a = b;
+        b = tmp;
+    }
+    b->next = a->child;
+    a->child = b;
+    return a;
+}
+
 static void
 SDL_AddTimerInternal(SDL_TimerData *data, SDL_Timer *timer)
 {
-    SDL_Timer *prev, *curr;
+    timer->child = NULL;
+    timer->next = NULL;
+    data->timers = SDL_MeldTimers(data->timers, timer);
+}
 
-    prev = NULL;
-    for (curr = data->timers; curr; prev = curr, curr = curr->next) {
-        if ((Sint32)(timer->scheduled-curr->scheduled) < 0) {
-            break;
+/* Remove the earliest timer from the heap, using the standard two-pass pairing */
+static void
+SDL_RemoveFirstTimer(SDL_TimerData *data)
+{
+    SDL_Timer *list = data->timers->child;
+    SDL_Timer *pairs = NULL;
+    SDL_Timer *root = NULL;
+
+    /* First pass: meld the children together in pairs, left to right */
+    while (list) {
+        SDL_Timer *a = list;
+        SDL_Timer *b = list->next;
+        if (b) {
+            list = b->next;
+            a->next = NULL;
+            b->next = NULL;
+            a = SDL_MeldTimers(a, b);
+        } else {
+            list = NULL;
         }
+        a->next = pairs;
+        pairs = a;
     }
 
-    /* Insert the timer here! */
-    if (prev) {
-        prev->next = timer;
-    } else {
-        data->timers = timer;
+    /* Second pass: meld the pairs into one heap, right to left */
+    while (pairs) {
+        SDL_Timer *a = pairs;
+        pairs = a->next;
+        a->next = NULL;
+        root = SDL_MeldTimers(root, a);
     }
-    timer->next = curr;
+
+    data->timers->child = NULL;
+    data->timers->next = NULL;
+    data->timers = root;
 }
 
 static int SDLCALL
@@ -105,7 +164,8 @@ SDL_TimerThread(void *_data)
     SDL_Timer *current;
     SDL_Timer *freelist_head = NULL;
     SDL_Timer *freelist_tail = NULL;
-    Uint32 tick, now, interval, delay;
+    Uint64 tick, now;
+    Uint32 interval, delay;
 
     /* Threaded timer loop:
      *  1. Queue timers added by other threads
@@ -128,7 +188,7 @@ SDL_TimerThread(void *_data)
         }
         SDL_AtomicUnlock(&data->lock);
 
-        /* Sort the pending timers into our list */
+        /* Add the pending timers to our heap */
         while (pending) {
             current = pending;
             pending = pending->next;
@@ -142,23 +202,19 @@ SDL_TimerThread(void *_data)
             break;
         }
 
-        /* Initial delay if there are no timers */
-        delay = SDL_MUTEX_MAXWAIT;
-
-        tick = SDL_GetTicks();
+        tick = SDL_GetPerformanceCounter();
 
         /* Process all the pending timers for this tick */
         while (data->timers) {
             current = data->timers;
 
-            if ((Sint32)(tick-current->scheduled) < 0) {
+            if (tick < current->scheduled) {
                 /* Scheduled for the future, wait a bit */
-                delay = (current->scheduled - tick);
                 break;
             }
 
             /* We're going to do something with this timer */
-            data->timers = current->next;
+            SDL_RemoveFirstTimer(data);
 
             if (SDL_AtomicGet(&current->canceled)) {
                 interval = 0;
@@ -167,9 +223,12 @@ SDL_TimerThread(void *_data)
             }
 
             if (interval > 0) {
-                /* Reschedule this timer */
+                /* Reschedule this timer, keeping the period unless we've fallen behind */
                 current->interval = interval;
-                current->scheduled = tick + interval;
+                current->scheduled += SDL_TimerIntervalToTicks(data, current, interval);
+                if (current->scheduled <= tick) {
+                    current->scheduled = tick + SDL_TimerIntervalToTicks(data, current, interval);
+                }
                 SDL_AddTimerInternal(data, current);
             } else {
                 if (!freelist_head) {
@@ -184,13 +243,27 @@ SDL_TimerThread(void *_data)
             }
         }
 
-        /* Adjust the delay based on processing time */
-        now = SDL_GetTicks();
-        interval = (now - tick);
-        if (interval > delay) {
-            delay = 0;
+        /* Work out the delay based on processing time */
+        if (!data->timers) {
+            delay = SDL_MUTEX_MAXWAIT;
         } else {
-            delay -= interval;
+            now = SDL_GetPerformanceCounter();
+            if (now >= data->timers->scheduled) {
+                continue;
+            }
+            now = data->timers->scheduled - now;
+            if (data->timers->microseconds) {
+                /* Wait on the semaphore for whole milliseconds, then sleep
+                   out the last one instead of spinning on it. A timer added
+                   meanwhile waits at most that millisecond. */
+                delay = (Uint32) SDL_min((now * 1000) / data->freq, SDL_MUTEX_MAXWAIT - 1);
+                if (delay == 0) {
+                    SDL_DelayNS(SDL_CounterToNS(now));
+                    continue;
+                }
+            } else {
+                delay = (Uint32) SDL_min((now * 1000 + data->freq - 1) / data->freq, SDL_MUTEX_MAXWAIT - 1);
+            }
         }
 
         /* Note that each time a timer is added, this will return
@@ -221,6 +294,8 @@ SDL_TimerInit(void)
             return -1;
         }
 
+        data->freq = SDL_GetPerformanceFrequency();
+
         SDL_AtomicSet(&data->active, 1);
 
         /* Timer threads use a callback into the app, so we can't set a limited stack size here. */
@@ -241,6 +316,7 @@ SDL_TimerQuit(void)
     SDL_TimerData *data = &SDL_timer_data;
     SDL_Timer *timer;
     SDL_TimerMap *entry;
+    int i;
 
     if (SDL_AtomicCAS(&data->active, 1, 0)) {  /* active? Move to inactive. */
         /* Shutdown the timer thread */
@@ -253,9 +329,17 @@ SDL_TimerQuit(void)
         SDL_DestroySemaphore(data->sem);
         data->sem = NULL;
 
-        /* Clean up the timer entries */
+        /* Clean up the timer entries, flattening the heap as we go */
         while (data->timers) {
             timer = data->timers;
+            if (timer->child) {
+                SDL_Timer *last = timer->child;
+                while (last->next) {
+                    last = last->next;
+                }
+                last->next = timer->next;
+                timer->next = timer->child;
+            }
             data->timers = timer->next;
             SDL_free(timer);
         }
@@ -264,23 +348,67 @@ SDL_TimerQuit(void)
             data->freelist = timer->next;
             SDL_free(timer);
         }
-        while (data->timermap) {
-            entry = data->timermap;
-            data->timermap = entry->next;
-            SDL_free(entry);
+        for (i = 0; i < data->timermap_size; ++i) {
+            while (data->timermap[i]) {
+                entry = data->timermap[i];
+                data->timermap[i] = entry->next;
+                SDL_free(entry);
+            }
         }
+        SDL_free(data->timermap);
+        data->timermap = NULL;
+        data->timermap_size = 0;
+        data->timermap_count = 0;
 
         SDL_DestroyMutex(data->timermap_lock);
         data->timermap_lock = NULL;
     }
 }
 
-SDL_TimerID
-SDL_AddTimer(Uint32 interval, SDL_TimerCallback callback, void *param)
+/* Add an entry to the timer ID hash table, growing it as needed.
+   This should be called with the timermap lock held. */
+static int
+SDL_AddTimerMapEntry(SDL_TimerData *data, SDL_TimerMap *entry)
+{
+    int bucket;
+
+    if (data->timermap_count >= data->timermap_size) {
+        const int size = data->timermap_size ? (data->timermap_size * 2) : SDL_TIMERMAP_INITIAL_SIZE;
+        SDL_TimerMap **timermap = (SDL_TimerMap **)SDL_calloc(size, sizeof(*timermap));
+        if (timermap) {
+            int i;
+            for (i = 0; i < data->timermap_size; ++i) {
+                while (data->timermap[i]) {
+                    SDL_TimerMap *moved = data->timermap[i];
+                    data->timermap[i] = moved->next;
+                    bucket = moved->timerID & (size - 1);
+                    moved->next = timermap[bucket];
+                    timermap[bucket] = moved;
+                }
+            }
+            SDL_free(data->timermap);
+            data->timermap = timermap;
+            data->timermap_size = size;
+        } else if (!data->timermap) {
+            return SDL_OutOfMemory();
+        }
+        /* If we couldn't grow the table, the buckets just get a little longer */
+    }
+
+    bucket = entry->timerID & (data->timermap_size - 1);
+    entry->next = data->timermap[bucket];
+    data->timermap[bucket] = entry;
+    ++data->timermap_count;
+    return 0;
+}
+
+static SDL_TimerID
+SDL_AddTimerWithUnits(Uint32 interval, SDL_TimerCallback callback, void *param, SDL_bool microseconds)
 {
     SDL_TimerData *data = &SDL_timer_data;
     SDL_Timer *timer;
     SDL_TimerMap *entry;
+    int status;
 
     SDL_AtomicLock(&data->lock);
     if (!SDL_AtomicGet(&data->active)) {
@@ -309,7 +437,8 @@ SDL_AddTimer(Uint32 interval, SDL_TimerCallback callback, void *param)
     timer->callback = callback;
     timer->param = param;
     timer->interval = interval;
-    timer->scheduled = SDL_GetTicks() + interval;
+    timer->microseconds = microseconds;
+    timer->scheduled = SDL_GetPerformanceCounter() + SDL_TimerIntervalToTicks(data, timer, interval);
     SDL_AtomicSet(&timer->canceled, 0);
 
     entry = (SDL_TimerMap *)SDL_malloc(sizeof(*entry));
@@ -322,9 +451,13 @@ SDL_AddTimer(Uint32 interval, SDL_TimerCallback callback, void *param)
     entry->timerID = timer->timerID;
 
     SDL_LockMutex(data->timermap_lock);
-    entry->next = data->timermap;
-    data->timermap = entry;
+    status = SDL_AddTimerMapEntry(data, entry);
     SDL_UnlockMutex(data->timermap_lock);
+    if (status < 0) {
+        SDL_free(entry);
+        SDL_free(timer);
+        return 0;
+    }
 
     /* Add the timer to the pending list for the timer thread */
     SDL_AtomicLock(&data->lock);
@@ -338,24 +471,40 @@ SDL_AddTimer(Uint32 interval, SDL_TimerCallback callback, void *param)
     return entry->timerID;
 }
 
+SDL_TimerID
+SDL_AddTimer(Uint32 interval, SDL_TimerCallback callback, void *param)
+{
+    return SDL_AddTimerWithUnits(interval, callback, param, SDL_FALSE);
+}
+
+SDL_TimerID
+SDL_AddTimerMicroseconds(Uint32 interval, SDL_TimerCallback callback, void *param)
+{
+    return SDL_AddTimerWithUnits(interval, callback, param, SDL_TRUE);
+}
+
 SDL_bool
 SDL_RemoveTimer(SDL_TimerID id)
 {
     SDL_TimerData *data = &SDL_timer_data;
-    SDL_TimerMap *prev, *entry;
+    SDL_TimerMap *prev, *entry = NULL;
     SDL_bool canceled = SDL_FALSE;
 
     /* Find the timer */
     SDL_LockMutex(data->timermap_lock);
-    prev = NULL;
-    for (entry = data->timermap; entry; prev = entry, entry = entry->next) {
-        if (entry->timerID == id) {
-            if (prev) {
-                prev->next = entry->next;
-            } else {
-                data->timermap = entry->next;
+    if (data->timermap) {
+        const int bucket = id & (data->timermap_size - 1);
+        prev = NULL;
+        for (entry = data->timermap[bucket]; entry; prev = entry, entry = entry->next) {
+            if (entry->timerID == id) {
+                if (prev) {
+                    prev->next = entry->next;
+                } else {
+                    data->timermap[bucket] = entry->next;
+                }
+                --data->timermap_count;
+                break;
             }
-            break;
         }
     }
     SDL_UnlockMutex(data->timermap_lock);
@@ -370,4 +519,69 @@ SDL_RemoveTimer(SDL_TimerID id)
     return canceled;
 }
 
+Uint64
+SDL_CounterToNS(Uint64 ticks)
+{
+    const Uint64 freq = SDL_GetPerformanceFrequency();
+    /* Split the multiply so long spans don't overflow */
+    return (ticks / freq) * 1000000000 + ((ticks % freq) * 1000000000) / freq;
+}
+
+Uint64
+SDL_NSToCounter(Uint64 ns)
+{
+    const Uint64 freq = SDL_GetPerformanceFrequency();
+    return (ns / 1000000000) * freq + ((ns % 1000000000) * freq) / 1000000000;
+}
+
+/* How long before a deadline SDL_DelayUntil() stops sleeping and starts
+   spinning, in microseconds. This adapts to how late the system wakes us. */
+#define SDL_DELAY_MIN_SPIN_US   50
+#define SDL_DELAY_MAX_SPIN_US   20000
+static SDL_atomic_t SDL_delay_spin_us = { 1000 };
+
+void
+SDL_DelayUntil(Uint64 deadline)
+{
+#if defined(SDL_TIMER_DUMMY) || defined(SDL_TIMERS_DISABLED)
+    SDL_Unsupported();
+#else
+    Uint64 now = SDL_GetPerformanceCounter();
+    int spin_us = SDL_AtomicGet(&SDL_delay_spin_us);
+    const Uint64 spin = SDL_NSToCounter((Uint64) spin_us * 1000);
+
+    if (now >= deadline) {
+        return;
+    }
+
+    if ((deadline - now) > spin) {
+        const Uint64 wake = deadline - spin;
+        Uint64 late_us;
+
+        SDL_SYS_DelayUntil(wake);
+
+        /* Keep the spin margin at about twice the recent oversleep: grow
+           it right away when we wake late, shrink it slowly otherwise. */
+        now = SDL_GetPerformanceCounter();
+        late_us = (now > wake) ? (SDL_CounterToNS(now - wake) / 1000) : 0;
+        if (late_us * 2 > (Uint64) spin_us) {
+            spin_us = (int) SDL_min(late_us * 2, SDL_DELAY_MAX_SPIN_US);
+        } else {
+            spin_us = SDL_max(spin_us - spin_us / 16, SDL_DELAY_MIN_SPIN_US);
+        }
+        SDL_AtomicSet(&SDL_delay_spin_us, spin_us);
+    }
+
+    while (SDL_GetPerformanceCounter() < deadline) {
+        SDL_CPUPauseInstruction();
+    }
+#endif
+}
+
+void
+SDL_DelayPrecise(Uint64 ns)
+{
+    SDL_DelayUntil(SDL_GetPerformanceCounter() + SDL_NSToCounter(ns));
+}
+
 /* vi: set ts=4 sw=4 expandtab: */
@@ -35,6 +35,14 @@ extern void SDL_TicksQuit(void);
 extern int SDL_TimerInit(void);
 extern void SDL_TimerQuit(void);
 
+/* Convert a span of performance counter ticks to nanoseconds, and back */
+extern Uint64 SDL_CounterToNS(Uint64 ticks);
+extern Uint64 SDL_NSToCounter(Uint64 ns);
+
+/* Sleep until about the performance counter value (deadline), without
+   oversleeping more than necessary. Implemented by each timer backend. */
+extern void SDL_SYS_DelayUntil(Uint64 deadline);
+
 #endif /* SDL_timer_c_h_ */
 
 /* vi: set ts=4 sw=4 expandtab: */
@@ -23,6 +23,7 @@
 #if defined(SDL_TIMER_DUMMY) || defined(SDL_TIMERS_DISABLED)
 
 #include "SDL_timer.h"
+#include "../SDL_timer_c.h"
 
 static SDL_bool ticks_started = SDL_FALSE;
 
@@ -70,6 +71,18 @@ SDL_Delay(Uint32 ms)
     SDL_Unsupported();
 }
 
+void
+SDL_DelayNS(Uint64 ns)
+{
+    SDL_Unsupported();
+}
+
+void
+SDL_SYS_DelayUntil(Uint64 deadline)
+{
+    SDL_Unsupported();
+}
+
 #endif /* SDL_TIMER_DUMMY || SDL_TIMERS_DISABLED */
 
 /* vi: set ts=4 sw=4 expandtab: */
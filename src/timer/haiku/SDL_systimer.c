@@ -25,6 +25,7 @@
 #include <kernel/OS.h>
 
 #include "SDL_timer.h"
+#include "../SDL_timer_c.h"
 
 static bigtime_t start;
 static SDL_bool ticks_started = SDL_FALSE;
@@ -75,6 +76,19 @@ SDL_Delay(Uint32 ms)
     snooze(ms * 1000);
 }
 
+void
+SDL_DelayNS(Uint64 ns)
+{
+    snooze((ns + 999) / 1000);
+}
+
+void
+SDL_SYS_DelayUntil(Uint64 deadline)
+{
+    /* The performance counter is system_time(), so this is an absolute sleep */
+    snooze_until(deadline, B_SYSTEM_TIMEBASE);
+}
+
 #endif /* SDL_TIMER_HAIKU */
 
 /* vi: set ts=4 sw=4 expandtab: */
@@ -184,7 +184,7 @@ SDL_GetPerformanceFrequency(void)
 }
 
 void
-SDL_Delay(Uint32 ms)
+SDL_DelayNS(Uint64 ns)
 {
     int was_error;
 
@@ -192,15 +192,15 @@ SDL_Delay(Uint32 ms)
     struct timespec elapsed, tv;
 #else
     struct timeval tv;
-    Uint32 then, now, elapsed;
+    Uint64 then, now, elapsed;
 #endif
 
     /* Set the timeout interval */
 #if HAVE_NANOSLEEP
-    elapsed.tv_sec = ms / 1000;
-    elapsed.tv_nsec = (ms % 1000) * 1000000;
+    elapsed.tv_sec = ns / 1000000000;
+    elapsed.tv_nsec = ns % 1000000000;
 #else
-    then = SDL_GetTicks();
+    then = SDL_GetPerformanceCounter();
 #endif
     do {
         errno = 0;
@@ -211,21 +211,63 @@ SDL_Delay(Uint32 ms)
         was_error = nanosleep(&tv, &elapsed);
 #else
         /* Calculate the time interval left (in case of interrupt) */
-        now = SDL_GetTicks();
-        elapsed = (now - then);
+        now = SDL_GetPerformanceCounter();
+        elapsed = SDL_CounterToNS(now - then);
         then = now;
-        if (elapsed >= ms) {
+        if (elapsed >= ns) {
             break;
         }
-        ms -= elapsed;
-        tv.tv_sec = ms / 1000;
-        tv.tv_usec = (ms % 1000) * 1000;
+        ns -= elapsed;
+        tv.tv_sec = ns / 1000000000;
+        tv.tv_usec = (ns % 1000000000) / 1000;
 
         was_error = select(0, NULL, NULL, NULL, &tv);
 #endif /* HAVE_NANOSLEEP */
     } while (was_error && (errno == EINTR));
 }
 
+void
+SDL_Delay(Uint32 ms)
+{
+    SDL_DelayNS((Uint64) ms * 1000000);
+}
+
+void
+SDL_SYS_DelayUntil(Uint64 deadline)
+{
+    const Uint64 now = SDL_GetPerformanceCounter();
+
+    if (now >= deadline) {
+        return;
+    }
+
+#if HAVE_CLOCK_GETTIME && defined(TIMER_ABSTIME) && !defined(__APPLE__)
+    if (has_monotonic_time) {
+        /* The performance counter may be CLOCK_MONOTONIC_RAW, which
+           clock_nanosleep() doesn't accept, so turn the deadline into an
+           absolute CLOCK_MONOTONIC time. Sleeping to an absolute time means
+           interruptions and scheduling delays don't add up. */
+        struct timespec tv;
+        Uint64 target;
+        int result;
+
+        if (clock_gettime(CLOCK_MONOTONIC, &tv) == 0) {
+            target = (Uint64) tv.tv_sec * 1000000000 + tv.tv_nsec + SDL_CounterToNS(deadline - now);
+            tv.tv_sec = target / 1000000000;
+            tv.tv_nsec = target % 1000000000;
+            do {
+                result = clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &tv, NULL);
+            } while (result == EINTR);
+            if (result == 0) {
+                return;
+            }
+        }
+    }
+#endif /* HAVE_CLOCK_GETTIME */
+
+    SDL_DelayNS(SDL_CounterToNS(deadline - now));
+}
+
 #endif /* SDL_TIMER_UNIX */
 
 /* vi: set ts=4 sw=4 expandtab: */
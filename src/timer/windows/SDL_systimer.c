@@ -27,6 +27,7 @@
 
 #include "SDL_timer.h"
 #include "SDL_hints.h"
+#include "../SDL_timer_c.h"
 
 
 /* The first (low-resolution) ticks value of the application */
@@ -195,6 +196,29 @@ SDL_Delay(Uint32 ms)
 #endif
 }
 
+void
+SDL_DelayNS(Uint64 ns)
+{
+    /* Sleep() only has millisecond granularity, round up so we wait long enough.
+       Avoid INFINITE, which would never return. */
+    const Uint64 ms = (ns + 999999) / 1000000;
+    SDL_Delay((Uint32) SDL_min(ms, INFINITE - 1));
+}
+
+void
+SDL_SYS_DelayUntil(Uint64 deadline)
+{
+    const Uint64 now = SDL_GetPerformanceCounter();
+
+    /* Round down, SDL_DelayUntil() spins for whatever is left */
+    if (deadline > now) {
+        const Uint64 ms = SDL_CounterToNS(deadline - now) / 1000000;
+        if (ms > 0) {
+            SDL_Delay((Uint32) SDL_min(ms, INFINITE - 1));
+        }
+    }
+}
+
 #endif /* SDL_TIMER_WINDOWS */
 
 /* vi: set ts=4 sw=4 expandtab: */
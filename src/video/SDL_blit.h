@@ -83,6 +83,21 @@ typedef struct
     SDL_BlitFunc func;
 } SDL_BlitFuncEntry;
 
+/* A blit set aside when the copy flags changed, to reuse if they change back */
+typedef struct SDL_BlitCacheEntry
+{
+    SDL_Surface *dst;           /* holds a reference, NULL if the entry is unused */
+    int flags;
+    int identity;
+    SDL_blit blit;
+    SDL_BlitFunc func;
+    Uint8 *table;
+    Uint32 dst_palette_version;
+    Uint32 src_palette_version;
+} SDL_BlitCacheEntry;
+
+#define SDL_BLITMAP_CACHE_SIZE 4
+
 /* Blit mapping definition */
 typedef struct SDL_BlitMap
 {
@@ -96,6 +111,9 @@ typedef struct SDL_BlitMap
        an invalid mapping */
     Uint32 dst_palette_version;
     Uint32 src_palette_version;
+
+    SDL_BlitCacheEntry cache[SDL_BLITMAP_CACHE_SIZE];
+    int cache_next;
 } SDL_BlitMap;
 
 /* Functions found in SDL_blit.c */
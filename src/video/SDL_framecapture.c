@@ -0,0 +1,593 @@
+/*
+  Simple DirectMedia Layer
+  Copyright (C) 1997-2020 Sam Lantinga <slouken@libsdl.org>
+
+  This software is provided 'as-is', without any express or implied
+  warranty.  In no event will the authors be held liable for any damages
+  arising from the use of this software.
+
+  Permission is granted to anyone to use this software for any purpose,
+  including commercial applications, and to alter it and redistribute it
+  freely, subject to the following restrictions:
+
+  1. The origin of this software must not be misrepresented; you must not
+     claim that you wrote the original software. If you use this software
+     in a product, an acknowledgment in the product documentation would be
+     appreciated but is not required.
+  2. Altered source versions must be plainly marked as such, and must not be
+     misrepresented as being the original software.
+  3. This notice may not be removed or altered from any source distribution.
+*/
+#include "../SDL_internal.h"
+
+#include "SDL_video.h"
+#include "SDL_log.h"
+#include "SDL_rwops.h"
+#include "SDL_thread.h"
+#include "SDL_framecapture_c.h"
+
+#define DEFAULT_CAPTURE_BUFFERS 4
+#define DEFAULT_CAPTURE_RATE    60
+
+typedef enum
+{
+    SDL_FRAMECAPTURE_BMP,
+    SDL_FRAMECAPTURE_RAW,
+    SDL_FRAMECAPTURE_I420,
+    SDL_FRAMECAPTURE_Y4M
+} SDL_FrameCaptureFormat;
+
+struct SDL_FrameCaptureConfig
+{
+    SDL_FrameCaptureFormat format;
+    char *path;
+    int num_buffers;
+    int rate;
+    int num_outputs;
+};
+
+/* The parts of the framebuffer updated in one frame, packed row by row */
+typedef struct SDL_CapturedFrame
+{
+    Uint8 *pixels;
+    SDL_Rect *rects;
+    int numrects;
+    int maxrects;
+} SDL_CapturedFrame;
+
+struct SDL_FrameCapture
+{
+    SDL_FrameCaptureFormat format;
+    int rate;
+    Uint32 window_id;
+    SDL_Surface *surface;       /* the window framebuffer */
+    SDL_RWops *rw;
+
+    /* Only touched by the writer thread while it's running */
+    SDL_Surface *canvas;        /* the whole frame, as the writer sees it */
+    Uint8 *yuv;
+    size_t yuv_size;
+    Uint32 frame_number;
+    Uint32 written;
+    SDL_bool failed;
+
+    /* Ring of frames waiting to be written, protected by lock */
+    SDL_CapturedFrame *frames;
+    int num_frames;
+    int head;
+    int count;
+    SDL_bool quit;
+    SDL_mutex *lock;
+    SDL_cond *cond;
+    SDL_Thread *thread;
+
+    /* Only touched by the presenting thread */
+    SDL_bool full_update;       /* a frame was dropped, the next one must be copied whole */
+    SDL_bool stopped;
+    Uint32 submitted;
+    Uint32 dropped;
+};
+
+SDL_FrameCaptureConfig *
+SDL_CreateFrameCaptureConfig(const char *prefix)
+{
+    SDL_FrameCaptureConfig *config;
+    char name[128];
+    const char *path;
+    const char *value;
+
+    SDL_snprintf(name, sizeof(name), "%s_CAPTURE", prefix);
+    path = SDL_getenv(name);
+    if (!path || !*path) {
+        path = NULL;
+        SDL_snprintf(name, sizeof(name), "%s_SAVE_FRAMES", prefix);
+        value = SDL_getenv(name);
+        if (!value || !*value) {
+            return NULL;
+        }
+    }
+
+    config = (SDL_FrameCaptureConfig *) SDL_calloc(1, sizeof(*config));
+    if (!config) {
+        SDL_OutOfMemory();
+        return NULL;
+    }
+
+    config->format = SDL_FRAMECAPTURE_BMP;
+    if (path) {
+        config->path = SDL_strdup(path);
+        if (!config->path) {
+            SDL_free(config);
+            SDL_OutOfMemory();
+            return NULL;
+        }
+
+        config->format = SDL_FRAMECAPTURE_RAW;
+        SDL_snprintf(name, sizeof(name), "%s_CAPTURE_FORMAT", prefix);
+        value = SDL_getenv(name);
+        if (value) {
+            if (SDL_strcasecmp(value, "i420") == 0) {
+                config->format = SDL_FRAMECAPTURE_I420;
+            } else if (SDL_strcasecmp(value, "y4m") == 0) {
+                config->format = SDL_FRAMECAPTURE_Y4M;
+            }
+        }
+    }
+
+    config->num_buffers = DEFAULT_CAPTURE_BUFFERS;
+    SDL_snprintf(name, sizeof(name), "%s_CAPTURE_BUFFERS", prefix);
+    value = SDL_getenv(name);
+    if (value && SDL_atoi(value) > 0) {
+        config->num_buffers = SDL_atoi(value);
+    }
+
+    config->rate = DEFAULT_CAPTURE_RATE;
+    SDL_snprintf(name, sizeof(name), "%s_CAPTURE_RATE", prefix);
+    value = SDL_getenv(name);
+    if (value && SDL_atoi(value) > 0) {
+        config->rate = SDL_atoi(value);
+    }
+
+    return config;
+}
+
+void
+SDL_DestroyFrameCaptureConfig(SDL_FrameCaptureConfig *config)
+{
+    if (config) {
+        SDL_free(config->path);
+        SDL_free(config);
+    }
+}
+
+static SDL_RWops *
+OpenCaptureOutput(SDL_FrameCaptureConfig *config, Uint32 window_id)
+{
+    char *path;
+    size_t len;
+    SDL_RWops *rw;
+
+#ifdef HAVE_STDIO_H
+    if (SDL_strcmp(config->path, "-") == 0) {
+        return SDL_RWFromFP(stdout, SDL_FALSE);
+    }
+#endif
+
+    /* The first window gets the requested path, any others get their own file */
+    if (config->num_outputs++ == 0) {
+        return SDL_RWFromFile(config->path, "wb");
+    }
+
+    len = SDL_strlen(config->path) + 16;
+    path = (char *) SDL_malloc(len);
+    if (!path) {
+        SDL_OutOfMemory();
+        return NULL;
+    }
+    SDL_snprintf(path, len, "%s.%u", config->path, (unsigned int) window_id);
+    rw = SDL_RWFromFile(path, "wb");
+    SDL_free(path);
+    return rw;
+}
+
+static void
+FreeCaptureFrames(SDL_FrameCapture *capture)
+{
+    int i;
+
+    if (capture->frames) {
+        for (i = 0; i < capture->num_frames; ++i) {
+            SDL_free(capture->frames[i].pixels);
+            SDL_free(capture->frames[i].rects);
+        }
+        SDL_free(capture->frames);
+        capture->frames = NULL;
+    }
+    SDL_FreeSurface(capture->canvas);
+    capture->canvas = NULL;
+    SDL_free(capture->yuv);
+    capture->yuv = NULL;
+}
+
+static int
+AllocateCaptureFrames(SDL_FrameCapture *capture, SDL_Surface *surface)
+{
+    const size_t frame_size = (size_t) surface->w * surface->h * surface->format->BytesPerPixel;
+    int i;
+
+    capture->frames = (SDL_CapturedFrame *) SDL_calloc(capture->num_frames, sizeof(*capture->frames));
+    if (!capture->frames) {
+        return SDL_OutOfMemory();
+    }
+    for (i = 0; i < capture->num_frames; ++i) {
+        capture->frames[i].pixels = (Uint8 *) SDL_malloc(frame_size ? frame_size : 1);
+        if (!capture->frames[i].pixels) {
+            return SDL_OutOfMemory();
+        }
+    }
+
+    capture->canvas = SDL_CreateRGBSurfaceWithFormat(0, surface->w, surface->h, 0, surface->format->format);
+    if (!capture->canvas) {
+        return -1;
+    }
+
+    if (capture->format == SDL_FRAMECAPTURE_I420 || capture->format == SDL_FRAMECAPTURE_Y4M) {
+        capture->yuv_size = (size_t) surface->w * surface->h +
+                            2 * (size_t) ((surface->w + 1) / 2) * ((surface->h + 1) / 2);
+        capture->yuv = (Uint8 *) SDL_malloc(capture->yuv_size);
+        if (!capture->yuv) {
+            return SDL_OutOfMemory();
+        }
+    }
+
+    capture->surface = surface;
+    capture->head = 0;
+    capture->count = 0;
+    capture->full_update = SDL_TRUE;
+    return 0;
+}
+
+static int
+WriteCaptureHeader(SDL_FrameCapture *capture)
+{
+    char header[128];
+
+    if (capture->format == SDL_FRAMECAPTURE_Y4M) {
+        /* SDL downsamples chroma by averaging 2x2 blocks and uses studio range */
+        SDL_snprintf(header, sizeof(header), "YUV4MPEG2 W%d H%d F%d:1 Ip A1:1 C420jpeg XCOLORRANGE=LIMITED\n",
+                     capture->surface->w, capture->surface->h, capture->rate);
+        if (SDL_RWwrite(capture->rw, header, SDL_strlen(header), 1) != 1) {
+            return -1;
+        }
+    }
+    return 0;
+}
+
+static int
+WriteCapturedFrame(SDL_FrameCapture *capture, const SDL_CapturedFrame *frame)
+{
+    SDL_Surface *canvas = capture->canvas;
+    const int bpp = canvas->format->BytesPerPixel;
+    const Uint8 *src = frame->pixels;
+    int i, y;
+
+    /* Bring the frame up to date */
+    for (i = 0; i < frame->numrects; ++i) {
+        const SDL_Rect *rect = &frame->rects[i];
+        const size_t length = (size_t) rect->w * bpp;
+        Uint8 *dst = (Uint8 *) canvas->pixels + rect->y * canvas->pitch + rect->x * bpp;
+
+        for (y = 0; y < rect->h; ++y) {
+            SDL_memcpy(dst, src, length);
+            src += length;
+            dst += canvas->pitch;
+        }
+    }
+
+    ++capture->frame_number;
+
+    switch (capture->format) {
+    case SDL_FRAMECAPTURE_BMP:
+        {
+            char file[128];
+            SDL_snprintf(file, sizeof(file), "SDL_window%d-%8.8d.bmp",
+                         capture->window_id, capture->frame_number);
+            return SDL_SaveBMP(canvas, file);
+        }
+    case SDL_FRAMECAPTURE_RAW:
+        {
+            const size_t length = (size_t) canvas->w * bpp;
+
+            if (canvas->pitch == length) {
+                if (SDL_RWwrite(capture->rw, canvas->pixels, length * canvas->h, 1) != 1) {
+                    return -1;
+                }
+            } else {
+                const Uint8 *row = (const Uint8 *) canvas->pixels;
+                for (y = 0; y < canvas->h; ++y) {
+                    if (SDL_RWwrite(capture->rw, row, length, 1) != 1) {
+                        return -1;
+                    }
+                    row += canvas->pitch;
+                }
+            }
+            return 0;
+        }
+    case SDL_FRAMECAPTURE_Y4M:
+        if (SDL_RWwrite(capture->rw, "FRAME\n", 6, 1) != 1) {
+            return -1;
+        }
+        /* Fall through */
+    case SDL_FRAMECAPTURE_I420:
+        if (SDL_ConvertPixels(canvas->w, canvas->h, canvas->format->format, canvas->pixels, canvas->pitch,
+                              SDL_PIXELFORMAT_IYUV, capture->yuv, canvas->w) < 0) {
+            return -1;
+        }
+        if (SDL_RWwrite(capture->rw, capture->yuv, capture->yuv_size, 1) != 1) {
+            return -1;
+        }
+        return 0;
+    }
+    return SDL_Unsupported();
+}
+
+static void
+ProcessCapturedFrame(SDL_FrameCapture *capture, const SDL_CapturedFrame *frame)
+{
+    if (capture->failed) {
+        return;
+    }
+    if (WriteCapturedFrame(capture, frame) < 0) {
+        SDL_LogError(SDL_LOG_CATEGORY_VIDEO, "Couldn't write captured frame for window %d: %s",
+                     capture->window_id, SDL_GetError());
+        capture->failed = SDL_TRUE;
+        return;
+    }
+    ++capture->written;
+}
+
+static int SDLCALL
+SDL_FrameCaptureThread(void *data)
+{
+    SDL_FrameCapture *capture = (SDL_FrameCapture *) data;
+    int tail;
+
+    SDL_LockMutex(capture->lock);
+    for ( ; ; ) {
+        while (capture->count == 0 && !capture->quit) {
+            SDL_CondWait(capture->cond, capture->lock);
+        }
+        if (capture->count == 0) {
+            break;
+        }
+        tail = (capture->head + capture->num_frames - capture->count) % capture->num_frames;
+        SDL_UnlockMutex(capture->lock);
+
+        ProcessCapturedFrame(capture, &capture->frames[tail]);
+
+        SDL_LockMutex(capture->lock);
+        --capture->count;
+        SDL_CondBroadcast(capture->cond);
+    }
+    SDL_UnlockMutex(capture->lock);
+    return 0;
+}
+
+static void
+WaitForCapturedFrames(SDL_FrameCapture *capture)
+{
+    if (capture->thread) {
+        SDL_LockMutex(capture->lock);
+        while (capture->count > 0) {
+            SDL_CondWait(capture->cond, capture->lock);
+        }
+        SDL_UnlockMutex(capture->lock);
+    }
+}
+
+SDL_FrameCapture *
+SDL_CreateFrameCapture(SDL_FrameCaptureConfig *config, SDL_Window *window, SDL_Surface *surface)
+{
+    SDL_FrameCapture *capture;
+
+    capture = (SDL_FrameCapture *) SDL_calloc(1, sizeof(*capture));
+    if (!capture) {
+        SDL_OutOfMemory();
+        return NULL;
+    }
+    capture->format = config->format;
+    capture->rate = config->rate;
+    capture->window_id = SDL_GetWindowID(window);
+    capture->num_frames = config->num_buffers;
+
+    if (AllocateCaptureFrames(capture, surface) < 0) {
+        SDL_DestroyFrameCapture(capture);
+        return NULL;
+    }
+
+    if (capture->format != SDL_FRAMECAPTURE_BMP) {
+        capture->rw = OpenCaptureOutput(config, capture->window_id);
+        if (!capture->rw || WriteCaptureHeader(capture) < 0) {
+            SDL_DestroyFrameCapture(capture);
+            return NULL;
+        }
+    }
+
+#if !SDL_THREADS_DISABLED
+    capture->lock = SDL_CreateMutex();
+    capture->cond = SDL_CreateCond();
+    if (!capture->lock || !capture->cond) {
+        SDL_DestroyFrameCapture(capture);
+        return NULL;
+    }
+    capture->thread = SDL_CreateThread(SDL_FrameCaptureThread, "SDLFrameCapture", capture);
+    if (!capture->thread) {
+        SDL_DestroyFrameCapture(capture);
+        return NULL;
+    }
+#endif /* !SDL_THREADS_DISABLED */
+
+    return capture;
+}
+
+int
+SDL_ResizeFrameCapture(SDL_FrameCapture *capture, SDL_Surface *surface)
+{
+    WaitForCapturedFrames(capture);
+
+    if (capture->stopped) {
+        return 0;
+    }
+
+    /* The old framebuffer has already been freed, compare against our copy */
+    if (surface->w != capture->canvas->w || surface->h != capture->canvas->h ||
+        surface->format->format != capture->canvas->format->format) {
+        FreeCaptureFrames(capture);
+
+        /* A video stream can't change size part way through */
+        if (capture->format != SDL_FRAMECAPTURE_BMP) {
+            SDL_LogWarn(SDL_LOG_CATEGORY_VIDEO, "Window %d changed size, frame capture stopped",
+                        capture->window_id);
+            capture->stopped = SDL_TRUE;
+            return 0;
+        }
+
+        if (AllocateCaptureFrames(capture, surface) < 0) {
+            FreeCaptureFrames(capture);
+            capture->stopped = SDL_TRUE;
+            return -1;
+        }
+    }
+    capture->surface = surface;
+    capture->full_update = SDL_TRUE;
+    return 0;
+}
+
+int
+SDL_SubmitFrameCapture(SDL_FrameCapture *capture, const SDL_Rect *rects, int numrects)
+{
+    SDL_Surface *surface = capture->surface;
+    const int bpp = surface->format->BytesPerPixel;
+    SDL_CapturedFrame *frame;
+    SDL_Rect bounds;
+    Uint8 *dst;
+    Sint64 area = 0;
+    int i, y;
+
+    if (capture->stopped) {
+        return 0;
+    }
+
+    ++capture->submitted;
+
+    SDL_LockMutex(capture->lock);
+    if (capture->count == capture->num_frames) {
+        SDL_UnlockMutex(capture->lock);
+        ++capture->dropped;
+        capture->full_update = SDL_TRUE;
+        return 0;
+    }
+    frame = &capture->frames[capture->head];
+    SDL_UnlockMutex(capture->lock);
+
+    bounds.x = 0;
+    bounds.y = 0;
+    bounds.w = surface->w;
+    bounds.h = surface->h;
+
+    /* The frame only has room for a full framebuffer, so overlapping rects
+       that would add up to more than that are copied as one */
+    if (!capture->full_update) {
+        for (i = 0; i < numrects; ++i) {
+            SDL_Rect clipped;
+            if (SDL_IntersectRect(&rects[i], &bounds, &clipped)) {
+                area += (Sint64) clipped.w * clipped.h;
+            }
+        }
+        if (area >= (Sint64) bounds.w * bounds.h) {
+            capture->full_update = SDL_TRUE;
+        }
+    }
+    if (capture->full_update) {
+        rects = &bounds;
+        numrects = 1;
+    }
+
+    if (numrects > frame->maxrects) {
+        SDL_Rect *new_rects = (SDL_Rect *) SDL_realloc(frame->rects, numrects * sizeof(*new_rects));
+        if (!new_rects) {
+            return SDL_OutOfMemory();
+        }
+        frame->rects = new_rects;
+        frame->maxrects = numrects;
+    }
+
+    /* Only the updated parts of the framebuffer are copied */
+    frame->numrects = 0;
+    dst = frame->pixels;
+    for (i = 0; i < numrects; ++i) {
+        SDL_Rect *rect = &frame->rects[frame->numrects];
+        const Uint8 *src;
+        size_t length;
+
+        if (!SDL_IntersectRect(&rects[i], &bounds, rect)) {
+            continue;
+        }
+        src = (const Uint8 *) surface->pixels + rect->y * surface->pitch + rect->x * bpp;
+        length = (size_t) rect->w * bpp;
+        for (y = 0; y < rect->h; ++y) {
+            SDL_memcpy(dst, src, length);
+            src += surface->pitch;
+            dst += length;
+        }
+        ++frame->numrects;
+    }
+    capture->full_update = SDL_FALSE;
+
+    if (!capture->thread) {
+        ProcessCapturedFrame(capture, frame);
+        return 0;
+    }
+
+    SDL_LockMutex(capture->lock);
+    capture->head = (capture->head + 1) % capture->num_frames;
+    ++capture->count;
+    SDL_CondBroadcast(capture->cond);
+    SDL_UnlockMutex(capture->lock);
+    return 0;
+}
+
+void
+SDL_DestroyFrameCapture(SDL_FrameCapture *capture)
+{
+    if (!capture) {
+        return;
+    }
+
+    if (capture->thread) {
+        SDL_LockMutex(capture->lock);
+        capture->quit = SDL_TRUE;
+        SDL_CondBroadcast(capture->cond);
+        SDL_UnlockMutex(capture->lock);
+        SDL_WaitThread(capture->thread, NULL);
+    }
+
+    if (capture->submitted > 0) {
+        SDL_LogInfo(SDL_LOG_CATEGORY_VIDEO, "Window %d: %u frames presented, %u written, %u dropped",
+                    capture->window_id, capture->submitted, capture->written, capture->dropped);
+    }
+
+    if (capture->rw) {
+        SDL_RWclose(capture->rw);
+    }
+    FreeCaptureFrames(capture);
+    if (capture->cond) {
+        SDL_DestroyCond(capture->cond);
+    }
+    if (capture->lock) {
+        SDL_DestroyMutex(capture->lock);
+    }
+    SDL_free(capture);
+}
+
+/* vi: set ts=4 sw=4 expandtab: */
@@ -0,0 +1,60 @@
+/*
+  Simple DirectMedia Layer
+  Copyright (C) 1997-2020 Sam Lantinga <slouken@libsdl.org>
+
+  This software is provided 'as-is', without any express or implied
+  warranty.  In no event will the authors be held liable for any damages
+  arising from the use of this software.
+
+  Permission is granted to anyone to use this software for any purpose,
+  including commercial applications, and to alter it and redistribute it
+  freely, subject to the following restrictions:
+
+  1. The origin of this software must not be misrepresented; you must not
+     claim that you wrote the original software. If you use this software
+     in a product, an acknowledgment in the product documentation would be
+     appreciated but is not required.
+  2. Altered source versions must be plainly marked as such, and must not be
+     misrepresented as being the original software.
+  3. This notice may not be removed or altered from any source distribution.
+*/
+
+#ifndef SDL_framecapture_c_h_
+#define SDL_framecapture_c_h_
+
+#include "../SDL_internal.h"
+
+/* Frame capture for the headless video drivers.
+
+   The capture settings are read from the environment once, when the driver
+   is initialized, using the driver's prefix (e.g. "SDL_VIDEO_DUMMY"):
+
+   <prefix>_SAVE_FRAMES      If set, save every frame as SDL_window<id>-<frame>.bmp
+   <prefix>_CAPTURE          Write every frame to this file or pipe ("-" is stdout)
+   <prefix>_CAPTURE_FORMAT   "raw" (the framebuffer pixels, default), "i420" or "y4m"
+   <prefix>_CAPTURE_BUFFERS  Number of frames that can be queued, default 4
+   <prefix>_CAPTURE_RATE     Frame rate written in the Y4M header, default 60
+
+   Presenting a frame only copies the updated rects into a preallocated ring
+   buffer, the conversion and writing is done on a background thread. If the
+   writer falls behind, the frame is dropped and counted.
+ */
+
+typedef struct SDL_FrameCaptureConfig SDL_FrameCaptureConfig;
+typedef struct SDL_FrameCapture SDL_FrameCapture;
+
+/* Returns NULL if frame capture isn't enabled for this driver */
+extern SDL_FrameCaptureConfig *SDL_CreateFrameCaptureConfig(const char *prefix);
+extern void SDL_DestroyFrameCaptureConfig(SDL_FrameCaptureConfig *config);
+
+/* Start capturing the framebuffer surface of a window */
+extern SDL_FrameCapture *SDL_CreateFrameCapture(SDL_FrameCaptureConfig *config, SDL_Window *window, SDL_Surface *surface);
+/* The window framebuffer was recreated, waits for queued frames to be written */
+extern int SDL_ResizeFrameCapture(SDL_FrameCapture *capture, SDL_Surface *surface);
+/* Queue the updated parts of the framebuffer to be written */
+extern int SDL_SubmitFrameCapture(SDL_FrameCapture *capture, const SDL_Rect *rects, int numrects);
+extern void SDL_DestroyFrameCapture(SDL_FrameCapture *capture);
+
+#endif /* SDL_framecapture_c_h_ */
+
+/* vi: set ts=4 sw=4 expandtab: */
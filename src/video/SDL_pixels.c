@@ -975,12 +975,9 @@ SDL_AllocBlitMap(void)
     return (map);
 }
 
-void
-SDL_InvalidateMap(SDL_BlitMap * map)
+static void
+SDL_ClearMap(SDL_BlitMap * map)
 {
-    if (!map) {
-        return;
-    }
     if (map->dst) {
         /* Release our reference to the surface - see the note below */
         if (--map->dst->refcount <= 0) {
@@ -994,6 +991,112 @@ SDL_InvalidateMap(SDL_BlitMap * map)
     map->info.table = NULL;
 }
 
+static void
+SDL_ClearCachedBlit(SDL_BlitCacheEntry * entry)
+{
+    if (entry->dst) {
+        if (--entry->dst->refcount <= 0) {
+            SDL_FreeSurface(entry->dst);
+        }
+    }
+    entry->dst = NULL;
+    SDL_free(entry->table);
+    entry->table = NULL;
+}
+
+void
+SDL_InvalidateMap(SDL_BlitMap * map)
+{
+    int i;
+
+    if (!map) {
+        return;
+    }
+    SDL_ClearMap(map);
+    for (i = 0; i < SDL_arraysize(map->cache); ++i) {
+        SDL_ClearCachedBlit(&map->cache[i]);
+    }
+}
+
+/* Keep the current blit in the map's cache, so that SDL_MapSurface() doesn't
+   have to choose it again if the map goes back to the same flags and
+   destination. */
+static void
+SDL_SetAsideBlit(SDL_BlitMap * map, int flags)
+{
+    /* RLE surfaces need encoding again anyway, and the tables of indexed
+       sources depend on the color and alpha modulation as well */
+    if (map->dst && map->data && !(flags & SDL_COPY_RLE_MASK) &&
+        !(SDL_ISPIXELFORMAT_INDEXED(map->info.src_fmt->format) &&
+          (flags & (SDL_COPY_MODULATE_COLOR | SDL_COPY_MODULATE_ALPHA)))) {
+        SDL_BlitCacheEntry *entry = &map->cache[map->cache_next];
+        map->cache_next = (map->cache_next + 1) % SDL_arraysize(map->cache);
+
+        SDL_ClearCachedBlit(entry);
+        entry->dst = map->dst;  /* The reference moves to the entry */
+        entry->flags = flags;
+        entry->identity = map->identity;
+        entry->blit = map->blit;
+        entry->func = (SDL_BlitFunc) map->data;
+        entry->table = map->info.table;
+        entry->dst_palette_version = map->dst_palette_version;
+        entry->src_palette_version = map->src_palette_version;
+        map->dst = NULL;
+        map->info.table = NULL;
+    }
+}
+
+/* Called when only the copy flags changed. The blit set up for the old flags
+   is kept, as a renderer often alternates modulated and plain copies of a
+   texture. */
+void
+SDL_InvalidateMapForFlags(SDL_BlitMap * map, int old_flags)
+{
+    if (!map) {
+        return;
+    }
+    SDL_SetAsideBlit(map, old_flags);
+    SDL_ClearMap(map);
+}
+
+/* Pick up a blit set aside by SDL_SetAsideBlit(), if there is one */
+static SDL_bool
+SDL_MapCachedBlit(SDL_Surface * src, SDL_Surface * dst)
+{
+    SDL_BlitMap *map = src->map;
+    const Uint32 src_palette_version = src->format->palette ? src->format->palette->version : 0;
+    const Uint32 dst_palette_version = dst->format->palette ? dst->format->palette->version : 0;
+    int i;
+
+    for (i = 0; i < SDL_arraysize(map->cache); ++i) {
+        SDL_BlitCacheEntry *entry = &map->cache[i];
+        if (entry->dst && entry->dst != dst && entry->dst->refcount == 1) {
+            /* The cache holds the last reference, the surface is gone */
+            SDL_ClearCachedBlit(entry);
+            continue;
+        }
+        if (entry->dst == dst && entry->flags == map->info.flags &&
+            entry->src_palette_version == src_palette_version &&
+            entry->dst_palette_version == dst_palette_version) {
+            map->dst = dst;  /* The reference moves back to the map */
+            map->identity = entry->identity;
+            map->blit = entry->blit;
+            map->data = (void *) entry->func;
+            map->info.table = entry->table;
+            map->info.src_fmt = src->format;
+            map->info.src_pitch = src->pitch;
+            map->info.dst_fmt = dst->format;
+            map->info.dst_pitch = dst->pitch;
+            map->src_palette_version = src_palette_version;
+            map->dst_palette_version = dst_palette_version;
+            entry->dst = NULL;
+            entry->table = NULL;
+            return SDL_TRUE;
+        }
+    }
+    return SDL_FALSE;
+}
+
 int
 SDL_MapSurface(SDL_Surface * src, SDL_Surface * dst)
 {
@@ -1008,7 +1111,18 @@ SDL_MapSurface(SDL_Surface * src, SDL_Surface * dst)
         SDL_UnRLESurface(src, 1);
     }
 #endif
-    SDL_InvalidateMap(map);
+    /* A texture drawn into several render targets in turn can go back to
+       the blit it had for each of them. If only a palette changed, the old
+       blit is out of date, and a destination nothing else refers to any
+       more, like a temporary conversion surface, isn't worth keeping. */
+    if (map->dst != dst && map->dst && map->dst->refcount > 1) {
+        SDL_SetAsideBlit(map, map->info.flags);
+    }
+    SDL_ClearMap(map);
+
+    if (SDL_MapCachedBlit(src, dst)) {
+        return 0;
+    }
 
     /* Figure out what kind of mapping we're doing */
     map->identity = 0;
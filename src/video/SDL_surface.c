@@ -266,7 +266,7 @@ SDL_SetColorKey(SDL_Surface * surface, int flag, Uint32 key)
         surface->map->info.flags &= ~SDL_COPY_COLORKEY;
     }
     if (surface->map->info.flags != flags) {
-        SDL_InvalidateMap(surface->map);
+        SDL_InvalidateMapForFlags(surface->map, flags);
     }
 
     return 0;
@@ -422,7 +422,7 @@ SDL_SetSurfaceColorMod(SDL_Surface * surface, Uint8 r, Uint8 g, Uint8 b)
         surface->map->info.flags &= ~SDL_COPY_MODULATE_COLOR;
     }
     if (surface->map->info.flags != flags) {
-        SDL_InvalidateMap(surface->map);
+        SDL_InvalidateMapForFlags(surface->map, flags);
     }
     return 0;
 }
@@ -465,7 +465,7 @@ SDL_SetSurfaceAlphaMod(SDL_Surface * surface, Uint8 alpha)
         surface->map->info.flags &= ~SDL_COPY_MODULATE_ALPHA;
     }
     if (surface->map->info.flags != flags) {
-        SDL_InvalidateMap(surface->map);
+        SDL_InvalidateMapForFlags(surface->map, flags);
     }
     return 0;
 }
@@ -517,7 +517,7 @@ SDL_SetSurfaceBlendMode(SDL_Surface * surface, SDL_BlendMode blendMode)
     }
 
     if (surface->map->info.flags != flags) {
-        SDL_InvalidateMap(surface->map);
+        SDL_InvalidateMapForFlags(surface->map, flags);
     }
 
     return status;
@@ -705,7 +705,7 @@ SDL_UpperBlit(SDL_Surface * src, const SDL_Rect * srcrect,
     /* Switch back to a fast blit if we were previously stretching */
     if (src->map->info.flags & SDL_COPY_NEAREST) {
         src->map->info.flags &= ~SDL_COPY_NEAREST;
-        SDL_InvalidateMap(src->map);
+        SDL_InvalidateMapForFlags(src->map, src->map->info.flags | SDL_COPY_NEAREST);
     }
 
     if (w > 0 && h > 0) {
@@ -886,7 +886,7 @@ SDL_LowerBlitScaled(SDL_Surface * src, SDL_Rect * srcrect,
 
     if (!(src->map->info.flags & SDL_COPY_NEAREST)) {
         src->map->info.flags |= SDL_COPY_NEAREST;
-        SDL_InvalidateMap(src->map);
+        SDL_InvalidateMapForFlags(src->map, src->map->info.flags & ~SDL_COPY_NEAREST);
     }
 
     if ( !(src->map->info.flags & complex_copy_flags) &&
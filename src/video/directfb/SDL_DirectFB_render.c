@@ -818,6 +818,10 @@ DirectFB_RunCommandQueue(SDL_Renderer * renderer, SDL_RenderCommand *cmd, void *
             case SDL_RENDERCMD_COPY_EX:
                 break;  /* unsupported */
 
+            case SDL_RENDERCMD_COPY_BATCH:  /* not queued, this backend has no QueueCopyBatch */
+            case SDL_RENDERCMD_GEOMETRY:  /* not queued, this backend has no QueueGeometry */
+                break;
+
             case SDL_RENDERCMD_NO_OP:
                 break;
         }
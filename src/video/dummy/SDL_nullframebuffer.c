@@ -23,13 +23,17 @@
 #if SDL_VIDEO_DRIVER_DUMMY
 
 #include "../SDL_sysvideo.h"
+#include "../SDL_framecapture_c.h"
 #include "SDL_nullframebuffer_c.h"
 
 
 #define DUMMY_SURFACE   "_SDL_DummySurface"
+#define DUMMY_CAPTURE   "_SDL_DummyCapture"
 
 int SDL_DUMMY_CreateWindowFramebuffer(_THIS, SDL_Window * window, Uint32 * format, void ** pixels, int *pitch)
 {
+    SDL_FrameCaptureConfig *config = (SDL_FrameCaptureConfig *) _this->driverdata;
+    SDL_FrameCapture *capture;
     SDL_Surface *surface;
     const Uint32 surface_format = SDL_PIXELFORMAT_RGB888;
     int w, h;
@@ -48,6 +52,21 @@ int SDL_DUMMY_CreateWindowFramebuffer(_THIS, SDL_Window * window, Uint32 * forma
         return -1;
     }
 
+    /* Start capturing frames, if requested */
+    if (config) {
+        capture = (SDL_FrameCapture *) SDL_GetWindowData(window, DUMMY_CAPTURE);
+        if (capture) {
+            SDL_ResizeFrameCapture(capture, surface);
+        } else {
+            capture = SDL_CreateFrameCapture(config, window, surface);
+            if (!capture) {
+                SDL_FreeSurface(surface);
+                return -1;
+            }
+            SDL_SetWindowData(window, DUMMY_CAPTURE, capture);
+        }
+    }
+
     /* Save the info and return! */
     SDL_SetWindowData(window, DUMMY_SURFACE, surface);
     *format = surface_format;
@@ -58,7 +77,7 @@ int SDL_DUMMY_CreateWindowFramebuffer(_THIS, SDL_Window * window, Uint32 * forma
 
 int SDL_DUMMY_UpdateWindowFramebuffer(_THIS, SDL_Window * window, const SDL_Rect * rects, int numrects)
 {
-    static int frame_number;
+    SDL_FrameCapture *capture;
     SDL_Surface *surface;
 
     surface = (SDL_Surface *) SDL_GetWindowData(window, DUMMY_SURFACE);
@@ -67,19 +86,21 @@ int SDL_DUMMY_UpdateWindowFramebuffer(_THIS, SDL_Window * window, const SDL_Rect
     }
 
     /* Send the data to the display */
-    if (SDL_getenv("SDL_VIDEO_DUMMY_SAVE_FRAMES")) {
-        char file[128];
-        SDL_snprintf(file, sizeof(file), "SDL_window%d-%8.8d.bmp",
-                     SDL_GetWindowID(window), ++frame_number);
-        SDL_SaveBMP(surface, file);
+    capture = (SDL_FrameCapture *) SDL_GetWindowData(window, DUMMY_CAPTURE);
+    if (capture) {
+        return SDL_SubmitFrameCapture(capture, rects, numrects);
     }
     return 0;
 }
 
 void SDL_DUMMY_DestroyWindowFramebuffer(_THIS, SDL_Window * window)
 {
+    SDL_FrameCapture *capture;
     SDL_Surface *surface;
 
+    capture = (SDL_FrameCapture *) SDL_SetWindowData(window, DUMMY_CAPTURE, NULL);
+    SDL_DestroyFrameCapture(capture);
+
     surface = (SDL_Surface *) SDL_SetWindowData(window, DUMMY_SURFACE, NULL);
     SDL_FreeSurface(surface);
 }
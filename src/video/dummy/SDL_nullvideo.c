@@ -41,6 +41,7 @@
 #include "SDL_mouse.h"
 #include "../SDL_sysvideo.h"
 #include "../SDL_pixels_c.h"
+#include "../SDL_framecapture_c.h"
 #include "../../events/SDL_events_c.h"
 
 #include "SDL_nullvideo.h"
@@ -124,6 +125,9 @@ DUMMY_VideoInit(_THIS)
     SDL_zero(mode);
     SDL_AddDisplayMode(&_this->displays[0], &mode);
 
+    /* Check once whether frames should be captured, rather than every frame */
+    _this->driverdata = SDL_CreateFrameCaptureConfig("SDL_VIDEO_DUMMY");
+
     /* We're done! */
     return 0;
 }
@@ -137,6 +141,8 @@ DUMMY_SetDisplayMode(_THIS, SDL_VideoDisplay * display, SDL_DisplayMode * mode)
 void
 DUMMY_VideoQuit(_THIS)
 {
+    SDL_DestroyFrameCaptureConfig((SDL_FrameCaptureConfig *) _this->driverdata);
+    _this->driverdata = NULL;
 }
 
 #endif /* SDL_VIDEO_DRIVER_DUMMY */
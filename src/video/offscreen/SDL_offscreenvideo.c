@@ -34,6 +34,7 @@
 #include "SDL_video.h"
 #include "SDL_mouse.h"
 #include "../SDL_sysvideo.h"
+#include "../SDL_framecapture_c.h"
 #include "../SDL_pixels_c.h"
 #include "../../events/SDL_events_c.h"
 
@@ -141,6 +142,9 @@ OFFSCREEN_VideoInit(_THIS)
     SDL_zero(mode);
     SDL_AddDisplayMode(&_this->displays[0], &mode);
 
+    /* Check once whether frames should be captured, rather than every frame */
+    _this->driverdata = SDL_CreateFrameCaptureConfig("SDL_VIDEO_OFFSCREEN");
+
     /* Init mouse */
     mouse = SDL_GetMouse();
     /* This function needs to be implemented by every driver */
@@ -159,6 +163,8 @@ OFFSCREEN_SetDisplayMode(_THIS, SDL_VideoDisplay * display, SDL_DisplayMode * mo
 void
 OFFSCREEN_VideoQuit(_THIS)
 {
+    SDL_DestroyFrameCaptureConfig((SDL_FrameCaptureConfig *) _this->driverdata);
+    _this->driverdata = NULL;
 }
 
 #endif /* SDL_VIDEO_DRIVER_OFFSCREEN */
@@ -0,0 +1,272 @@
+/*
+  Copyright (C) 1997-2020 Sam Lantinga <slouken@libsdl.org>
+
+  This software is provided 'as-is', without any express or implied
+  warranty.  In no event will the authors be held liable for any damages
+  arising from the use of this software.
+
+  Permission is granted to anyone to use this software for any purpose,
+  including commercial applications, and to alter it and redistribute it
+  freely.
+*/
+
+/* Benchmark loading many small files with SDL_LoadFile() against the
+   asynchronous I/O queue, and check reads from a stream at offsets. */
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "SDL.h"
+
+#define NUM_FILES 2000
+#define CHUNK_SIZE 4096
+#define NUM_CHUNKS 64
+
+static char *
+FileName(int index, char *name, size_t len)
+{
+    SDL_snprintf(name, len, "testasyncio%d.tmp", index);
+    return name;
+}
+
+static size_t
+FileSize(int index)
+{
+    return 1024 + (index % 8) * 512;
+}
+
+static Uint8
+FileByte(int index, size_t offset)
+{
+    return (Uint8) (index * 31 + offset * 7);
+}
+
+static SDL_bool
+CheckFile(int index, const Uint8 *data, size_t size)
+{
+    size_t i;
+
+    if (!data || size != FileSize(index)) {
+        return SDL_FALSE;
+    }
+    for (i = 0; i < size; ++i) {
+        if (data[i] != FileByte(index, i)) {
+            return SDL_FALSE;
+        }
+    }
+    return SDL_TRUE;
+}
+
+static void
+RemoveFiles(int count)
+{
+    char name[64];
+    int i;
+
+    for (i = 0; i < count; ++i) {
+        remove(FileName(i, name, sizeof (name)));
+    }
+}
+
+static int
+CreateFiles(void)
+{
+    Uint8 data[8 * 1024];
+    char name[64];
+    int i;
+    size_t j;
+
+    for (i = 0; i < NUM_FILES; ++i) {
+        SDL_RWops *rwops = SDL_RWFromFile(FileName(i, name, sizeof (name)), "wb");
+        size_t size = FileSize(i);
+
+        if (!rwops) {
+            SDL_Log("Couldn't create %s: %s\n", name, SDL_GetError());
+            RemoveFiles(i);
+            return -1;
+        }
+        for (j = 0; j < size; ++j) {
+            data[j] = FileByte(i, j);
+        }
+        SDL_RWwrite(rwops, data, 1, size);
+        SDL_RWclose(rwops);
+    }
+    return 0;
+}
+
+static double
+Elapsed(Uint64 start)
+{
+    return (double) ((SDL_GetPerformanceCounter() - start) * 1000) / SDL_GetPerformanceFrequency();
+}
+
+static int
+LoadSequential(double *ms)
+{
+    Uint64 start = SDL_GetPerformanceCounter();
+    char name[64];
+    int i;
+
+    for (i = 0; i < NUM_FILES; ++i) {
+        size_t size = 0;
+        void *data = SDL_LoadFile(FileName(i, name, sizeof (name)), &size);
+        if (!CheckFile(i, (const Uint8 *) data, size)) {
+            SDL_Log("SDL_LoadFile() of %s failed\n", name);
+            SDL_free(data);
+            return -1;
+        }
+        SDL_free(data);
+    }
+    *ms = Elapsed(start);
+    return 0;
+}
+
+static int
+LoadAsync(SDL_AsyncIOQueue *queue, double *ms)
+{
+    Uint64 start = SDL_GetPerformanceCounter();
+    SDL_AsyncIOOutcome outcome;
+    char name[64];
+    int i, result = 0;
+
+    for (i = 0; i < NUM_FILES; ++i) {
+        if (SDL_LoadFileAsyncIO(queue, FileName(i, name, sizeof (name)), (void *) (size_t) i) < 0) {
+            SDL_Log("Couldn't submit %s: %s\n", name, SDL_GetError());
+            result = -1;
+            break;
+        }
+    }
+    while (SDL_WaitAsyncIOResult(queue, &outcome, -1)) {
+        i = (int) (size_t) outcome.userdata;
+        if (outcome.result != SDL_ASYNCIO_COMPLETE ||
+            !CheckFile(i, (const Uint8 *) outcome.buffer, outcome.bytes_transferred)) {
+            SDL_Log("Asynchronous load of %s failed\n", FileName(i, name, sizeof (name)));
+            result = -1;
+        }
+        SDL_free(outcome.buffer);
+    }
+    *ms = Elapsed(start);
+    return result;
+}
+
+/* Read a file in chunks, out of order, and check they landed in the right place */
+static int
+TestReads(SDL_AsyncIOQueue *queue)
+{
+    Uint8 *expected = (Uint8 *) SDL_malloc(CHUNK_SIZE * NUM_CHUNKS);
+    Uint8 *data = (Uint8 *) SDL_calloc(NUM_CHUNKS, CHUNK_SIZE);
+    SDL_AsyncIOOutcome outcome;
+    SDL_RWops *rwops;
+    int i, completed = 0, result = 0;
+
+    if (!expected || !data) {
+        SDL_Log("Out of memory!\n");
+        SDL_free(expected);
+        SDL_free(data);
+        return -1;
+    }
+    for (i = 0; i < CHUNK_SIZE * NUM_CHUNKS; ++i) {
+        expected[i] = FileByte(NUM_FILES, i);
+    }
+
+    rwops = SDL_RWFromFile("testasyncio.tmp", "wb");
+    if (!rwops) {
+        SDL_Log("Couldn't create testasyncio.tmp: %s\n", SDL_GetError());
+        SDL_free(expected);
+        SDL_free(data);
+        return -1;
+    }
+    SDL_RWwrite(rwops, expected, CHUNK_SIZE, NUM_CHUNKS);
+    SDL_RWclose(rwops);
+
+    rwops = SDL_RWFromFile("testasyncio.tmp", "rb");
+    for (i = NUM_CHUNKS - 1; rwops && i >= 0; --i) {
+        SDL_ReadAsyncIO(queue, rwops, (Sint64) i * CHUNK_SIZE, data + i * CHUNK_SIZE, CHUNK_SIZE, NULL);
+    }
+    while (SDL_WaitAsyncIOResult(queue, &outcome, -1)) {
+        if (outcome.result != SDL_ASYNCIO_COMPLETE || outcome.bytes_transferred != CHUNK_SIZE) {
+            result = -1;
+        }
+        ++completed;
+    }
+    if (completed != NUM_CHUNKS || SDL_memcmp(data, expected, CHUNK_SIZE * NUM_CHUNKS) != 0) {
+        result = -1;
+    }
+
+    /* Reads past the end finish with nothing read */
+    if (rwops) {
+        SDL_ReadAsyncIO(queue, rwops, (Sint64) CHUNK_SIZE * NUM_CHUNKS - 10, data, CHUNK_SIZE, NULL);
+        if (!SDL_WaitAsyncIOResult(queue, &outcome, -1) || outcome.bytes_transferred != 10) {
+            result = -1;
+        }
+        SDL_RWclose(rwops);
+    }
+
+    /* Files that aren't there fail */
+    SDL_LoadFileAsyncIO(queue, "testasyncio-missing.tmp", NULL);
+    if (!SDL_WaitAsyncIOResult(queue, &outcome, 1000) || outcome.result != SDL_ASYNCIO_FAILURE) {
+        result = -1;
+    }
+
+    /* Nothing left to wait for */
+    if (SDL_WaitAsyncIOResult(queue, &outcome, -1) || SDL_GetAsyncIOResult(queue, &outcome)) {
+        result = -1;
+    }
+
+    remove("testasyncio.tmp");
+    SDL_free(expected);
+    SDL_free(data);
+
+    if (result < 0) {
+        SDL_Log("Asynchronous reads failed!\n");
+    } else {
+        SDL_Log("Asynchronous reads OK\n");
+    }
+    return result;
+}
+
+int
+main(int argc, char *argv[])
+{
+    SDL_AsyncIOQueue *queue;
+    double sequential_ms = 0.0, async_ms = 0.0;
+    int result = 0;
+
+    /* Enable standard application logging */
+    SDL_LogSetPriority(SDL_LOG_CATEGORY_APPLICATION, SDL_LOG_PRIORITY_INFO);
+
+    /* Load the SDL library */
+    if (SDL_Init(0) < 0) {
+        SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Couldn't initialize SDL: %s\n", SDL_GetError());
+        return 1;
+    }
+
+    queue = SDL_CreateAsyncIOQueue(0);
+    if (!queue) {
+        SDL_Log("Couldn't create I/O queue: %s\n", SDL_GetError());
+        SDL_Quit();
+        return 1;
+    }
+
+    if (CreateFiles() < 0) {
+        SDL_DestroyAsyncIOQueue(queue);
+        SDL_Quit();
+        return 1;
+    }
+
+    if (LoadSequential(&sequential_ms) < 0 ||
+        LoadAsync(queue, &async_ms) < 0 ||
+        TestReads(queue) < 0) {
+        result = 1;
+    } else {
+        SDL_Log("Loading %d files: SDL_LoadFile %9.3f ms, asynchronous %9.3f ms\n",
+                NUM_FILES, sequential_ms, async_ms);
+    }
+
+    RemoveFiles(NUM_FILES);
+    SDL_DestroyAsyncIOQueue(queue);
+    SDL_Quit();
+    return result;
+}
+
+/* vi: set ts=4 sw=4 expandtab: */
@@ -0,0 +1,300 @@
+/*
+  Copyright (C) 1997-2020 Sam Lantinga <slouken@libsdl.org>
+
+  This software is provided 'as-is', without any express or implied
+  warranty.  In no event will the authors be held liable for any damages
+  arising from the use of this software.
+
+  Permission is granted to anyone to use this software for any purpose,
+  including commercial applications, and to alter it and redistribute it
+  freely.
+*/
+
+/* Benchmark drawing text from thousands of small glyph images, with a
+   texture for each glyph and with a texture atlas, and check that the
+   atlas draws the same thing after images are removed, evicted and
+   packed again. */
+
+#include <stdlib.h>
+
+#include "SDL.h"
+
+#define WINDOW_WIDTH 640
+#define WINDOW_HEIGHT 480
+#define NUM_GLYPHS 2000
+#define GLYPHS_PER_FRAME 8000
+#define MAX_GLYPH_SIZE 20
+
+typedef struct
+{
+    int w, h;
+    Uint32 pixels[MAX_GLYPH_SIZE * MAX_GLYPH_SIZE];
+} Glyph;
+
+static Glyph glyphs[NUM_GLYPHS];
+static SDL_Texture *textures[NUM_GLYPHS];
+static SDL_AtlasID ids[NUM_GLYPHS];
+static SDL_TextureAtlas *atlas;
+static int num_frames = 30;
+static int atlas_misses;
+
+/* The glyphs drawn in a frame come from a window of them, which moves
+   along by some each frame, like text changing on the screen */
+static int glyph_window = NUM_GLYPHS;
+static int glyph_step = 0;
+
+static void
+MakeGlyphs(void)
+{
+    int i, x, y;
+
+    srand(1);
+    for (i = 0; i < NUM_GLYPHS; ++i) {
+        Glyph *glyph = &glyphs[i];
+        glyph->w = 6 + rand() % (MAX_GLYPH_SIZE - 9);
+        glyph->h = 10 + rand() % (MAX_GLYPH_SIZE - 9);
+        for (y = 0; y < glyph->h; ++y) {
+            for (x = 0; x < glyph->w; ++x) {
+                const Uint32 alpha = ((x * 7 + y * 13 + i) % 5) * 63;
+                glyph->pixels[y * glyph->w + x] = (alpha << 24) | (Uint32) ((i * 2654435761u) & 0xFFFFFF);
+            }
+        }
+    }
+}
+
+static SDL_AtlasID
+AddToAtlas(int i)
+{
+    SDL_AtlasID id = SDL_AddAtlasImage(atlas, glyphs[i].w, glyphs[i].h);
+    if (id) {
+        SDL_UpdateAtlasImage(atlas, id, glyphs[i].pixels, glyphs[i].w * sizeof (Uint32));
+    }
+    return id;
+}
+
+static void
+DrawWithTextures(SDL_Renderer *renderer, int i, const SDL_FRect *dst)
+{
+    SDL_RenderCopyF(renderer, textures[i], NULL, dst);
+}
+
+static void
+DrawWithAtlas(SDL_Renderer *renderer, int i, const SDL_FRect *dst)
+{
+    if (SDL_RenderCopyAtlasImage(renderer, atlas, ids[i], dst) < 0) {
+        /* Evicted, put it back, the way a glyph cache would */
+        ++atlas_misses;
+        ids[i] = AddToAtlas(i);
+        SDL_RenderCopyAtlasImage(renderer, atlas, ids[i], dst);
+    }
+}
+
+/* Lines of text, with random glyphs from the frame's glyph window, or
+   only odd ones if odd_only is set */
+static void
+DrawText(SDL_Renderer *renderer, void (*draw)(SDL_Renderer *, int, const SDL_FRect *),
+         SDL_bool odd_only, int frame)
+{
+    SDL_FRect dst;
+    int i;
+
+    dst.x = 0.0f;
+    dst.y = 0.0f;
+    srand(frame);
+    for (i = 0; i < GLYPHS_PER_FRAME; ++i) {
+        int glyph = (frame * glyph_step + rand() % glyph_window) % NUM_GLYPHS;
+        if (odd_only) {
+            glyph |= 1;
+        }
+        dst.w = (float) glyphs[glyph].w;
+        dst.h = (float) glyphs[glyph].h;
+        if (dst.x + dst.w > WINDOW_WIDTH) {
+            dst.x = 0.0f;
+            dst.y += MAX_GLYPH_SIZE;
+            if (dst.y + MAX_GLYPH_SIZE > WINDOW_HEIGHT) {
+                dst.y = 0.0f;
+            }
+        }
+        draw(renderer, glyph, &dst);
+        dst.x += dst.w;
+    }
+}
+
+static double
+Elapsed(Uint64 start)
+{
+    return (double) ((SDL_GetPerformanceCounter() - start) * 1000) / SDL_GetPerformanceFrequency();
+}
+
+/* Draw a few frames and keep the pixels of the first */
+static double
+Run(SDL_Renderer *renderer, void (*draw)(SDL_Renderer *, int, const SDL_FRect *),
+    SDL_bool odd_only, Uint32 *pixels, SDL_RenderStats *stats)
+{
+    Uint64 start = SDL_GetPerformanceCounter();
+    int frame;
+
+    for (frame = 0; frame < num_frames; ++frame) {
+        SDL_SetRenderDrawColor(renderer, 0x00, 0x00, 0x00, 0xFF);
+        SDL_RenderClear(renderer);
+        DrawText(renderer, draw, odd_only, frame);
+        if (frame == 0) {
+            SDL_RenderReadPixels(renderer, NULL, SDL_PIXELFORMAT_ARGB8888, pixels, WINDOW_WIDTH * sizeof (Uint32));
+        }
+        SDL_RenderPresent(renderer);
+    }
+    SDL_RenderGetStats(renderer, stats);
+    return Elapsed(start);
+}
+
+static SDL_bool
+Compare(const char *what, const Uint32 *expected, const Uint32 *actual)
+{
+    if (SDL_memcmp(expected, actual, WINDOW_WIDTH * WINDOW_HEIGHT * sizeof (Uint32)) != 0) {
+        SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "%s drew something different!\n", what);
+        return SDL_FALSE;
+    }
+    return SDL_TRUE;
+}
+
+int
+main(int argc, char *argv[])
+{
+    SDL_Window *window;
+    SDL_Renderer *renderer;
+    SDL_RenderStats stats;
+    Uint32 *expected, *actual;
+    Uint64 start;
+    double ms;
+    int i, result = 0;
+
+    /* Enable standard application logging */
+    SDL_LogSetPriority(SDL_LOG_CATEGORY_APPLICATION, SDL_LOG_PRIORITY_INFO);
+
+    if (argc > 1) {
+        num_frames = SDL_atoi(argv[1]);
+        if (num_frames <= 0) {
+            SDL_Log("Usage: %s [frames]\n", argv[0]);
+            return 1;
+        }
+    }
+
+    /* Copies from one texture are drawn together when commands are optimized */
+    SDL_SetHint(SDL_HINT_RENDER_DRIVER, "software");
+    SDL_SetHint(SDL_HINT_RENDER_BATCHING, "1");
+    SDL_SetHint(SDL_HINT_RENDER_OPTIMIZE_COMMANDS, "1");
+
+    if (SDL_Init(SDL_INIT_VIDEO) < 0) {
+        SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Couldn't initialize SDL: %s\n", SDL_GetError());
+        return 1;
+    }
+    if (SDL_CreateWindowAndRenderer(WINDOW_WIDTH, WINDOW_HEIGHT, 0, &window, &renderer) < 0) {
+        SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Couldn't create window and renderer: %s\n", SDL_GetError());
+        SDL_Quit();
+        return 1;
+    }
+
+    expected = (Uint32 *) SDL_malloc(WINDOW_WIDTH * WINDOW_HEIGHT * sizeof (Uint32));
+    actual = (Uint32 *) SDL_malloc(WINDOW_WIDTH * WINDOW_HEIGHT * sizeof (Uint32));
+    if (!expected || !actual) {
+        SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Out of memory!\n");
+        result = 1;
+        goto done;
+    }
+
+    MakeGlyphs();
+    SDL_Log("%d glyphs, %d drawn a frame, %d frames\n", NUM_GLYPHS, GLYPHS_PER_FRAME, num_frames);
+
+    /* A texture for each glyph */
+    start = SDL_GetPerformanceCounter();
+    for (i = 0; i < NUM_GLYPHS; ++i) {
+        textures[i] = SDL_CreateTexture(renderer, SDL_PIXELFORMAT_ARGB8888, SDL_TEXTUREACCESS_STATIC,
+                                        glyphs[i].w, glyphs[i].h);
+        SDL_SetTextureBlendMode(textures[i], SDL_BLENDMODE_BLEND);
+        SDL_UpdateTexture(textures[i], NULL, glyphs[i].pixels, glyphs[i].w * sizeof (Uint32));
+    }
+    ms = Elapsed(start);
+    SDL_Log("Textures: created in %9.3f ms\n", ms);
+    ms = Run(renderer, DrawWithTextures, SDL_FALSE, expected, &stats);
+    SDL_Log("Textures: drawn in   %9.3f ms, %u commands in the last frame\n", ms, stats.commands_executed);
+
+    /* One atlas for all of them */
+    start = SDL_GetPerformanceCounter();
+    atlas = SDL_CreateTextureAtlas(renderer, SDL_PIXELFORMAT_ARGB8888, 1024, 1024, 0);
+    if (!atlas) {
+        SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Couldn't create atlas: %s\n", SDL_GetError());
+        result = 1;
+        goto done;
+    }
+    for (i = 0; i < NUM_GLYPHS; ++i) {
+        ids[i] = AddToAtlas(i);
+        if (!ids[i]) {
+            SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Couldn't add glyph %d: %s\n", i, SDL_GetError());
+            result = 1;
+            goto done;
+        }
+    }
+    ms = Elapsed(start);
+    SDL_Log("Atlas:    created in %9.3f ms\n", ms);
+    ms = Run(renderer, DrawWithAtlas, SDL_FALSE, actual, &stats);
+    SDL_Log("Atlas:    drawn in   %9.3f ms, %u commands in the last frame\n", ms, stats.commands_executed);
+    if (!Compare("The atlas", expected, actual)) {
+        result = 1;
+    }
+
+    /* Remove the even glyphs, pack the odd ones again and draw those */
+    for (i = 0; i < NUM_GLYPHS; i += 2) {
+        SDL_RemoveAtlasImage(atlas, ids[i]);
+    }
+    if (SDL_QueryAtlasImage(atlas, ids[0], NULL, NULL) == 0) {
+        SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "A removed image is still in the atlas!\n");
+        result = 1;
+    }
+    start = SDL_GetPerformanceCounter();
+    if (SDL_DefragmentTextureAtlas(atlas) < 0) {
+        SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Couldn't defragment the atlas: %s\n", SDL_GetError());
+        result = 1;
+    }
+    SDL_Log("Atlas:    defragmented in %9.3f ms\n", Elapsed(start));
+    Run(renderer, DrawWithTextures, SDL_TRUE, expected, &stats);
+    Run(renderer, DrawWithAtlas, SDL_TRUE, actual, &stats);
+    if (!Compare("The defragmented atlas", expected, actual)) {
+        result = 1;
+    }
+    SDL_DestroyTextureAtlas(atlas);
+
+    /* An atlas too small for all of them, used as a glyph cache.
+       Format 0 gets the software renderer's preferred format, ARGB8888. */
+    atlas = SDL_CreateTextureAtlas(renderer, 0, 256, 256, SDL_ATLAS_EVICT);
+    if (!atlas) {
+        SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Couldn't create atlas: %s\n", SDL_GetError());
+        result = 1;
+        goto done;
+    }
+    SDL_zero(ids);
+    glyph_window = 300;
+    glyph_step = 50;
+    Run(renderer, DrawWithTextures, SDL_FALSE, expected, &stats);
+    ms = Run(renderer, DrawWithAtlas, SDL_FALSE, actual, &stats);
+    SDL_Log("Evicting: drawn in   %9.3f ms, %u commands in the last frame, %d glyphs added again\n",
+            ms, stats.commands_executed, atlas_misses);
+    if (!Compare("The evicting atlas", expected, actual)) {
+        result = 1;
+    }
+
+done:
+    SDL_DestroyTextureAtlas(atlas);
+    for (i = 0; i < NUM_GLYPHS; ++i) {
+        if (textures[i]) {
+            SDL_DestroyTexture(textures[i]);
+        }
+    }
+    SDL_free(expected);
+    SDL_free(actual);
+    SDL_DestroyRenderer(renderer);
+    SDL_DestroyWindow(window);
+    SDL_Quit();
+    return result;
+}
+
+/* vi: set ts=4 sw=4 expandtab: */
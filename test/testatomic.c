@@ -40,6 +40,7 @@ void RunBasicTest()
     SDL_SpinLock lock = 0;
 
     SDL_atomic_t v;
+    SDL_atomic64_t v64;
     SDL_bool tfret = SDL_FALSE;
 
     SDL_Log("\nspin lock---------------------------------------\n\n");
@@ -75,6 +76,18 @@ void RunBasicTest()
     value = SDL_AtomicGet(&v);
     tfret = (SDL_AtomicCAS(&v, value, 20) == SDL_TRUE) ? SDL_TRUE : SDL_FALSE;
     SDL_Log("AtomicCAS()          tfret=%s val=%d\n", tf(tfret), SDL_AtomicGet(&v));
+
+    SDL_Log("\natomic 64-bit ----------------------------------\n\n");
+
+    SDL_AtomicSet64(&v64, 0);
+    tfret = SDL_AtomicSet64(&v64, SDL_MAX_SINT64 - 20) == 0 ? SDL_TRUE : SDL_FALSE;
+    SDL_Log("AtomicSet64(max-20)  tfret=%s val=%" SDL_PRIs64 "\n", tf(tfret), SDL_AtomicGet64(&v64));
+    tfret = SDL_AtomicAdd64(&v64, 10) == SDL_MAX_SINT64 - 20 ? SDL_TRUE : SDL_FALSE;
+    SDL_Log("AtomicAdd64(10)      tfret=%s val=%" SDL_PRIs64 "\n", tf(tfret), SDL_AtomicGet64(&v64));
+    tfret = (SDL_AtomicCAS64(&v64, 0, 20) == SDL_FALSE) ? SDL_TRUE : SDL_FALSE;
+    SDL_Log("AtomicCAS64()        tfret=%s val=%" SDL_PRIs64 "\n", tf(tfret), SDL_AtomicGet64(&v64));
+    tfret = (SDL_AtomicCAS64(&v64, SDL_MAX_SINT64 - 10, SDL_MIN_SINT64) == SDL_TRUE) ? SDL_TRUE : SDL_FALSE;
+    SDL_Log("AtomicCAS64()        tfret=%s val=%" SDL_PRIs64 "\n", tf(tfret), SDL_AtomicGet64(&v64));
 }
 
 /**************************************************************************/
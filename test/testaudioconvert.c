@@ -0,0 +1,173 @@
+/*
+  Copyright (C) 1997-2020 Sam Lantinga <slouken@libsdl.org>
+
+  This software is provided 'as-is', without any express or implied
+  warranty.  In no event will the authors be held liable for any damages
+  arising from the use of this software.
+
+  Permission is granted to anyone to use this software for any purpose,
+  including commercial applications, and to alter it and redistribute it
+  freely.
+*/
+
+/* Benchmark SDL_ConvertAudio() between every pair of sample formats.
+   By default this converts a minute of 8-channel 48KHz audio per pair. */
+
+#include <stdlib.h>
+
+#include "SDL.h"
+
+#define BENCH_FREQ 48000
+#define BENCH_CHANNELS 8
+
+static const struct
+{
+    SDL_AudioFormat format;
+    const char *name;
+} formats[] = {
+    { AUDIO_U8, "U8" },
+    { AUDIO_S8, "S8" },
+    { AUDIO_U16LSB, "U16LSB" },
+    { AUDIO_S16LSB, "S16LSB" },
+    { AUDIO_U16MSB, "U16MSB" },
+    { AUDIO_S16MSB, "S16MSB" },
+    { AUDIO_S32LSB, "S32LSB" },
+    { AUDIO_S32MSB, "S32MSB" },
+    { AUDIO_F32LSB, "F32LSB" },
+    { AUDIO_F32MSB, "F32MSB" }
+};
+
+/* Converts the float source data into (format), returning a new buffer of (*len) bytes. */
+static Uint8 *
+MakeSource(const float *data, const int samples, const SDL_AudioFormat format, int *len)
+{
+    SDL_AudioCVT cvt;
+    if (SDL_BuildAudioCVT(&cvt, AUDIO_F32SYS, BENCH_CHANNELS, BENCH_FREQ, format, BENCH_CHANNELS, BENCH_FREQ) < 0) {
+        SDL_Log("Couldn't build source converter: %s\n", SDL_GetError());
+        return NULL;
+    }
+    cvt.len = samples * sizeof (float);
+    cvt.buf = (Uint8 *) SDL_malloc(cvt.len * cvt.len_mult);
+    if (!cvt.buf) {
+        SDL_OutOfMemory();
+        return NULL;
+    }
+    SDL_memcpy(cvt.buf, data, cvt.len);
+    if (cvt.needed && (SDL_ConvertAudio(&cvt) < 0)) {
+        SDL_Log("Couldn't convert source data: %s\n", SDL_GetError());
+        SDL_free(cvt.buf);
+        return NULL;
+    }
+    *len = cvt.needed ? cvt.len_cvt : cvt.len;
+    return cvt.buf;
+}
+
+int
+main(int argc, char **argv)
+{
+    const Uint64 freq = SDL_GetPerformanceFrequency();
+    int seconds = 60;
+    int samples;
+    float *data;
+    Uint8 *work = NULL;
+    size_t worklen = 0;
+    double total_ms = 0.0;
+    int i, j;
+
+    /* Enable standard application logging */
+    SDL_LogSetPriority(SDL_LOG_CATEGORY_APPLICATION, SDL_LOG_PRIORITY_INFO);
+
+    if (argc > 1) {
+        seconds = SDL_atoi(argv[1]);
+        if (seconds <= 0) {
+            SDL_Log("USAGE: %s [seconds]\n", argv[0]);
+            return 1;
+        }
+    }
+
+    if (SDL_Init(0) < 0) {
+        SDL_Log("Couldn't initialize SDL: %s\n", SDL_GetError());
+        return 1;
+    }
+
+    samples = seconds * BENCH_FREQ * BENCH_CHANNELS;
+    data = (float *) SDL_malloc(samples * sizeof (float));
+    if (!data) {
+        SDL_Log("Out of memory!\n");
+        SDL_Quit();
+        return 1;
+    }
+
+    /* a different full-scale-ish waveform on each channel. */
+    for (i = 0; i < samples; i++) {
+        const int frame = i / BENCH_CHANNELS;
+        const int chan = i % BENCH_CHANNELS;
+        data[i] = (float) SDL_sin((double) frame * (chan + 1) * 440.0 * 2.0 * M_PI / BENCH_FREQ) * 0.9f;
+    }
+
+    SDL_Log("Converting %d seconds of %d-channel %dHz audio (%d samples) through every format pair.\n",
+            seconds, BENCH_CHANNELS, BENCH_FREQ, samples);
+    SDL_Log("CPU has SSE2=%d AVX2=%d NEON=%d\n", (int) SDL_HasSSE2(), (int) SDL_HasAVX2(), (int) SDL_HasNEON());
+
+    for (i = 0; i < SDL_arraysize(formats); i++) {
+        int srclen = 0;
+        Uint8 *src = MakeSource(data, samples, formats[i].format, &srclen);
+        if (!src) {
+            break;
+        }
+
+        for (j = 0; j < SDL_arraysize(formats); j++) {
+            SDL_AudioCVT cvt;
+            Uint64 start, end;
+            double ms;
+
+            if (i == j) {
+                continue;
+            }
+
+            if (SDL_BuildAudioCVT(&cvt, formats[i].format, BENCH_CHANNELS, BENCH_FREQ, formats[j].format, BENCH_CHANNELS, BENCH_FREQ) < 0) {
+                SDL_Log("%6s -> %-6s: couldn't build converter: %s\n", formats[i].name, formats[j].name, SDL_GetError());
+                continue;
+            }
+
+            cvt.len = srclen;
+            if (worklen < (size_t) (cvt.len * cvt.len_mult)) {
+                worklen = (size_t) (cvt.len * cvt.len_mult);
+                SDL_free(work);
+                work = (Uint8 *) SDL_malloc(worklen);
+                if (!work) {
+                    SDL_Log("Out of memory!\n");
+                    SDL_free(src);
+                    SDL_free(data);
+                    SDL_Quit();
+                    return 1;
+                }
+            }
+            cvt.buf = work;
+            SDL_memcpy(cvt.buf, src, srclen);
+
+            start = SDL_GetPerformanceCounter();
+            if (SDL_ConvertAudio(&cvt) < 0) {
+                SDL_Log("%6s -> %-6s: conversion failed: %s\n", formats[i].name, formats[j].name, SDL_GetError());
+                continue;
+            }
+            end = SDL_GetPerformanceCounter();
+
+            ms = (double) ((end - start) * 1000) / freq;
+            total_ms += ms;
+            SDL_Log("%6s -> %-6s: %9.3f ms, %8.1f Msamples/sec\n", formats[i].name, formats[j].name,
+                    ms, (ms > 0.0) ? ((samples / 1000000.0) / (ms / 1000.0)) : 0.0);
+        }
+
+        SDL_free(src);
+    }
+
+    SDL_Log("Total: %.3f ms\n", total_ms);
+
+    SDL_free(work);
+    SDL_free(data);
+    SDL_Quit();
+    return 0;
+}
+
+/* vi: set ts=4 sw=4 expandtab: */
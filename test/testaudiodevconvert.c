@@ -0,0 +1,286 @@
+/*
+  Copyright (C) 1997-2020 Sam Lantinga <slouken@libsdl.org>
+
+  This software is provided 'as-is', without any express or implied
+  warranty.  In no event will the authors be held liable for any damages
+  arising from the use of this software.
+
+  Permission is granted to anyone to use this software for any purpose,
+  including commercial applications, and to alter it and redistribute it
+  freely.
+*/
+
+/* Play audio through the disk driver, set up to want a different format
+   than the callback provides, so the audio thread converts every period.
+   This checks that what gets written matches SDL_ConvertAudio(), and times
+   how long the audio thread takes for each period. */
+
+#include <stdio.h>
+
+#include "SDL.h"
+
+#define TEST_FREQ 48000
+#define TEST_CHANNELS 8
+#define TEST_SAMPLES 1024
+#define SOURCE_PERIODS 16
+#define OUTPUT_FILE "testaudiodevconvert.raw"
+
+static const struct
+{
+    SDL_AudioFormat src;
+    SDL_AudioFormat dst;
+    const char *srcname;
+    const char *dstname;
+} tests[] = {
+    { AUDIO_F32SYS, AUDIO_S16SYS, "F32", "S16" },
+    { AUDIO_F32SYS, AUDIO_S32SYS, "F32", "S32" },
+    { AUDIO_S16SYS, AUDIO_F32SYS, "S16", "F32" }
+};
+
+static Uint8 *source;
+static int source_period_len;
+static int num_periods = 1000;
+static int periods_played;
+static Uint64 first_period, last_period;
+static SDL_atomic_t done;
+
+static void SDLCALL
+FillAudio(void *userdata, Uint8 *stream, int len)
+{
+    if (periods_played >= num_periods || len != source_period_len) {
+        SDL_memset(stream, 0, len);
+        SDL_AtomicSet(&done, 1);
+        return;
+    }
+
+    if (periods_played == 0) {
+        first_period = SDL_GetPerformanceCounter();
+    }
+    SDL_memcpy(stream, source + (periods_played % SOURCE_PERIODS) * len, len);
+    if (++periods_played == num_periods) {
+        last_period = SDL_GetPerformanceCounter();
+        SDL_AtomicSet(&done, 1);
+    }
+}
+
+/* Converts (len) bytes from one format to another, returning a new buffer of (*outlen) bytes. */
+static Uint8 *
+Convert(const void *src, const int len, const SDL_AudioFormat srcfmt, const SDL_AudioFormat dstfmt, int *outlen)
+{
+    SDL_AudioCVT cvt;
+    if (SDL_BuildAudioCVT(&cvt, srcfmt, TEST_CHANNELS, TEST_FREQ, dstfmt, TEST_CHANNELS, TEST_FREQ) < 0) {
+        SDL_Log("Couldn't build converter: %s\n", SDL_GetError());
+        return NULL;
+    }
+    cvt.len = len;
+    cvt.buf = (Uint8 *) SDL_malloc(cvt.len * cvt.len_mult);
+    if (!cvt.buf) {
+        SDL_Log("Out of memory!\n");
+        return NULL;
+    }
+    SDL_memcpy(cvt.buf, src, cvt.len);
+    if (cvt.needed && (SDL_ConvertAudio(&cvt) < 0)) {
+        SDL_Log("Couldn't convert audio: %s\n", SDL_GetError());
+        SDL_free(cvt.buf);
+        return NULL;
+    }
+    *outlen = cvt.needed ? cvt.len_cvt : cvt.len;
+    return cvt.buf;
+}
+
+/* Plays num_periods periods of the source and returns what the driver wrote */
+static Uint8 *
+Play(const int test, int *outlen)
+{
+    SDL_AudioSpec spec;
+    SDL_AudioDeviceID dev;
+    SDL_RWops *rw;
+    Uint8 *output;
+    Sint64 size;
+
+    SDL_setenv("SDL_DISKAUDIOFORMAT", tests[test].dstname, 1);
+    if (SDL_InitSubSystem(SDL_INIT_AUDIO) < 0) {
+        SDL_Log("Couldn't initialize the disk audio driver: %s\n", SDL_GetError());
+        return NULL;
+    }
+
+    SDL_zero(spec);
+    spec.freq = TEST_FREQ;
+    spec.format = tests[test].src;
+    spec.channels = TEST_CHANNELS;
+    spec.samples = TEST_SAMPLES;
+    spec.callback = FillAudio;
+
+    periods_played = 0;
+    SDL_AtomicSet(&done, 0);
+    dev = SDL_OpenAudioDevice(NULL, 0, &spec, NULL, 0);
+    if (!dev) {
+        SDL_Log("Couldn't open audio: %s\n", SDL_GetError());
+        SDL_QuitSubSystem(SDL_INIT_AUDIO);
+        return NULL;
+    }
+    SDL_PauseAudioDevice(dev, 0);
+    while (!SDL_AtomicGet(&done)) {
+        SDL_Delay(10);
+    }
+    SDL_CloseAudioDevice(dev);
+    SDL_QuitSubSystem(SDL_INIT_AUDIO);
+
+    if (periods_played != num_periods) {
+        SDL_Log("The callback was asked for the wrong amount of audio\n");
+        return NULL;
+    }
+
+    rw = SDL_RWFromFile(OUTPUT_FILE, "rb");
+    if (!rw) {
+        SDL_Log("Couldn't open %s: %s\n", OUTPUT_FILE, SDL_GetError());
+        return NULL;
+    }
+    size = SDL_RWsize(rw);
+    output = (size > 0) ? (Uint8 *) SDL_malloc((size_t) size) : NULL;
+    if (!output || SDL_RWread(rw, output, (size_t) size, 1) != 1) {
+        SDL_Log("Couldn't read %s\n", OUTPUT_FILE);
+        SDL_free(output);
+        SDL_RWclose(rw);
+        return NULL;
+    }
+    SDL_RWclose(rw);
+    *outlen = (int) size;
+    return output;
+}
+
+/* Runs one test, returning 0 if the output matched, or -1 */
+static int
+RunTest(const int test, const float *data, const int datalen)
+{
+    const Uint64 freq = SDL_GetPerformanceFrequency();
+    const int period_samples = TEST_SAMPLES * TEST_CHANNELS;
+    Uint8 *expected = NULL, *output = NULL;
+    float *expected_f = NULL, *output_f = NULL;
+    int srclen, expectedlen, expected_flen, outputlen, output_flen;
+    int expected_period_len, skip;
+    int i, retval = -1;
+
+    source = Convert(data, datalen, AUDIO_F32SYS, tests[test].src, &srclen);
+    if (!source) {
+        goto done;
+    }
+    source_period_len = srclen / SOURCE_PERIODS;
+
+    /* What the audio thread should write, in floats so rounding can be allowed for */
+    expected = Convert(source, srclen, tests[test].src, tests[test].dst, &expectedlen);
+    if (!expected) {
+        goto done;
+    }
+    expected_period_len = expectedlen / SOURCE_PERIODS;
+    expected_f = (float *) Convert(expected, expectedlen, tests[test].dst, AUDIO_F32SYS, &expected_flen);
+    if (!expected_f) {
+        goto done;
+    }
+
+    output = Play(test, &outputlen);
+    if (!output) {
+        goto done;
+    }
+
+    /* The device plays silence until it's unpaused, so skip that */
+    for (skip = 0; skip + expected_period_len <= outputlen; skip += expected_period_len) {
+        for (i = 0; i < expected_period_len; ++i) {
+            if (output[skip + i] != 0) {
+                break;
+            }
+        }
+        if (i < expected_period_len) {
+            break;
+        }
+    }
+    if (outputlen - skip < num_periods * expected_period_len) {
+        SDL_Log("%s -> %s: only %d of %d bytes were written\n", tests[test].srcname, tests[test].dstname,
+                outputlen - skip, num_periods * expected_period_len);
+        goto done;
+    }
+    output_f = (float *) Convert(output + skip, num_periods * expected_period_len, tests[test].dst, AUDIO_F32SYS, &output_flen);
+    if (!output_f) {
+        goto done;
+    }
+
+    for (i = 0; i < num_periods * period_samples; ++i) {
+        const float want = expected_f[(i / period_samples) % SOURCE_PERIODS * period_samples + i % period_samples];
+        if (SDL_fabs(output_f[i] - want) > (1.0f / 8192.0f)) {
+            SDL_Log("%s -> %s: sample %d is %f, expected %f\n", tests[test].srcname, tests[test].dstname,
+                    i, output_f[i], want);
+            goto done;
+        }
+    }
+
+    SDL_Log("%s -> %s: %d periods match, %.2f us per period\n", tests[test].srcname, tests[test].dstname,
+            num_periods, (double) ((last_period - first_period) * 1000000) / freq / (num_periods - 1));
+    retval = 0;
+
+done:
+    SDL_free(output_f);
+    SDL_free(output);
+    SDL_free(expected_f);
+    SDL_free(expected);
+    SDL_free(source);
+    source = NULL;
+    return retval;
+}
+
+int
+main(int argc, char **argv)
+{
+    const int samples = SOURCE_PERIODS * TEST_SAMPLES * TEST_CHANNELS;
+    float *data;
+    int i, result = 0;
+
+    /* Enable standard application logging */
+    SDL_LogSetPriority(SDL_LOG_CATEGORY_APPLICATION, SDL_LOG_PRIORITY_INFO);
+
+    if (argc > 1) {
+        num_periods = SDL_atoi(argv[1]);
+        if (num_periods <= 1) {
+            SDL_Log("USAGE: %s [periods]\n", argv[0]);
+            return 1;
+        }
+    }
+
+    if (SDL_Init(0) < 0) {
+        SDL_Log("Couldn't initialize SDL: %s\n", SDL_GetError());
+        return 1;
+    }
+
+    data = (float *) SDL_malloc(samples * sizeof (float));
+    if (!data) {
+        SDL_Log("Out of memory!\n");
+        SDL_Quit();
+        return 1;
+    }
+
+    /* a different waveform on each channel. */
+    for (i = 0; i < samples; i++) {
+        const int frame = i / TEST_CHANNELS;
+        const int chan = i % TEST_CHANNELS;
+        data[i] = (float) SDL_sin((double) frame * (chan + 1) * 440.0 * 2.0 * M_PI / TEST_FREQ) * 0.9f;
+    }
+
+    /* Write as fast as the audio thread can go */
+    SDL_setenv("SDL_AUDIODRIVER", "disk", 1);
+    SDL_setenv("SDL_DISKAUDIOFILE", OUTPUT_FILE, 1);
+    SDL_setenv("SDL_DISKAUDIODELAY", "0", 1);
+
+    SDL_Log("Playing %d periods of %d-channel %dHz audio, %d samples each.\n",
+            num_periods, TEST_CHANNELS, TEST_FREQ, TEST_SAMPLES);
+    for (i = 0; i < SDL_arraysize(tests); i++) {
+        if (RunTest(i, data, samples * sizeof (float)) < 0) {
+            result = 1;
+        }
+    }
+
+    remove(OUTPUT_FILE);
+    SDL_free(data);
+    SDL_Quit();
+    return result;
+}
+
+/* vi: set ts=4 sw=4 expandtab: */
@@ -145,6 +145,62 @@ hints_setHint(void *arg)
   return TEST_COMPLETED;
 }
 
+/* Counts calls to the hint callback */
+static int _hintCallbackCount = 0;
+
+static void SDLCALL
+_hintTestCallback(void *userdata, const char *name, const char *oldValue, const char *newValue)
+{
+  _hintCallbackCount++;
+}
+
+/**
+ * @brief Call to SDL_RefreshHintEnvironment
+ */
+int
+hints_refreshEnvironment(void *arg)
+{
+  const char *name = "SDL_TEST_HINT_REFRESH_ENVIRONMENT";
+  const char *testValue;
+  SDL_bool result;
+
+  SDL_setenv(name, "0", 1);
+  SDLTest_AssertPass("Call to SDL_setenv(%s, 0)", name);
+
+  result = SDL_GetHintBoolean(name, SDL_TRUE);
+  SDLTest_AssertPass("Call to SDL_GetHintBoolean(%s, SDL_TRUE)", name);
+  SDLTest_AssertCheck(result == SDL_FALSE, "Verify environment value was used, expected: %i, got: %i", SDL_FALSE, result);
+
+  /* The environment overrides normal priority hints */
+  result = SDL_SetHint(name, "1");
+  SDLTest_AssertPass("Call to SDL_SetHint(%s, 1)", name);
+  SDLTest_AssertCheck(result == SDL_FALSE, "Verify hint was not set, expected: %i, got: %i", SDL_FALSE, result);
+
+  _hintCallbackCount = 0;
+  SDL_AddHintCallback(name, _hintTestCallback, NULL);
+  SDLTest_AssertPass("Call to SDL_AddHintCallback()");
+  SDLTest_AssertCheck(_hintCallbackCount == 1, "Verify callback was called, expected: 1, got: %i", _hintCallbackCount);
+
+  SDL_setenv(name, "2", 1);
+  SDL_RefreshHintEnvironment();
+  SDLTest_AssertPass("Call to SDL_RefreshHintEnvironment()");
+  testValue = SDL_GetHint(name);
+  SDLTest_AssertCheck(testValue && SDL_strcmp(testValue, "2") == 0, "Verify new environment value, expected: 2, got: %s", testValue ? testValue : "null");
+  result = SDL_GetHintBoolean(name, SDL_FALSE);
+  SDLTest_AssertCheck(result == SDL_TRUE, "Verify boolean value, expected: %i, got: %i", SDL_TRUE, result);
+  SDLTest_AssertCheck(_hintCallbackCount == 2, "Verify callback was called, expected: 2, got: %i", _hintCallbackCount);
+
+  /* Refreshing an unchanged environment doesn't call the callback */
+  SDL_RefreshHintEnvironment();
+  SDLTest_AssertPass("Call to SDL_RefreshHintEnvironment()");
+  SDLTest_AssertCheck(_hintCallbackCount == 2, "Verify callback was not called, expected: 2, got: %i", _hintCallbackCount);
+
+  SDL_DelHintCallback(name, _hintTestCallback, NULL);
+  SDLTest_AssertPass("Call to SDL_DelHintCallback()");
+
+  return TEST_COMPLETED;
+}
+
 /* ================= Test References ================== */
 
 /* Hints test cases */
@@ -154,9 +210,12 @@ static const SDLTest_TestCaseReference hintsTest1 =
 static const SDLTest_TestCaseReference hintsTest2 =
         { (SDLTest_TestCaseFp)hints_setHint, "hints_setHint", "Call to SDL_SetHint", TEST_ENABLED };
 
+static const SDLTest_TestCaseReference hintsTest3 =
+        { (SDLTest_TestCaseFp)hints_refreshEnvironment, "hints_refreshEnvironment", "Call to SDL_RefreshHintEnvironment", TEST_ENABLED };
+
 /* Sequence of Hints test cases */
 static const SDLTest_TestCaseReference *hintsTests[] =  {
-    &hintsTest1, &hintsTest2, NULL
+    &hintsTest1, &hintsTest2, &hintsTest3, NULL
 };
 
 /* Hints test suite (global) */
@@ -766,6 +766,94 @@ render_testBlitBlend (void *arg)
 }
 
 
+/**
+ * @brief Tests the statistics collected for a frame.
+ *
+ * \sa
+ * http://wiki.libsdl.org/moin.cgi/SDL_RenderGetStats
+ */
+int
+render_testStats (void *arg)
+{
+   int ret;
+   SDL_Rect rect;
+   SDL_RenderStats stats;
+   SDL_Texture *texture;
+   Uint32 pixels[8 * 8];
+   Uint32 pixel;
+   Uint32 sum;
+   int i;
+
+   /* Invalid parameters. */
+   ret = SDL_RenderGetStats(NULL, &stats);
+   SDLTest_AssertCheck(ret == -1, "Validate result from SDL_RenderGetStats(NULL, &stats), expected: -1, got: %i", ret);
+   ret = SDL_RenderGetStats(renderer, NULL);
+   SDLTest_AssertCheck(ret == -1, "Validate result from SDL_RenderGetStats(renderer, NULL), expected: -1, got: %i", ret);
+
+   texture = SDL_CreateTexture(renderer, SDL_PIXELFORMAT_ARGB8888, SDL_TEXTUREACCESS_STATIC, 8, 8);
+   SDLTest_AssertCheck(texture != NULL, "Verify SDL_CreateTexture() result");
+   if (texture == NULL) {
+       return TEST_ABORTED;
+   }
+   SDL_memset(pixels, 0xFF, sizeof (pixels));
+
+   /* Start a new frame. */
+   SDL_RenderPresent(renderer);
+
+   SDL_SetRenderDrawColor(renderer, 0, 0, 0, SDL_ALPHA_OPAQUE);
+   SDL_RenderClear(renderer);
+   SDL_SetRenderDrawColor(renderer, 13, 73, 200, SDL_ALPHA_OPAQUE);
+   rect.x = 0;
+   rect.y = 0;
+   rect.w = 10;
+   rect.h = 10;
+   SDL_RenderFillRect(renderer, &rect);
+   rect.x = 20;
+   SDL_RenderFillRect(renderer, &rect);
+   SDL_RenderDrawLine(renderer, 0, 30, 40, 30);
+   ret = SDL_UpdateTexture(texture, NULL, pixels, 8 * sizeof (Uint32));
+   SDLTest_AssertCheck(ret == 0, "Validate result from SDL_UpdateTexture, expected: 0, got: %i", ret);
+   SDL_RenderCopy(renderer, texture, NULL, NULL);
+   rect.w = 1;
+   rect.h = 1;
+   SDL_RenderReadPixels(renderer, &rect, SDL_PIXELFORMAT_ARGB8888, &pixel, sizeof (pixel));
+   SDL_RenderPresent(renderer);
+
+   ret = SDL_RenderGetStats(renderer, &stats);
+   SDLTest_AssertCheck(ret == 0, "Validate result from SDL_RenderGetStats, expected: 0, got: %i", ret);
+   SDLTest_AssertCheck(stats.clears == 1, "Validate clears, expected: 1, got: %u", (unsigned int) stats.clears);
+   SDLTest_AssertCheck(stats.rect_fills == 2, "Validate rect_fills, expected: 2, got: %u", (unsigned int) stats.rect_fills);
+   SDLTest_AssertCheck(stats.line_draws == 1, "Validate line_draws, expected: 1, got: %u", (unsigned int) stats.line_draws);
+   SDLTest_AssertCheck(stats.copies == 1, "Validate copies, expected: 1, got: %u", (unsigned int) stats.copies);
+   SDLTest_AssertCheck(stats.commands_executed == stats.commands_queued,
+                       "Validate commands_executed, expected: %u, got: %u",
+                       (unsigned int) stats.commands_queued, (unsigned int) stats.commands_executed);
+   SDLTest_AssertCheck(stats.texture_uploads == 1, "Validate texture_uploads, expected: 1, got: %u", (unsigned int) stats.texture_uploads);
+   SDLTest_AssertCheck(stats.texture_upload_bytes == sizeof (pixels),
+                       "Validate texture_upload_bytes, expected: %u, got: %u",
+                       (unsigned int) sizeof (pixels), (unsigned int) stats.texture_upload_bytes);
+   SDLTest_AssertCheck(stats.flushes >= 1, "Validate flushes, expected: >= 1, got: %u", (unsigned int) stats.flushes);
+   sum = 0;
+   for (i = 0; i < SDL_NUM_RENDERFLUSH_CAUSES; ++i) {
+       sum += stats.flush_causes[i];
+   }
+   SDLTest_AssertCheck(sum == stats.flushes, "Validate flush causes add up to flushes, expected: %u, got: %u",
+                       (unsigned int) stats.flushes, (unsigned int) sum);
+
+   /* A frame with nothing drawn has nothing to report. */
+   SDL_RenderPresent(renderer);
+   ret = SDL_RenderGetStats(renderer, &stats);
+   SDLTest_AssertCheck(ret == 0, "Validate result from SDL_RenderGetStats, expected: 0, got: %i", ret);
+   SDLTest_AssertCheck(stats.commands_queued == 0 && stats.flushes == 0,
+                       "Validate an empty frame, expected: 0 commands and 0 flushes, got: %u and %u",
+                       (unsigned int) stats.commands_queued, (unsigned int) stats.flushes);
+
+   SDL_DestroyTexture(texture);
+
+   return TEST_COMPLETED;
+}
+
+
 /**
  * @brief Checks to see if functionality is supported. Helper function.
  */
@@ -1085,9 +1173,12 @@ static const SDLTest_TestCaseReference renderTest6 =
 static const SDLTest_TestCaseReference renderTest7 =
         {  (SDLTest_TestCaseFp)render_testBlitBlend, "render_testBlitBlend", "Tests blitting with blending", TEST_DISABLED };
 
+static const SDLTest_TestCaseReference renderTest8 =
+        { (SDLTest_TestCaseFp)render_testStats, "render_testStats", "Tests the statistics collected for a frame", TEST_ENABLED };
+
 /* Sequence of Render test cases */
 static const SDLTest_TestCaseReference *renderTests[] =  {
-    &renderTest1, &renderTest2, &renderTest3, &renderTest4, &renderTest5, &renderTest6, &renderTest7, NULL
+    &renderTest1, &renderTest2, &renderTest3, &renderTest4, &renderTest5, &renderTest6, &renderTest7, &renderTest8, NULL
 };
 
 /* Render test suite (global) */
@@ -103,6 +103,48 @@ timer_delayAndGetTicks(void *arg)
   return TEST_COMPLETED;
 }
 
+/**
+ * @brief Call to SDL_DelayNS, SDL_DelayPrecise and SDL_DelayUntil
+ */
+int
+timer_delayPrecise(void *arg)
+{
+  const Uint64 freq = SDL_GetPerformanceFrequency();
+  const Uint64 testDelay = 5000000; /* 5 ms in nanoseconds */
+  const Uint64 testPeriod = (testDelay * freq) / 1000000000;
+  Uint64 start, end, deadline;
+
+  /* Zero delays return right away */
+  SDL_DelayNS(0);
+  SDLTest_AssertPass("Call to SDL_DelayNS(0)");
+  SDL_DelayPrecise(0);
+  SDLTest_AssertPass("Call to SDL_DelayPrecise(0)");
+
+  start = SDL_GetPerformanceCounter();
+  SDL_DelayNS(testDelay);
+  end = SDL_GetPerformanceCounter();
+  SDLTest_AssertPass("Call to SDL_DelayNS(%d)", (int) testDelay);
+  SDLTest_AssertCheck(end - start >= testPeriod, "Check delay, expected: >=%d, got: %d", (int) testPeriod, (int) (end - start));
+
+  start = SDL_GetPerformanceCounter();
+  SDL_DelayPrecise(testDelay);
+  end = SDL_GetPerformanceCounter();
+  SDLTest_AssertPass("Call to SDL_DelayPrecise(%d)", (int) testDelay);
+  SDLTest_AssertCheck(end - start >= testPeriod, "Check delay, expected: >=%d, got: %d", (int) testPeriod, (int) (end - start));
+
+  deadline = SDL_GetPerformanceCounter() + testPeriod;
+  SDL_DelayUntil(deadline);
+  end = SDL_GetPerformanceCounter();
+  SDLTest_AssertPass("Call to SDL_DelayUntil()");
+  SDLTest_AssertCheck(end >= deadline, "Check deadline reached, expected: >=%d, got: %d", (int) deadline, (int) end);
+
+  /* A deadline in the past returns right away */
+  SDL_DelayUntil(0);
+  SDLTest_AssertPass("Call to SDL_DelayUntil(0)");
+
+  return TEST_COMPLETED;
+}
+
 /* Test callback */
 Uint32 SDLCALL _timerTestCallback(Uint32 interval, void *param)
 {
@@ -172,6 +214,55 @@ timer_addRemoveTimer(void *arg)
   return TEST_COMPLETED;
 }
 
+/**
+ * @brief Call to SDL_AddTimerMicroseconds and SDL_RemoveTimer
+ */
+int
+timer_addRemoveTimerMicroseconds(void *arg)
+{
+  SDL_TimerID id;
+  SDL_bool result;
+  int param;
+
+  /* Reset state */
+  _paramCheck = 0;
+  _timerCallbackCalled = 0;
+
+  /* Set timer with a long delay */
+  id = SDL_AddTimerMicroseconds(10000000, _timerTestCallback, NULL);
+  SDLTest_AssertPass("Call to SDL_AddTimerMicroseconds(10000000,...)");
+  SDLTest_AssertCheck(id > 0, "Check result value, expected: >0, got: %d", id);
+
+  /* Remove timer again and check that callback was not called */
+  result = SDL_RemoveTimer(id);
+  SDLTest_AssertPass("Call to SDL_RemoveTimer()");
+  SDLTest_AssertCheck(result == SDL_TRUE, "Check result value, expected: %i, got: %i", SDL_TRUE, result);
+  SDLTest_AssertCheck(_timerCallbackCalled == 0, "Check callback WAS NOT called, expected: 0, got: %i", _timerCallbackCalled);
+
+  /* Reset state */
+  param = SDLTest_RandomIntegerInRange(-1024, 1024);
+  _paramCheck = 1;
+  _paramValue = param;
+  _timerCallbackCalled = 0;
+
+  /* Set timer with a short delay */
+  id = SDL_AddTimerMicroseconds(500, _timerTestCallback, (void *)&param);
+  SDLTest_AssertPass("Call to SDL_AddTimerMicroseconds(500, param)");
+  SDLTest_AssertCheck(id > 0, "Check result value, expected: >0, got: %d", id);
+
+  /* Wait to let timer trigger callback */
+  SDL_Delay(100);
+  SDLTest_AssertPass("Call to SDL_Delay(100)");
+
+  /* Remove timer again and check that callback was called */
+  result = SDL_RemoveTimer(id);
+  SDLTest_AssertPass("Call to SDL_RemoveTimer()");
+  SDLTest_AssertCheck(result == SDL_FALSE, "Check result value, expected: %i, got: %i", SDL_FALSE, result);
+  SDLTest_AssertCheck(_timerCallbackCalled == 1, "Check callback WAS called, expected: 1, got: %i", _timerCallbackCalled);
+
+  return TEST_COMPLETED;
+}
+
 /* ================= Test References ================== */
 
 /* Timer test cases */
@@ -187,9 +278,15 @@ static const SDLTest_TestCaseReference timerTest3 =
 static const SDLTest_TestCaseReference timerTest4 =
         { (SDLTest_TestCaseFp)timer_addRemoveTimer, "timer_addRemoveTimer", "Call to SDL_AddTimer and SDL_RemoveTimer", TEST_ENABLED };
 
+static const SDLTest_TestCaseReference timerTest5 =
+        { (SDLTest_TestCaseFp)timer_addRemoveTimerMicroseconds, "timer_addRemoveTimerMicroseconds", "Call to SDL_AddTimerMicroseconds and SDL_RemoveTimer", TEST_ENABLED };
+
+static const SDLTest_TestCaseReference timerTest6 =
+        { (SDLTest_TestCaseFp)timer_delayPrecise, "timer_delayPrecise", "Call to SDL_DelayNS, SDL_DelayPrecise and SDL_DelayUntil", TEST_ENABLED };
+
 /* Sequence of Timer test cases */
 static const SDLTest_TestCaseReference *timerTests[] =  {
-    &timerTest1, &timerTest2, &timerTest3, &timerTest4, NULL
+    &timerTest1, &timerTest2, &timerTest3, &timerTest4, &timerTest5, &timerTest6, NULL
 };
 
 /* Timer test suite (global) */
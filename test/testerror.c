@@ -41,6 +41,36 @@ ThreadFunc(void *data)
     return (0);
 }
 
+/* Measure how many thread-local lookups and error updates we can make */
+#define BENCHMARK_CALLS 10000000
+
+static void
+Benchmark(void)
+{
+    SDL_TLSID id = SDL_TLSCreate();
+    Uint64 start;
+    double seconds;
+    int i;
+
+    SDL_TLSSet(id, &alive, NULL);
+    start = SDL_GetPerformanceCounter();
+    for (i = 0; i < BENCHMARK_CALLS; ++i) {
+        if (SDL_TLSGet(id) != &alive) {
+            SDL_Log("SDL_TLSGet() returned the wrong value!\n");
+            break;
+        }
+    }
+    seconds = (double) (SDL_GetPerformanceCounter() - start) / SDL_GetPerformanceFrequency();
+    SDL_Log("SDL_TLSGet():  %.1f million calls per second\n", BENCHMARK_CALLS / seconds / 1000000.0);
+
+    start = SDL_GetPerformanceCounter();
+    for (i = 0; i < BENCHMARK_CALLS / 10; ++i) {
+        SDL_SetError("Error %d", i);
+    }
+    seconds = (double) (SDL_GetPerformanceCounter() - start) / SDL_GetPerformanceFrequency();
+    SDL_Log("SDL_SetError(): %.1f million calls per second\n", BENCHMARK_CALLS / 10 / seconds / 1000000.0);
+}
+
 int
 main(int argc, char *argv[])
 {
@@ -71,6 +101,8 @@ main(int argc, char *argv[])
 
     SDL_Log("Main thread error string: %s\n", SDL_GetError());
 
+    Benchmark();
+
     SDL_Quit();
     return (0);
 }
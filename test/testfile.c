@@ -40,6 +40,9 @@
 #define NULL ((void *)0)
 #endif
 
+#define BENCHMARK_SIZE      (64 * 1024 * 1024)
+#define BENCHMARK_CHUNK     (64 * 1024)
+
 static void
 cleanup(void)
 {
@@ -60,6 +63,158 @@ rwops_error_quit(unsigned line, SDL_RWops * rwops)
 
 #define RWOP_ERR_QUIT(x)    rwops_error_quit( __LINE__, (x) )
 
+/* A stream that hides its size, like a pipe or a decompressor would */
+static Sint64 SDLCALL
+unsized_size(SDL_RWops * context)
+{
+    return -1;
+}
+
+static Sint64 SDLCALL
+unsized_seek(SDL_RWops * context, Sint64 offset, int whence)
+{
+    return SDL_RWseek((SDL_RWops *) context->hidden.unknown.data1, offset, whence);
+}
+
+static size_t SDLCALL
+unsized_read(SDL_RWops * context, void *ptr, size_t size, size_t maxnum)
+{
+    /* Hand out data in small pieces, the way a pipe does */
+    if (size * maxnum > 4096) {
+        maxnum = SDL_max(4096 / size, 1);
+    }
+    return SDL_RWread((SDL_RWops *) context->hidden.unknown.data1, ptr, size, maxnum);
+}
+
+static size_t SDLCALL
+unsized_write(SDL_RWops * context, const void *ptr, size_t size, size_t num)
+{
+    return 0;
+}
+
+static int SDLCALL
+unsized_close(SDL_RWops * context)
+{
+    int status = SDL_RWclose((SDL_RWops *) context->hidden.unknown.data1);
+    SDL_FreeRW(context);
+    return status;
+}
+
+static SDL_RWops *
+unsized_open(SDL_RWops * src)
+{
+    SDL_RWops *rwops = SDL_AllocRW();
+    if (rwops) {
+        rwops->size = unsized_size;
+        rwops->seek = unsized_seek;
+        rwops->read = unsized_read;
+        rwops->write = unsized_write;
+        rwops->close = unsized_close;
+        rwops->hidden.unknown.data1 = src;
+    }
+    return rwops;
+}
+
+/* Load a whole stream, check it against what we expect, and time it */
+static void
+load_file(const char *name, SDL_RWops * src, const Uint8 * expected, size_t expected_size)
+{
+    Uint64 start = SDL_GetPerformanceCounter();
+    size_t size = 0;
+    Uint8 *data;
+    double ms;
+
+    data = (Uint8 *) SDL_LoadFile_RW(src, &size, 1);
+    ms = (double) ((SDL_GetPerformanceCounter() - start) * 1000) / SDL_GetPerformanceFrequency();
+    if (!data || size != expected_size || SDL_memcmp(data, expected, size) != 0 || data[size] != '\0') {
+        SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "SDL_LoadFile_RW() from %s failed\n", name);
+        cleanup();
+        exit(1);
+    }
+    SDL_free(data);
+    SDL_Log("  %-20s %9.3f ms\n", name, ms);
+}
+
+/* A stream with no buffering of its own, counting how often it's called */
+static int unbuffered_calls;
+
+static Sint64 SDLCALL
+unbuffered_size(SDL_RWops * context)
+{
+    ++unbuffered_calls;
+    return SDL_RWsize((SDL_RWops *) context->hidden.unknown.data1);
+}
+
+static Sint64 SDLCALL
+unbuffered_seek(SDL_RWops * context, Sint64 offset, int whence)
+{
+    ++unbuffered_calls;
+    return SDL_RWseek((SDL_RWops *) context->hidden.unknown.data1, offset, whence);
+}
+
+static size_t SDLCALL
+unbuffered_read(SDL_RWops * context, void *ptr, size_t size, size_t maxnum)
+{
+    ++unbuffered_calls;
+    return SDL_RWread((SDL_RWops *) context->hidden.unknown.data1, ptr, size, maxnum);
+}
+
+static size_t SDLCALL
+unbuffered_write(SDL_RWops * context, const void *ptr, size_t size, size_t num)
+{
+    ++unbuffered_calls;
+    return SDL_RWwrite((SDL_RWops *) context->hidden.unknown.data1, ptr, size, num);
+}
+
+static SDL_RWops *
+unbuffered_open(SDL_RWops * src)
+{
+    SDL_RWops *rwops = SDL_AllocRW();
+    if (rwops) {
+        rwops->size = unbuffered_size;
+        rwops->seek = unbuffered_seek;
+        rwops->read = unbuffered_read;
+        rwops->write = unbuffered_write;
+        rwops->close = unsized_close;
+        rwops->hidden.unknown.data1 = src;
+    }
+    return rwops;
+}
+
+/* Read a stream of 32-bit values, the way file format parsers do */
+static Uint32
+parse_values(SDL_RWops * rwops, int count, double *ms)
+{
+    Uint64 start = SDL_GetPerformanceCounter();
+    Uint32 sum = 0;
+    int i;
+
+    for (i = 0; i < count; ++i) {
+        sum += SDL_ReadLE32(rwops);
+        sum += SDL_ReadBE16(rwops);
+        sum += SDL_ReadU8(rwops);
+    }
+    *ms = (double) ((SDL_GetPerformanceCounter() - start) * 1000) / SDL_GetPerformanceFrequency();
+    return sum;
+}
+
+/* Read a whole file in chunks and return a checksum of it */
+static Uint32
+read_file(SDL_RWops * rwops, Uint8 * buf, double *ms)
+{
+    Uint64 start = SDL_GetPerformanceCounter();
+    Uint32 sum = 0;
+    size_t i, amount;
+
+    while ((amount = SDL_RWread(rwops, buf, 1, BENCHMARK_CHUNK)) > 0) {
+        for (i = 0; i < amount; i += 64) {
+            sum += buf[i];
+        }
+    }
+    *ms = (double) ((SDL_GetPerformanceCounter() - start) * 1000) / SDL_GetPerformanceFrequency();
+    return sum;
+}
+
 
 
 int
@@ -278,6 +433,224 @@ main(int argc, char *argv[])
         RWOP_ERR_QUIT(rwops);
     rwops->close(rwops);
     SDL_Log("test5 OK\n");
+
+/* test6 : memory-mapped read-only file */
+    rwops = SDL_RWFromFileMapped(NULL);
+    if (rwops)
+        RWOP_ERR_QUIT(rwops);
+    rwops = SDL_RWFromFileMapped(FBASENAME2);
+    if (rwops)
+        RWOP_ERR_QUIT(rwops);
+    rwops = SDL_RWFromFileMapped(FBASENAME1);
+    if (!rwops)
+        RWOP_ERR_QUIT(rwops);
+    if (54 != SDL_RWsize(rwops))
+        RWOP_ERR_QUIT(rwops);
+    if (0 != rwops->write(rwops, "1234567890", 1, 10))
+        RWOP_ERR_QUIT(rwops);
+    if (3 != rwops->read(rwops, test_buf, 10, 3))
+        RWOP_ERR_QUIT(rwops);
+    if (SDL_memcmp(test_buf, "123456789012345678901234567123", 30))
+        RWOP_ERR_QUIT(rwops);
+    if (47 != rwops->seek(rwops, -7, RW_SEEK_END))
+        RWOP_ERR_QUIT(rwops);
+    if (7 != rwops->read(rwops, test_buf, 1, 10))
+        RWOP_ERR_QUIT(rwops);
+    if (SDL_memcmp(test_buf, "1234567", 7))
+        RWOP_ERR_QUIT(rwops);
+    if (rwops->type == SDL_RWOPS_MAPPED) {
+        size_t size = 0;
+        const char *data = (const char *) SDL_RWGetMemory(rwops, &size);
+        if (!data || size != 54 || SDL_memcmp(data + 27, "1234567890", 10))
+            RWOP_ERR_QUIT(rwops);
+    }
+    rwops->close(rwops);
+    SDL_Log("test6 OK\n");
+
+/* test7 : benchmark reading a large file through stdio and a mapping */
+    {
+        Uint8 *buf = (Uint8 *) SDL_malloc(BENCHMARK_CHUNK);
+        Uint32 stdio_sum, mapped_sum;
+        double stdio_ms, mapped_ms, zerocopy_ms;
+        int i;
+
+        if (!buf)
+            RWOP_ERR_QUIT(NULL);
+        for (i = 0; i < BENCHMARK_CHUNK; ++i) {
+            buf[i] = (Uint8) (i * 7);
+        }
+        rwops = SDL_RWFromFile(FBASENAME1, "wb");
+        if (!rwops)
+            RWOP_ERR_QUIT(rwops);
+        for (i = 0; i < BENCHMARK_SIZE / BENCHMARK_CHUNK; ++i) {
+            if (1 != rwops->write(rwops, buf, BENCHMARK_CHUNK, 1))
+                RWOP_ERR_QUIT(rwops);
+        }
+        rwops->close(rwops);
+
+        rwops = SDL_RWFromFile(FBASENAME1, "rb");
+        if (!rwops)
+            RWOP_ERR_QUIT(rwops);
+        stdio_sum = read_file(rwops, buf, &stdio_ms);
+        rwops->close(rwops);
+
+        rwops = SDL_RWFromFileMapped(FBASENAME1);
+        if (!rwops)
+            RWOP_ERR_QUIT(rwops);
+        mapped_sum = read_file(rwops, buf, &mapped_ms);
+        if (stdio_sum != mapped_sum)
+            RWOP_ERR_QUIT(rwops);
+
+        /* Consumers that can use the data in place don't need to copy it at all */
+        zerocopy_ms = 0.0;
+        if (rwops->type == SDL_RWOPS_MAPPED) {
+            Uint64 start = SDL_GetPerformanceCounter();
+            size_t size, j;
+            const Uint8 *data = (const Uint8 *) SDL_RWGetMemory(rwops, &size);
+            mapped_sum = 0;
+            for (j = 0; j < size; j += 64) {
+                mapped_sum += data[j];
+            }
+            zerocopy_ms = (double) ((SDL_GetPerformanceCounter() - start) * 1000) / SDL_GetPerformanceFrequency();
+            if (stdio_sum != mapped_sum)
+                RWOP_ERR_QUIT(rwops);
+        }
+        rwops->close(rwops);
+        SDL_free(buf);
+
+        SDL_Log("test7 OK: read %d MB, stdio %.3f ms, mapped %.3f ms, mapped in place %.3f ms\n",
+                BENCHMARK_SIZE / (1024 * 1024), stdio_ms, mapped_ms, zerocopy_ms);
+    }
+
+/* test8 : loading whole files from sized and unsized streams */
+    {
+        size_t size = 0;
+        Uint8 *expected = (Uint8 *) SDL_LoadFile(FBASENAME1, &size);
+        if (!expected || size != BENCHMARK_SIZE)
+            RWOP_ERR_QUIT(NULL);
+
+        SDL_Log("test8: loading %d MB with SDL_LoadFile_RW()\n", BENCHMARK_SIZE / (1024 * 1024));
+        load_file("stdio file", SDL_RWFromFile(FBASENAME1, "rb"), expected, size);
+        load_file("mapped file", SDL_RWFromFileMapped(FBASENAME1), expected, size);
+        load_file("memory", SDL_RWFromConstMem(expected, (int) size), expected, size);
+        load_file("unsized stdio file", unsized_open(SDL_RWFromFile(FBASENAME1, "rb")), expected, size);
+        load_file("unsized memory", unsized_open(SDL_RWFromConstMem(expected, (int) size)), expected, size);
+
+        /* Loading continues from the current position */
+        rwops = SDL_RWFromConstMem(expected, (int) size);
+        if (!rwops)
+            RWOP_ERR_QUIT(rwops);
+        SDL_RWseek(rwops, 1000, RW_SEEK_SET);
+        load_file("memory, offset", rwops, expected + 1000, size - 1000);
+        rwops = SDL_RWFromFile(FBASENAME1, "rb");
+        if (!rwops)
+            RWOP_ERR_QUIT(rwops);
+        SDL_RWseek(rwops, 1000, RW_SEEK_SET);
+        load_file("stdio file, offset", rwops, expected + 1000, size - 1000);
+
+        SDL_free(expected);
+        SDL_Log("test8 OK\n");
+    }
+
+/* test9 : buffered streams behave like the stream they wrap */
+    {
+        Uint8 *plain_mem = (Uint8 *) SDL_calloc(1, 4096);
+        Uint8 *buffered_mem = (Uint8 *) SDL_calloc(1, 4096);
+        Uint8 plain_buf[64], buffered_buf[64];
+        SDL_RWops *plain, *buffered;
+        Uint32 seed = 12345;
+        int i;
+
+        if (!plain_mem || !buffered_mem)
+            RWOP_ERR_QUIT(NULL);
+        plain = SDL_RWFromMem(plain_mem, 4096);
+        buffered = SDL_RWFromRWBuffered(SDL_RWFromMem(buffered_mem, 4096), 16, SDL_TRUE);
+        if (!plain || !buffered)
+            RWOP_ERR_QUIT(buffered);
+
+        /* Random reads, writes, and seeks, small and larger than the buffer */
+        for (i = 0; i < 100000; ++i) {
+            size_t amount, j;
+            Sint64 offset;
+
+            seed = seed * 1103515245 + 12345;
+            amount = 1 + (seed >> 8) % 40;
+            if (SDL_RWtell(plain) + 64 > 4096) {
+                SDL_RWseek(plain, 0, RW_SEEK_SET);
+                SDL_RWseek(buffered, 0, RW_SEEK_SET);
+            }
+            switch ((seed >> 20) % 5) {
+            case 0:
+            case 1:
+                if (SDL_RWread(plain, plain_buf, 1, amount) != SDL_RWread(buffered, buffered_buf, 1, amount) ||
+                    SDL_memcmp(plain_buf, buffered_buf, amount) != 0)
+                    RWOP_ERR_QUIT(buffered);
+                break;
+            case 2:
+            case 3:
+                for (j = 0; j < amount; ++j) {
+                    plain_buf[j] = (Uint8) (seed + j);
+                }
+                if (SDL_RWwrite(plain, plain_buf, 1, amount) != SDL_RWwrite(buffered, plain_buf, 1, amount))
+                    RWOP_ERR_QUIT(buffered);
+                break;
+            default:
+                /* Stay where writes fit, since buffered writes fail later than direct ones */
+                offset = (Sint64) ((seed >> 4) % (4096 - 64)) - SDL_RWtell(plain);
+                if (SDL_RWseek(plain, offset, RW_SEEK_CUR) != SDL_RWseek(buffered, offset, RW_SEEK_CUR))
+                    RWOP_ERR_QUIT(buffered);
+                break;
+            }
+            if (SDL_ReadU8(plain) != SDL_ReadU8(buffered) || SDL_RWtell(plain) != SDL_RWtell(buffered))
+                RWOP_ERR_QUIT(buffered);
+            SDL_WriteLE16(plain, (Uint16) i);
+            SDL_WriteLE16(buffered, (Uint16) i);
+        }
+        if (SDL_RWsize(buffered) != 4096)
+            RWOP_ERR_QUIT(buffered);
+        if (SDL_RWclose(buffered) < 0)
+            RWOP_ERR_QUIT(NULL);
+        SDL_RWclose(plain);
+        if (SDL_memcmp(plain_mem, buffered_mem, 4096) != 0)
+            RWOP_ERR_QUIT(NULL);
+        SDL_free(plain_mem);
+        SDL_free(buffered_mem);
+        SDL_Log("test9 OK\n");
+    }
+
+/* test10 : benchmark parsing values from an unbuffered stream */
+    {
+        const int count = 1000000;
+        Uint8 *mem = (Uint8 *) SDL_malloc(count * 7);
+        Uint32 unbuffered_sum, buffered_sum;
+        double unbuffered_ms, buffered_ms;
+        int unbuffered_count;
+        int i;
+
+        if (!mem)
+            RWOP_ERR_QUIT(NULL);
+        for (i = 0; i < count * 7; ++i) {
+            mem[i] = (Uint8) (i * 13);
+        }
+
+        unbuffered_calls = 0;
+        rwops = unbuffered_open(SDL_RWFromConstMem(mem, count * 7));
+        unbuffered_sum = parse_values(rwops, count, &unbuffered_ms);
+        SDL_RWclose(rwops);
+        unbuffered_count = unbuffered_calls;
+
+        unbuffered_calls = 0;
+        rwops = SDL_RWFromRWBuffered(unbuffered_open(SDL_RWFromConstMem(mem, count * 7)), 0, SDL_TRUE);
+        buffered_sum = parse_values(rwops, count, &buffered_ms);
+        SDL_RWclose(rwops);
+        SDL_free(mem);
+
+        if (unbuffered_sum != buffered_sum)
+            RWOP_ERR_QUIT(NULL);
+        SDL_Log("test10 OK: parsed %d records, unbuffered %.3f ms (%d calls), buffered %.3f ms (%d calls)\n",
+                count, unbuffered_ms, unbuffered_count, buffered_ms, unbuffered_calls);
+    }
+
     cleanup();
     return 0;                   /* all ok */
 }
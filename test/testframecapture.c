@@ -0,0 +1,314 @@
+/*
+  Copyright (C) 1997-2020 Sam Lantinga <slouken@libsdl.org>
+
+  This software is provided 'as-is', without any express or implied
+  warranty.  In no event will the authors be held liable for any damages
+  arising from the use of this software.
+
+  Permission is granted to anyone to use this software for any purpose,
+  including commercial applications, and to alter it and redistribute it
+  freely.
+*/
+
+/* Check the frames captured by the dummy video driver, and benchmark how long
+   presenting a frame takes with each of the capture formats. */
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "SDL.h"
+
+#define WINDOW_WIDTH 640
+#define WINDOW_HEIGHT 480
+#define BOX_SIZE 64
+#define NUM_FRAMES 100
+#define NUM_VERIFY_FRAMES 8
+
+typedef enum
+{
+    CAPTURE_NONE,
+    CAPTURE_BMP,
+    CAPTURE_RAW,
+    CAPTURE_I420,
+    CAPTURE_Y4M,
+    NUM_MODES
+} Mode;
+
+static const char *mode_names[NUM_MODES] = {
+    "none", "bmp", "raw", "i420", "y4m"
+};
+
+static const char *output = "testframecapture.out";
+static int num_frames = NUM_FRAMES;
+
+static void
+SetCaptureMode(Mode mode, int num_buffers)
+{
+    char buffers[32];
+
+    SDL_snprintf(buffers, sizeof(buffers), "%d", num_buffers);
+    SDL_setenv("SDL_VIDEO_DUMMY_SAVE_FRAMES", mode == CAPTURE_BMP ? "1" : "", 1);
+    SDL_setenv("SDL_VIDEO_DUMMY_CAPTURE", mode > CAPTURE_BMP ? output : "", 1);
+    SDL_setenv("SDL_VIDEO_DUMMY_CAPTURE_FORMAT", mode_names[mode], 1);
+    SDL_setenv("SDL_VIDEO_DUMMY_CAPTURE_BUFFERS", buffers, 1);
+}
+
+/* Move a box across a background, updating only the area that changed.
+   Every few frames the update also lists the whole window twice and an
+   empty rect with a large negative width, which add up to less than the
+   window unless they're clipped first. */
+static void
+DrawFrame(SDL_Window *window, SDL_Surface *surface, int frame)
+{
+    SDL_Rect rects[5];
+    int numrects = 0;
+
+    if (frame == 0) {
+        SDL_FillRect(surface, NULL, SDL_MapRGB(surface->format, 0x20, 0x40, 0x60));
+    } else {
+        rects[0].x = ((frame - 1) * 7) % (WINDOW_WIDTH - BOX_SIZE);
+        rects[0].y = ((frame - 1) * 5) % (WINDOW_HEIGHT - BOX_SIZE);
+        rects[0].w = rects[0].h = BOX_SIZE;
+        SDL_FillRect(surface, &rects[0], SDL_MapRGB(surface->format, 0x20, 0x40, 0x60));
+        ++numrects;
+    }
+    rects[numrects].x = (frame * 7) % (WINDOW_WIDTH - BOX_SIZE);
+    rects[numrects].y = (frame * 5) % (WINDOW_HEIGHT - BOX_SIZE);
+    rects[numrects].w = rects[numrects].h = BOX_SIZE;
+    SDL_FillRect(surface, &rects[numrects], SDL_MapRGB(surface->format, frame & 0xFF, 0xFF, 0x80));
+    ++numrects;
+
+    if (frame % 4 == 3) {
+        rects[numrects].x = rects[numrects].y = 0;
+        rects[numrects].w = WINDOW_WIDTH;
+        rects[numrects].h = WINDOW_HEIGHT;
+        ++numrects;
+        rects[numrects] = rects[numrects - 1];
+        ++numrects;
+        rects[numrects].x = rects[numrects].y = 0;
+        rects[numrects].w = -WINDOW_WIDTH * WINDOW_HEIGHT * 2;
+        rects[numrects].h = 1;
+        ++numrects;
+    }
+
+    if (frame == 0) {
+        SDL_UpdateWindowSurface(window);
+    } else {
+        SDL_UpdateWindowSurfaceRects(window, rects, numrects);
+    }
+}
+
+/* Present some frames, keeping a copy of each one in the format it should be captured in */
+static int
+Run(Mode mode, int frames, int num_buffers, Uint8 **expected, size_t *frame_size, double *present_ms, double *total_ms)
+{
+    SDL_Window *window;
+    SDL_Surface *surface;
+    Uint64 start, present_time = 0;
+    int frame;
+
+    SetCaptureMode(mode, num_buffers);
+    if (SDL_VideoInit("dummy") < 0) {
+        SDL_Log("Couldn't initialize the dummy video driver: %s\n", SDL_GetError());
+        return -1;
+    }
+
+    start = SDL_GetPerformanceCounter();
+    window = SDL_CreateWindow("testframecapture", 0, 0, WINDOW_WIDTH, WINDOW_HEIGHT, 0);
+    surface = window ? SDL_GetWindowSurface(window) : NULL;
+    if (!surface) {
+        SDL_Log("Couldn't create window surface: %s\n", SDL_GetError());
+        SDL_VideoQuit();
+        return -1;
+    }
+
+    if (mode == CAPTURE_I420 || mode == CAPTURE_Y4M) {
+        *frame_size = WINDOW_WIDTH * WINDOW_HEIGHT * 3 / 2;
+    } else {
+        *frame_size = WINDOW_WIDTH * WINDOW_HEIGHT * 4;
+    }
+
+    for (frame = 0; frame < frames; ++frame) {
+        const Uint64 present_start = SDL_GetPerformanceCounter();
+        DrawFrame(window, surface, frame);
+        present_time += SDL_GetPerformanceCounter() - present_start;
+
+        if (expected) {
+            Uint8 *dst = expected[frame];
+            if (mode == CAPTURE_I420 || mode == CAPTURE_Y4M) {
+                SDL_ConvertPixels(surface->w, surface->h, surface->format->format, surface->pixels, surface->pitch,
+                                  SDL_PIXELFORMAT_IYUV, dst, surface->w);
+            } else {
+                int y;
+                for (y = 0; y < surface->h; ++y) {
+                    SDL_memcpy(dst + y * surface->w * 4, (Uint8 *) surface->pixels + y * surface->pitch, surface->w * 4);
+                }
+            }
+        }
+    }
+
+    /* Destroying the window waits for the captured frames to be written */
+    SDL_DestroyWindow(window);
+    SDL_VideoQuit();
+
+    *present_ms = (double) (present_time * 1000) / SDL_GetPerformanceFrequency();
+    *total_ms = (double) ((SDL_GetPerformanceCounter() - start) * 1000) / SDL_GetPerformanceFrequency();
+    return 0;
+}
+
+static void
+RemoveSavedFrames(int frames)
+{
+    char file[128];
+    int frame;
+
+    for (frame = 1; frame <= frames; ++frame) {
+        SDL_snprintf(file, sizeof(file), "SDL_window%d-%8.8d.bmp", 1, frame);
+        remove(file);
+    }
+}
+
+/* Check that every frame was captured exactly as it was presented */
+static int
+VerifyMode(Mode mode)
+{
+    Uint8 *expected[NUM_VERIFY_FRAMES];
+    Uint8 *data = NULL;
+    size_t frame_size, size, offset = 0;
+    double present_ms, total_ms;
+    const char *header = "YUV4MPEG2 W640 H480 F60:1 Ip A1:1 C420jpeg XCOLORRANGE=LIMITED\n";
+    int frame, result = 0;
+
+    for (frame = 0; frame < NUM_VERIFY_FRAMES; ++frame) {
+        expected[frame] = (Uint8 *) SDL_malloc(WINDOW_WIDTH * WINDOW_HEIGHT * 4);
+        if (!expected[frame]) {
+            SDL_Log("Out of memory\n");
+            return -1;
+        }
+    }
+
+    if (Run(mode, NUM_VERIFY_FRAMES, NUM_VERIFY_FRAMES, expected, &frame_size, &present_ms, &total_ms) < 0) {
+        result = -1;
+    }
+
+    if (result == 0 && mode == CAPTURE_BMP) {
+        for (frame = 0; frame < NUM_VERIFY_FRAMES; ++frame) {
+            char file[128];
+            SDL_Surface *saved;
+            int y;
+
+            SDL_snprintf(file, sizeof(file), "SDL_window%d-%8.8d.bmp", 1, frame + 1);
+            saved = SDL_LoadBMP(file);
+            if (saved) {
+                SDL_Surface *converted = SDL_ConvertSurfaceFormat(saved, SDL_PIXELFORMAT_RGB888, 0);
+                SDL_FreeSurface(saved);
+                saved = converted;
+            }
+            if (!saved) {
+                SDL_Log("Couldn't load %s: %s\n", file, SDL_GetError());
+                result = -1;
+                break;
+            }
+            for (y = 0; y < saved->h; ++y) {
+                if (SDL_memcmp((Uint8 *) saved->pixels + y * saved->pitch, expected[frame] + y * saved->w * 4, saved->w * 4) != 0) {
+                    SDL_Log("%s doesn't match the frame presented\n", file);
+                    result = -1;
+                    break;
+                }
+            }
+            SDL_FreeSurface(saved);
+        }
+        RemoveSavedFrames(NUM_VERIFY_FRAMES);
+    } else if (result == 0) {
+        data = (Uint8 *) SDL_LoadFile(output, &size);
+        if (!data) {
+            SDL_Log("Couldn't load %s: %s\n", output, SDL_GetError());
+            result = -1;
+        }
+        if (data && mode == CAPTURE_Y4M) {
+            offset = SDL_strlen(header);
+            if (size < offset || SDL_memcmp(data, header, offset) != 0) {
+                SDL_Log("Unexpected Y4M header\n");
+                result = -1;
+            }
+        }
+        for (frame = 0; frame < NUM_VERIFY_FRAMES && result == 0; ++frame) {
+            if (mode == CAPTURE_Y4M) {
+                if (offset + 6 > size || SDL_memcmp(data + offset, "FRAME\n", 6) != 0) {
+                    SDL_Log("Missing Y4M frame header for frame %d\n", frame);
+                    result = -1;
+                    break;
+                }
+                offset += 6;
+            }
+            if (offset + frame_size > size || SDL_memcmp(data + offset, expected[frame], frame_size) != 0) {
+                SDL_Log("Captured frame %d doesn't match the frame presented\n", frame);
+                result = -1;
+                break;
+            }
+            offset += frame_size;
+        }
+        if (result == 0 && offset != size) {
+            SDL_Log("Captured %u bytes, expected %u\n", (unsigned int) size, (unsigned int) offset);
+            result = -1;
+        }
+        SDL_free(data);
+        remove(output);
+    }
+
+    for (frame = 0; frame < NUM_VERIFY_FRAMES; ++frame) {
+        SDL_free(expected[frame]);
+    }
+
+    if (result == 0) {
+        SDL_Log("Capturing %s frames OK\n", mode_names[mode]);
+    }
+    return result;
+}
+
+int
+main(int argc, char *argv[])
+{
+    double present_ms, total_ms;
+    size_t frame_size;
+    int i, result = 0;
+
+    /* Enable standard application logging, and the capture statistics */
+    SDL_LogSetPriority(SDL_LOG_CATEGORY_APPLICATION, SDL_LOG_PRIORITY_INFO);
+    SDL_LogSetPriority(SDL_LOG_CATEGORY_VIDEO, SDL_LOG_PRIORITY_INFO);
+
+    for (i = 1; i < argc; ++i) {
+        if (SDL_strcasecmp(argv[i], "--frames") == 0 && argv[i + 1] && SDL_atoi(argv[i + 1]) > 0) {
+            num_frames = SDL_atoi(argv[++i]);
+        } else if (SDL_strcasecmp(argv[i], "--output") == 0 && argv[i + 1]) {
+            output = argv[++i];
+        } else {
+            SDL_Log("Usage: %s [--frames N] [--output file]\n", argv[0]);
+            return 1;
+        }
+    }
+
+    for (i = CAPTURE_BMP; i < NUM_MODES; ++i) {
+        if (VerifyMode((Mode) i) < 0) {
+            result = 1;
+        }
+    }
+
+    SDL_Log("Presenting %d %dx%d frames:\n", num_frames, WINDOW_WIDTH, WINDOW_HEIGHT);
+    for (i = 0; i < NUM_MODES; ++i) {
+        if (Run((Mode) i, num_frames, 4, NULL, &frame_size, &present_ms, &total_ms) < 0) {
+            result = 1;
+            continue;
+        }
+        SDL_Log("%-5s %.3f ms per frame presented, %9.3f ms until written\n",
+                mode_names[i], present_ms / num_frames, total_ms);
+        if (i == CAPTURE_BMP) {
+            RemoveSavedFrames(num_frames);
+        }
+    }
+    remove(output);
+
+    return result;
+}
+
+/* vi: set ts=4 sw=4 expandtab: */
@@ -0,0 +1,325 @@
+/*
+  Copyright (C) 1997-2020 Sam Lantinga <slouken@libsdl.org>
+
+  This software is provided 'as-is', without any express or implied
+  warranty.  In no event will the authors be held liable for any damages
+  arising from the use of this software.
+
+  Permission is granted to anyone to use this software for any purpose,
+  including commercial applications, and to alter it and redistribute it
+  freely.
+*/
+/* Benchmark drawing large lists of small textured, colored triangles with
+   SDL_RenderGeometry(), the way particle systems and 2D meshes do. */
+
+#include <stdlib.h>
+#include <stdio.h>
+
+#include "SDL_test_common.h"
+
+#define DEFAULT_TRIANGLES 100000
+#define MIN_TRIANGLE_SIZE 4
+#define MAX_TRIANGLE_SIZE 24
+#define DEFAULT_FRAMES 20
+
+typedef struct
+{
+    float x, y, dx, dy;
+    float size;
+    SDL_Color colors[3];
+} Particle;
+
+static SDLTest_CommonState *state;
+static SDL_Renderer *renderer;
+static SDL_Texture *sprite;
+static Particle *particles;
+static SDL_Vertex *vertices;
+static int num_triangles = DEFAULT_TRIANGLES;
+static int num_frames = DEFAULT_FRAMES;
+static SDL_bool textured = SDL_TRUE;
+static Uint32 seed = 1;
+
+/* Call this instead of exit(), so we can clean up SDL: atexit() is evil. */
+static void
+quit(int rc)
+{
+    SDL_free(particles);
+    SDL_free(vertices);
+    SDLTest_CommonQuit(state);
+    exit(rc);
+}
+
+/* The same numbers every run, so the checksums can be compared */
+static int
+Random(int max)
+{
+    seed = seed * 1103515245 + 12345;
+    return (int) ((seed >> 16) % max);
+}
+
+static SDL_Texture *
+LoadTexture(const char *file, SDL_bool transparent)
+{
+    SDL_Surface *temp;
+    SDL_Texture *texture;
+
+    temp = SDL_LoadBMP(file);
+    if (temp == NULL) {
+        SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Couldn't load %s: %s", file, SDL_GetError());
+        return NULL;
+    }
+
+    /* Set transparent pixel as the pixel at (0,0) */
+    if (transparent && temp->format->palette) {
+        SDL_SetColorKey(temp, SDL_TRUE, *(Uint8 *) temp->pixels);
+    }
+
+    texture = SDL_CreateTextureFromSurface(renderer, temp);
+    if (!texture) {
+        SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Couldn't create texture: %s\n", SDL_GetError());
+    }
+    SDL_FreeSurface(temp);
+    return texture;
+}
+
+static Uint32
+Checksum(void)
+{
+    SDL_Rect viewport;
+    Uint32 *pixels;
+    Uint32 checksum = 2166136261u;
+    int i;
+
+    SDL_RenderGetViewport(renderer, &viewport);
+    pixels = (Uint32 *) SDL_malloc(viewport.w * viewport.h * sizeof(*pixels));
+    if (!pixels) {
+        return 0;
+    }
+    if (SDL_RenderReadPixels(renderer, NULL, SDL_PIXELFORMAT_ARGB8888, pixels, viewport.w * sizeof(*pixels)) == 0) {
+        for (i = 0; i < viewport.w * viewport.h; ++i) {
+            checksum = (checksum ^ pixels[i]) * 16777619;
+        }
+    }
+    SDL_free(pixels);
+    return checksum;
+}
+
+/* Sprites drawn as two triangles should match SDL_RenderCopy() exactly */
+static SDL_bool
+VerifyQuads(void)
+{
+    static const int indices[6] = { 0, 1, 2, 2, 1, 3 };
+    SDL_Rect viewport, rect;
+    Uint32 *expected, *pixels;
+    SDL_Vertex quad[4];
+    int i, pass, w, h;
+    SDL_bool result = SDL_TRUE;
+
+    SDL_RenderGetViewport(renderer, &viewport);
+    SDL_QueryTexture(sprite, NULL, NULL, &w, &h);
+    expected = (Uint32 *) SDL_malloc(viewport.w * viewport.h * sizeof(*expected));
+    pixels = (Uint32 *) SDL_malloc(viewport.w * viewport.h * sizeof(*pixels));
+    if (!expected || !pixels) {
+        SDL_free(expected);
+        SDL_free(pixels);
+        return SDL_FALSE;
+    }
+
+    for (pass = 0; pass < 2; ++pass) {
+        SDL_SetRenderDrawColor(renderer, 0x30, 0x60, 0x90, 0xFF);
+        SDL_RenderClear(renderer);
+        for (i = 0; i < 16; ++i) {
+            /* Some of them hang off the edges */
+            rect.x = (i % 4) * (viewport.w + w) / 4 - w / 2;
+            rect.y = (i / 4) * (viewport.h + h) / 4 - h / 2;
+            rect.w = w;
+            rect.h = h;
+            if (pass == 0) {
+                SDL_RenderCopy(renderer, sprite, NULL, &rect);
+                continue;
+            }
+            SDL_zero(quad);
+            quad[0].position.x = quad[2].position.x = (float) rect.x;
+            quad[1].position.x = quad[3].position.x = (float) (rect.x + rect.w);
+            quad[0].position.y = quad[1].position.y = (float) rect.y;
+            quad[2].position.y = quad[3].position.y = (float) (rect.y + rect.h);
+            quad[1].tex_coord.x = quad[3].tex_coord.x = 1.0f;
+            quad[2].tex_coord.y = quad[3].tex_coord.y = 1.0f;
+            quad[0].color.r = quad[0].color.g = quad[0].color.b = quad[0].color.a = 0xFF;
+            quad[1].color = quad[2].color = quad[3].color = quad[0].color;
+            SDL_RenderGeometry(renderer, sprite, quad, 4, indices, 6);
+        }
+        SDL_RenderReadPixels(renderer, NULL, SDL_PIXELFORMAT_ARGB8888, pass == 0 ? expected : pixels, viewport.w * sizeof(*pixels));
+    }
+
+    for (i = 0; i < viewport.w * viewport.h; ++i) {
+        if (pixels[i] != expected[i]) {
+            SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Pixel %d,%d is %08X, expected %08X\n",
+                         i % viewport.w, i / viewport.w, pixels[i], expected[i]);
+            result = SDL_FALSE;
+            break;
+        }
+    }
+    SDL_free(expected);
+    SDL_free(pixels);
+    return result;
+}
+
+static void
+CreateParticles(int w, int h)
+{
+    int i, j;
+
+    for (i = 0; i < num_triangles; ++i) {
+        Particle *particle = &particles[i];
+        particle->x = (float) Random(w);
+        particle->y = (float) Random(h);
+        particle->dx = (float) (Random(9) - 4) * 0.5f;
+        particle->dy = (float) (Random(9) - 4) * 0.5f;
+        particle->size = (float) (MIN_TRIANGLE_SIZE + Random(MAX_TRIANGLE_SIZE - MIN_TRIANGLE_SIZE + 1));
+        for (j = 0; j < 3; ++j) {
+            particle->colors[j].r = (Uint8) Random(256);
+            particle->colors[j].g = (Uint8) Random(256);
+            particle->colors[j].b = (Uint8) Random(256);
+            particle->colors[j].a = (Uint8) (0x80 + Random(128));
+        }
+    }
+}
+
+static void
+loop(int frame)
+{
+    SDL_Rect viewport;
+    SDL_Vertex *vertex = vertices;
+    int i;
+
+    SDL_RenderGetViewport(renderer, &viewport);
+    SDL_SetRenderDrawColor(renderer, 0x20, 0x20, 0x20, 0xFF);
+    SDL_RenderClear(renderer);
+
+    for (i = 0; i < num_triangles; ++i) {
+        const Particle *particle = &particles[i];
+        const float span = (float) (viewport.w + MAX_TRIANGLE_SIZE);
+        float x = SDL_fmodf(particle->x + particle->dx * frame + span, span) - MAX_TRIANGLE_SIZE;
+        float y = SDL_fmodf(particle->y + particle->dy * frame + viewport.h, (float) viewport.h);
+
+        vertex->position.x = x;
+        vertex->position.y = y;
+        vertex->color = particle->colors[0];
+        vertex->tex_coord.x = 0.0f;
+        vertex->tex_coord.y = 0.0f;
+        ++vertex;
+        vertex->position.x = x + particle->size;
+        vertex->position.y = y + particle->size * 0.25f;
+        vertex->color = particle->colors[1];
+        vertex->tex_coord.x = 1.0f;
+        vertex->tex_coord.y = 0.25f;
+        ++vertex;
+        vertex->position.x = x + particle->size * 0.5f;
+        vertex->position.y = y + particle->size;
+        vertex->color = particle->colors[2];
+        vertex->tex_coord.x = 0.5f;
+        vertex->tex_coord.y = 1.0f;
+        ++vertex;
+    }
+    SDL_RenderGeometry(renderer, textured ? sprite : NULL, vertices, num_triangles * 3, NULL, 0);
+}
+
+int
+main(int argc, char *argv[])
+{
+    SDL_Event event;
+    SDL_Rect viewport;
+    SDL_RendererInfo info;
+    Uint64 start, elapsed;
+    Uint32 checksum = 0;
+    int i, frame, done = 0;
+
+    /* Enable standard application logging */
+    SDL_LogSetPriority(SDL_LOG_CATEGORY_APPLICATION, SDL_LOG_PRIORITY_INFO);
+
+    /* Initialize test framework */
+    state = SDLTest_CommonCreateState(argv, SDL_INIT_VIDEO);
+    if (!state) {
+        return 1;
+    }
+    for (i = 1; i < argc;) {
+        int consumed;
+
+        consumed = SDLTest_CommonArg(state, i);
+        if (consumed == 0) {
+            consumed = -1;
+            if (SDL_strcasecmp(argv[i], "--triangles") == 0 && argv[i + 1]) {
+                num_triangles = SDL_atoi(argv[i + 1]);
+                if (num_triangles > 0) {
+                    consumed = 2;
+                }
+            } else if (SDL_strcasecmp(argv[i], "--frames") == 0 && argv[i + 1]) {
+                num_frames = SDL_atoi(argv[i + 1]);
+                if (num_frames > 0) {
+                    consumed = 2;
+                }
+            } else if (SDL_strcasecmp(argv[i], "--untextured") == 0) {
+                textured = SDL_FALSE;
+                consumed = 1;
+            }
+        }
+        if (consumed < 0) {
+            static const char *options[] = { "[--triangles N]", "[--frames N]", "[--untextured]", NULL };
+            SDLTest_CommonLogUsage(state, argv[0], options);
+            quit(1);
+        }
+        i += consumed;
+    }
+    if (!SDLTest_CommonInit(state)) {
+        quit(2);
+    }
+    renderer = state->renderers[0];
+
+    sprite = LoadTexture("icon.bmp", SDL_TRUE);
+    particles = (Particle *) SDL_calloc(num_triangles, sizeof(*particles));
+    vertices = (SDL_Vertex *) SDL_calloc(num_triangles * 3, sizeof(*vertices));
+    if (!sprite || !particles || !vertices) {
+        quit(2);
+    }
+
+    /* The other renderers may sample texels at slightly different places */
+    SDL_GetRendererInfo(renderer, &info);
+    if (SDL_strcmp(info.name, "software") == 0) {
+        if (!VerifyQuads()) {
+            quit(3);
+        }
+        SDL_Log("Triangles match SDL_RenderCopy()\n");
+    }
+
+    SDL_RenderGetViewport(renderer, &viewport);
+    CreateParticles(viewport.w, viewport.h);
+
+    /* Main render loop */
+    start = SDL_GetPerformanceCounter();
+    for (frame = 0; !done; ++frame) {
+        while (SDL_PollEvent(&event)) {
+            SDLTest_CommonEvent(state, &event, &done);
+        }
+        loop(frame);
+        if (frame + 1 == num_frames) {
+            checksum = Checksum();
+            done = 1;
+        }
+        SDL_RenderPresent(renderer);
+    }
+    elapsed = SDL_GetPerformanceCounter() - start;
+
+    /* Print out some timing information */
+    if (elapsed > 0) {
+        const double seconds = (double) elapsed / SDL_GetPerformanceFrequency();
+        SDL_Log("%d frames of %d %s triangles: %2.2f frames per second, %.2f million triangles per second, checksum %08X\n",
+                frame, num_triangles, textured ? "textured" : "colored", frame / seconds,
+                frame * (double) num_triangles / seconds / 1000000.0, checksum);
+    }
+
+    quit(0);
+    return 0;
+}
+
+/* vi: set ts=4 sw=4 expandtab: */
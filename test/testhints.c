@@ -0,0 +1,106 @@
+/*
+  Copyright (C) 1997-2020 Sam Lantinga <slouken@libsdl.org>
+
+  This software is provided 'as-is', without any express or implied
+  warranty.  In no event will the authors be held liable for any damages
+  arising from the use of this software.
+
+  Permission is granted to anyone to use this software for any purpose,
+  including commercial applications, and to alter it and redistribute it
+  freely.
+*/
+
+/* Benchmark SDL_GetHint() and SDL_GetHintBoolean() with a realistic number
+   of hints set, for hints set in the environment, by the app, and unset. */
+
+#include <stdlib.h>
+
+#include "SDL.h"
+
+#define NUM_FILLER_HINTS 100
+#define DEFAULT_ITERATIONS 10000000
+
+static void
+bench_boolean(const char *description, const char *name, int iterations)
+{
+    const Uint64 freq = SDL_GetPerformanceFrequency();
+    Uint64 start, end;
+    int i, count = 0;
+
+    start = SDL_GetPerformanceCounter();
+    for (i = 0; i < iterations; ++i) {
+        count += SDL_GetHintBoolean(name, SDL_FALSE);
+    }
+    end = SDL_GetPerformanceCounter();
+
+    SDL_Log("SDL_GetHintBoolean, %-12s: %8.2f ns/call, %6.1f Mcalls/sec (%d true)\n", description,
+            ((double) (end - start) * 1000000000.0) / freq / iterations,
+            ((double) iterations * freq) / (end - start) / 1000000.0, count);
+}
+
+static void
+bench_string(const char *description, const char *name, int iterations)
+{
+    const Uint64 freq = SDL_GetPerformanceFrequency();
+    Uint64 start, end;
+    int i, count = 0;
+
+    start = SDL_GetPerformanceCounter();
+    for (i = 0; i < iterations; ++i) {
+        count += (SDL_GetHint(name) != NULL);
+    }
+    end = SDL_GetPerformanceCounter();
+
+    SDL_Log("SDL_GetHint,        %-12s: %8.2f ns/call, %6.1f Mcalls/sec (%d set)\n", description,
+            ((double) (end - start) * 1000000000.0) / freq / iterations,
+            ((double) iterations * freq) / (end - start) / 1000000.0, count);
+}
+
+int
+main(int argc, char *argv[])
+{
+    int iterations = DEFAULT_ITERATIONS;
+    char name[64];
+    int i;
+
+    /* Enable standard application logging */
+    SDL_LogSetPriority(SDL_LOG_CATEGORY_APPLICATION, SDL_LOG_PRIORITY_INFO);
+
+    if (argc > 1) {
+        iterations = SDL_atoi(argv[1]);
+        if (iterations <= 0) {
+            SDL_Log("USAGE: %s [iterations]\n", argv[0]);
+            return 1;
+        }
+    }
+
+    /* Set lots of hints first, so lookups don't have a trivially short list to search */
+    for (i = 0; i < NUM_FILLER_HINTS; ++i) {
+        SDL_snprintf(name, sizeof (name), "SDL_TEST_FILLER_HINT_%d", i);
+        SDL_SetHint(name, "1");
+    }
+
+    SDL_setenv("SDL_TEST_ENVIRONMENT_HINT", "1", 1);
+    SDL_SetHint("SDL_TEST_APP_HINT", "true");
+
+    if (SDL_Init(0) < 0) {
+        SDL_Log("Couldn't initialize SDL: %s\n", SDL_GetError());
+        return 1;
+    }
+
+    SDL_Log("%d hints set, %d iterations each\n", NUM_FILLER_HINTS + 2, iterations);
+
+    bench_boolean("environment", "SDL_TEST_ENVIRONMENT_HINT", iterations);
+    bench_boolean("app", "SDL_TEST_APP_HINT", iterations);
+    bench_boolean("unset", "SDL_TEST_UNSET_HINT", iterations);
+    bench_boolean("renderer", SDL_HINT_RENDER_BATCHING, iterations);
+
+    bench_string("environment", "SDL_TEST_ENVIRONMENT_HINT", iterations);
+    bench_string("app", "SDL_TEST_APP_HINT", iterations);
+    bench_string("unset", "SDL_TEST_UNSET_HINT", iterations);
+
+    SDL_Quit();
+    return 0;
+}
+
+/* vi: set ts=4 sw=4 expandtab: */
@@ -25,6 +25,110 @@ widelen(char *data)
     return len;
 }
 
+#define BENCHMARK_SIZE (1024 * 1024)
+#define BENCHMARK_LOOPS 10
+
+/* Fill a buffer with UTF-8 text made of a repeated phrase */
+static char *
+MakeText(const char *phrase, size_t size)
+{
+    size_t len = SDL_strlen(phrase);
+    char *text = (char *) SDL_malloc(size + 1);
+    size_t i;
+
+    if (!text) {
+        return NULL;
+    }
+    for (i = 0; i + len <= size; i += len) {
+        SDL_memcpy(text + i, phrase, len);
+    }
+    text[i] = '\0';
+    return text;
+}
+
+/* Convert text to an encoding and back, and report the throughput of each */
+static int
+Benchmark(const char *name, const char *text, const char *format, size_t unit)
+{
+    size_t len = SDL_strlen(text) + 1;
+    char *converted = NULL, *restored = NULL;
+    Uint64 start, to_ticks, from_ticks;
+    double to_rate, from_rate;
+    int i, errors = 0;
+
+    start = SDL_GetPerformanceCounter();
+    for (i = 0; i < BENCHMARK_LOOPS; ++i) {
+        SDL_free(converted);
+        converted = SDL_iconv_string(format, "UTF-8", text, len);
+    }
+    to_ticks = SDL_GetPerformanceCounter() - start;
+
+    if (converted) {
+        /* Find the terminator, which is a whole zero character */
+        size_t size = 0;
+        while (SDL_memcmp(converted + size, "\0\0\0\0", unit) != 0) {
+            size += unit;
+        }
+        size += unit;
+
+        start = SDL_GetPerformanceCounter();
+        for (i = 0; i < BENCHMARK_LOOPS; ++i) {
+            SDL_free(restored);
+            restored = SDL_iconv_string("UTF-8", format, converted, size);
+        }
+        from_ticks = SDL_GetPerformanceCounter() - start;
+    } else {
+        from_ticks = 0;
+    }
+
+    if (!restored || SDL_strcmp(restored, text) != 0) {
+        SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "FAIL: %s text to %s and back\n", name, format);
+        ++errors;
+    } else {
+        to_rate = ((double) len * BENCHMARK_LOOPS) / (1024.0 * 1024.0) * SDL_GetPerformanceFrequency() / to_ticks;
+        from_rate = ((double) len * BENCHMARK_LOOPS) / (1024.0 * 1024.0) * SDL_GetPerformanceFrequency() / from_ticks;
+        SDL_Log("%-5s UTF-8 -> %-14s %8.1f MB/s, back %8.1f MB/s\n", name, format, to_rate, from_rate);
+    }
+    SDL_free(converted);
+    SDL_free(restored);
+    return errors;
+}
+
+static int
+RunBenchmarks(void)
+{
+    /* Mostly ASCII, with the odd accented letter */
+    char *ascii = MakeText("The quick brown fox jumps over the lazy dog, na\xC3\xAFvely. ", BENCHMARK_SIZE);
+    /* Mostly CJK, "Japanese text" and "Chinese" with a little punctuation */
+    char *cjk = MakeText("\xE6\x97\xA5\xE6\x9C\xAC\xE8\xAA\x9E\xE3\x81\xAE\xE3\x83\x86\xE3\x82\xAD\xE3\x82\xB9\xE3\x83\x88\xE3\x80\x81"
+                         "\xE4\xB8\xAD\xE6\x96\x87 123 \xF0\x9F\x98\x80\xE3\x80\x82", BENCHMARK_SIZE);
+    int errors = 0;
+
+    if (!ascii || !cjk) {
+        SDL_free(ascii);
+        SDL_free(cjk);
+        SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Out of memory!\n");
+        return 1;
+    }
+
+    /* Only the built-in converter has the fast paths, and knows SDL's own
+       names like "UCS-4-INTERNAL", so stick to names every iconv knows */
+#ifdef HAVE_ICONV
+    SDL_Log("Benchmarking the system iconv\n");
+#else
+    SDL_Log("Benchmarking the built-in SDL_iconv\n");
+#endif
+    errors += Benchmark("ASCII", ascii, "UTF-16LE", 2);
+    errors += Benchmark("ASCII", ascii, "UTF-32LE", 4);
+    errors += Benchmark("ASCII", ascii, "ISO-8859-1", 1);
+    errors += Benchmark("CJK", cjk, "UTF-16LE", 2);
+    errors += Benchmark("CJK", cjk, "UTF-32LE", 4);
+
+    SDL_free(ascii);
+    SDL_free(cjk);
+    return errors;
+}
+
 int
 main(int argc, char *argv[])
 {
@@ -84,5 +188,7 @@ main(int argc, char *argv[])
         SDL_free(test[0]);
     }
     fclose(file);
+
+    errors += RunBenchmarks();
     return (errors ? errors + 1 : 0);
 }
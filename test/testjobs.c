@@ -0,0 +1,296 @@
+/*
+  Copyright (C) 1997-2020 Sam Lantinga <slouken@libsdl.org>
+
+  This software is provided 'as-is', without any express or implied
+  warranty.  In no event will the authors be held liable for any damages
+  arising from the use of this software.
+
+  Permission is granted to anyone to use this software for any purpose,
+  including commercial applications, and to alter it and redistribute it
+  freely.
+*/
+
+/* Benchmark the SDL job pool against creating a thread per task,
+   and check that both compute the same results. */
+
+#include <stdlib.h>
+
+#include "SDL.h"
+
+#define NUM_TASKS 256
+#define SMALL_WORK 2000
+#define LARGE_WORK 2000000
+#define PARALLEL_COUNT (4 * 1024 * 1024)
+
+typedef struct
+{
+    int index;
+    int work;
+    Uint32 result;
+} Task;
+
+static Task tasks[NUM_TASKS];
+static Uint32 *values;
+static SDL_atomic_t order;
+static int before_order[8];
+static int after_order;
+
+static Uint32
+DoWork(int index, int work)
+{
+    Uint32 x = (Uint32) index * 2654435761u + 1;
+    int i;
+    for (i = 0; i < work; ++i) {
+        x ^= x << 13;
+        x ^= x >> 17;
+        x ^= x << 5;
+    }
+    return x;
+}
+
+static int SDLCALL
+TaskThread(void *data)
+{
+    Task *task = (Task *) data;
+    task->result = DoWork(task->index, task->work);
+    return 0;
+}
+
+static void SDLCALL
+TaskJob(void *data)
+{
+    Task *task = (Task *) data;
+    task->result = DoWork(task->index, task->work);
+}
+
+static void SDLCALL
+FillValues(int start, int end, void *data)
+{
+    int i;
+    for (i = start; i < end; ++i) {
+        values[i] = DoWork(i, 16);
+    }
+}
+
+static void SDLCALL
+BeforeJob(void *data)
+{
+    int *slot = (int *) data;
+    SDL_Delay(10);
+    *slot = SDL_AtomicAdd(&order, 1);
+}
+
+static void SDLCALL
+AfterJob(void *data)
+{
+    after_order = SDL_AtomicAdd(&order, 1);
+}
+
+static Uint32
+SumTasks(void)
+{
+    Uint32 sum = 0;
+    int i;
+    for (i = 0; i < NUM_TASKS; ++i) {
+        sum += tasks[i].result;
+    }
+    return sum;
+}
+
+static void
+ResetTasks(int work)
+{
+    int i;
+    for (i = 0; i < NUM_TASKS; ++i) {
+        tasks[i].index = i;
+        tasks[i].work = work;
+        tasks[i].result = 0;
+    }
+}
+
+static double
+Elapsed(Uint64 start)
+{
+    return (double) ((SDL_GetPerformanceCounter() - start) * 1000) / SDL_GetPerformanceFrequency();
+}
+
+/* Returns the sum of the task results, or 0 if the threads couldn't be created. */
+static Uint32
+RunThreads(int work, double *ms)
+{
+    SDL_Thread *threads[NUM_TASKS];
+    Uint64 start;
+    int i;
+
+    ResetTasks(work);
+    start = SDL_GetPerformanceCounter();
+    for (i = 0; i < NUM_TASKS; ++i) {
+        threads[i] = SDL_CreateThread(TaskThread, "TaskThread", &tasks[i]);
+        if (!threads[i]) {
+            SDL_Log("Couldn't create thread: %s\n", SDL_GetError());
+            while (i--) {
+                SDL_WaitThread(threads[i], NULL);
+            }
+            return 0;
+        }
+    }
+    for (i = 0; i < NUM_TASKS; ++i) {
+        SDL_WaitThread(threads[i], NULL);
+    }
+    *ms = Elapsed(start);
+    return SumTasks();
+}
+
+static Uint32
+RunJobs(SDL_JobPool *pool, int work, double *ms)
+{
+    SDL_JobGroup *group = SDL_CreateJobGroup();
+    Uint64 start;
+    int i;
+
+    if (!group) {
+        SDL_Log("Couldn't create job group: %s\n", SDL_GetError());
+        return 0;
+    }
+
+    ResetTasks(work);
+    start = SDL_GetPerformanceCounter();
+    for (i = 0; i < NUM_TASKS; ++i) {
+        if (SDL_SubmitJob(pool, TaskJob, &tasks[i], group) < 0) {
+            SDL_Log("Couldn't submit job: %s\n", SDL_GetError());
+            break;
+        }
+    }
+    SDL_WaitJobGroup(pool, group);
+    *ms = Elapsed(start);
+    SDL_DestroyJobGroup(group);
+    return SumTasks();
+}
+
+static int
+Compare(const char *name, int work, SDL_JobPool *pool)
+{
+    double thread_ms = 0.0, job_ms = 0.0;
+    Uint32 thread_sum = RunThreads(work, &thread_ms);
+    Uint32 job_sum = RunJobs(pool, work, &job_ms);
+
+    SDL_Log("%s tasks: thread per task %9.3f ms, job pool %9.3f ms\n", name, thread_ms, job_ms);
+    if (thread_sum != job_sum) {
+        SDL_Log("%s tasks: results differ (0x%.8x vs 0x%.8x)!\n", name, thread_sum, job_sum);
+        return -1;
+    }
+    return 0;
+}
+
+static int
+TestParallelFor(SDL_JobPool *pool)
+{
+    Uint64 start;
+    double serial_ms, parallel_ms;
+    Uint32 serial_sum = 0, parallel_sum = 0;
+    int i;
+
+    values = (Uint32 *) SDL_malloc(PARALLEL_COUNT * sizeof (Uint32));
+    if (!values) {
+        SDL_Log("Out of memory!\n");
+        return -1;
+    }
+
+    start = SDL_GetPerformanceCounter();
+    FillValues(0, PARALLEL_COUNT, NULL);
+    serial_ms = Elapsed(start);
+    for (i = 0; i < PARALLEL_COUNT; ++i) {
+        serial_sum += values[i];
+    }
+
+    SDL_memset(values, 0, PARALLEL_COUNT * sizeof (Uint32));
+    start = SDL_GetPerformanceCounter();
+    if (SDL_ParallelFor(pool, 0, PARALLEL_COUNT, 0, FillValues, NULL) < 0) {
+        SDL_Log("Couldn't run parallel for: %s\n", SDL_GetError());
+        SDL_free(values);
+        return -1;
+    }
+    parallel_ms = Elapsed(start);
+    for (i = 0; i < PARALLEL_COUNT; ++i) {
+        parallel_sum += values[i];
+    }
+    SDL_free(values);
+
+    SDL_Log("Parallel for: serial %9.3f ms, job pool %9.3f ms\n", serial_ms, parallel_ms);
+    if (serial_sum != parallel_sum) {
+        SDL_Log("Parallel for: results differ (0x%.8x vs 0x%.8x)!\n", serial_sum, parallel_sum);
+        return -1;
+    }
+    return 0;
+}
+
+static int
+TestDependencies(SDL_JobPool *pool)
+{
+    SDL_JobGroup *before = SDL_CreateJobGroup();
+    SDL_JobGroup *all = SDL_CreateJobGroup();
+    int i, result = 0;
+
+    if (!before || !all) {
+        SDL_Log("Couldn't create job group: %s\n", SDL_GetError());
+        SDL_DestroyJobGroup(before);
+        SDL_DestroyJobGroup(all);
+        return -1;
+    }
+
+    SDL_AtomicSet(&order, 0);
+    for (i = 0; i < SDL_arraysize(before_order); ++i) {
+        SDL_SubmitJob(pool, BeforeJob, &before_order[i], before);
+    }
+    SDL_SubmitJobAfter(pool, before, AfterJob, NULL, all);
+    SDL_WaitJobGroup(pool, all);
+
+    if (after_order != SDL_arraysize(before_order)) {
+        SDL_Log("Dependent job ran at position %d, expected %d!\n", after_order, (int) SDL_arraysize(before_order));
+        result = -1;
+    } else {
+        SDL_Log("Dependent job ran after the jobs it waited for.\n");
+    }
+
+    SDL_DestroyJobGroup(before);
+    SDL_DestroyJobGroup(all);
+    return result;
+}
+
+int
+main(int argc, char *argv[])
+{
+    SDL_JobPool *pool;
+    int result = 0;
+
+    /* Enable standard application logging */
+    SDL_LogSetPriority(SDL_LOG_CATEGORY_APPLICATION, SDL_LOG_PRIORITY_INFO);
+
+    /* Load the SDL library */
+    if (SDL_Init(0) < 0) {
+        SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Couldn't initialize SDL: %s\n", SDL_GetError());
+        return 1;
+    }
+
+    pool = SDL_CreateJobPool(0);
+    if (!pool) {
+        SDL_Log("Couldn't create job pool: %s\n", SDL_GetError());
+        SDL_Quit();
+        return 1;
+    }
+    SDL_Log("Running %d tasks on %d CPUs, %d job pool threads.\n",
+            NUM_TASKS, SDL_GetCPUCount(), SDL_GetJobPoolThreadCount(pool));
+
+    if (Compare("Small", SMALL_WORK, pool) < 0 ||
+        Compare("Large", LARGE_WORK, pool) < 0 ||
+        TestParallelFor(pool) < 0 ||
+        TestDependencies(pool) < 0) {
+        result = 1;
+    }
+
+    SDL_DestroyJobPool(pool);
+    SDL_Quit();
+    return result;
+}
+
+/* vi: set ts=4 sw=4 expandtab: */
@@ -89,6 +89,65 @@ Run(void *data)
     return (0);
 }
 
+/* Contention benchmark: several threads taking the same lock around a short
+   critical section, the way the audio and event threads do */
+#define CONTENTION_THREADS 4
+#define CONTENTION_LOOPS 200000
+
+static SDL_SpinLock spinlock;
+static int contended_value;
+
+int SDLCALL
+ContendMutex(void *data)
+{
+    int i;
+    for (i = 0; i < CONTENTION_LOOPS; ++i) {
+        SDL_LockMutex(mutex);
+        ++contended_value;
+        SDL_UnlockMutex(mutex);
+    }
+    return 0;
+}
+
+int SDLCALL
+ContendSpinLock(void *data)
+{
+    int i;
+    for (i = 0; i < CONTENTION_LOOPS; ++i) {
+        SDL_AtomicLock(&spinlock);
+        ++contended_value;
+        SDL_AtomicUnlock(&spinlock);
+    }
+    return 0;
+}
+
+static void
+TestContention(const char *name, SDL_ThreadFunction func)
+{
+    SDL_Thread *contenders[CONTENTION_THREADS];
+    Uint64 start;
+    double ms;
+    int i;
+
+    contended_value = 0;
+    start = SDL_GetPerformanceCounter();
+    for (i = 0; i < CONTENTION_THREADS; ++i) {
+        contenders[i] = SDL_CreateThread(func, "Contender", NULL);
+    }
+    for (i = 0; i < CONTENTION_THREADS; ++i) {
+        SDL_WaitThread(contenders[i], NULL);
+    }
+    ms = (double) ((SDL_GetPerformanceCounter() - start) * 1000) / SDL_GetPerformanceFrequency();
+
+    SDL_Log("%s: %d threads took %.3f ms, %.1f ns per lock\n", name, CONTENTION_THREADS,
+            ms, (ms * 1000000.0) / (CONTENTION_THREADS * CONTENTION_LOOPS));
+    if (contended_value != CONTENTION_THREADS * CONTENTION_LOOPS) {
+        SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "%s: counted %d; expected: %d\n", name,
+                     contended_value, CONTENTION_THREADS * CONTENTION_LOOPS);
+        exit(1);
+    }
+}
+
 int
 main(int argc, char *argv[])
 {
@@ -112,6 +171,9 @@ main(int argc, char *argv[])
         exit(1);
     }
 
+    TestContention("Mutex", ContendMutex);
+    TestContention("Spinlock", ContendSpinLock);
+
     mainthread = SDL_ThreadID();
     SDL_Log("Main thread: %lu\n", mainthread);
     atexit(printid);
@@ -0,0 +1,132 @@
+/*
+  Copyright (C) 1997-2020 Sam Lantinga <slouken@libsdl.org>
+
+  This software is provided 'as-is', without any express or implied
+  warranty.  In no event will the authors be held liable for any damages
+  arising from the use of this software.
+
+  Permission is granted to anyone to use this software for any purpose,
+  including commercial applications, and to alter it and redistribute it
+  freely.
+*/
+
+/* Benchmark several threads allocating and freeing small blocks with
+   SDL_malloc() at the same time, the way the audio, render and job threads
+   do, and check the allocation count comes back to where it started. */
+
+#include <stdlib.h>
+
+#include "SDL.h"
+
+#define MAX_THREADS 8
+#define NUM_LIVE_BLOCKS 64
+#define NUM_ALLOCATIONS 1000000
+#define MAX_BLOCK_SIZE 256
+
+static SDL_atomic_t corrupted;
+
+static int SDLCALL
+Allocator(void *data)
+{
+    Uint8 *blocks[NUM_LIVE_BLOCKS];
+    size_t sizes[NUM_LIVE_BLOCKS];
+    Uint32 seed = (Uint32) (size_t) data;
+    int i, j;
+
+    SDL_zeroa(blocks);
+    for (i = 0; i < NUM_ALLOCATIONS; ++i) {
+        /* Replace a random live block with one of a random size */
+        seed = seed * 1103515245 + 12345;
+        j = (seed >> 16) % NUM_LIVE_BLOCKS;
+        if (blocks[j]) {
+            if (blocks[j][0] != (Uint8) j || blocks[j][sizes[j] - 1] != (Uint8) j) {
+                SDL_AtomicIncRef(&corrupted);
+            }
+            SDL_free(blocks[j]);
+        }
+        sizes[j] = 1 + (seed >> 8) % MAX_BLOCK_SIZE;
+        if ((i % 4) == 0) {
+            blocks[j] = (Uint8 *) SDL_calloc(1, sizes[j]);
+            if (blocks[j] && blocks[j][sizes[j] - 1] != 0) {
+                SDL_AtomicIncRef(&corrupted);
+            }
+        } else {
+            blocks[j] = (Uint8 *) SDL_malloc(sizes[j]);
+        }
+        if (!blocks[j]) {
+            SDL_AtomicIncRef(&corrupted);
+            break;
+        }
+        blocks[j][0] = blocks[j][sizes[j] - 1] = (Uint8) j;
+    }
+    for (j = 0; j < NUM_LIVE_BLOCKS; ++j) {
+        SDL_free(blocks[j]);
+    }
+    return 0;
+}
+
+static int SDLCALL
+Idle(void *data)
+{
+    return 0;
+}
+
+static double
+RunAllocators(int num_threads)
+{
+    SDL_Thread *threads[MAX_THREADS];
+    Uint64 start = SDL_GetPerformanceCounter();
+    int i;
+
+    for (i = 0; i < num_threads; ++i) {
+        threads[i] = SDL_CreateThread(Allocator, "Allocator", (void *) (size_t) (i + 1));
+    }
+    for (i = 0; i < num_threads; ++i) {
+        SDL_WaitThread(threads[i], NULL);
+    }
+    return (double) ((SDL_GetPerformanceCounter() - start) * 1000) / SDL_GetPerformanceFrequency();
+}
+
+int
+main(int argc, char *argv[])
+{
+    int num_threads, num_allocations;
+    double ms;
+
+    /* Enable standard application logging */
+    SDL_LogSetPriority(SDL_LOG_CATEGORY_APPLICATION, SDL_LOG_PRIORITY_INFO);
+
+    if (SDL_Init(0) < 0) {
+        SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Couldn't initialize SDL: %s\n", SDL_GetError());
+        return 1;
+    }
+
+    SDL_Log("%d allocations of up to %d bytes per thread, on %d CPUs\n",
+            NUM_ALLOCATIONS, MAX_BLOCK_SIZE, SDL_GetCPUCount());
+
+    /* Don't count what SDL sets up for the first thread it creates */
+    SDL_WaitThread(SDL_CreateThread(Idle, "Idle", NULL), NULL);
+    num_allocations = SDL_GetNumAllocations();
+    for (num_threads = 1; num_threads <= MAX_THREADS; num_threads *= 2) {
+        ms = RunAllocators(num_threads);
+        SDL_Log("%d thread%s: %9.3f ms, %6.1f million allocations per second\n",
+                num_threads, num_threads > 1 ? "s" : " ", ms,
+                (num_threads * (double) NUM_ALLOCATIONS) / (ms * 1000.0));
+    }
+
+    if (SDL_AtomicGet(&corrupted) > 0) {
+        SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Blocks were corrupted or missing %d times!\n", SDL_AtomicGet(&corrupted));
+        SDL_Quit();
+        return 1;
+    }
+    if (SDL_GetNumAllocations() != num_allocations) {
+        SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "%d allocations weren't freed!\n", SDL_GetNumAllocations() - num_allocations);
+        SDL_Quit();
+        return 1;
+    }
+
+    SDL_Quit();
+    return 0;
+}
+
+/* vi: set ts=4 sw=4 expandtab: */
@@ -0,0 +1,172 @@
+/*
+  Copyright (C) 1997-2020 Sam Lantinga <slouken@libsdl.org>
+
+  This software is provided 'as-is', without any express or implied
+  warranty.  In no event will the authors be held liable for any damages
+  arising from the use of this software.
+
+  Permission is granted to anyone to use this software for any purpose,
+  including commercial applications, and to alter it and redistribute it
+  freely.
+*/
+
+/* Benchmark copies of the same image that alternate between tinted and
+   plain, with surface blits and with the software renderer, and check
+   the tinted copies come out the same as with a freshly set up image. */
+
+#include <stdlib.h>
+
+#include "SDL.h"
+
+#define NUM_COPIES 100000
+#define IMAGE_SIZE 8
+
+static void
+SetTint(SDL_Surface *surface, SDL_bool tinted)
+{
+    if (tinted) {
+        SDL_SetSurfaceColorMod(surface, 255, 128, 64);
+        SDL_SetSurfaceAlphaMod(surface, 192);
+    } else {
+        SDL_SetSurfaceColorMod(surface, 255, 255, 255);
+        SDL_SetSurfaceAlphaMod(surface, 255);
+    }
+}
+
+static double
+Elapsed(Uint64 start)
+{
+    return (double) ((SDL_GetPerformanceCounter() - start) * 1000) / SDL_GetPerformanceFrequency();
+}
+
+static double
+BlitSurfaces(SDL_Surface *image, SDL_Surface *screen)
+{
+    Uint64 start = SDL_GetPerformanceCounter();
+    int i;
+
+    for (i = 0; i < NUM_COPIES; ++i) {
+        SDL_Rect rect;
+        rect.x = (i * 7) % (screen->w - IMAGE_SIZE);
+        rect.y = (i * 13) % (screen->h - IMAGE_SIZE);
+        SetTint(image, (i & 1) ? SDL_TRUE : SDL_FALSE);
+        SDL_BlitSurface(image, NULL, screen, &rect);
+    }
+    return Elapsed(start);
+}
+
+static double
+RenderCopies(SDL_Surface *image, SDL_Surface *screen)
+{
+    SDL_Renderer *renderer = SDL_CreateSoftwareRenderer(screen);
+    SDL_Texture *texture;
+    Uint64 start;
+    int i;
+
+    if (!renderer) {
+        SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Couldn't create renderer: %s\n", SDL_GetError());
+        return -1.0;
+    }
+    texture = SDL_CreateTextureFromSurface(renderer, image);
+    if (!texture) {
+        SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Couldn't create texture: %s\n", SDL_GetError());
+        SDL_DestroyRenderer(renderer);
+        return -1.0;
+    }
+    SDL_SetTextureBlendMode(texture, SDL_BLENDMODE_BLEND);
+
+    start = SDL_GetPerformanceCounter();
+    for (i = 0; i < NUM_COPIES; ++i) {
+        SDL_Rect rect;
+        rect.x = (i * 7) % (screen->w - IMAGE_SIZE);
+        rect.y = (i * 13) % (screen->h - IMAGE_SIZE);
+        rect.w = rect.h = IMAGE_SIZE;
+        if (i & 1) {
+            SDL_SetTextureColorMod(texture, 255, 128, 64);
+            SDL_SetTextureAlphaMod(texture, 192);
+        } else {
+            SDL_SetTextureColorMod(texture, 255, 255, 255);
+            SDL_SetTextureAlphaMod(texture, 255);
+        }
+        SDL_RenderCopy(renderer, texture, NULL, &rect);
+    }
+    SDL_RenderPresent(renderer);
+
+    SDL_DestroyTexture(texture);
+    SDL_DestroyRenderer(renderer);
+    return Elapsed(start);
+}
+
+/* Tinted copies of an image that has gone back and forth should match
+   those of a copy of it that never has */
+static int
+CheckTint(SDL_Surface *image, SDL_Surface *screen)
+{
+    SDL_Surface *fresh = SDL_ConvertSurface(image, image->format, 0);
+    SDL_Surface *expected = SDL_ConvertSurface(screen, screen->format, 0);
+    int result = 0;
+
+    if (!fresh || !expected) {
+        SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Couldn't copy surfaces: %s\n", SDL_GetError());
+        result = -1;
+    } else {
+        SDL_SetSurfaceBlendMode(fresh, SDL_BLENDMODE_BLEND);
+        SetTint(fresh, SDL_TRUE);
+        SDL_BlitSurface(fresh, NULL, expected, NULL);
+
+        SetTint(image, SDL_TRUE);
+        SDL_BlitSurface(image, NULL, screen, NULL);
+
+        if (SDL_memcmp(screen->pixels, expected->pixels, screen->h * screen->pitch) != 0) {
+            SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Tinted copies don't match!\n");
+            result = -1;
+        }
+    }
+    SDL_FreeSurface(fresh);
+    SDL_FreeSurface(expected);
+    return result;
+}
+
+int
+main(int argc, char *argv[])
+{
+    SDL_Surface *image, *screen;
+    double blit_ms, render_ms;
+    int i, result = 0;
+
+    /* Enable standard application logging */
+    SDL_LogSetPriority(SDL_LOG_CATEGORY_APPLICATION, SDL_LOG_PRIORITY_INFO);
+
+    image = SDL_CreateRGBSurfaceWithFormat(0, IMAGE_SIZE, IMAGE_SIZE, 32, SDL_PIXELFORMAT_ARGB8888);
+    screen = SDL_CreateRGBSurfaceWithFormat(0, 640, 480, 32, SDL_PIXELFORMAT_RGB888);
+    if (!image || !screen) {
+        SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Couldn't create surfaces: %s\n", SDL_GetError());
+        return 1;
+    }
+    for (i = 0; i < IMAGE_SIZE * IMAGE_SIZE; ++i) {
+        ((Uint32 *) image->pixels)[i] = (Uint32) rand() * 2654435761u;
+    }
+    SDL_SetSurfaceBlendMode(image, SDL_BLENDMODE_BLEND);
+
+    blit_ms = BlitSurfaces(image, screen);
+    if (CheckTint(image, screen) < 0) {
+        result = 1;
+    }
+    render_ms = RenderCopies(image, screen);
+    if (render_ms < 0.0) {
+        result = 1;
+    }
+
+    if (result == 0) {
+        SDL_Log("%d copies alternating tinted and plain %dx%d images\n", NUM_COPIES, IMAGE_SIZE, IMAGE_SIZE);
+        SDL_Log("Surface blits:     %9.3f ms\n", blit_ms);
+        SDL_Log("Software renderer: %9.3f ms\n", render_ms);
+    }
+
+    SDL_FreeSurface(image);
+    SDL_FreeSurface(screen);
+    SDL_Quit();
+    return result;
+}
+
+/* vi: set ts=4 sw=4 expandtab: */
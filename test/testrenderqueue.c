@@ -0,0 +1,185 @@
+/*
+  Copyright (C) 1997-2020 Sam Lantinga <slouken@libsdl.org>
+
+  This software is provided 'as-is', without any express or implied
+  warranty.  In no event will the authors be held liable for any damages
+  arising from the use of this software.
+
+  Permission is granted to anyone to use this software for any purpose,
+  including commercial applications, and to alter it and redistribute it
+  freely.
+*/
+
+/* Benchmark the software renderer drawing a scene that switches textures a
+   lot, with and without SDL_HINT_RENDER_OPTIMIZE_COMMANDS, and check that
+   both draw the same thing. */
+
+#include <stdlib.h>
+
+#include "SDL.h"
+
+#define WINDOW_WIDTH 640
+#define WINDOW_HEIGHT 480
+#define TILE_SIZE 32
+#define NUM_FRAMES 100
+
+static int num_frames = NUM_FRAMES;
+
+static SDL_Texture *
+LoadTexture(SDL_Renderer *renderer, Uint8 r, Uint8 g, Uint8 b)
+{
+    SDL_Surface *surface = SDL_LoadBMP("icon.bmp");
+    SDL_Texture *texture;
+
+    if (!surface) {
+        SDL_Log("Couldn't load icon.bmp: %s\n", SDL_GetError());
+        return NULL;
+    }
+    /* Set transparent pixel as the pixel at (0,0) */
+    if (surface->format->palette) {
+        SDL_SetColorKey(surface, SDL_TRUE, *(Uint8 *) surface->pixels);
+    }
+    texture = SDL_CreateTextureFromSurface(renderer, surface);
+    SDL_FreeSurface(surface);
+    if (texture) {
+        SDL_SetTextureColorMod(texture, r, g, b);
+    }
+    return texture;
+}
+
+/* A tile map from two tile sheets in a checkerboard, sprites on top,
+   and a status bar drawn with rects */
+static void
+DrawScene(SDL_Renderer *renderer, SDL_Texture *tiles[2], SDL_Texture *sprite, int frame)
+{
+    SDL_Rect rect;
+    int x, y, i;
+
+    rect.w = TILE_SIZE;
+    rect.h = TILE_SIZE;
+    for (y = 0; y < WINDOW_HEIGHT; y += TILE_SIZE) {
+        for (x = 0; x < WINDOW_WIDTH; x += TILE_SIZE) {
+            rect.x = x;
+            rect.y = y;
+            SDL_RenderCopy(renderer, tiles[((x + y) / TILE_SIZE) % 2], NULL, &rect);
+        }
+    }
+
+    for (i = 0; i < 100; ++i) {
+        rect.x = (i * 53 + frame * 3) % (WINDOW_WIDTH - TILE_SIZE);
+        rect.y = (i * 97 + frame * 2) % (WINDOW_HEIGHT - TILE_SIZE);
+        SDL_RenderCopy(renderer, sprite, NULL, &rect);
+    }
+
+    SDL_SetRenderDrawColor(renderer, 0x20, 0x20, 0x20, 0xFF);
+    for (i = 0; i < 20; ++i) {
+        rect.x = i * (WINDOW_WIDTH / 20) + 2;
+        rect.y = WINDOW_HEIGHT - 12;
+        rect.w = WINDOW_WIDTH / 20 - 4;
+        rect.h = 8;
+        SDL_RenderFillRect(renderer, &rect);
+    }
+}
+
+static Uint32 *
+Run(const char *optimize, double *ms, SDL_RenderStats *stats)
+{
+    SDL_Window *window;
+    SDL_Renderer *renderer;
+    SDL_Texture *tiles[2], *sprite;
+    Uint32 *pixels = NULL;
+    Uint64 start;
+    int frame;
+
+    SDL_SetHint(SDL_HINT_RENDER_OPTIMIZE_COMMANDS, optimize);
+
+    window = SDL_CreateWindow("testrenderqueue", SDL_WINDOWPOS_UNDEFINED, SDL_WINDOWPOS_UNDEFINED,
+                              WINDOW_WIDTH, WINDOW_HEIGHT, 0);
+    if (!window) {
+        SDL_Log("Couldn't create window: %s\n", SDL_GetError());
+        return NULL;
+    }
+    renderer = SDL_CreateRenderer(window, -1, 0);
+    if (!renderer) {
+        SDL_Log("Couldn't create renderer: %s\n", SDL_GetError());
+        SDL_DestroyWindow(window);
+        return NULL;
+    }
+
+    tiles[0] = LoadTexture(renderer, 0xFF, 0xFF, 0xFF);
+    tiles[1] = LoadTexture(renderer, 0x80, 0xC0, 0x80);
+    sprite = LoadTexture(renderer, 0xFF, 0x80, 0x40);
+    if (tiles[0] && tiles[1] && sprite) {
+        pixels = (Uint32 *) SDL_malloc(WINDOW_WIDTH * WINDOW_HEIGHT * sizeof (Uint32));
+    }
+
+    if (pixels) {
+        start = SDL_GetPerformanceCounter();
+        for (frame = 0; frame < num_frames; ++frame) {
+            SDL_SetRenderDrawColor(renderer, 0x00, 0x00, 0x00, 0xFF);
+            SDL_RenderClear(renderer);
+            DrawScene(renderer, tiles, sprite, frame);
+            if (frame == 0) {
+                SDL_RenderReadPixels(renderer, NULL, SDL_PIXELFORMAT_ARGB8888, pixels, WINDOW_WIDTH * sizeof (Uint32));
+            }
+            SDL_RenderPresent(renderer);
+        }
+        *ms = (double) ((SDL_GetPerformanceCounter() - start) * 1000) / SDL_GetPerformanceFrequency();
+        SDL_RenderGetStats(renderer, stats);
+    }
+
+    SDL_DestroyRenderer(renderer);
+    SDL_DestroyWindow(window);
+    return pixels;
+}
+
+int
+main(int argc, char *argv[])
+{
+    SDL_RenderStats stats[2];
+    Uint32 *pixels[2];
+    double ms[2];
+    int result = 0;
+
+    /* Enable standard application logging */
+    SDL_LogSetPriority(SDL_LOG_CATEGORY_APPLICATION, SDL_LOG_PRIORITY_INFO);
+
+    if (argc > 1) {
+        num_frames = SDL_atoi(argv[1]);
+        if (num_frames <= 0) {
+            SDL_Log("Usage: %s [frames]\n", argv[0]);
+            return 1;
+        }
+    }
+
+    /* The commands are only optimized when they're batched */
+    SDL_SetHint(SDL_HINT_RENDER_DRIVER, "software");
+    SDL_SetHint(SDL_HINT_RENDER_BATCHING, "1");
+
+    if (SDL_Init(SDL_INIT_VIDEO) < 0) {
+        SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Couldn't initialize SDL: %s\n", SDL_GetError());
+        return 1;
+    }
+
+    pixels[0] = Run("0", &ms[0], &stats[0]);
+    pixels[1] = Run("1", &ms[1], &stats[1]);
+    if (!pixels[0] || !pixels[1]) {
+        result = 1;
+    } else if (SDL_memcmp(pixels[0], pixels[1], WINDOW_WIDTH * WINDOW_HEIGHT * sizeof (Uint32)) != 0) {
+        SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Optimized commands drew something different!\n");
+        result = 1;
+    } else {
+        SDL_Log("%d frames, commands queued/executed, copies and time running commands in the last frame:\n", num_frames);
+        SDL_Log("As queued: %5u/%5u %5u %6u us, total %9.3f ms\n", stats[0].commands_queued, stats[0].commands_executed,
+                stats[0].copies, stats[0].run_time_us, ms[0]);
+        SDL_Log("Optimized: %5u/%5u %5u %6u us, total %9.3f ms\n", stats[1].commands_queued, stats[1].commands_executed,
+                stats[1].copies, stats[1].run_time_us, ms[1]);
+    }
+
+    SDL_free(pixels[0]);
+    SDL_free(pixels[1]);
+    SDL_Quit();
+    return result;
+}
+
+/* vi: set ts=4 sw=4 expandtab: */
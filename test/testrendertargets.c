@@ -0,0 +1,248 @@
+/*
+  Copyright (C) 1997-2020 Sam Lantinga <slouken@libsdl.org>
+
+  This software is provided 'as-is', without any express or implied
+  warranty.  In no event will the authors be held liable for any damages
+  arising from the use of this software.
+
+  Permission is granted to anyone to use this software for any purpose,
+  including commercial applications, and to alter it and redistribute it
+  freely.
+*/
+/* Benchmark switching between many small render targets each frame, the way
+   games draw UI panels and shadow maps, then compositing them to the window. */
+
+#include <stdlib.h>
+#include <stdio.h>
+
+#include "SDL_test_common.h"
+
+#define DEFAULT_TARGETS 48
+#define DEFAULT_TARGET_SIZE 64
+#define SPRITES_PER_TARGET 2
+#define DEFAULT_FRAMES 1000
+
+static SDLTest_CommonState *state;
+static SDL_Renderer *renderer;
+static SDL_Texture *sprite;
+static SDL_Texture **targets;
+static int num_targets = DEFAULT_TARGETS;
+static int target_size = DEFAULT_TARGET_SIZE;
+static int num_frames = DEFAULT_FRAMES;
+static Uint64 switch_time;
+static Uint32 switches;
+
+/* Call this instead of exit(), so we can clean up SDL: atexit() is evil. */
+static void
+quit(int rc)
+{
+    int i;
+
+    if (targets) {
+        for (i = 0; i < num_targets; ++i) {
+            SDL_DestroyTexture(targets[i]);
+        }
+        SDL_free(targets);
+    }
+    SDLTest_CommonQuit(state);
+    exit(rc);
+}
+
+static SDL_Texture *
+LoadTexture(const char *file, SDL_bool transparent)
+{
+    SDL_Surface *temp;
+    SDL_Texture *texture;
+
+    temp = SDL_LoadBMP(file);
+    if (temp == NULL) {
+        SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Couldn't load %s: %s", file, SDL_GetError());
+        return NULL;
+    }
+
+    /* Set transparent pixel as the pixel at (0,0) */
+    if (transparent && temp->format->palette) {
+        SDL_SetColorKey(temp, SDL_TRUE, *(Uint8 *) temp->pixels);
+    }
+
+    texture = SDL_CreateTextureFromSurface(renderer, temp);
+    if (!texture) {
+        SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Couldn't create texture: %s\n", SDL_GetError());
+    }
+    SDL_FreeSurface(temp);
+    return texture;
+}
+
+/* Time only the switches, that's the part that doesn't depend on what's drawn */
+static void
+SetTarget(SDL_Texture *target)
+{
+    const Uint64 start = SDL_GetPerformanceCounter();
+    SDL_SetRenderTarget(renderer, target);
+    switch_time += SDL_GetPerformanceCounter() - start;
+    ++switches;
+}
+
+static void
+DrawPanel(int index, int frame)
+{
+    SDL_Rect clip, rect;
+    int i;
+
+    SetTarget(targets[index]);
+
+    SDL_SetRenderDrawColor(renderer, (Uint8) (index * 5), 0x40, (Uint8) (0xFF - index * 5), 0xFF);
+    SDL_RenderClear(renderer);
+
+    /* Panels clip their contents to a border */
+    clip.x = clip.y = target_size / 16;
+    clip.w = clip.h = target_size - 2 * clip.x;
+    SDL_RenderSetClipRect(renderer, &clip);
+
+    for (i = 0; i < SPRITES_PER_TARGET; ++i) {
+        SDL_QueryTexture(sprite, NULL, NULL, &rect.w, &rect.h);
+        rect.x = ((frame + index * 7 + i * 23) % (target_size + rect.w)) - rect.w;
+        rect.y = ((frame * 2 + index * 3 + i * 17) % (target_size + rect.h)) - rect.h;
+        SDL_RenderCopy(renderer, sprite, NULL, &rect);
+    }
+    SDL_RenderSetClipRect(renderer, NULL);
+}
+
+static void
+loop(int frame)
+{
+    SDL_Rect viewport, rect;
+    int i, columns;
+
+    for (i = 0; i < num_targets; ++i) {
+        DrawPanel(i, frame);
+    }
+    SetTarget(NULL);
+
+    SDL_RenderGetViewport(renderer, &viewport);
+    SDL_SetRenderDrawColor(renderer, 0x20, 0x20, 0x20, 0xFF);
+    SDL_RenderClear(renderer);
+    columns = SDL_max(viewport.w / target_size, 1);
+    for (i = 0; i < num_targets; ++i) {
+        rect.x = (i % columns) * target_size;
+        rect.y = (i / columns) * target_size;
+        rect.w = rect.h = target_size;
+        SDL_RenderCopy(renderer, targets[i], NULL, &rect);
+    }
+}
+
+static Uint32
+Checksum(void)
+{
+    SDL_Rect viewport;
+    Uint32 *pixels;
+    Uint32 checksum = 2166136261u;
+    int i;
+
+    SDL_RenderGetViewport(renderer, &viewport);
+    pixels = (Uint32 *) SDL_malloc(viewport.w * viewport.h * sizeof(*pixels));
+    if (!pixels) {
+        return 0;
+    }
+    if (SDL_RenderReadPixels(renderer, NULL, SDL_PIXELFORMAT_ARGB8888, pixels, viewport.w * sizeof(*pixels)) == 0) {
+        for (i = 0; i < viewport.w * viewport.h; ++i) {
+            checksum = (checksum ^ pixels[i]) * 16777619;
+        }
+    }
+    SDL_free(pixels);
+    return checksum;
+}
+
+int
+main(int argc, char *argv[])
+{
+    SDL_Event event;
+    Uint64 start, elapsed;
+    Uint32 checksum = 0;
+    int i, frame, done = 0;
+
+    /* Enable standard application logging */
+    SDL_LogSetPriority(SDL_LOG_CATEGORY_APPLICATION, SDL_LOG_PRIORITY_INFO);
+
+    /* Initialize test framework */
+    state = SDLTest_CommonCreateState(argv, SDL_INIT_VIDEO);
+    if (!state) {
+        return 1;
+    }
+    for (i = 1; i < argc;) {
+        int consumed;
+
+        consumed = SDLTest_CommonArg(state, i);
+        if (consumed == 0) {
+            consumed = -1;
+            if (SDL_strcasecmp(argv[i], "--targets") == 0 && argv[i + 1]) {
+                num_targets = SDL_atoi(argv[i + 1]);
+                if (num_targets > 0) {
+                    consumed = 2;
+                }
+            } else if (SDL_strcasecmp(argv[i], "--size") == 0 && argv[i + 1]) {
+                target_size = SDL_atoi(argv[i + 1]);
+                if (target_size > 0) {
+                    consumed = 2;
+                }
+            } else if (SDL_strcasecmp(argv[i], "--frames") == 0 && argv[i + 1]) {
+                num_frames = SDL_atoi(argv[i + 1]);
+                if (num_frames > 0) {
+                    consumed = 2;
+                }
+            }
+        }
+        if (consumed < 0) {
+            static const char *options[] = { "[--targets N]", "[--size N]", "[--frames N]", NULL };
+            SDLTest_CommonLogUsage(state, argv[0], options);
+            quit(1);
+        }
+        i += consumed;
+    }
+    if (!SDLTest_CommonInit(state)) {
+        quit(2);
+    }
+    renderer = state->renderers[0];
+
+    sprite = LoadTexture("icon.bmp", SDL_TRUE);
+    targets = (SDL_Texture **) SDL_calloc(num_targets, sizeof(*targets));
+    if (!sprite || !targets) {
+        quit(2);
+    }
+    for (i = 0; i < num_targets; ++i) {
+        targets[i] = SDL_CreateTexture(renderer, SDL_PIXELFORMAT_ARGB8888, SDL_TEXTUREACCESS_TARGET, target_size, target_size);
+        if (!targets[i]) {
+            SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Couldn't create render target texture: %s\n", SDL_GetError());
+            quit(2);
+        }
+        SDL_SetTextureBlendMode(targets[i], SDL_BLENDMODE_BLEND);
+    }
+
+    /* Main render loop */
+    start = SDL_GetPerformanceCounter();
+    for (frame = 0; !done; ++frame) {
+        while (SDL_PollEvent(&event)) {
+            SDLTest_CommonEvent(state, &event, &done);
+        }
+        loop(frame);
+        if (frame + 1 == num_frames) {
+            checksum = Checksum();
+            done = 1;
+        }
+        SDL_RenderPresent(renderer);
+    }
+    elapsed = SDL_GetPerformanceCounter() - start;
+
+    /* Print out some timing information */
+    if (elapsed > 0 && switches > 0) {
+        const double seconds = (double) elapsed / SDL_GetPerformanceFrequency();
+        SDL_Log("%d frames with %d targets: %2.2f frames per second, %.2f us per target switch, checksum %08X\n",
+                frame, num_targets, frame / seconds,
+                (double) (switch_time * 1000000) / SDL_GetPerformanceFrequency() / switches, checksum);
+    }
+
+    quit(0);
+    return 0;
+}
+
+/* vi: set ts=4 sw=4 expandtab: */
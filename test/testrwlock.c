@@ -0,0 +1,189 @@
+/*
+  Copyright (C) 1997-2020 Sam Lantinga <slouken@libsdl.org>
+
+  This software is provided 'as-is', without any express or implied
+  warranty.  In no event will the authors be held liable for any damages
+  arising from the use of this software.
+
+  Permission is granted to anyone to use this software for any purpose,
+  including commercial applications, and to alter it and redistribute it
+  freely.
+*/
+
+/* Benchmark readers of read-mostly data behind a mutex and a reader-writer
+   lock, with a writer occasionally updating the data, and then the same
+   kind of readers going through the joystick API. */
+
+#include <stdlib.h>
+
+#include "SDL.h"
+
+#define NUM_READERS 4
+#define NUM_READS 200000
+#define NUM_VALUES 16
+
+static SDL_mutex *mutex;
+static SDL_rwlock *rwlock;
+static int values[NUM_VALUES];
+static SDL_atomic_t readers_done;
+static SDL_atomic_t mismatches;
+
+static void
+Lock(SDL_bool writing)
+{
+    if (!rwlock) {
+        SDL_LockMutex(mutex);
+    } else if (writing) {
+        SDL_LockRWLockForWriting(rwlock);
+    } else {
+        SDL_LockRWLockForReading(rwlock);
+    }
+}
+
+static void
+Unlock(void)
+{
+    if (rwlock) {
+        SDL_UnlockRWLock(rwlock);
+    } else {
+        SDL_UnlockMutex(mutex);
+    }
+}
+
+static int SDLCALL
+Reader(void *data)
+{
+    int i, j;
+
+    for (i = 0; i < NUM_READS; ++i) {
+        Lock(SDL_FALSE);
+        /* The writer changes every value at once, so they should all match */
+        for (j = 1; j < NUM_VALUES; ++j) {
+            if (values[j] != values[0]) {
+                SDL_AtomicIncRef(&mismatches);
+                break;
+            }
+        }
+        Unlock();
+    }
+    SDL_AtomicIncRef(&readers_done);
+    return 0;
+}
+
+static int SDLCALL
+Writer(void *data)
+{
+    int i;
+
+    while (SDL_AtomicGet(&readers_done) < NUM_READERS) {
+        Lock(SDL_TRUE);
+        for (i = 0; i < NUM_VALUES; ++i) {
+            ++values[i];
+        }
+        Unlock();
+        SDL_Delay(1);
+    }
+    return 0;
+}
+
+static double
+RunReaders(SDL_ThreadFunction reader, SDL_ThreadFunction writer)
+{
+    SDL_Thread *threads[NUM_READERS + 1];
+    Uint64 start;
+    int i;
+
+    SDL_AtomicSet(&readers_done, 0);
+    start = SDL_GetPerformanceCounter();
+    for (i = 0; i < NUM_READERS; ++i) {
+        threads[i] = SDL_CreateThread(reader, "Reader", NULL);
+    }
+    threads[NUM_READERS] = SDL_CreateThread(writer, "Writer", NULL);
+    for (i = 0; i <= NUM_READERS; ++i) {
+        SDL_WaitThread(threads[i], NULL);
+    }
+    return (double) ((SDL_GetPerformanceCounter() - start) * 1000) / SDL_GetPerformanceFrequency();
+}
+
+static SDL_JoystickID joystick_id;
+
+/* The kind of lookups an input thread makes for each event */
+static int SDLCALL
+JoystickReader(void *data)
+{
+    int i;
+
+    for (i = 0; i < NUM_READS; ++i) {
+        SDL_Joystick *joystick = SDL_JoystickFromInstanceID(joystick_id);
+        if (joystick) {
+            SDL_JoystickGetAxis(joystick, 0);
+        } else {
+            SDL_NumJoysticks();
+        }
+    }
+    SDL_AtomicIncRef(&readers_done);
+    return 0;
+}
+
+static int SDLCALL
+JoystickWriter(void *data)
+{
+    while (SDL_AtomicGet(&readers_done) < NUM_READERS) {
+        SDL_JoystickUpdate();
+        SDL_Delay(1);
+    }
+    return 0;
+}
+
+int
+main(int argc, char *argv[])
+{
+    SDL_Joystick *joystick = NULL;
+    double ms;
+
+    /* Enable standard application logging */
+    SDL_LogSetPriority(SDL_LOG_CATEGORY_APPLICATION, SDL_LOG_PRIORITY_INFO);
+
+    if (SDL_Init(SDL_INIT_JOYSTICK) < 0) {
+        SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Couldn't initialize SDL: %s\n", SDL_GetError());
+        return 1;
+    }
+
+    SDL_Log("%d readers doing %d reads each, on %d CPUs\n", NUM_READERS, NUM_READS, SDL_GetCPUCount());
+
+    mutex = SDL_CreateMutex();
+    ms = RunReaders(Reader, Writer);
+    SDL_Log("Mutex:              %9.3f ms\n", ms);
+    SDL_DestroyMutex(mutex);
+
+    rwlock = SDL_CreateRWLock();
+    if (!rwlock) {
+        SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Couldn't create rwlock: %s\n", SDL_GetError());
+        SDL_Quit();
+        return 1;
+    }
+    ms = RunReaders(Reader, Writer);
+    SDL_Log("Reader-writer lock: %9.3f ms\n", ms);
+    SDL_DestroyRWLock(rwlock);
+
+    if (SDL_AtomicGet(&mismatches) > 0) {
+        SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Readers saw a partial update %d times!\n", SDL_AtomicGet(&mismatches));
+        SDL_Quit();
+        return 1;
+    }
+
+    if (SDL_NumJoysticks() > 0) {
+        joystick = SDL_JoystickOpen(0);
+    }
+    joystick_id = joystick ? SDL_JoystickInstanceID(joystick) : -1;
+    ms = RunReaders(JoystickReader, JoystickWriter);
+    SDL_Log("Joystick lookups:   %9.3f ms (%s)\n", ms, joystick ? SDL_JoystickName(joystick) : "no joystick");
+    if (joystick) {
+        SDL_JoystickClose(joystick);
+    }
+
+    SDL_Quit();
+    return 0;
+}
+
+/* vi: set ts=4 sw=4 expandtab: */
@@ -19,6 +19,9 @@
 #include "SDL.h"
 
 #define NUM_THREADS 10
+#define NUM_OVERHEAD_OPS 10000
+#define NUM_OVERHEAD_OPS_MULT 10
+#define NUM_CONTENDED_THREADS 4
 
 static SDL_sem *sem;
 int alive = 1;
@@ -75,6 +78,101 @@ TestWaitTimeout(void)
         SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "SDL_SemWaitTimeout returned: %d; expected: %d\n", retval, SDL_MUTEX_TIMEDOUT);
 }
 
+static void
+TestOverheadUncontended(void)
+{
+    Uint64 start;
+    double ms;
+    int i, j;
+
+    sem = SDL_CreateSemaphore(0);
+    SDL_Log("Doing %d uncontended Post/Wait operations on semaphore\n", NUM_OVERHEAD_OPS * NUM_OVERHEAD_OPS_MULT);
+
+    start = SDL_GetPerformanceCounter();
+    for (i = 0; i < NUM_OVERHEAD_OPS_MULT; i++) {
+        for (j = 0; j < NUM_OVERHEAD_OPS; j++) {
+            SDL_SemPost(sem);
+        }
+        for (j = 0; j < NUM_OVERHEAD_OPS; j++) {
+            SDL_SemWait(sem);
+        }
+    }
+    ms = (double) ((SDL_GetPerformanceCounter() - start) * 1000) / SDL_GetPerformanceFrequency();
+    SDL_Log("Took %.3f milliseconds, %.1f ns per operation\n", ms,
+            (ms * 1000000.0) / (NUM_OVERHEAD_OPS * NUM_OVERHEAD_OPS_MULT * 2));
+
+    SDL_DestroySemaphore(sem);
+}
+
+static SDL_atomic_t contended_done;
+
+int SDLCALL
+ThreadFuncOverheadContended(void *data)
+{
+    SDL_bool try_wait = *(SDL_bool *) data;
+    int taken = 0;
+
+    while (!SDL_AtomicGet(&contended_done)) {
+        if (try_wait) {
+            if (SDL_SemTryWait(sem) == 0) {
+                ++taken;
+            }
+        } else if (SDL_SemWaitTimeout(sem, 10) == 0) {
+            ++taken;
+        }
+    }
+    return taken;
+}
+
+static void
+TestOverheadContended(SDL_bool try_wait)
+{
+    SDL_Thread *threads[NUM_CONTENDED_THREADS];
+    Uint64 start;
+    double ms;
+    int i, j, taken, status;
+
+    sem = SDL_CreateSemaphore(0);
+    SDL_AtomicSet(&contended_done, 0);
+    SDL_Log("Doing %d contended %s operations on semaphore using %d threads\n",
+            NUM_OVERHEAD_OPS * NUM_OVERHEAD_OPS_MULT, try_wait ? "Post/TryWait" : "Post/WaitTimeout",
+            NUM_CONTENDED_THREADS);
+
+    for (i = 0; i < NUM_CONTENDED_THREADS; i++) {
+        char name[64];
+        SDL_snprintf(name, sizeof (name), "Contended%d", i);
+        threads[i] = SDL_CreateThread(ThreadFuncOverheadContended, name, &try_wait);
+    }
+
+    start = SDL_GetPerformanceCounter();
+    for (i = 0; i < NUM_OVERHEAD_OPS_MULT; i++) {
+        for (j = 0; j < NUM_OVERHEAD_OPS; j++) {
+            SDL_SemPost(sem);
+        }
+        /* Let the threads catch up before posting more */
+        while (SDL_SemValue(sem) > 0) {
+            SDL_Delay(0);
+        }
+    }
+    ms = (double) ((SDL_GetPerformanceCounter() - start) * 1000) / SDL_GetPerformanceFrequency();
+
+    SDL_AtomicSet(&contended_done, 1);
+    taken = 0;
+    for (i = 0; i < NUM_CONTENDED_THREADS; i++) {
+        SDL_WaitThread(threads[i], &status);
+        taken += status;
+    }
+
+    SDL_Log("Took %.3f milliseconds, %.1f ns per operation\n", ms,
+            (ms * 1000000.0) / (NUM_OVERHEAD_OPS * NUM_OVERHEAD_OPS_MULT));
+    if (taken != NUM_OVERHEAD_OPS * NUM_OVERHEAD_OPS_MULT) {
+        SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Threads took the semaphore %d times; expected: %d\n",
+                     taken, NUM_OVERHEAD_OPS * NUM_OVERHEAD_OPS_MULT);
+    }
+
+    SDL_DestroySemaphore(sem);
+}
+
 int
 main(int argc, char **argv)
 {
@@ -125,6 +223,12 @@ main(int argc, char **argv)
 
     TestWaitTimeout();
 
+    TestOverheadUncontended();
+
+    TestOverheadContended(SDL_FALSE);
+
+    TestOverheadContended(SDL_TRUE);
+
     SDL_Quit();
     return (0);
 }
@@ -24,6 +24,7 @@
 
 #define NUM_SPRITES    100
 #define MAX_SPEED     1
+#define NUM_CAPTURE_BUFFERS 3
 
 static SDLTest_CommonState *state;
 static int num_sprites;
@@ -35,6 +36,8 @@ static int current_alpha = 0;
 static int current_color = 0;
 static SDL_Rect *positions;
 static SDL_Rect *velocities;
+static SDL_FRect *batch_rects;
+static SDL_bool use_batch;
 static int sprite_w, sprite_h;
 static SDL_BlendMode blendMode = SDL_BLENDMODE_BLEND;
 static Uint32 next_fps_check, frames;
@@ -44,15 +47,39 @@ static const Uint32 fps_check_delay = 5000;
 /* -1: infinite random moves (default); >=0: enables N deterministic moves */
 static int iterations = -1;
 
+/* Number of frames to draw before quitting, or -1 to keep going */
+static int max_frames = -1;
+
+/* Read back every frame, the way a screen recorder would */
+static SDL_bool capture;
+static SDL_bool capture_async;
+static SDL_RenderReadback **readbacks;
+static Uint8 *capture_pixels;
+static Uint32 captured_frames;
+static Uint64 captured_bytes;
+static Uint32 capture_checksum;
+static Uint64 capture_time;
+static Uint64 capture_start;
+
 int done;
 
 /* Call this instead of exit(), so we can clean up SDL: atexit() is evil. */
 static void
 quit(int rc)
 {
+    int i;
+
+    if (readbacks) {
+        for (i = 0; i < state->num_windows; ++i) {
+            SDL_DestroyRenderReadback(readbacks[i]);
+        }
+        SDL_free(readbacks);
+    }
+    SDL_free(capture_pixels);
     SDL_free(sprites);
     SDL_free(positions);
     SDL_free(velocities);
+    SDL_free(batch_rects);
     SDLTest_CommonQuit(state);
     exit(rc);
 }
@@ -114,6 +141,117 @@ LoadSprite(const char *file)
     return (0);
 }
 
+/* What the screen recorder would do with the frame: encode it, save it... */
+static void
+ConsumeFrame(const SDL_Rect *rect, const void *pixels, int pitch)
+{
+    const Uint8 *row = (const Uint8 *) pixels;
+    const int length = rect->w * 3;
+    int x, y;
+
+    for (y = 0; y < rect->h; ++y) {
+        for (x = 0; x + 4 <= length; x += 4) {
+            capture_checksum = (capture_checksum ^ *(const Uint32 *) (row + x)) * 16777619;
+        }
+        for (; x < length; ++x) {
+            capture_checksum = (capture_checksum ^ row[x]) * 16777619;
+        }
+        row += pitch;
+    }
+    ++captured_frames;
+    captured_bytes += (Uint64) rect->w * rect->h * 3;
+}
+
+/* Get the next frame read back, counting the time spent waiting for it */
+static int
+GetReadback(SDL_RenderReadback *readback, SDL_RenderReadbackFrame *frame, Sint32 timeout)
+{
+    const Uint64 start = SDL_GetPerformanceCounter();
+    const int retval = SDL_GetRenderReadback(readback, frame, timeout);
+
+    capture_time += SDL_GetPerformanceCounter() - start;
+    return retval;
+}
+
+static void
+ConsumeReadback(SDL_RenderReadback *readback, Sint32 timeout)
+{
+    SDL_RenderReadbackFrame frame;
+
+    while (GetReadback(readback, &frame, timeout) == 1) {
+        ConsumeFrame(&frame.rect, frame.pixels, frame.pitch);
+        SDL_ReleaseRenderReadback(readback, &frame);
+    }
+}
+
+static void
+CaptureFrame(SDL_Renderer * renderer)
+{
+    SDL_RenderReadback *readback = NULL;
+    SDL_Rect rect;
+    Uint64 start;
+    int i, result;
+
+    for (i = 0; i < state->num_windows; ++i) {
+        if (state->renderers[i] == renderer) {
+            readback = readbacks ? readbacks[i] : NULL;
+        }
+    }
+
+    /* Draw the frame first, so only the time spent reading it is counted */
+    SDL_RenderFlush(renderer);
+
+    if (readback) {
+        /* Wait for the oldest frame if all the buffers are busy */
+        for ( ; ; ) {
+            SDL_RenderReadbackFrame frame;
+
+            start = SDL_GetPerformanceCounter();
+            result = SDL_RenderReadPixelsAsync(readback, NULL);
+            capture_time += SDL_GetPerformanceCounter() - start;
+            if (result >= 0) {
+                break;
+            }
+            if (GetReadback(readback, &frame, -1) != 1) {
+                SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Couldn't read back frame: %s\n", SDL_GetError());
+                break;
+            }
+            ConsumeFrame(&frame.rect, frame.pixels, frame.pitch);
+            SDL_ReleaseRenderReadback(readback, &frame);
+        }
+        ConsumeReadback(readback, 0);
+    } else {
+        SDL_RenderGetViewport(renderer, &rect);
+        rect.x = rect.y = 0;
+        start = SDL_GetPerformanceCounter();
+        result = SDL_RenderReadPixels(renderer, NULL, SDL_PIXELFORMAT_RGB24, capture_pixels, state->window_w * 3);
+        capture_time += SDL_GetPerformanceCounter() - start;
+        if (result == 0) {
+            ConsumeFrame(&rect, capture_pixels, state->window_w * 3);
+        }
+    }
+}
+
+static void
+ReportCapture(void)
+{
+    const double seconds = (double) (SDL_GetPerformanceCounter() - capture_start) / SDL_GetPerformanceFrequency();
+    const double capture_seconds = (double) capture_time / SDL_GetPerformanceFrequency();
+    int i;
+
+    if (capture_async) {
+        for (i = 0; i < state->num_windows; ++i) {
+            ConsumeReadback(readbacks[i], -1);
+        }
+    }
+    SDL_Log("Captured %u frames (%.1f MB) %s in %.3f s: %.2f frames per second, %.1f MB/s, "
+            "%.3f s waiting for pixels, checksum %08X\n",
+            (unsigned int) captured_frames, captured_bytes / (1024.0 * 1024.0),
+            capture_async ? "asynchronously" : "synchronously", seconds,
+            captured_frames / seconds, captured_bytes / (1024.0 * 1024.0) / seconds,
+            capture_seconds, (unsigned int) capture_checksum);
+}
+
 void
 MoveSprites(SDL_Renderer * renderer, SDL_Texture * sprite)
 {
@@ -232,11 +370,26 @@ MoveSprites(SDL_Renderer * renderer, SDL_Texture * sprite)
     }
 
     /* Draw sprites */
-    for (i = 0; i < num_sprites; ++i) {
-        position = &positions[i];
+    if (use_batch) {
+        /* Blit all the sprites onto the screen in one call */
+        for (i = 0; i < num_sprites; ++i) {
+            batch_rects[i].x = (float) positions[i].x;
+            batch_rects[i].y = (float) positions[i].y;
+            batch_rects[i].w = (float) positions[i].w;
+            batch_rects[i].h = (float) positions[i].h;
+        }
+        SDL_RenderCopyBatch(renderer, sprite, NULL, batch_rects, NULL, NULL, NULL, num_sprites);
+    } else {
+        for (i = 0; i < num_sprites; ++i) {
+            position = &positions[i];
+
+            /* Blit the sprite onto the screen */
+            SDL_RenderCopy(renderer, sprite, NULL, position);
+        }
+    }
 
-        /* Blit the sprite onto the screen */
-        SDL_RenderCopy(renderer, sprite, NULL, position);
+    if (capture) {
+        CaptureFrame(renderer);
     }
 
     /* Update the screen! */
@@ -266,6 +419,9 @@ loop()
 #endif
 
     frames++;
+    if (max_frames > 0 && --max_frames == 0) {
+        done = 1;
+    }
     now = SDL_GetTicks();
     if (SDL_TICKS_PASSED(now, next_fps_check)) {
         /* Print out some timing information */
@@ -325,12 +481,31 @@ main(int argc, char *argv[])
                     if (iterations < -1) iterations = -1;
                     consumed = 2;
                 }
+            } else if (SDL_strcasecmp(argv[i], "--frames") == 0) {
+                if (argv[i + 1]) {
+                    max_frames = SDL_atoi(argv[i + 1]);
+                    consumed = 2;
+                }
+            } else if (SDL_strcasecmp(argv[i], "--capture") == 0) {
+                if (argv[i + 1]) {
+                    if (SDL_strcasecmp(argv[i + 1], "sync") == 0) {
+                        capture = SDL_TRUE;
+                        consumed = 2;
+                    } else if (SDL_strcasecmp(argv[i + 1], "async") == 0) {
+                        capture = SDL_TRUE;
+                        capture_async = SDL_TRUE;
+                        consumed = 2;
+                    }
+                }
             } else if (SDL_strcasecmp(argv[i], "--cyclecolor") == 0) {
                 cycle_color = SDL_TRUE;
                 consumed = 1;
             } else if (SDL_strcasecmp(argv[i], "--cyclealpha") == 0) {
                 cycle_alpha = SDL_TRUE;
                 consumed = 1;
+            } else if (SDL_strcasecmp(argv[i], "--batch") == 0) {
+                use_batch = SDL_TRUE;
+                consumed = 1;
             } else if (SDL_isdigit(*argv[i])) {
                 num_sprites = SDL_atoi(argv[i]);
                 consumed = 1;
@@ -340,7 +515,7 @@ main(int argc, char *argv[])
             }
         }
         if (consumed < 0) {
-            static const char *options[] = { "[--blend none|blend|add|mod]", "[--cyclecolor]", "[--cyclealpha]", "[--iterations N]", "[num_sprites]", "[icon.bmp]", NULL };
+            static const char *options[] = { "[--blend none|blend|add|mod]", "[--cyclecolor]", "[--cyclealpha]", "[--batch]", "[--iterations N]", "[--frames N]", "[--capture sync|async]", "[num_sprites]", "[icon.bmp]", NULL };
             SDLTest_CommonLogUsage(state, argv[0], options);
             quit(1);
         }
@@ -366,10 +541,32 @@ main(int argc, char *argv[])
         quit(2);
     }
 
+    if (capture_async) {
+        readbacks = (SDL_RenderReadback **) SDL_calloc(state->num_windows, sizeof(*readbacks));
+        if (!readbacks) {
+            SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Out of memory!\n");
+            quit(2);
+        }
+        for (i = 0; i < state->num_windows; ++i) {
+            readbacks[i] = SDL_CreateRenderReadback(state->renderers[i], SDL_PIXELFORMAT_RGB24, NUM_CAPTURE_BUFFERS);
+            if (!readbacks[i]) {
+                SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Couldn't create readback: %s\n", SDL_GetError());
+                quit(2);
+            }
+        }
+    } else if (capture) {
+        capture_pixels = (Uint8 *) SDL_malloc(state->window_w * state->window_h * 3);
+        if (!capture_pixels) {
+            SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Out of memory!\n");
+            quit(2);
+        }
+    }
+
     /* Allocate memory for the sprite info */
     positions = (SDL_Rect *) SDL_malloc(num_sprites * sizeof(SDL_Rect));
     velocities = (SDL_Rect *) SDL_malloc(num_sprites * sizeof(SDL_Rect));
-    if (!positions || !velocities) {
+    batch_rects = (SDL_FRect *) SDL_malloc(num_sprites * sizeof(SDL_FRect));
+    if (!positions || !velocities || !batch_rects) {
         SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Out of memory!\n");
         quit(2);
     }
@@ -399,6 +596,7 @@ main(int argc, char *argv[])
     /* Main render loop */
     frames = 0;
     next_fps_check = SDL_GetTicks() + fps_check_delay;
+    capture_start = SDL_GetPerformanceCounter();
     done = 0;
 
 #ifdef __EMSCRIPTEN__
@@ -409,6 +607,10 @@ main(int argc, char *argv[])
     }
 #endif
 
+    if (capture) {
+        ReportCapture();
+    }
+
     quit(0);
     return 0;
 }
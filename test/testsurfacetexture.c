@@ -0,0 +1,368 @@
+/*
+  Copyright (C) 1997-2020 Sam Lantinga <slouken@libsdl.org>
+
+  This software is provided 'as-is', without any express or implied
+  warranty.  In no event will the authors be held liable for any damages
+  arising from the use of this software.
+
+  Permission is granted to anyone to use this software for any purpose,
+  including commercial applications, and to alter it and redistribute it
+  freely.
+*/
+
+/* Benchmark streaming a large image that changes a little each frame to the
+   software renderer: uploading all of it, uploading the part that changed,
+   and drawing it from a texture that shares the surface's pixels. */
+
+#include <stdlib.h>
+
+#include "SDL.h"
+
+#define WINDOW_WIDTH 640
+#define WINDOW_HEIGHT 480
+#define IMAGE_SIZE 2048
+#define DIRTY_SIZE 128
+#define NUM_FRAMES 200
+
+typedef enum
+{
+    UPDATE_WHOLE,
+    UPDATE_DIRTY,
+    SHARE_SURFACE,
+    NUM_METHODS
+} Method;
+
+static const char *method_names[NUM_METHODS] = {
+    "Upload whole image",
+    "Upload changed area",
+    "Share surface"
+};
+
+static int num_frames = NUM_FRAMES;
+
+/* Count what's allocated while creating textures */
+static SDL_malloc_func real_malloc;
+static SDL_calloc_func real_calloc;
+static SDL_realloc_func real_realloc;
+static SDL_free_func real_free;
+static SDL_bool counting;
+static size_t allocated;
+
+static void * SDLCALL
+CountingMalloc(size_t size)
+{
+    if (counting) {
+        allocated += size;
+    }
+    return real_malloc(size);
+}
+
+static void * SDLCALL
+CountingCalloc(size_t nmemb, size_t size)
+{
+    if (counting) {
+        allocated += nmemb * size;
+    }
+    return real_calloc(nmemb, size);
+}
+
+static void * SDLCALL
+CountingRealloc(void *mem, size_t size)
+{
+    if (counting) {
+        allocated += size;
+    }
+    return real_realloc(mem, size);
+}
+
+static void SDLCALL
+CountingFree(void *mem)
+{
+    real_free(mem);
+}
+
+static double
+Elapsed(Uint64 start)
+{
+    return (double) ((SDL_GetPerformanceCounter() - start) * 1000) / SDL_GetPerformanceFrequency();
+}
+
+static void
+FillImage(SDL_Surface *surface)
+{
+    int x, y;
+
+    for (y = 0; y < surface->h; ++y) {
+        Uint32 *row = (Uint32 *) ((Uint8 *) surface->pixels + y * surface->pitch);
+        for (x = 0; x < surface->w; ++x) {
+            row[x] = 0xFF000000 | ((x & 0xFF) << 16) | ((y & 0xFF) << 8) | ((x ^ y) & 0xFF);
+        }
+    }
+}
+
+/* The part of the image shown this frame, and a square in it that changes */
+static void
+ChangeImage(SDL_Surface *surface, int frame, SDL_Rect *view, SDL_Rect *dirty)
+{
+    int x, y;
+
+    view->x = (frame * 7) % (IMAGE_SIZE - WINDOW_WIDTH);
+    view->y = (frame * 5) % (IMAGE_SIZE - WINDOW_HEIGHT);
+    view->w = WINDOW_WIDTH;
+    view->h = WINDOW_HEIGHT;
+
+    dirty->x = view->x + (frame * 13) % (WINDOW_WIDTH - DIRTY_SIZE);
+    dirty->y = view->y + (frame * 11) % (WINDOW_HEIGHT - DIRTY_SIZE);
+    dirty->w = DIRTY_SIZE;
+    dirty->h = DIRTY_SIZE;
+
+    for (y = dirty->y; y < dirty->y + dirty->h; ++y) {
+        Uint32 *row = (Uint32 *) ((Uint8 *) surface->pixels + y * surface->pitch);
+        for (x = dirty->x; x < dirty->x + dirty->w; ++x) {
+            row[x] = 0xFF000000 | ((frame * 3) & 0xFF) << 16 | ((x + frame) & 0xFF) << 8 | (y & 0xFF);
+        }
+    }
+}
+
+static Uint32 *
+Run(Method method, double *upload_ms, double *total_ms, size_t *texture_bytes, SDL_RenderStats *stats)
+{
+    SDL_Window *window;
+    SDL_Renderer *renderer;
+    SDL_Surface *surface;
+    SDL_Texture *texture = NULL;
+    Uint32 *pixels = NULL;
+    SDL_Rect view, dirty;
+    Uint64 start, upload_start;
+    Uint64 upload_time = 0;
+    int frame;
+
+    window = SDL_CreateWindow("testsurfacetexture", SDL_WINDOWPOS_UNDEFINED, SDL_WINDOWPOS_UNDEFINED,
+                              WINDOW_WIDTH, WINDOW_HEIGHT, 0);
+    if (!window) {
+        SDL_Log("Couldn't create window: %s\n", SDL_GetError());
+        return NULL;
+    }
+    renderer = SDL_CreateRenderer(window, -1, 0);
+    if (!renderer) {
+        SDL_Log("Couldn't create renderer: %s\n", SDL_GetError());
+        SDL_DestroyWindow(window);
+        return NULL;
+    }
+
+    surface = SDL_CreateRGBSurfaceWithFormat(0, IMAGE_SIZE, IMAGE_SIZE, 32, SDL_PIXELFORMAT_ARGB8888);
+    if (surface) {
+        FillImage(surface);
+
+        allocated = 0;
+        counting = SDL_TRUE;
+        if (method == SHARE_SURFACE) {
+            texture = SDL_CreateSurfaceTexture(renderer, surface);
+        } else {
+            texture = SDL_CreateTextureFromSurface(renderer, surface);
+        }
+        counting = SDL_FALSE;
+        *texture_bytes = allocated;
+    }
+    if (texture) {
+        pixels = (Uint32 *) SDL_malloc(WINDOW_WIDTH * WINDOW_HEIGHT * sizeof (Uint32));
+    } else {
+        SDL_Log("Couldn't create texture: %s\n", SDL_GetError());
+    }
+
+    if (pixels) {
+        start = SDL_GetPerformanceCounter();
+        for (frame = 0; frame < num_frames; ++frame) {
+            ChangeImage(surface, frame, &view, &dirty);
+
+            upload_start = SDL_GetPerformanceCounter();
+            switch (method) {
+                case UPDATE_WHOLE:
+                    SDL_UpdateTexture(texture, NULL, surface->pixels, surface->pitch);
+                    break;
+                case UPDATE_DIRTY:
+                    SDL_UpdateTexture(texture, &dirty,
+                                      (Uint8 *) surface->pixels + dirty.y * surface->pitch + dirty.x * 4,
+                                      surface->pitch);
+                    break;
+                default:
+                    SDL_UpdateSurfaceTexture(texture, &dirty);
+                    break;
+            }
+            upload_time += SDL_GetPerformanceCounter() - upload_start;
+
+            SDL_RenderCopy(renderer, texture, &view, NULL);
+            if (frame == num_frames - 1) {
+                SDL_RenderReadPixels(renderer, NULL, SDL_PIXELFORMAT_ARGB8888, pixels, WINDOW_WIDTH * sizeof (Uint32));
+            }
+            SDL_RenderPresent(renderer);
+        }
+        *total_ms = Elapsed(start);
+        *upload_ms = (double) (upload_time * 1000) / SDL_GetPerformanceFrequency();
+        SDL_RenderGetStats(renderer, stats);
+    }
+
+    SDL_DestroyTexture(texture);
+    SDL_FreeSurface(surface);
+    SDL_DestroyRenderer(renderer);
+    SDL_DestroyWindow(window);
+    return pixels;
+}
+
+/* A surface texture keeps its surface alive, and surfaces the renderer
+   can't share are copied and updated like SDL_CreateTextureFromSurface() */
+static int
+TestSurfaceTextures(void)
+{
+    SDL_Surface *surface, *target, *expected;
+    SDL_Renderer *renderer;
+    SDL_Texture *texture, *reference;
+    SDL_Rect dirty;
+    int result = 0;
+
+    target = SDL_CreateRGBSurfaceWithFormat(0, 64, 64, 32, SDL_PIXELFORMAT_ARGB8888);
+    expected = SDL_CreateRGBSurfaceWithFormat(0, 64, 64, 32, SDL_PIXELFORMAT_ARGB8888);
+    renderer = target ? SDL_CreateSoftwareRenderer(target) : NULL;
+    if (!renderer || !expected) {
+        SDL_Log("Couldn't create software renderer: %s\n", SDL_GetError());
+        SDL_FreeSurface(target);
+        SDL_FreeSurface(expected);
+        return -1;
+    }
+
+    /* Draw after the application has freed the surface */
+    surface = SDL_CreateRGBSurfaceWithFormat(0, 64, 64, 32, SDL_PIXELFORMAT_ARGB8888);
+    if (surface) {
+        FillImage(surface);
+        SDL_BlitSurface(surface, NULL, expected, NULL);
+    }
+    texture = surface ? SDL_CreateSurfaceTexture(renderer, surface) : NULL;
+    SDL_FreeSurface(surface);
+    SDL_SetRenderDrawColor(renderer, 0, 0, 0, 0xFF);
+    SDL_RenderClear(renderer);
+    SDL_RenderCopy(renderer, texture, NULL, NULL);
+    SDL_RenderFlush(renderer);
+    if (!texture || SDL_memcmp(target->pixels, expected->pixels, 64 * target->pitch) != 0) {
+        SDL_Log("Drawing a surface texture after freeing its surface failed\n");
+        result = -1;
+    }
+    SDL_DestroyTexture(texture);
+
+    /* A color keyed surface is converted to a texture with alpha */
+    surface = SDL_CreateRGBSurfaceWithFormat(0, 64, 64, 32, SDL_PIXELFORMAT_RGB888);
+    if (surface) {
+        FillImage(surface);
+        SDL_SetColorKey(surface, SDL_TRUE, 0);
+        texture = SDL_CreateSurfaceTexture(renderer, surface);
+        dirty.x = 10;
+        dirty.y = 24;
+        dirty.w = 30;
+        dirty.h = 4;
+        SDL_FillRect(surface, &dirty, 0);
+        dirty.y = 20;
+        SDL_FillRect(surface, &dirty, SDL_MapRGB(surface->format, 0x80, 0x40, 0x20));
+        dirty.h = 8;
+        if (SDL_UpdateSurfaceTexture(texture, &dirty) < 0) {
+            SDL_Log("SDL_UpdateSurfaceTexture() failed: %s\n", SDL_GetError());
+            result = -1;
+        }
+
+        reference = SDL_CreateTextureFromSurface(renderer, surface);
+        SDL_SetRenderDrawColor(renderer, 0x10, 0x20, 0x30, 0xFF);
+        SDL_RenderClear(renderer);
+        SDL_RenderCopy(renderer, reference, NULL, NULL);
+        SDL_RenderFlush(renderer);
+        SDL_BlitSurface(target, NULL, expected, NULL);
+        SDL_RenderClear(renderer);
+        SDL_RenderCopy(renderer, texture, NULL, NULL);
+        SDL_RenderFlush(renderer);
+        if (!texture || !reference || SDL_memcmp(target->pixels, expected->pixels, 64 * target->pitch) != 0) {
+            SDL_Log("Updating a color keyed surface texture failed\n");
+            result = -1;
+        }
+        SDL_DestroyTexture(reference);
+
+        /* Ordinary textures can't be updated from a surface */
+        reference = SDL_CreateTextureFromSurface(renderer, surface);
+        if (!reference || SDL_UpdateSurfaceTexture(reference, NULL) == 0) {
+            SDL_Log("SDL_UpdateSurfaceTexture() accepted an ordinary texture\n");
+            result = -1;
+        }
+        SDL_DestroyTexture(reference);
+        SDL_DestroyTexture(texture);
+        SDL_FreeSurface(surface);
+    }
+
+    SDL_DestroyRenderer(renderer);
+    SDL_FreeSurface(target);
+    SDL_FreeSurface(expected);
+
+    if (result == 0) {
+        SDL_Log("Surface textures OK\n");
+    }
+    return result;
+}
+
+int
+main(int argc, char *argv[])
+{
+    SDL_RenderStats stats[NUM_METHODS];
+    Uint32 *pixels[NUM_METHODS];
+    double upload_ms[NUM_METHODS], total_ms[NUM_METHODS];
+    size_t texture_bytes[NUM_METHODS];
+    int i, result = 0;
+
+    SDL_GetMemoryFunctions(&real_malloc, &real_calloc, &real_realloc, &real_free);
+    SDL_SetMemoryFunctions(CountingMalloc, CountingCalloc, CountingRealloc, CountingFree);
+
+    /* Enable standard application logging */
+    SDL_LogSetPriority(SDL_LOG_CATEGORY_APPLICATION, SDL_LOG_PRIORITY_INFO);
+
+    if (argc > 1) {
+        num_frames = SDL_atoi(argv[1]);
+        if (num_frames <= 0) {
+            SDL_Log("Usage: %s [frames]\n", argv[0]);
+            return 1;
+        }
+    }
+
+    SDL_SetHint(SDL_HINT_RENDER_DRIVER, "software");
+
+    if (SDL_Init(SDL_INIT_VIDEO) < 0) {
+        SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Couldn't initialize SDL: %s\n", SDL_GetError());
+        return 1;
+    }
+
+    if (TestSurfaceTextures() < 0) {
+        result = 1;
+    }
+
+    for (i = 0; i < NUM_METHODS; ++i) {
+        pixels[i] = Run((Method) i, &upload_ms[i], &total_ms[i], &texture_bytes[i], &stats[i]);
+        if (!pixels[i]) {
+            result = 1;
+        } else if (i > 0 && pixels[0] &&
+                   SDL_memcmp(pixels[0], pixels[i], WINDOW_WIDTH * WINDOW_HEIGHT * sizeof (Uint32)) != 0) {
+            SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "%s drew something different!\n", method_names[i]);
+            result = 1;
+        }
+    }
+
+    if (result == 0) {
+        SDL_Log("%d frames of a %dx%d image with a %dx%d area changing each frame:\n",
+                num_frames, IMAGE_SIZE, IMAGE_SIZE, DIRTY_SIZE, DIRTY_SIZE);
+        for (i = 0; i < NUM_METHODS; ++i) {
+            SDL_Log("%-20s texture %9u bytes, uploads %9.3f ms (%u bytes in the last frame), total %9.3f ms\n",
+                    method_names[i], (unsigned int) texture_bytes[i], upload_ms[i],
+                    (unsigned int) stats[i].texture_upload_bytes, total_ms[i]);
+        }
+    }
+
+    for (i = 0; i < NUM_METHODS; ++i) {
+        SDL_free(pixels[i]);
+    }
+    SDL_Quit();
+    return result;
+}
+
+/* vi: set ts=4 sw=4 expandtab: */
@@ -20,9 +20,24 @@
 #include "SDL.h"
 
 #define DEFAULT_RESOLUTION  1
+#define JITTER_TIMERS       10000
+#define PACING_HZ           240
 
 static int ticks = 0;
 
+/* Each jitter timer tracks when it is next expected to fire */
+typedef struct
+{
+    Uint64 due;
+    Uint64 period;
+} JitterTimer;
+
+static JitterTimer jitter_timers[JITTER_TIMERS];
+static SDL_TimerID jitter_ids[JITTER_TIMERS];
+static Uint64 jitter_total;
+static Uint64 jitter_max;
+static int jitter_count;
+
 static Uint32 SDLCALL
 ticktock(Uint32 interval, void *param)
 {
@@ -37,6 +52,134 @@ callback(Uint32 interval, void *param)
     return interval;
 }
 
+static Uint32 SDLCALL
+jitter_callback(Uint32 interval, void *param)
+{
+    /* All timer callbacks run on the timer thread, so no locking is needed */
+    JitterTimer *timer = (JitterTimer *) param;
+    const Uint64 now = SDL_GetPerformanceCounter();
+    const Uint64 late = (now > timer->due) ? (now - timer->due) : 0;
+
+    jitter_total += late;
+    if (late > jitter_max) {
+        jitter_max = late;
+    }
+    ++jitter_count;
+
+    timer->due += timer->period;
+    if (timer->due <= now) {
+        timer->due = now + timer->period;
+    }
+    return interval;
+}
+
+/* Run (count) concurrent timers for (seconds), reporting how late they were dispatched */
+static void
+jitter_test(int count, int seconds, SDL_bool microseconds)
+{
+    const Uint64 freq = SDL_GetPerformanceFrequency();
+    const Uint32 units = microseconds ? 1000000 : 1000;
+    Uint64 start, now;
+    int i;
+
+    jitter_total = 0;
+    jitter_max = 0;
+    jitter_count = 0;
+
+    start = SDL_GetPerformanceCounter();
+    for (i = 0; i < count; ++i) {
+        /* Spread the intervals over 1-50 ms, or 250-1000 us */
+        const Uint32 interval = microseconds ? (250 + (i % 4) * 250) : (1 + (i % 50));
+        JitterTimer *timer = &jitter_timers[i];
+        timer->period = (interval * freq) / units;
+        timer->due = SDL_GetPerformanceCounter() + timer->period;
+        if (microseconds) {
+            jitter_ids[i] = SDL_AddTimerMicroseconds(interval, jitter_callback, timer);
+        } else {
+            jitter_ids[i] = SDL_AddTimer(interval, jitter_callback, timer);
+        }
+        if (!jitter_ids[i]) {
+            SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Could not create timer %d: %s\n", i, SDL_GetError());
+            count = i;
+            break;
+        }
+    }
+    now = SDL_GetPerformanceCounter();
+    SDL_Log("Adding %d %s timers took %f ms\n", count, microseconds ? "microsecond" : "millisecond",
+            (double)((now - start)*1000) / freq);
+
+    SDL_Delay(seconds * 1000);
+
+    start = SDL_GetPerformanceCounter();
+    for (i = 0; i < count; ++i) {
+        SDL_RemoveTimer(jitter_ids[i]);
+    }
+    now = SDL_GetPerformanceCounter();
+    SDL_Log("Removing %d timers took %f ms\n", count, (double)((now - start)*1000) / freq);
+
+    /* Let any callback in flight finish before reading the results */
+    SDL_Delay(100);
+
+    if (jitter_count) {
+        SDL_Log("%d dispatches in %d seconds, average lateness %f us, maximum %f us\n",
+                jitter_count, seconds,
+                ((double) jitter_total * 1000000.0) / freq / jitter_count,
+                ((double) jitter_max * 1000000.0) / freq);
+    }
+}
+
+typedef enum
+{
+    PACE_DELAY,
+    PACE_DELAY_NS,
+    PACE_DELAY_UNTIL
+} PacingMethod;
+
+/* Pace a loop at PACING_HZ for (seconds), reporting how far from its target
+   time each frame started */
+static void
+pacing_test(PacingMethod method, int seconds)
+{
+    static const char *names[] = { "SDL_Delay", "SDL_DelayNS", "SDL_DelayUntil" };
+    const Uint64 freq = SDL_GetPerformanceFrequency();
+    const Uint64 period = freq / PACING_HZ;
+    const int frames = seconds * PACING_HZ;
+    Uint64 deadline = SDL_GetPerformanceCounter() + period;
+    Uint64 now, error, total = 0, worst = 0;
+    int i;
+
+    for (i = 0; i < frames; ++i) {
+        now = SDL_GetPerformanceCounter();
+        switch (method) {
+        case PACE_DELAY:
+            if (deadline > now) {
+                SDL_Delay((Uint32) (((deadline - now) * 1000) / freq));
+            }
+            break;
+        case PACE_DELAY_NS:
+            if (deadline > now) {
+                SDL_DelayNS(((deadline - now) * 1000000000) / freq);
+            }
+            break;
+        case PACE_DELAY_UNTIL:
+            SDL_DelayUntil(deadline);
+            break;
+        }
+        now = SDL_GetPerformanceCounter();
+
+        error = (now > deadline) ? (now - deadline) : (deadline - now);
+        total += error;
+        if (error > worst) {
+            worst = error;
+        }
+        deadline += period;
+    }
+
+    SDL_Log("%-14s: average error %f us, maximum %f us\n", names[method],
+            ((double) total * 1000000.0) / freq / frames,
+            ((double) worst * 1000000.0) / freq);
+}
+
 int
 main(int argc, char *argv[])
 {
@@ -107,6 +250,17 @@ main(int argc, char *argv[])
     now = SDL_GetPerformanceCounter();
     SDL_Log("1 million iterations of ticktock took %f ms\n", (double)((now - start)*1000) / SDL_GetPerformanceFrequency());
 
+    SDL_Log("Testing %d concurrent timers...\n", JITTER_TIMERS);
+    jitter_test(JITTER_TIMERS, 5, SDL_FALSE);
+
+    SDL_Log("Testing 100 concurrent microsecond timers...\n");
+    jitter_test(100, 2, SDL_TRUE);
+
+    SDL_Log("Pacing a loop at %d Hz...\n", PACING_HZ);
+    pacing_test(PACE_DELAY, 2);
+    pacing_test(PACE_DELAY_NS, 2);
+    pacing_test(PACE_DELAY_UNTIL, 2);
+
     SDL_Log("Performance counter frequency: %"SDL_PRIu64"\n", (unsigned long long) SDL_GetPerformanceFrequency());
     start32 = SDL_GetTicks();
     start = SDL_GetPerformanceCounter();